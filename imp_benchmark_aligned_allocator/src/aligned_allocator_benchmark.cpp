@@ -25,10 +25,53 @@
 #include <cstdint>
 #include <iostream>
 #include <stdlib.h>
+#include <utility>
+#include <vector>
 #include <ze/common/logging.hpp>
 #include <ze/common/timer.hpp>
 #include <ze/common/timer_statistics.hpp>
 #include <imp/core/image_raw.hpp>
+#include <imp/core/memory_pool.hpp>
+
+namespace {
+
+//! Allocation pattern of one frame: the camera image plus a four level
+//! float pyramid, as created per frame by the data provider and the tracker.
+void allocateFrame(ze::uint32_t width, ze::uint32_t height)
+{
+  ze::ImageRaw8uC1 img(width, height);
+  std::vector<ze::ImageRaw32fC1::Ptr> pyramid;
+  for (int level = 0; level < 4; ++level)
+  {
+    pyramid.push_back(std::make_shared<ze::ImageRaw32fC1>(width >> level,
+                                                          height >> level));
+  }
+  // Touch the memory as a real frame would.
+  img.setValue(ze::Pixel8uC1(0));
+  for (const ze::ImageRaw32fC1::Ptr& level : pyramid)
+  {
+    level->setValue(ze::Pixel32fC1(0.0f));
+  }
+}
+
+double benchmarkFrames(const ze::MemoryPoolOptions& options,
+                       ze::uint32_t width, ze::uint32_t height,
+                       std::uint64_t num_frames)
+{
+  ze::MemoryPool::instance().setOptions(options);
+
+  allocateFrame(width, height); // warm-up
+  ze::TimerStatistics timer;
+  for (std::uint64_t i=0; i<num_frames; ++i)
+  {
+    __attribute__((unused)) auto t = timer.timeScope();
+    allocateFrame(width, height);
+  }
+  ze::MemoryPool::instance().setOptions(ze::MemoryPoolOptions());
+  return timer.mean();
+}
+
+} // unnamed namespace
 
 int main(int argc, char* argv[])
 {
@@ -65,7 +108,29 @@ int main(int argc, char* argv[])
       std::uint8_t* p_data_aligned = (std::uint8_t*)aligned_alloc(memaddr_align, memory_size);
       free(p_data_aligned);
     }
-    VLOG(1) << "posix_memalign: " << timer.mean() << "ms";
+    VLOG(1) << "aligned_alloc: " << timer.mean() << "ms";
   }
 
+  // Steady-state per-frame allocations with and without the memory pool.
+  ze::MemoryPoolOptions no_pool;
+  ze::MemoryPoolOptions pool;
+  pool.enabled = true;
+  ze::MemoryPoolOptions pool_huge_pages = pool;
+  pool_huge_pages.use_huge_pages = true;
+
+  const std::uint64_t num_frames = 1e3;
+  for (const std::pair<ze::uint32_t, ze::uint32_t>& size :
+       {std::make_pair(752u, 480u), std::make_pair(1920u, 1080u)})
+  {
+    const double malloc_ms =
+        benchmarkFrames(no_pool, size.first, size.second, num_frames);
+    const double pool_ms =
+        benchmarkFrames(pool, size.first, size.second, num_frames);
+    const double huge_pages_ms =
+        benchmarkFrames(pool_huge_pages, size.first, size.second, num_frames);
+    VLOG(1) << "frame " << size.first << "x" << size.second
+            << " (image + 4 level pyramid): posix_memalign " << malloc_ms
+            << "ms, memory pool " << pool_ms
+            << "ms, memory pool with huge pages " << huge_pages_ms << "ms";
+  }
 }
@@ -70,7 +70,15 @@ ImageCv<Pixel>::ImageCv(const Image<Pixel>& from)
   this->header_.pitch = mat_.step;
   this->header_.memory_type = (MemoryStorage<Pixel>::isAligned(data())) ?
         MemoryType::CpuAligned : MemoryType::Cpu;
-  from.copyTo(*this);
+  if (from.isGpuMemory())
+  {
+    from.copyTo(*this);
+  }
+  else
+  {
+    // The whole image and not only the ROI, which is part of the copied header.
+    copy(from.view(), this->view());
+  }
 }
 
 //-----------------------------------------------------------------------------
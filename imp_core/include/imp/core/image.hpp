@@ -30,6 +30,8 @@
 #include <ze/common/macros.hpp>
 #include <ze/common/logging.hpp>
 #include <imp/core/image_base.hpp>
+#include <imp/core/image_copy.hpp>
+#include <imp/core/image_view.hpp>
 #include <imp/core/pixel.hpp>
 
 namespace ze {
@@ -54,6 +56,41 @@ public:
   virtual Pixel* data(uint32_t ox = 0, uint32_t oy = 0) = 0;
   virtual const Pixel* data(uint32_t ox = 0, uint32_t oy = 0) const = 0;
 
+  /** Returns a non-virtual view on the whole (CPU) image.
+   * The pixel accessors below go through the virtual data() on every call, so
+   * per-pixel loops in CPU kernels should work on a view instead.
+   */
+  ImageView<Pixel> view()
+  {
+    CHECK(!this->isGpuMemory());
+    if (this->numel() == 0u)
+    {
+      return ImageView<Pixel>();
+    }
+    return ImageView<Pixel>(this->data(), this->size(), this->pitch());
+  }
+
+  ConstImageView<Pixel> view() const
+  {
+    CHECK(!this->isGpuMemory());
+    if (this->numel() == 0u)
+    {
+      return ConstImageView<Pixel>();
+    }
+    return ConstImageView<Pixel>(this->data(), this->size(), this->pitch());
+  }
+
+  /** Returns a non-virtual view on the image's region of interest. */
+  ImageView<Pixel> roiView()
+  {
+    return view().subView(this->roi());
+  }
+
+  ConstImageView<Pixel> roiView() const
+  {
+    return view().subView(this->roi());
+  }
+
   /** Get Pixel value at position x,y. */
   Pixel pixel(uint32_t x, uint32_t y) const
   {
@@ -104,82 +141,64 @@ public:
   virtual void setValue(const Pixel& value)
   {
     CHECK(roi() != Roi2u(0,0,0,0)) << "ROI not set. Should not happen when initializing the image header properly.";
-    // safety check if memory is contiguous and roi is not set.
-    if ((this->bytes() == this->pitch()*this->height()) &&
-        (this->roi() == ze::Roi2u(this->size())))
-    {
-      std::fill(this->data(), this->data()+this->stride()*this->height(), value);
-    }
-    else
-    {
-      for (uint32_t y=this->roi().y(); y<this->roi().y()+this->roi().height(); ++y)
-      {
-        std::fill_n(this->data(this->roi().x(),y), this->roi().width(), value);
-      }
-    }
+    fill(this->roiView(), value);
   }
 
   /**
-   * @brief copyTo copies the internal image data to another class instance
+   * @brief copyTo copies the region of interest of this image to the region
+   *        of interest of \a dst. Both regions must have the same size.
    * @param dst Image class that will receive this image's data.
-   * @todo (MWE) handle roi
    */
   virtual void copyTo(Image& dst) const
   {
-    CHECK_EQ(this->width(), dst.width());
-    CHECK_EQ(this->height(), dst.height());
-
     // check if dst image is on the gpu and the src image is not so we can
     // use the copyFrom functionality from the dst image as the Image class
     // doesn't know anything about gpu memory (poor thing)
     if (dst.isGpuMemory())
     {
+      CHECK_EQ(this->width(), dst.width());
+      CHECK_EQ(this->height(), dst.height());
       dst.copyFrom(*this);
     }
-    else if (this->bytes() == dst.bytes())
-    {
-      std::copy(this->data(), this->data()+this->stride()*this->height(), dst.data());
-    }
     else
     {
-      for (uint32_t y=0; y<this->height(); ++y)
-      {
-        for (uint32_t x=0; x<this->width(); ++x)
-        {
-          dst[y][x] = this->pixel(x,y);
-        }
-      }
+      CHECK_EQ(this->roi().size(), dst.roi().size());
+      copy(this->roiView(), dst.roiView());
     }
   }
 
   /**
-   * @brief copyFrom copies the image data from another class instance to this image
+   * @brief copyFrom copies the region of interest of \a from to the region of
+   *        interest of this image. Both regions must have the same size.
    * @param from Image class providing the image data.
    */
   virtual void copyFrom(const Image& from)
   {
-    CHECK_EQ(this->size(), from.size());
-
     if (from.isGpuMemory())
     {
+      CHECK_EQ(this->size(), from.size());
       from.copyTo(*this);
     }
-    else if (this->bytes() == from.bytes())
-    {
-      std::copy(from.data(), from.data()+from.stride()*from.height(), this->data());
-    }
     else
     {
-      for (uint32_t y=0; y<this->height(); ++y)
-      {
-        for (uint32_t x=0; x<this->width(); ++x)
-        {
-          (*this)[y][x] = from.pixel(x, y);
-        }
-      }
+      CHECK_EQ(this->roi().size(), from.roi().size());
+      copy(from.roiView(), this->roiView());
     }
   }
 
+  /**
+   * @brief convertTo copies the region of interest of this image to the
+   *        region of interest of \a dst and converts the pixel type on the
+   *        fly: dst = this * scale + offset. CPU images only.
+   * @param dst Image with the same number of channels.
+   */
+  template<typename DstPixel>
+  void convertTo(Image<DstPixel>& dst, float scale = 1.0f, float offset = 0.0f) const
+  {
+    CHECK_EQ(this->roi().size(), dst.roi().size());
+    convert(this->roiView(), dst.roiView(), scale, offset);
+  }
+
 
 protected:
   Image(ze::PixelOrder pixel_order = ze::PixelOrder::undefined)
@@ -0,0 +1,184 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <ze/common/logging.hpp>
+#include <imp/core/image_view.hpp>
+#include <imp/core/parallel.hpp>
+
+namespace ze {
+
+//------------------------------------------------------------------------------
+/**
+ * @brief copyPitched copies \a rows rows of \a row_bytes bytes between two
+ *        pitched buffers. Contiguous buffers are copied as one block. Large
+ *        copies use non-temporal stores (SSE2) to not evict the caches and are
+ *        split into row bands on imageThreadPool().
+ */
+void copyPitched(const void* src, size_t src_pitch,
+                 void* dst, size_t dst_pitch,
+                 size_t row_bytes, size_t rows);
+
+//! Copies of at least this size bypass the caches.
+constexpr size_t c_non_temporal_copy_bytes = 4u * 1024u * 1024u;
+//! Copies and conversions of at least this size are multithreaded.
+constexpr size_t c_parallel_bytes = 8u * 1024u * 1024u;
+//! Copies are memory bound, more than a few threads do not add bandwidth.
+constexpr size_t c_max_copy_row_bands = 4u;
+
+//! Number of row bands for parallelForRowBands() when copying or converting
+//! an image of the given size.
+constexpr size_t copyRowBands(size_t bytes)
+{
+  return bytes < c_parallel_bytes ? 1u : c_max_copy_row_bands;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * @brief copy copies the pixels of \a src to the equally sized view \a dst.
+ *        The row padding is neither read nor written.
+ */
+template<typename SrcPixel, typename DstPixel>
+void copy(const ImageView<SrcPixel>& src, const ImageView<DstPixel>& dst)
+{
+  static_assert(std::is_same<typename std::remove_const<SrcPixel>::type,
+                             DstPixel>::value,
+                "Source and destination views must have the same pixel type.");
+  CHECK_EQ(src.width(), dst.width());
+  CHECK_EQ(src.height(), dst.height());
+  if (src.empty())
+  {
+    return;
+  }
+  copyPitched(src.data(), src.pitch(), dst.data(), dst.pitch(),
+              src.rowBytes(), src.height());
+}
+
+namespace internal {
+
+//! Rounds and clamps for integer destinations, plain cast for floating point.
+//! Clamped in double: The limits of 32-bit integers are not representable as
+//! float, where INT32_MAX rounds up to 2^31.
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value, T>::type
+saturateCast(double v)
+{
+  static_assert(sizeof(T) <= 4u, "64-bit integer limits are not representable as double.");
+  v = std::round(v);
+  v = std::max(v, static_cast<double>(std::numeric_limits<T>::lowest()));
+  v = std::min(v, static_cast<double>(std::numeric_limits<T>::max()));
+  return static_cast<T>(v);
+}
+
+//! 8- and 16-bit limits are exact in float, which keeps the loops vectorized.
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value && (sizeof(T) < 4u), T>::type
+saturateCast(float v)
+{
+  v = std::round(v);
+  v = std::max(v, static_cast<float>(std::numeric_limits<T>::lowest()));
+  v = std::min(v, static_cast<float>(std::numeric_limits<T>::max()));
+  return static_cast<T>(v);
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value && (sizeof(T) >= 4u), T>::type
+saturateCast(float v)
+{
+  return saturateCast<T>(static_cast<double>(v));
+}
+
+template<typename T>
+inline typename std::enable_if<!std::is_integral<T>::value, T>::type
+saturateCast(float v)
+{
+  return static_cast<T>(v);
+}
+
+template<typename T>
+inline typename std::enable_if<!std::is_integral<T>::value, T>::type
+saturateCast(double v)
+{
+  return static_cast<T>(v);
+}
+
+//! Arithmetic type of convert(): float, unless one side is a 32-bit integer
+//! whose values above 2^24 are not exact in float.
+template<typename SrcT, typename DstT>
+using ConvertArithmetic = typename std::conditional<
+    (std::is_integral<SrcT>::value && sizeof(SrcT) >= 4u)
+    || (std::is_integral<DstT>::value && sizeof(DstT) >= 4u),
+    double, float>::type;
+
+} // namespace internal
+
+/**
+ * @brief convert copies \a src to the equally sized view \a dst while
+ *        converting the channel type: dst = src * scale + offset.
+ *        Integer destinations are rounded and saturated. Both pixel types
+ *        must have the same number of channels, e.g. 8uC1 -> 32fC1 with
+ *        scale 1/255 replaces a copy and a separate normalization pass.
+ */
+template<typename SrcPixel, typename DstPixel>
+void convert(const ImageView<SrcPixel>& src, const ImageView<DstPixel>& dst,
+             float scale = 1.0f, float offset = 0.0f)
+{
+  using SrcT = typename std::remove_const<SrcPixel>::type::T;
+  using DstT = typename DstPixel::T;
+  constexpr size_t c_channels = sizeof(SrcPixel) / sizeof(SrcT);
+  static_assert(c_channels == sizeof(DstPixel) / sizeof(DstT),
+                "Source and destination pixels must have the same number of channels.");
+  CHECK_EQ(src.width(), dst.width());
+  CHECK_EQ(src.height(), dst.height());
+
+  using Arithmetic = internal::ConvertArithmetic<SrcT, DstT>;
+  const Arithmetic a_scale = scale;
+  const Arithmetic a_offset = offset;
+  const size_t n = size_t{src.width()} * c_channels;
+  parallelForRowBands(src.height(), 1u, [&](size_t row_begin, size_t row_end)
+  {
+    for (size_t y = row_begin; y < row_end; ++y)
+    {
+      const SrcT* s = reinterpret_cast<const SrcT*>(src.rowPtr(y));
+      DstT* d = reinterpret_cast<DstT*>(dst.rowPtr(y));
+#pragma GCC ivdep
+      for (size_t i = 0u; i < n; ++i)
+      {
+        d[i] = internal::saturateCast<DstT>(
+              static_cast<Arithmetic>(s[i]) * a_scale + a_offset);
+      }
+    }
+  }, copyRowBands(src.height() * (src.rowBytes() + dst.rowBytes())));
+}
+
+} // namespace ze
@@ -124,6 +124,9 @@ public:
   virtual const Pixel* data(uint32_t ox = 0, uint32_t oy = 0) const override;
 
 protected:
+  //! Copy of all pixels of the equally sized \a from, used by the copy constructors.
+  void copyAll(const Base& from);
+
   std::unique_ptr<Pixel, Deallocator> data_; //!< the actual image data
   std::shared_ptr<void const> tracked_ = nullptr; //!< tracked object to share memory
 };
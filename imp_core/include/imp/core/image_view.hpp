@@ -0,0 +1,332 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include <ze/common/logging.hpp>
+#include <imp/core/roi.hpp>
+#include <imp/core/size.hpp>
+
+namespace ze {
+
+namespace internal {
+
+//! Byte pointer with the same constness as Pixel, used for pitch arithmetic.
+template<typename Pixel>
+using BytePtr = typename std::conditional<
+  std::is_const<Pixel>::value, const std::uint8_t*, std::uint8_t*>::type;
+
+template<typename Pixel>
+inline Pixel* offsetBytes(Pixel* ptr, std::size_t bytes)
+{
+  return reinterpret_cast<Pixel*>(reinterpret_cast<BytePtr<Pixel>>(ptr) + bytes);
+}
+
+} // namespace internal
+
+//------------------------------------------------------------------------------
+/**
+ * @brief The ImageRowSpan class is a contiguous, non-owning range of pixels,
+ *        i.e. one row of an ImageView.
+ */
+template<typename Pixel>
+class ImageRowSpan
+{
+public:
+  using value_type = typename std::remove_const<Pixel>::type;
+  using iterator = Pixel*;
+
+  ImageRowSpan(Pixel* data, std::uint32_t size)
+    : data_(data)
+    , size_(size)
+  {
+  }
+
+  inline Pixel* data() const { return data_; }
+  inline std::uint32_t size() const { return size_; }
+  inline Pixel* begin() const { return data_; }
+  inline Pixel* end() const { return data_ + size_; }
+
+  inline Pixel& operator[](std::uint32_t x) const
+  {
+    DEBUG_CHECK_LT(x, size_);
+    return data_[x];
+  }
+
+private:
+  Pixel* data_;
+  std::uint32_t size_;
+};
+
+//------------------------------------------------------------------------------
+/**
+ * @brief The ImageViewIterator class visits all pixels of an ImageView in
+ *        row-major order and skips the row padding. The current coordinates
+ *        are available via x() and y().
+ */
+template<typename Pixel>
+class ImageViewIterator
+{
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename std::remove_const<Pixel>::type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Pixel*;
+  using reference = Pixel&;
+
+  ImageViewIterator() = default;
+
+  ImageViewIterator(Pixel* row, std::uint32_t x, std::uint32_t y,
+                    std::uint32_t width, std::uint32_t pitch)
+    : row_(row)
+    , x_(x)
+    , y_(y)
+    , width_(width)
+    , pitch_(pitch)
+  {
+  }
+
+  inline Pixel& operator*() const { return row_[x_]; }
+  inline Pixel* operator->() const { return row_ + x_; }
+
+  inline ImageViewIterator& operator++()
+  {
+    if (++x_ == width_)
+    {
+      x_ = 0u;
+      ++y_;
+      row_ = internal::offsetBytes(row_, pitch_);
+    }
+    return *this;
+  }
+
+  inline ImageViewIterator operator++(int)
+  {
+    ImageViewIterator tmp(*this);
+    ++(*this);
+    return tmp;
+  }
+
+  inline bool operator==(const ImageViewIterator& rhs) const
+  {
+    return x_ == rhs.x_ && y_ == rhs.y_;
+  }
+
+  inline bool operator!=(const ImageViewIterator& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  inline std::uint32_t x() const { return x_; }
+  inline std::uint32_t y() const { return y_; }
+
+private:
+  Pixel* row_ = nullptr;
+  std::uint32_t x_ = 0u;
+  std::uint32_t y_ = 0u;
+  std::uint32_t width_ = 0u;
+  std::uint32_t pitch_ = 0u;
+};
+
+//------------------------------------------------------------------------------
+/**
+ * @brief The ImageView class is a typed, non-owning and non-virtual view on
+ *        pitched CPU image memory (pointer, pitch and size).
+ *
+ * In contrast to the pixel accessors of Image, which go through the virtual
+ * data() function, all accessors of the view can be inlined. CPU kernels
+ * should therefore fetch a view once with Image::view() and work on it.
+ * Use ConstImageView for read-only access, an ImageView converts implicitly.
+ *
+ * The view does not keep the image alive and is invalidated when the image
+ * memory is reallocated.
+ */
+template<typename Pixel>
+class ImageView
+{
+public:
+  using pixel_t = Pixel;
+  using value_type = typename std::remove_const<Pixel>::type;
+  using iterator = ImageViewIterator<Pixel>;
+  using RowSpan = ImageRowSpan<Pixel>;
+
+  ImageView() = default;
+
+  /**
+   * @brief ImageView on the given memory.
+   * @param data Pointer to the first pixel.
+   * @param width Width in pixels.
+   * @param height Height in pixels.
+   * @param pitch Length of a row in bytes (including padding).
+   */
+  ImageView(Pixel* data, std::uint32_t width, std::uint32_t height,
+            std::uint32_t pitch)
+    : data_(data)
+    , width_(width)
+    , height_(height)
+    , pitch_(pitch)
+  {
+    DEBUG_CHECK_GE(pitch_, width_ * sizeof(Pixel));
+    DEBUG_CHECK_EQ(pitch_ % sizeof(Pixel), 0u);
+  }
+
+  ImageView(Pixel* data, const Size2u& size, std::uint32_t pitch)
+    : ImageView(data, size.width(), size.height(), pitch)
+  {
+  }
+
+  /** Mutable to const view conversion. */
+  template<typename OtherPixel, typename = typename std::enable_if<
+             std::is_same<const OtherPixel, Pixel>::value>::type>
+  ImageView(const ImageView<OtherPixel>& other)
+    : ImageView(other.data(), other.width(), other.height(), other.pitch())
+  {
+  }
+
+  inline Pixel* data() const { return data_; }
+  inline std::uint32_t width() const { return width_; }
+  inline std::uint32_t height() const { return height_; }
+  inline Size2u size() const { return Size2u(width_, height_); }
+  inline bool empty() const { return width_ == 0u || height_ == 0u; }
+  inline std::size_t numel() const { return std::size_t{width_} * height_; }
+
+  /** Returns the distance in bytes between starts of consecutive rows. */
+  inline std::uint32_t pitch() const { return pitch_; }
+
+  /** Returns the length of a row (not including the padding!) in bytes. */
+  inline std::size_t rowBytes() const { return width_ * sizeof(Pixel); }
+
+  /** Returns true if there is no padding between rows. */
+  inline bool isContiguous() const { return pitch_ == rowBytes() || height_ <= 1u; }
+
+  /** Returns a pointer to the beginning of row \a y. */
+  inline Pixel* rowPtr(std::uint32_t y) const
+  {
+    DEBUG_CHECK_LT(y, height_);
+    return internal::offsetBytes(data_, std::size_t{y} * pitch_);
+  }
+
+  /** Returns row \a y as contiguous range of width() pixels. */
+  inline RowSpan row(std::uint32_t y) const
+  {
+    return RowSpan(rowPtr(y), width_);
+  }
+
+  /** Enables the usage of the [y][x] operator. */
+  inline Pixel* operator[](std::uint32_t y) const
+  {
+    return rowPtr(y);
+  }
+
+  inline Pixel& operator()(std::uint32_t x, std::uint32_t y) const
+  {
+    DEBUG_CHECK_LT(x, width_);
+    return rowPtr(y)[x];
+  }
+
+  /** Returns the view on the region \a roi of this view. */
+  inline ImageView subView(const Roi2u& roi) const
+  {
+    CHECK_LE(roi.x() + roi.width(), width_);
+    CHECK_LE(roi.y() + roi.height(), height_);
+    if (roi.width() == 0u || roi.height() == 0u)
+    {
+      return ImageView();
+    }
+    return ImageView(rowPtr(roi.y()) + roi.x(), roi.width(), roi.height(), pitch_);
+  }
+
+  inline iterator begin() const
+  {
+    return empty() ? end() : iterator(data_, 0u, 0u, width_, pitch_);
+  }
+
+  inline iterator end() const
+  {
+    return iterator(nullptr, 0u, empty() ? 0u : height_, width_, pitch_);
+  }
+
+private:
+  Pixel* data_ = nullptr;
+  std::uint32_t width_ = 0u;
+  std::uint32_t height_ = 0u;
+  std::uint32_t pitch_ = 0u;
+};
+
+template<typename Pixel>
+using ConstImageView = ImageView<const Pixel>;
+
+//------------------------------------------------------------------------------
+/**
+ * @brief fill sets all pixels of the view \a dst to \a value.
+ */
+template<typename Pixel>
+void fill(const ImageView<Pixel>& dst,
+          const typename ImageView<Pixel>::value_type& value)
+{
+  static_assert(!std::is_const<Pixel>::value, "Cannot fill a ConstImageView.");
+  if (dst.isContiguous())
+  {
+    std::fill_n(dst.data(), dst.numel(), value);
+    return;
+  }
+  for (std::uint32_t y = 0u; y < dst.height(); ++y)
+  {
+    std::fill_n(dst.rowPtr(y), dst.width(), value);
+  }
+}
+
+/**
+ * @brief forEachTile splits \a view into tiles of at most
+ *        \a tile_width x \a tile_height pixels and calls
+ *        fn(tile_view, tile_x, tile_y) for each of them in row-major order,
+ *        where (tile_x, tile_y) is the tile's upper-left corner in \a view.
+ *        Tiles at the right and bottom border may be smaller.
+ */
+template<typename Pixel, typename Fn>
+void forEachTile(const ImageView<Pixel>& view,
+                 std::uint32_t tile_width, std::uint32_t tile_height,
+                 const Fn& fn)
+{
+  CHECK_GT(tile_width, 0u);
+  CHECK_GT(tile_height, 0u);
+  for (std::uint32_t y = 0u; y < view.height(); y += tile_height)
+  {
+    const std::uint32_t h = std::min(tile_height, view.height() - y);
+    for (std::uint32_t x = 0u; x < view.width(); x += tile_width)
+    {
+      const std::uint32_t w = std::min(tile_width, view.width() - x);
+      fn(view.subView(Roi2u(x, y, w, h)), x, y);
+    }
+  }
+}
+
+} // namespace ze
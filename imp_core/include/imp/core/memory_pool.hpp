@@ -0,0 +1,125 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <ze/common/noncopyable.hpp>
+
+namespace ze {
+
+//------------------------------------------------------------------------------
+struct MemoryPoolOptions
+{
+  //! If false, MemoryStorage::managedAlloc() falls back to posix_memalign/free.
+  bool enabled = false;
+
+  //! Upper bound for the memory held in the pool while not in use.
+  size_t max_cached_bytes = 256u * 1024u * 1024u;
+
+  //! Upper bound for the number of free blocks kept per block size.
+  size_t max_blocks_per_bucket = 8u;
+
+  //! Back blocks of at least huge_page_threshold bytes with (transparent)
+  //! huge pages. Only has an effect on Linux. The threshold is also the huge
+  //! page size and must be a power of two.
+  bool use_huge_pages = false;
+  size_t huge_page_threshold = 2u * 1024u * 1024u;
+};
+
+//------------------------------------------------------------------------------
+/**
+ * @brief The MemoryPool class recycles aligned memory blocks of image and
+ *        linear memory buffers.
+ *
+ * Free blocks are bucketed by their exact size in bytes. Since the pitch is a
+ * function of the width, images of the same size and pixel type always hit
+ * the same bucket, e.g. the per-frame images of a data provider or the levels
+ * of an image pyramid. Released blocks are kept until one of the caps in
+ * MemoryPoolOptions is reached, then they are freed.
+ *
+ * All functions are thread-safe. Blocks are 128-byte aligned, which satisfies
+ * every alignment supported by MemoryStorage.
+ */
+class MemoryPool : Noncopyable
+{
+public:
+  static constexpr size_t c_alignment = 128u;
+
+  //! Process-wide pool. It is never destroyed, so that deallocators of
+  //! static images can still return their memory during shutdown.
+  static MemoryPool& instance();
+
+  MemoryPool() = default;
+  ~MemoryPool();
+
+  //! Sets the options and frees cached blocks that exceed the new caps.
+  void setOptions(const MemoryPoolOptions& options);
+  MemoryPoolOptions options() const;
+
+  inline bool isEnabled() const
+  {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  //! Returns a block of \a bytes from the pool or allocates a new one.
+  //! Throws std::bad_alloc if the allocation fails.
+  void* allocate(size_t bytes);
+
+  //! Returns a block obtained with allocate(\a bytes) to the pool.
+  void release(void* ptr, size_t bytes);
+
+  //! Frees all cached blocks.
+  void clear();
+
+  size_t cachedBytes() const;
+  size_t numCachedBlocks() const;
+
+  //! Number of allocate() calls served from the pool / by a new allocation.
+  inline uint64_t numHits() const { return num_hits_.load(); }
+  inline uint64_t numMisses() const { return num_misses_.load(); }
+
+private:
+  //! Allocates a new block, huge_page_size > 0 requests huge page backing.
+  static void* allocateBlock(size_t bytes, size_t huge_page_size);
+  void trim();
+
+  mutable std::mutex mutex_;
+  MemoryPoolOptions options_;
+  std::atomic<bool> enabled_ { false };
+  std::unordered_map<size_t, std::vector<void*>> buckets_;
+  size_t cached_bytes_ = 0u;
+  size_t num_cached_blocks_ = 0u;
+  std::atomic<uint64_t> num_hits_ { 0u };
+  std::atomic<uint64_t> num_misses_ { 0u };
+};
+
+} // namespace ze
@@ -29,19 +29,27 @@
 #include <math.h>
 #include <functional>
 #include <algorithm>
+#include <memory>
 
 #include <ze/common/logging.hpp>
 #include <ze/common/types.hpp>
+#include <imp/core/memory_pool.hpp>
 #include <imp/core/size.hpp>
 #include <imp/core/types.hpp>
 
 namespace ze {
 
+// fwd
+template<typename Pixel>
+class MemoryDeallocator;
+
 //--------------------------------------------------------------------------
 template <typename Pixel, int memaddr_align=32, bool align_rows=true>
 struct MemoryStorage
 {
 public:
+  using ManagedPtr = std::unique_ptr<Pixel, MemoryDeallocator<Pixel>>;
+
   MemoryStorage() = delete;
   virtual ~MemoryStorage() = delete;
 
@@ -113,14 +121,51 @@ public:
     assert((memaddr_align != 0) && memaddr_align <= 128 &&
            ((memaddr_align & (~memaddr_align + 1)) == memaddr_align));
 
-    // check if the width allows a correct alignment of every row, otherwise add padding
-    const uint32_t width_bytes = size.width() * sizeof(Pixel);
-    // bytes % memaddr_align = 0 for bytes=n*memaddr_align is the reason for
-    // the decrement in the following compution:
-    const uint32_t bytes_to_add = (memaddr_align-1) - ((width_bytes-1) % memaddr_align);
-    const uint32_t pitched_width = size.width() + bytes_to_add/sizeof(Pixel);
-    *pitch = width_bytes + bytes_to_add;
-    return alignedAlloc(pitched_width*size.height(), init_with_zeros);
+    return alignedAlloc(pitchedNumElements(size, pitch), init_with_zeros);
+  }
+
+  /**
+   * @brief managedAlloc allocates like alignedAlloc but returns the memory
+   *        together with the matching deallocator. If the MemoryPool is
+   *        enabled, the block is taken from and returned to the pool.
+   * @param num_elements Number of (minimum) allocated elements
+   * @param init_with_zeros Flag if the memory elements should be zeroed out (default=false).
+   */
+  static ManagedPtr managedAlloc(const uint32_t num_elements,
+                                 bool init_with_zeros=false)
+  {
+    MemoryPool& pool = MemoryPool::instance();
+    if (!pool.isEnabled())
+    {
+      return ManagedPtr(alignedAlloc(num_elements, init_with_zeros),
+                        MemoryDeallocator<Pixel>());
+    }
+    CHECK_GT(num_elements, 0u) << "Failed to allocate memory: num_elements=0";
+    static_assert(memaddr_align <= MemoryPool::c_alignment,
+                  "The memory pool does not support the requested alignment.");
+
+    const size_t memory_size = sizeof(Pixel) * num_elements;
+    Pixel* p_data = static_cast<Pixel*>(pool.allocate(memory_size));
+    if (init_with_zeros)
+    {
+      std::fill(p_data, p_data+num_elements, Pixel(0));
+    }
+    return ManagedPtr(p_data, MemoryDeallocator<Pixel>::pooled(memory_size));
+  }
+
+  /**
+   * @brief managedAlloc allocates like alignedAlloc for an image of size \a size
+   *        but returns the memory together with the matching deallocator.
+   * @param size Image size
+   * @param pitch Row alignment [bytes] if padding is needed.
+   * @param init_with_zeros Flag if the memory elements should be zeroed out (default=false).
+   */
+  static ManagedPtr managedAlloc(
+      ze::Size2u size, uint32_t* pitch, bool init_with_zeros=false)
+  {
+    CHECK_GT(size.width(), 0u);
+    CHECK_GT(size.height(), 0u);
+    return managedAlloc(pitchedNumElements(size, pitch), init_with_zeros);
   }
 
 
@@ -132,6 +177,23 @@ public:
   {
     free(buffer);
   }
+
+private:
+  /**
+   * @brief pitchedNumElements computes the row \a pitch [bytes] for \a size
+   *        and returns the number of elements to allocate.
+   */
+  static uint32_t pitchedNumElements(ze::Size2u size, uint32_t* pitch)
+  {
+    // check if the width allows a correct alignment of every row, otherwise add padding
+    const uint32_t width_bytes = size.width() * sizeof(Pixel);
+    // bytes % memaddr_align = 0 for bytes=n*memaddr_align is the reason for
+    // the decrement in the following compution:
+    const uint32_t bytes_to_add = (memaddr_align-1) - ((width_bytes-1) % memaddr_align);
+    const uint32_t pitched_width = size.width() + bytes_to_add/sizeof(Pixel);
+    *pitch = width_bytes + bytes_to_add;
+    return pitched_width*size.height();
+  }
 }; // struct MemoryStorage
 
 /**
@@ -159,6 +221,17 @@ public:
     : f_(f)
   { }
 
+  /**
+   * @brief pooled returns a deallocator that hands a block of \a bytes
+   *        obtained from the MemoryPool back to the pool.
+   */
+  static MemoryDeallocator pooled(size_t bytes)
+  {
+    return MemoryDeallocator([bytes](Pixel* p) {
+      MemoryPool::instance().release(p, bytes);
+    });
+  }
+
   void operator()(Pixel* p) const
   {
     f_(p);
@@ -0,0 +1,65 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#include <ze/common/work_stealing_thread_pool.hpp>
+
+namespace ze {
+
+//! Thread pool shared by all CPU image functions, from the copies in imp_core
+//! to the filters and solvers built on them, so that nested parallel loops
+//! do not oversubscribe the cores. It is started on first use with one worker
+//! less than there are hardware threads, the calling thread participates in
+//! parallelForRowBands().
+WorkStealingThreadPool& imageThreadPool();
+
+//! Calls fn(row_begin, row_end) for disjoint bands of consecutive rows that
+//! cover [0, rows). Bands have at least min_rows rows, so that per-band setup
+//! costs (e.g. filter borders) stay small, and there are neither more bands
+//! than threads nor more than max_bands, e.g. for memory bound loops that do
+//! not gain from more threads. A single band runs on the calling thread.
+//! Returns when all bands are processed.
+template<typename Fn>
+void parallelForRowBands(size_t rows, size_t min_rows, const Fn& fn,
+                         size_t max_bands = std::numeric_limits<size_t>::max())
+{
+  if (rows == 0u)
+  {
+    return;
+  }
+  WorkStealingThreadPool& pool = imageThreadPool();
+  const size_t num_bands = std::min(
+        {std::max<size_t>(1u, rows / std::max<size_t>(min_rows, 1u)),
+         pool.numThreads() + 1u, std::max<size_t>(max_bands, 1u)});
+  const size_t grain = (rows + num_bands - 1u) / num_bands;
+  pool.parallelFor(0u, rows, grain, fn);
+}
+
+} // namespace ze
@@ -0,0 +1,90 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+namespace ze {
+
+enum class StereoPDSolver
+{
+  HuberL1, //!< Huber regularization + pointwise L1 intensity matching costs
+  PrecondHuberL1, //!< Huber regularization + pointwise L1 intensity matching costs
+  PrecondHuberL1Weighted, //!< weighted Huber regularization + pointwise L1 intensity matching costs
+  EpipolarPrecondHuberL1 //!< Huber regularization + pointwise L1 intensity matching costs applied on generic images with known epipolar geometry (not rectified)
+};
+
+/**
+ * @brief The VariationalStereoParams struct holds the parameters shared by
+ *        the variational stereo solvers on the CPU and on the GPU. The
+ *        backends derive from it and add the pointwise lambda as an image in
+ *        their memory.
+ */
+struct VariationalStereoParams
+{
+  StereoPDSolver solver=StereoPDSolver::PrecondHuberL1; //!< selected primal-dual solver / model combination
+  float lambda = 30.0f; //!< tradeoff between regularization and matching term (R(u) + \lambda * D(u))
+  float eps_u = 0.05f; //!< tradeoff between L1 and L2 part of the Huber regularization
+
+  float edge_sigma = 1.f;
+  float edge_alpha = 7.f;
+  float edge_q = 0.7f;
+
+  // settings for the ctf warping
+  struct CTF
+  {
+    float scale_factor = 0.8f; //!< multiplicative scale factor between coarse-to-fine pyramid levels
+    uint32_t iters = 100;
+    uint32_t warps =  10;
+    size_t levels = UINT32_MAX;
+    size_t coarsest_level = UINT32_MAX;
+    size_t finest_level = 0;
+    bool apply_median_filter = true;
+  } ctf;
+};
+
+inline std::ostream& operator<<(std::ostream& stream,
+                                const VariationalStereoParams& p)
+{
+  stream << "  solver: " << static_cast<int>(p.solver) << std::endl
+         << "  lambda: " << p.lambda << std::endl
+         << "  eps_u: " << p.eps_u << std::endl
+         << "  edge_sigma: " << p.edge_sigma << std::endl
+         << "  edge_alpha: " << p.edge_alpha << std::endl
+         << "  edge_q: " << p.edge_q << std::endl
+         << "  ctf.scale_factor: " << p.ctf.scale_factor << std::endl
+         << "  ctf.iters: " << p.ctf.iters << std::endl
+         << "  ctf.warps: " << p.ctf.warps << std::endl
+         << "  ctf.levels: " << p.ctf.levels << std::endl
+         << "  ctf.coarsest_level: " << p.ctf.coarsest_level << std::endl
+         << "  ctf.finest_level: " << p.ctf.finest_level << std::endl
+         << "  ctf.apply_median_filter: " << p.ctf.apply_median_filter << std::endl;
+  return stream;
+}
+
+} // namespace ze
@@ -0,0 +1,127 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/core/image_copy.hpp>
+
+#include <cstring>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+namespace ze {
+
+namespace {
+
+void copyRow(const uint8_t* src, uint8_t* dst, size_t bytes, bool non_temporal)
+{
+#ifdef __SSE2__
+  if (non_temporal)
+  {
+    // Regular copy up to the first 16-byte aligned destination address.
+    const size_t head = std::min(
+          bytes, (16u - reinterpret_cast<std::uintptr_t>(dst) % 16u) % 16u);
+    std::memcpy(dst, src, head);
+    size_t i = head;
+    for (; i + 64u <= bytes; i += 64u)
+    {
+      const __m128i* s = reinterpret_cast<const __m128i*>(src + i);
+      __m128i* d = reinterpret_cast<__m128i*>(dst + i);
+      const __m128i a = _mm_loadu_si128(s);
+      const __m128i b = _mm_loadu_si128(s + 1);
+      const __m128i c = _mm_loadu_si128(s + 2);
+      const __m128i e = _mm_loadu_si128(s + 3);
+      _mm_stream_si128(d, a);
+      _mm_stream_si128(d + 1, b);
+      _mm_stream_si128(d + 2, c);
+      _mm_stream_si128(d + 3, e);
+    }
+    std::memcpy(dst + i, src + i, bytes - i);
+    return;
+  }
+#else
+  (void)non_temporal;
+#endif
+  std::memcpy(dst, src, bytes);
+}
+
+//! Orders the streamed stores of this thread before anything it does next,
+//! e.g. signalling the end of a parallel block.
+inline void storeFence(bool non_temporal)
+{
+#ifdef __SSE2__
+  if (non_temporal)
+  {
+    _mm_sfence();
+  }
+#else
+  (void)non_temporal;
+#endif
+}
+
+} // unnamed namespace
+
+//-----------------------------------------------------------------------------
+void copyPitched(const void* src, size_t src_pitch,
+                 void* dst, size_t dst_pitch,
+                 size_t row_bytes, size_t rows)
+{
+  CHECK_LE(row_bytes, src_pitch);
+  CHECK_LE(row_bytes, dst_pitch);
+  const uint8_t* src_bytes = static_cast<const uint8_t*>(src);
+  uint8_t* dst_bytes = static_cast<uint8_t*>(dst);
+  const size_t total_bytes = row_bytes * rows;
+  const bool non_temporal = total_bytes >= c_non_temporal_copy_bytes;
+
+  if (src_pitch == row_bytes && dst_pitch == row_bytes
+      && total_bytes < c_parallel_bytes)
+  {
+    copyRow(src_bytes, dst_bytes, total_bytes, non_temporal);
+    storeFence(non_temporal);
+  }
+  else
+  {
+    parallelForRowBands(rows, 1u, [&](size_t row_begin, size_t row_end)
+    {
+      if (src_pitch == row_bytes && dst_pitch == row_bytes)
+      {
+        copyRow(src_bytes + row_begin * row_bytes,
+                dst_bytes + row_begin * row_bytes,
+                (row_end - row_begin) * row_bytes, non_temporal);
+      }
+      else
+      {
+        for (size_t y = row_begin; y < row_end; ++y)
+        {
+          copyRow(src_bytes + y * src_pitch, dst_bytes + y * dst_pitch,
+                  row_bytes, non_temporal);
+        }
+      }
+      storeFence(non_temporal);
+    }, copyRowBands(total_bytes));
+  }
+}
+
+} // namespace ze
@@ -22,7 +22,9 @@
 // ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-#include <imp/cu_imgproc/image_pyramid.hpp>
+#include <imp/core/image_pyramid.hpp>
+
+#include <cmath>
 
 #include <glog/logging.h>
 #include <imp/core/pixel_enums.hpp>
@@ -45,6 +47,7 @@ template<typename Pixel>
 void ImagePyramid<Pixel>::clear() noexcept
 {
   levels_.clear();
+  scratch_.clear();
   scale_factors_.clear();
 }
 
@@ -34,7 +34,7 @@ template<typename Pixel>
 ImageRaw<Pixel>::ImageRaw(const ze::Size2u& size, PixelOrder pixel_order)
   : Base(size, pixel_order)
 {
-  data_.reset(Memory::alignedAlloc(size, &this->header_.pitch));
+  data_ = Memory::managedAlloc(size, &this->header_.pitch);
   this->header_.memory_type = MemoryType::CpuAligned;
 }
 
@@ -43,9 +43,9 @@ template<typename Pixel>
 ImageRaw<Pixel>::ImageRaw(const ImageRaw& from)
   : Base(from)
 {
-  data_.reset(Memory::alignedAlloc(this->size(), &this->header_.pitch));
+  data_ = Memory::managedAlloc(this->size(), &this->header_.pitch);
   this->header_.memory_type = MemoryType::CpuAligned;
-  from.copyTo(*this);
+  copyAll(from);
 }
 
 //-----------------------------------------------------------------------------
@@ -53,9 +53,9 @@ template<typename Pixel>
 ImageRaw<Pixel>::ImageRaw(const Image<Pixel>& from)
   : Base(from)
 {
-  data_.reset(Memory::alignedAlloc(this->size(), &this->header_.pitch));
+  data_ = Memory::managedAlloc(this->size(), &this->header_.pitch);
   this->header_.memory_type = MemoryType::CpuAligned;
-  from.copyTo(*this);
+  copyAll(from);
 }
 
 //-----------------------------------------------------------------------------
@@ -78,23 +78,10 @@ ImageRaw<Pixel>
   }
   else
   {
-    data_.reset(Memory::alignedAlloc(this->size(), &this->header_.pitch));
+    data_ = Memory::managedAlloc(this->size(), &this->header_.pitch);
     this->header_.memory_type = MemoryType::CpuAligned;
 
-    if (this->bytes() == pitch*height)
-    {
-      std::copy(data, data+this->stride()*height, data_.get());
-    }
-    else
-    {
-      for (uint32_t y=0; y<height; ++y)
-      {
-        for (uint32_t x=0; x<width; ++x)
-        {
-          data_.get()[y*this->stride()+x] = data[y*this->stride() + x];
-        }
-      }
-    }
+    copy(ConstImageView<Pixel>(data, width, height, pitch), this->view());
   }
 }
 
@@ -118,6 +105,21 @@ ImageRaw<Pixel>::ImageRaw(Pixel* data,
                                  MemoryType::CpuAligned : MemoryType::Cpu;
 }
 
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void ImageRaw<Pixel>::copyAll(const Base& from)
+{
+  if (from.isGpuMemory())
+  {
+    from.copyTo(*this);
+  }
+  else
+  {
+    // The whole image and not only the ROI, which is part of the copied header.
+    copy(from.view(), this->view());
+  }
+}
+
 //-----------------------------------------------------------------------------
 template<typename Pixel>
 Pixel* ImageRaw<Pixel>::data(uint32_t ox, uint32_t oy)
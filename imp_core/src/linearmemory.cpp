@@ -33,7 +33,7 @@ namespace ze {
 template<typename Pixel>
 LinearMemory<Pixel>::LinearMemory(const uint32_t& length)
   : LinearMemoryBase(length)
-  , data_(Memory::alignedAlloc(this->length()))
+  , data_(Memory::managedAlloc(this->length()))
 {
 }
 
@@ -43,7 +43,7 @@ LinearMemory<Pixel>::LinearMemory(const LinearMemory<Pixel>& from)
   : LinearMemoryBase(from)
 {
   CHECK(from.data_);
-  data_.reset(Memory::alignedAlloc(this->length()));
+  data_ = Memory::managedAlloc(this->length());
   std::copy(from.data_.get(), from.data_.get()+from.length(), data_.get());
 }
 
@@ -67,7 +67,7 @@ LinearMemory<Pixel>::LinearMemory(Pixel* host_data,
   else
   {
     // allocates an internal data pointer and copies the external data it.
-    data_.reset(Memory::alignedAlloc(this->length()));
+    data_ = Memory::managedAlloc(this->length());
     std::copy(host_data, host_data+length, data_.get());
   }
 }
@@ -0,0 +1,199 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/core/memory_pool.hpp>
+
+#include <stdlib.h>
+#include <new>
+
+#ifdef __linux__
+#  include <sys/mman.h>
+#endif
+
+#include <ze/common/logging.hpp>
+
+namespace ze {
+
+constexpr size_t MemoryPool::c_alignment;
+
+//-----------------------------------------------------------------------------
+MemoryPool& MemoryPool::instance()
+{
+  static MemoryPool* pool = new MemoryPool();
+  return *pool;
+}
+
+//-----------------------------------------------------------------------------
+MemoryPool::~MemoryPool()
+{
+  clear();
+}
+
+//-----------------------------------------------------------------------------
+void MemoryPool::setOptions(const MemoryPoolOptions& options)
+{
+  CHECK(!options.use_huge_pages
+        || (options.huge_page_threshold >= c_alignment
+            && (options.huge_page_threshold & (options.huge_page_threshold - 1u)) == 0u))
+      << "huge_page_threshold must be a power of two.";
+  std::lock_guard<std::mutex> lock(mutex_);
+  options_ = options;
+  enabled_.store(options.enabled, std::memory_order_relaxed);
+  trim();
+}
+
+//-----------------------------------------------------------------------------
+MemoryPoolOptions MemoryPool::options() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return options_;
+}
+
+//-----------------------------------------------------------------------------
+void* MemoryPool::allocate(size_t bytes)
+{
+  CHECK_GT(bytes, 0u);
+  size_t huge_page_size = 0u;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = buckets_.find(bytes);
+    if (it != buckets_.end() && !it->second.empty())
+    {
+      void* ptr = it->second.back();
+      it->second.pop_back();
+      cached_bytes_ -= bytes;
+      --num_cached_blocks_;
+      ++num_hits_;
+      return ptr;
+    }
+    if (options_.use_huge_pages && bytes >= options_.huge_page_threshold)
+    {
+      huge_page_size = options_.huge_page_threshold;
+    }
+  }
+  ++num_misses_;
+  return allocateBlock(bytes, huge_page_size);
+}
+
+//-----------------------------------------------------------------------------
+void MemoryPool::release(void* ptr, size_t bytes)
+{
+  if (ptr == nullptr)
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (options_.enabled
+        && cached_bytes_ + bytes <= options_.max_cached_bytes)
+    {
+      std::vector<void*>& bucket = buckets_[bytes];
+      if (bucket.size() < options_.max_blocks_per_bucket)
+      {
+        bucket.push_back(ptr);
+        cached_bytes_ += bytes;
+        ++num_cached_blocks_;
+        return;
+      }
+    }
+  }
+  ::free(ptr);
+}
+
+//-----------------------------------------------------------------------------
+void MemoryPool::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& bucket : buckets_)
+  {
+    for (void* ptr : bucket.second)
+    {
+      ::free(ptr);
+    }
+  }
+  buckets_.clear();
+  cached_bytes_ = 0u;
+  num_cached_blocks_ = 0u;
+}
+
+//-----------------------------------------------------------------------------
+size_t MemoryPool::cachedBytes() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cached_bytes_;
+}
+
+//-----------------------------------------------------------------------------
+size_t MemoryPool::numCachedBlocks() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_cached_blocks_;
+}
+
+//-----------------------------------------------------------------------------
+void* MemoryPool::allocateBlock(size_t bytes, size_t huge_page_size)
+{
+  const size_t alignment = huge_page_size > 0u ? huge_page_size : c_alignment;
+
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, alignment, bytes) != 0 || ptr == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+#ifdef __linux__
+  if (huge_page_size > 0u)
+  {
+    // Transparent huge pages are only used for the aligned, whole pages.
+    const size_t huge_bytes = bytes - bytes % huge_page_size;
+    if (huge_bytes > 0u)
+    {
+      ::madvise(ptr, huge_bytes, MADV_HUGEPAGE);
+    }
+  }
+#endif
+  return ptr;
+}
+
+//-----------------------------------------------------------------------------
+void MemoryPool::trim()
+{
+  // Called with the mutex locked.
+  for (auto& bucket : buckets_)
+  {
+    std::vector<void*>& blocks = bucket.second;
+    while (!blocks.empty()
+           && (blocks.size() > options_.max_blocks_per_bucket
+               || cached_bytes_ > options_.max_cached_bytes
+               || !options_.enabled))
+    {
+      ::free(blocks.back());
+      blocks.pop_back();
+      cached_bytes_ -= bucket.first;
+      --num_cached_blocks_;
+    }
+  }
+}
+
+} // namespace ze
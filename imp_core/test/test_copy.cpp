@@ -22,10 +22,14 @@
 // ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <limits>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <imp/core/image.hpp>
 #include <imp/core/image_raw.hpp>
+#include <imp/core/parallel.hpp>
 #include <ze/common/random.hpp>
 
 namespace ze {
@@ -94,3 +98,173 @@ TEST(IMPCoreTestSuite, testCopy8uC1DifferentBytes)
     }
   }
 }
+
+TEST(IMPCoreTestSuite, testCopyRoi)
+{
+  using namespace ze;
+  ImageRaw8uC1 img = generateRandomImage(640, 480);
+  ImageRaw8uC1 dst(200, 100);
+  dst.setValue(Pixel8uC1(0));
+
+  img.setRoi(Roi2u(100, 50, 150, 80));
+  dst.setRoi(Roi2u(20, 10, 150, 80));
+  img.copyTo(dst);
+  for (uint32_t y = 0; y < dst.height(); ++y)
+  {
+    for (uint32_t x = 0; x < dst.width(); ++x)
+    {
+      if (x >= 20 && x < 170 && y >= 10 && y < 90)
+      {
+        EXPECT_EQ(img(x + 80, y + 40), dst(x, y));
+      }
+      else
+      {
+        EXPECT_EQ(0, dst(x, y));
+      }
+    }
+  }
+
+  // The copy constructor copies the whole image despite the ROI.
+  ImageRaw8uC1 img_copy(img);
+  EXPECT_EQ(img.roi(), img_copy.roi());
+  EXPECT_EQ(img(0, 0), img_copy(0, 0));
+  EXPECT_EQ(img(639, 479), img_copy(639, 479));
+}
+
+TEST(IMPCoreTestSuite, testCopyLargePitched)
+{
+  using namespace ze;
+  // Large enough for the non-temporal and multithreaded paths.
+  constexpr uint32_t width{3001};
+  constexpr uint32_t padded_width{3072};
+  constexpr uint32_t height{1500};
+  ASSERT_GE(width * height * sizeof(Pixel16uC1), c_parallel_bytes);
+
+  std::vector<Pixel16uC1> data(padded_width * height);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    data[i] = static_cast<uint16_t>(i % 65521);
+  }
+  ImageRaw16uC1 img(data.data(), width, height,
+                    padded_width * sizeof(Pixel16uC1), true);
+  ImageRaw16uC1 img_copy(width, height);
+  img_copy.copyFrom(img);
+  for (uint32_t y = 0; y < height; ++y)
+  {
+    for (uint32_t x = 0; x < width; ++x)
+    {
+      ASSERT_EQ(img(x, y), img_copy(x, y)) << "at " << x << ", " << y;
+    }
+  }
+}
+
+TEST(IMPCoreTestSuite, testCopyLargeInsideRowBands)
+{
+  using namespace ze;
+  // Large copies inside the bands of another parallel loop run on the same
+  // pool, the waiting bands help with the nested copies.
+  constexpr uint32_t width{2048};
+  constexpr uint32_t height{2048};
+  ASSERT_GE(width * height * sizeof(Pixel16uC1), c_parallel_bytes);
+  std::vector<ImageRaw16uC1> src, dst;
+  for (int i = 0; i < 4; ++i)
+  {
+    src.emplace_back(width, height);
+    src.back().setValue(Pixel16uC1(static_cast<uint16_t>(i + 1)));
+    dst.emplace_back(width, height);
+  }
+  parallelForRowBands(src.size(), 1u, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      dst[i].copyFrom(src[i]);
+    }
+  });
+  for (size_t i = 0; i < src.size(); ++i)
+  {
+    EXPECT_EQ(src[i](0, 0), dst[i](0, 0));
+    EXPECT_EQ(src[i](width - 1, height - 1), dst[i](width - 1, height - 1));
+  }
+}
+
+TEST(IMPCoreTestSuite, testConvert8uC1To32fC1)
+{
+  using namespace ze;
+  ImageRaw8uC1 img = generateRandomImage(1024, 768);
+  ImageRaw32fC1 img_32f(img.width(), img.height());
+  img.convertTo(img_32f, 1.0f / 255.0f);
+  for (uint32_t y = 0; y < img.height(); ++y)
+  {
+    for (uint32_t x = 0; x < img.width(); ++x)
+    {
+      EXPECT_FLOAT_EQ(img(x, y).x / 255.0f, img_32f(x, y));
+    }
+  }
+
+  // And back, with rounding.
+  ImageRaw8uC1 img_8u(img.width(), img.height());
+  img_32f.convertTo(img_8u, 255.0f);
+  for (uint32_t y = 0; y < img.height(); ++y)
+  {
+    for (uint32_t x = 0; x < img.width(); ++x)
+    {
+      EXPECT_EQ(img(x, y), img_8u(x, y));
+    }
+  }
+}
+
+TEST(IMPCoreTestSuite, testConvertSaturates)
+{
+  using namespace ze;
+  ImageRaw32fC1 src(64, 2);
+  src.setValue(Pixel32fC1(-3.0f));
+  src.setRoi(Roi2u(0, 1, 64, 1));
+  src.setValue(Pixel32fC1(300.4f));
+  src.setRoi(Roi2u(0, 0, 64, 2));
+
+  ImageRaw8uC1 dst(64, 2);
+  src.convertTo(dst);
+  EXPECT_EQ(0, dst(10, 0));
+  EXPECT_EQ(255, dst(10, 1));
+
+  ImageRaw16sC1 dst_16s(64, 2);
+  src.convertTo(dst_16s, 1.0f, 0.5f);
+  EXPECT_EQ(-3, dst_16s(10, 0));
+  EXPECT_EQ(301, dst_16s(10, 1));
+}
+
+TEST(IMPCoreTestSuite, testConvert32sC1NearLimits)
+{
+  using namespace ze;
+  constexpr int32_t c_max = std::numeric_limits<int32_t>::max();
+  constexpr int32_t c_min = std::numeric_limits<int32_t>::lowest();
+  const std::vector<int32_t> values{c_max, c_max - 1, (1 << 24) + 1, -7, c_min};
+  ImageRaw32sC1 src(values.size(), 1);
+  for (size_t x = 0; x < values.size(); ++x)
+  {
+    src(x, 0) = values[x];
+  }
+
+  // Exact, values above 2^24 are not rounded to float.
+  ImageRaw32sC1 dst(src.size());
+  src.convertTo(dst);
+  for (size_t x = 0; x < values.size(); ++x)
+  {
+    EXPECT_EQ(values[x], dst(x, 0).x);
+  }
+
+  // Saturates at the limits instead of overflowing.
+  src.convertTo(dst, 2.0f);
+  EXPECT_EQ(c_max, dst(0, 0).x);
+  EXPECT_EQ((1 << 25) + 2, dst(2, 0).x);
+  EXPECT_EQ(-14, dst(3, 0).x);
+  EXPECT_EQ(c_min, dst(4, 0).x);
+
+  ImageRaw32fC1 src_32f(src.size());
+  src_32f.setValue(Pixel32fC1(3e9f));
+  src_32f.convertTo(dst);
+  EXPECT_EQ(c_max, dst(0, 0).x);
+  src_32f.setValue(Pixel32fC1(-3e9f));
+  src_32f.convertTo(dst);
+  EXPECT_EQ(c_min, dst(0, 0).x);
+}
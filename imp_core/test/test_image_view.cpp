@@ -0,0 +1,191 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <vector>
+
+#include <ze/common/test_entrypoint.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/core/image_view.hpp>
+
+namespace {
+
+//! Pitched external memory with a distinct value per pixel and a marker in
+//! the padding.
+constexpr uint32_t c_width = 37u;
+constexpr uint32_t c_height = 23u;
+constexpr uint32_t c_stride = 48u;
+constexpr uint8_t c_padding = 255u;
+
+std::vector<ze::Pixel8uC1> pitchedData()
+{
+  std::vector<ze::Pixel8uC1> data(c_stride * c_height, c_padding);
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      data[y * c_stride + x] = static_cast<uint8_t>((x + 3u * y) % 200u);
+    }
+  }
+  return data;
+}
+
+} // unnamed namespace
+
+TEST(ImageViewTest, testAccessors)
+{
+  using namespace ze;
+  std::vector<Pixel8uC1> data = pitchedData();
+  ImageView<Pixel8uC1> view(data.data(), c_width, c_height, c_stride);
+  EXPECT_FALSE(view.isContiguous());
+  EXPECT_EQ(c_width * c_height, view.numel());
+
+  ImageRaw8uC1 img(data.data(), c_width, c_height, c_stride, true);
+  ConstImageView<Pixel8uC1> img_view = img.view();
+  EXPECT_EQ(data.data(), img_view.data());
+  EXPECT_EQ(c_stride, img_view.pitch());
+
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    ImageRowSpan<Pixel8uC1> row = view.row(y);
+    EXPECT_EQ(c_width, row.size());
+    uint32_t x = 0u;
+    for (const Pixel8uC1& px : row)
+    {
+      EXPECT_EQ(img(x, y), px);
+      EXPECT_EQ(img(x, y), view(x, y));
+      EXPECT_EQ(img(x, y), img_view[y][x]);
+      ++x;
+    }
+  }
+}
+
+TEST(ImageViewTest, testIteratorSkipsPadding)
+{
+  using namespace ze;
+  std::vector<Pixel8uC1> data = pitchedData();
+  ConstImageView<Pixel8uC1> view(data.data(), c_width, c_height, c_stride);
+
+  size_t n = 0u;
+  for (auto it = view.begin(); it != view.end(); ++it)
+  {
+    EXPECT_EQ(n % c_width, it.x());
+    EXPECT_EQ(n / c_width, it.y());
+    EXPECT_EQ(view(it.x(), it.y()), *it);
+    EXPECT_NE(c_padding, *it);
+    ++n;
+  }
+  EXPECT_EQ(view.numel(), n);
+
+  ConstImageView<Pixel8uC1> empty;
+  EXPECT_TRUE(empty.begin() == empty.end());
+}
+
+TEST(ImageViewTest, testSubViewAndFill)
+{
+  using namespace ze;
+  std::vector<Pixel8uC1> data = pitchedData();
+  ImageView<Pixel8uC1> view(data.data(), c_width, c_height, c_stride);
+  ImageView<Pixel8uC1> sub = view.subView(Roi2u(5u, 7u, 11u, 3u));
+  EXPECT_EQ(11u, sub.width());
+  EXPECT_EQ(3u, sub.height());
+  EXPECT_EQ(&view(5u, 7u), &sub(0u, 0u));
+  EXPECT_EQ(&view(15u, 9u), &sub(10u, 2u));
+
+  fill(sub, Pixel8uC1(201u));
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_stride; ++x)
+    {
+      const bool inside = x >= 5u && x < 16u && y >= 7u && y < 10u;
+      if (inside)
+      {
+        EXPECT_EQ(201u, data[y * c_stride + x]);
+      }
+      else
+      {
+        EXPECT_NE(201u, data[y * c_stride + x]);
+      }
+    }
+  }
+}
+
+TEST(ImageViewTest, testCopyPitched)
+{
+  using namespace ze;
+  std::vector<Pixel8uC1> data = pitchedData();
+  ImageRaw8uC1 src(data.data(), c_width, c_height, c_stride, true);
+
+  // Copy constructor from external pitched memory.
+  ImageRaw8uC1 copied(data.data(), c_width, c_height, c_stride, false);
+  ImageRaw8uC1 dst(c_width, c_height);
+  dst.copyFrom(src);
+
+  std::vector<Pixel8uC1> packed(c_width * c_height);
+  ImageView<Pixel8uC1> packed_view(
+        packed.data(), c_width, c_height, c_width * sizeof(Pixel8uC1));
+  EXPECT_TRUE(packed_view.isContiguous());
+  copy(src.view(), packed_view);
+
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      EXPECT_EQ(src(x, y), copied(x, y));
+      EXPECT_EQ(src(x, y), dst(x, y));
+      EXPECT_EQ(src(x, y), packed[y * c_width + x]);
+    }
+  }
+  // The padding of the source is never touched.
+  EXPECT_EQ(c_padding, data[c_stride - 1u]);
+}
+
+TEST(ImageViewTest, testForEachTile)
+{
+  using namespace ze;
+  ImageRaw32sC1 img(c_width, c_height);
+  img.setValue(Pixel32sC1(0));
+
+  int num_tiles = 0;
+  forEachTile(img.view(), 16u, 8u,
+              [&](const ImageView<Pixel32sC1>& tile, uint32_t x0, uint32_t y0)
+  {
+    EXPECT_LE(tile.width(), 16u);
+    EXPECT_LE(tile.height(), 8u);
+    EXPECT_EQ(&img(x0, y0), &tile(0u, 0u));
+    for (Pixel32sC1& px : tile)
+    {
+      px.x += 1;
+    }
+    ++num_tiles;
+  });
+  EXPECT_EQ(3 * 3, num_tiles);
+
+  for (const Pixel32sC1& px : ConstImageView<Pixel32sC1>(img.view()))
+  {
+    EXPECT_EQ(1, px.x);
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,172 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <thread>
+#include <vector>
+
+#include <ze/common/test_entrypoint.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/core/linearmemory.hpp>
+#include <imp/core/memory_pool.hpp>
+
+namespace {
+
+//! Enables the process-wide pool for the lifetime of the object.
+class ScopedMemoryPool
+{
+public:
+  explicit ScopedMemoryPool(ze::MemoryPoolOptions options = ze::MemoryPoolOptions())
+  {
+    options.enabled = true;
+    ze::MemoryPool::instance().setOptions(options);
+  }
+
+  ~ScopedMemoryPool()
+  {
+    ze::MemoryPool::instance().setOptions(ze::MemoryPoolOptions());
+  }
+};
+
+} // unnamed namespace
+
+TEST(MemoryPoolTest, testDisabledByDefault)
+{
+  using namespace ze;
+  MemoryPool& pool = MemoryPool::instance();
+  EXPECT_FALSE(pool.isEnabled());
+  {
+    ImageRaw8uC1 img(640, 480);
+  }
+  EXPECT_EQ(0u, pool.numCachedBlocks());
+}
+
+TEST(MemoryPoolTest, testImageMemoryIsRecycled)
+{
+  using namespace ze;
+  ScopedMemoryPool scoped_pool;
+  MemoryPool& pool = MemoryPool::instance();
+
+  const Pixel32fC1* first;
+  uint32_t pitch;
+  {
+    ImageRaw32fC1 img(641, 480);
+    first = img.data();
+    pitch = img.pitch();
+  }
+  EXPECT_EQ(1u, pool.numCachedBlocks());
+  EXPECT_EQ(size_t{pitch} * 480u, pool.cachedBytes());
+
+  const uint64_t hits = pool.numHits();
+  {
+    ImageRaw32fC1 img(641, 480);
+    EXPECT_EQ(first, img.data());
+    EXPECT_EQ(pitch, img.pitch());
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(img.data()) % 32u);
+    EXPECT_EQ(0u, pool.numCachedBlocks());
+
+    // Different size: served by a new block.
+    ImageRaw32fC1 other(320, 240);
+    EXPECT_NE(first, other.data());
+  }
+  EXPECT_EQ(hits + 1u, pool.numHits());
+  EXPECT_EQ(2u, pool.numCachedBlocks());
+
+  {
+    LinearMemory32fC1 mem(1000u);
+    mem.setValue(Pixel32fC1(1.0f));
+  }
+  EXPECT_EQ(3u, pool.numCachedBlocks());
+}
+
+TEST(MemoryPoolTest, testCaps)
+{
+  using namespace ze;
+  MemoryPoolOptions options;
+  options.max_blocks_per_bucket = 2u;
+  options.max_cached_bytes = 3u * 1024u;
+  ScopedMemoryPool scoped_pool(options);
+  MemoryPool& pool = MemoryPool::instance();
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < 4; ++i)
+  {
+    blocks.push_back(pool.allocate(1024u));
+  }
+  for (void* block : blocks)
+  {
+    pool.release(block, 1024u);
+  }
+  EXPECT_EQ(2u, pool.numCachedBlocks());
+
+  pool.release(pool.allocate(2048u), 2048u);
+  EXPECT_EQ(2u, pool.numCachedBlocks());
+  EXPECT_EQ(2048u, pool.cachedBytes());
+
+  // Disabling the pool frees the cached blocks.
+  pool.setOptions(MemoryPoolOptions());
+  EXPECT_EQ(0u, pool.numCachedBlocks());
+  EXPECT_EQ(0u, pool.cachedBytes());
+}
+
+TEST(MemoryPoolTest, testHugePages)
+{
+  using namespace ze;
+  MemoryPoolOptions options;
+  options.use_huge_pages = true;
+  options.huge_page_threshold = 2u * 1024u * 1024u;
+  ScopedMemoryPool scoped_pool(options);
+
+  ImageRaw8uC1 img(2048, 2048);
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(img.data())
+                % options.huge_page_threshold);
+  img.setValue(Pixel8uC1(7u));
+  EXPECT_EQ(7u, img(2047, 2047));
+}
+
+TEST(MemoryPoolTest, testConcurrentFrames)
+{
+  using namespace ze;
+  ScopedMemoryPool scoped_pool;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([t]() {
+      for (int frame = 0; frame < 200; ++frame)
+      {
+        ImageRaw8uC1 img(752, 480);
+        img.setValue(Pixel8uC1(static_cast<uint8_t>(t)));
+        CHECK_EQ(static_cast<uint8_t>(t), img(751, 479).x);
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  EXPECT_LE(MemoryPool::instance().numCachedBlocks(), 4u);
+}
+
+ZE_UNITTEST_ENTRYPOINT
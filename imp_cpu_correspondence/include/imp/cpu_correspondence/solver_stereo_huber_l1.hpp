@@ -0,0 +1,81 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <imp/core/image_raw.hpp>
+#include <imp/core/size.hpp>
+#include <imp/cpu_correspondence/solver_stereo_abstract.hpp>
+
+namespace ze {
+
+/**
+ * @brief The SolverStereoHuberL1 class solves one level of the Huber-L1
+ *        stereo model with the L1 data term in the proximal map of the primal
+ *        update, the CPU counterpart of cu::SolverStereoHuberL1.
+ *
+ * The primal-dual iterations are swept band by band on imageThreadPool(),
+ * see iterate() in solver_stereo_kernels.hpp.
+ */
+class SolverStereoHuberL1 : public SolverStereoAbstract
+{
+public:
+  SolverStereoHuberL1() = delete;
+  virtual ~SolverStereoHuberL1() = default;
+
+  SolverStereoHuberL1(const Parameters::Ptr& params,
+                      ze::Size2u size, size_t level);
+
+  virtual void init() override;
+  virtual void init(const SolverStereoAbstract& rhs) override;
+  virtual void solve(const std::vector<Image32fC1::Ptr>& images) override;
+
+  virtual ImageRaw32fC1::Ptr computePrimalEnergy() override;
+
+  virtual inline ImageRaw32fC1::Ptr getDisparities() override {return u_;}
+
+protected:
+  ImageRaw32fC1::Ptr u_; //!< disparities (result)
+  ImageRaw32fC1::Ptr u_prev_; //!< over-relaxed disparities of the last iteration
+  ImageRaw32fC1::Ptr u0_; //!< disparities of the current warp
+  ImageRaw32fC1::Ptr p_x_; //!< dual variable of the regularizer, stored planar
+  ImageRaw32fC1::Ptr p_y_;
+  ImageRaw32fC1::Ptr lix_; //!< lambda * ix
+  ImageRaw32fC1::Ptr c_; //!< lambda * (it - ix*u0)
+
+  std::vector<Image32fC1::Ptr> images_; //!< images of the last solve() call
+  ImageRaw32fC1::Ptr lambda_; //!< pointwise lambda of this level or nullptr
+
+  //! First row of every band, followed by the image height.
+  std::vector<uint32_t> band_rows_;
+  std::vector<float> halo_;
+  std::vector<float> zeros_;
+};
+
+} // namespace ze
@@ -0,0 +1,86 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <imp/core/image_raw.hpp>
+#include <imp/core/size.hpp>
+#include <imp/cpu_correspondence/solver_stereo_abstract.hpp>
+
+namespace ze {
+
+/**
+ * @brief The SolverStereoPrecondHuberL1 class solves one level of the
+ *        diagonally preconditioned Huber-L1 stereo model with a dual
+ *        variable for the data term, the CPU counterpart of
+ *        cu::SolverStereoPrecondHuberL1.
+ *
+ * If edge weights g_ are set (see SolverStereoPrecondHuberL1Weighted), the
+ * regularizer is weighted with them.
+ */
+class SolverStereoPrecondHuberL1 : public SolverStereoAbstract
+{
+public:
+  SolverStereoPrecondHuberL1() = delete;
+  virtual ~SolverStereoPrecondHuberL1() = default;
+
+  SolverStereoPrecondHuberL1(const Parameters::Ptr& params,
+                             ze::Size2u size, size_t level);
+
+  virtual void init() override;
+  virtual void init(const SolverStereoAbstract& rhs) override;
+  virtual void solve(const std::vector<Image32fC1::Ptr>& images) override;
+
+  virtual ImageRaw32fC1::Ptr computePrimalEnergy() override;
+
+  virtual inline ImageRaw32fC1::Ptr getDisparities() override {return u_;}
+
+protected:
+  ImageRaw32fC1::Ptr u_; //!< disparities (result)
+  ImageRaw32fC1::Ptr u_prev_; //!< over-relaxed disparities of the last iteration
+  ImageRaw32fC1::Ptr u0_; //!< disparities of the current warp
+  ImageRaw32fC1::Ptr p_x_; //!< dual variable of the regularizer, stored planar
+  ImageRaw32fC1::Ptr p_y_;
+  ImageRaw32fC1::Ptr q_; //!< dual variable of the data term
+  ImageRaw32fC1::Ptr lix_; //!< lambda * ix
+  ImageRaw32fC1::Ptr c_; //!< lambda * (it - ix*u0)
+  ImageRaw32fC1::Ptr step_; //!< primal step tau/xi (preconditioner)
+  ImageRaw32fC1::Ptr sigma_q_; //!< dual step of q
+  ImageRaw32fC1::Ptr g_; //!< edge weights, nullptr for the unweighted model
+
+  std::vector<Image32fC1::Ptr> images_; //!< images of the last solve() call
+  ImageRaw32fC1::Ptr lambda_; //!< pointwise lambda of this level or nullptr
+
+  //! First row of every band, followed by the image height.
+  std::vector<uint32_t> band_rows_;
+  std::vector<float> halo_;
+  std::vector<float> zeros_;
+};
+
+} // namespace ze
@@ -0,0 +1,60 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <vector>
+
+#include <imp/core/image_raw.hpp>
+#include <imp/core/size.hpp>
+#include <imp/cpu_correspondence/solver_stereo_precond_huber_l1.hpp>
+
+namespace ze {
+
+/**
+ * @brief The SolverStereoPrecondHuberL1Weighted class weights the
+ *        regularizer of SolverStereoPrecondHuberL1 with natural edges of the
+ *        fixed image (params edge_sigma, edge_alpha, edge_q), the CPU
+ *        counterpart of cu::SolverStereoPrecondHuberL1Weighted.
+ */
+class SolverStereoPrecondHuberL1Weighted : public SolverStereoPrecondHuberL1
+{
+public:
+  SolverStereoPrecondHuberL1Weighted() = delete;
+  virtual ~SolverStereoPrecondHuberL1Weighted() = default;
+
+  SolverStereoPrecondHuberL1Weighted(const Parameters::Ptr& params,
+                                     ze::Size2u size, size_t level);
+
+  virtual void solve(const std::vector<Image32fC1::Ptr>& images) override;
+
+  //! Pixels of the moving image hit by more than one disparity are set to 0.
+  virtual ImageRaw32fC1::Ptr getOcclusion() override;
+
+protected:
+  ImageRaw32fC1::Ptr occ_; //!< occlusion mask
+};
+
+} // namespace ze
@@ -0,0 +1,88 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <imp/core/image.hpp>
+#include <imp/core/image_pyramid.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_correspondence/variational_stereo_parameters.hpp>
+
+namespace ze {
+
+// forward declarations
+class SolverStereoAbstract;
+
+/**
+ * @brief The StereoCtFWarping class is the CPU counterpart of
+ *        cu::StereoCtFWarping. It builds an image pyramid per input image
+ *        and solves the levels from params.ctf.coarsest_level to
+ *        params.ctf.finest_level, each initialized with the prolongated
+ *        solution of the next coarser one.
+ */
+class StereoCtFWarping
+{
+public:
+  using Parameters = VariationalStereoParameters;
+
+public:
+  StereoCtFWarping() = delete;
+  virtual ~StereoCtFWarping();
+
+  StereoCtFWarping(Parameters::Ptr params);
+
+  void addImage(const Image32fC1::Ptr& image);
+  void reset();
+  void solve();
+  ImageRaw32fC1::Ptr computePrimalEnergy(size_t level=0);
+  ImageRaw32fC1::Ptr getDisparities(size_t level=0);
+  ImageRaw32fC1::Ptr getOcclusion(size_t level=0);
+
+protected:
+  /**
+   * @brief ready checks if everything is setup and initialized.
+   * @return State if everything is ready to solve the given problem.
+   */
+  bool ready();
+
+  /**
+   * @brief init initializes the solvers for the current setup
+   */
+  void init();
+
+  //! Solver of the given pyramid level.
+  SolverStereoAbstract& levelSolver(size_t level);
+
+private:
+  Parameters::Ptr params_; //!< configuration parameters
+  std::vector<Image32fC1::Ptr> images_; //!< all unprocessed input images
+  std::vector<ImagePyramid32fC1::Ptr> image_pyramids_; //!< image pyramids corresponding to the unprocesed input images
+  std::vector<std::unique_ptr<SolverStereoAbstract>> levels_; //!< solvers from finest_level to coarsest_level
+};
+
+} // namespace ze
@@ -0,0 +1,144 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_correspondence/solver_stereo_huber_l1.hpp>
+
+#include <cmath>
+
+#include <ze/common/logging.hpp>
+#include <imp/cpu_imgproc/image_filter.hpp>
+
+#include "solver_stereo_kernels.hpp"
+
+namespace ze {
+
+//------------------------------------------------------------------------------
+SolverStereoHuberL1::SolverStereoHuberL1(
+    const Parameters::Ptr& params,
+    ze::Size2u size,
+    size_t level)
+  : SolverStereoAbstract(params, size, level)
+{
+  CHECK_GE(size.width(), 2u);
+  CHECK_GE(size.height(), 2u);
+  u_.reset(new ImageRaw32fC1(size));
+  u_prev_.reset(new ImageRaw32fC1(size));
+  u0_.reset(new ImageRaw32fC1(size));
+  p_x_.reset(new ImageRaw32fC1(size));
+  p_y_.reset(new ImageRaw32fC1(size));
+  lix_.reset(new ImageRaw32fC1(size));
+  c_.reset(new ImageRaw32fC1(size));
+
+  band_rows_ = stereoBandRows(size.height());
+  halo_.resize((band_rows_.size() - 2u) * size.width());
+  zeros_.assign(size.width(), 0.0f);
+}
+
+//------------------------------------------------------------------------------
+void SolverStereoHuberL1::init()
+{
+  u_->setValue(Pixel32fC1(0.0f));
+  p_x_->setValue(Pixel32fC1(0.0f));
+  p_y_->setValue(Pixel32fC1(0.0f));
+  // other variables are init and/or set when needed!
+}
+
+//------------------------------------------------------------------------------
+void SolverStereoHuberL1::init(const SolverStereoAbstract& rhs)
+{
+  const SolverStereoHuberL1* from =
+      dynamic_cast<const SolverStereoHuberL1*>(&rhs);
+  CHECK(from != nullptr);
+
+  float inv_sf = 1./params_->ctf.scale_factor; // >1 for adapting prolongated disparities
+
+  if(params_->ctf.apply_median_filter)
+  {
+    filterMedian3x3(*from->u0_, *from->u_);
+    resamplePoint(*u_, *from->u0_, inv_sf);
+  }
+  else
+  {
+    resamplePoint(*u_, *from->u_, inv_sf);
+  }
+
+  resamplePoint(*p_x_, *from->p_x_);
+  resamplePoint(*p_y_, *from->p_y_);
+}
+
+//------------------------------------------------------------------------------
+void SolverStereoHuberL1::solve(const std::vector<Image32fC1::Ptr>& images)
+{
+  VLOG(100) << "SolverStereoHuberL1: solving level "
+            << level_ << " with " << images.size() << " images";
+  CHECK_GE(images.size(), 2u);
+
+  images_ = images;
+  lambda_ = levelLambda(*params_, size_);
+  u_prev_->copyFrom(*u_);
+
+  const StereoSolverState state{
+    RowAccess(*u_), RowAccess(*u_prev_), RowAccess(*u0_),
+    RowAccess(*p_x_), RowAccess(*p_y_), RowAccess(*lix_), RowAccess(*c_),
+    RowAccess(), RowAccess(), RowAccess(), RowAccess(),
+    &band_rows_, halo_.data(), zeros_.data(), size_.width(), size_.height()};
+
+  // constants
+  const float L = std::sqrt(8.f);
+  const float tau = 1.f/L;
+  const float sigma = 1.f/L;
+  float lin_step = 0.5f;
+
+  // warping
+  for (uint32_t warp = 0; warp < params_->ctf.warps; ++warp)
+  {
+    VLOG(101) << "SOLVING warp iteration of Huber-L1 stereo model. warp: " << warp;
+
+    u0_->copyFrom(*u_);
+
+    // compute warped spatial and temporal gradients
+    warpedGradients(state, *images.at(0), *images.at(1), params_->lambda,
+                    lambda_.get());
+
+    const HuberL1Update update{tau, sigma, params_->eps_u, lin_step};
+    for (uint32_t iter = 0; iter < params_->ctf.iters; ++iter)
+    {
+      iterate(update, state);
+    }
+    lin_step /= 1.2f;
+  }
+}
+
+//------------------------------------------------------------------------------
+ImageRaw32fC1::Ptr SolverStereoHuberL1::computePrimalEnergy()
+{
+  CHECK_GE(images_.size(), 2u) << "solve() was not called yet";
+  auto ep = std::make_shared<ImageRaw32fC1>(size_);
+  primalEnergy(*ep, *u_, nullptr, *images_.at(0), *images_.at(1),
+               params_->lambda, lambda_.get());
+  return ep;
+}
+
+} // namespace ze
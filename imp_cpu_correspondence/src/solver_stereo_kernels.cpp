@@ -0,0 +1,289 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "solver_stereo_kernels.hpp"
+
+#include <imp/cpu_imgproc/image_filter.hpp>
+
+namespace ze {
+
+namespace {
+
+//! Bands have at least this many rows, there is one per thread otherwise.
+constexpr uint32_t c_min_band_rows = 16u;
+
+//! Linear interpolation in a row at pos in [0, width-1].
+inline float interpolateRow(const float* row, float pos, uint32_t width)
+{
+  const uint32_t x0 = static_cast<uint32_t>(pos);
+  const uint32_t x1 = std::min(x0 + 1u, width - 1u);
+  const float a = pos - static_cast<float>(x0);
+  return row[x0] + a * (row[x1] - row[x0]);
+}
+
+} // unnamed namespace
+
+//-----------------------------------------------------------------------------
+std::vector<uint32_t> stereoBandRows(uint32_t height)
+{
+  const size_t num_bands = std::max<size_t>(
+        1u, std::min<size_t>(imageThreadPool().numThreads() + 1u,
+                             height / c_min_band_rows));
+  std::vector<uint32_t> band_rows(num_bands + 1u);
+  for (size_t k = 0u; k <= num_bands; ++k)
+  {
+    band_rows[k] = static_cast<uint32_t>(k * height / num_bands);
+  }
+  return band_rows;
+}
+
+//-----------------------------------------------------------------------------
+void warpedGradients(const StereoSolverState& s,
+                     const Image32fC1& i1, const Image32fC1& i2,
+                     float lambda, const ImageRaw32fC1* lambda_pointwise)
+{
+  CHECK_EQ(i1.size(), Size2u(s.width, s.height));
+  CHECK_EQ(i2.size(), Size2u(s.width, s.height));
+  const RowAccess i1_rows(i1);
+  const RowAccess i2_rows(i2);
+  const RowAccess lambda_rows = lambda_pointwise ? RowAccess(*lambda_pointwise)
+                                                 : RowAccess();
+  const uint32_t w = s.width;
+  const float bd = 0.5f;
+  const float wx_max = static_cast<float>(w) - bd - 1.0f;
+
+  parallelForRowBands(s.height, c_min_band_rows, [&](uint32_t y_begin, uint32_t y_end)
+  {
+    for (uint32_t y = y_begin; y < y_end; ++y)
+    {
+      float* lix = s.lix.data(y);
+      float* c = s.c.data(y);
+      if (y == 0u || y + 1u == s.height)
+      {
+        std::fill(lix, lix + w, 0.0f);
+        std::fill(c, c + w, 0.0f);
+        continue;
+      }
+      const float* u0 = s.u0.data(y);
+      const float* i1_row = i1_rows.data(y);
+      const float* i2_row = i2_rows.data(y);
+      const float* lambda_row = lambda_pointwise ? lambda_rows.data(y) : nullptr;
+      lix[0] = c[0] = 0.0f;
+      lix[w - 1u] = c[w - 1u] = 0.0f;
+      for (uint32_t x = 1u; x < w - 1u; ++x)
+      {
+        const float wx = static_cast<float>(x) + u0[x];
+        if (!(wx >= bd && wx <= wx_max))
+        {
+          lix[x] = c[x] = 0.0f;
+          continue;
+        }
+        const float i2_w_c = interpolateRow(i2_row, wx, w);
+        const float i2_w_m = interpolateRow(i2_row, wx - 0.5f, w);
+        const float i2_w_p = interpolateRow(i2_row, wx + 0.5f, w);
+        const float l = lambda_row ? lambda_row[x] : lambda;
+        // spatial gradient on the warped image and temporal gradient between
+        // the warped moving image and the fixed image
+        lix[x] = l * (i2_w_p - i2_w_m);
+        c[x] = l * (i2_w_c - i1_row[x]) - lix[x] * u0[x];
+      }
+    }
+  });
+}
+
+//-----------------------------------------------------------------------------
+void preconditioner(const StereoSolverState& s, float tau, float sigma,
+                    bool weighted)
+{
+  const uint32_t w = s.width;
+  parallelForRowBands(s.height, c_min_band_rows, [&](uint32_t y_begin, uint32_t y_end)
+  {
+    for (uint32_t y = y_begin; y < y_end; ++y)
+    {
+      const float* lix = s.lix.data(y);
+      const float* g = weighted ? s.g.data(y) : nullptr;
+      float* step = s.step.data(y);
+      float* sigma_q = s.sigma_q.data(y);
+      for (uint32_t x = 0u; x < w; ++x)
+      {
+        const float abs_lix = std::abs(lix[x]);
+        step[x] = tau / ((weighted ? 4.0f * g[x] : 4.0f) + abs_lix);
+        sigma_q[x] = sigma / std::max(1e-6f, abs_lix);
+      }
+    }
+  });
+}
+
+//-----------------------------------------------------------------------------
+void resamplePoint(ImageRaw32fC1& dst, const ImageRaw32fC1& src, float scale)
+{
+  const uint32_t dw = dst.width();
+  const uint32_t sw = src.width();
+  const uint32_t sh = src.height();
+  const float sf_x = static_cast<float>(sw) / static_cast<float>(dw);
+  const float sf_y = static_cast<float>(sh) / static_cast<float>(dst.height());
+  std::vector<uint32_t> src_x(dw);
+  for (uint32_t x = 0u; x < dw; ++x)
+  {
+    src_x[x] = std::min(sw - 1u, static_cast<uint32_t>(x * sf_x + 0.5f));
+  }
+  const RowAccess dst_rows(dst);
+  const RowAccess src_rows(src);
+  parallelForRowBands(dst.height(), c_min_band_rows, [&](uint32_t y_begin, uint32_t y_end)
+  {
+    for (uint32_t y = y_begin; y < y_end; ++y)
+    {
+      const float* src_row =
+          src_rows.data(std::min(sh - 1u, static_cast<uint32_t>(y * sf_y + 0.5f)));
+      float* dst_row = dst_rows.data(y);
+      for (uint32_t x = 0u; x < dw; ++x)
+      {
+        dst_row[x] = scale * src_row[src_x[x]];
+      }
+    }
+  });
+}
+
+//-----------------------------------------------------------------------------
+ImageRaw32fC1::Ptr levelLambda(const VariationalStereoParameters& params,
+                               const Size2u& size)
+{
+  if (!params.lambda_pointwise || params.lambda_pointwise->size() == size)
+  {
+    return params.lambda_pointwise;
+  }
+  auto lambda = std::make_shared<ImageRaw32fC1>(size);
+  resamplePoint(*lambda, *params.lambda_pointwise);
+  return lambda;
+}
+
+//-----------------------------------------------------------------------------
+void naturalEdges(ImageRaw32fC1& g, const Image32fC1& img,
+                  float sigma, float alpha, float q)
+{
+  CHECK_EQ(g.size(), img.size());
+  ImageRaw32fC1 denoised(img.size());
+  filterGauss(denoised, img, sigma);
+
+  const RowAccess g_rows(g);
+  const RowAccess src_rows(denoised);
+  const uint32_t w = g.width();
+  const uint32_t h = g.height();
+  parallelForRowBands(h, c_min_band_rows, [&](uint32_t y_begin, uint32_t y_end)
+  {
+    for (uint32_t y = y_begin; y < y_end; ++y)
+    {
+      const float* src = src_rows.data(y);
+      const float* src_next = src_rows.data(std::min(y + 1u, h - 1u));
+      float* g_row = g_rows.data(y);
+      for (uint32_t x = 0u; x < w; ++x)
+      {
+        const float dx = src[std::min(x + 1u, w - 1u)] - src[x];
+        const float dy = src_next[x] - src[x];
+        const float norm = std::sqrt(dx * dx + dy * dy);
+        g_row[x] = std::max(1e-3f, std::exp(-alpha * std::pow(norm, q)));
+      }
+    }
+  });
+}
+
+//-----------------------------------------------------------------------------
+void primalEnergy(ImageRaw32fC1& ep, const ImageRaw32fC1& u,
+                  const ImageRaw32fC1* g,
+                  const Image32fC1& i1, const Image32fC1& i2,
+                  float lambda, const ImageRaw32fC1* lambda_pointwise)
+{
+  const RowAccess ep_rows(ep);
+  const RowAccess u_rows(u);
+  const RowAccess g_rows = g ? RowAccess(*g) : RowAccess();
+  const RowAccess i1_rows(i1);
+  const RowAccess i2_rows(i2);
+  const RowAccess lambda_rows = lambda_pointwise ? RowAccess(*lambda_pointwise)
+                                                 : RowAccess();
+  const uint32_t w = u.width();
+  const uint32_t h = u.height();
+  const float bd = 0.5f;
+  parallelForRowBands(h, c_min_band_rows, [&](uint32_t y_begin, uint32_t y_end)
+  {
+    for (uint32_t y = y_begin; y < y_end; ++y)
+    {
+      const float* u_row = u_rows.data(y);
+      const float* u_next = u_rows.data(std::min(y + 1u, h - 1u));
+      const float* i1_row = i1_rows.data(y);
+      const float* i2_row = i2_rows.data(y);
+      float* ep_row = ep_rows.data(y);
+      const bool inner_row = (y > bd) && (y < h - bd - 1.0f);
+      for (uint32_t x = 0u; x < w; ++x)
+      {
+        const float weight = g ? g_rows.data(y)[x] : 1.0f;
+        const float dx = weight * (u_row[std::min(x + 1u, w - 1u)] - u_row[x]);
+        const float dy = weight * (u_next[x] - u_row[x]);
+        const float wx = x + u_row[x];
+        float dat = 0.0f;
+        if (inner_row && wx > bd && x > bd && wx < w - bd - 1.0f && x < w - bd - 1.0f)
+        {
+          dat = interpolateRow(i2_row, wx, w) - i1_row[x];
+        }
+        const float l = lambda_pointwise ? lambda_rows.data(y)[x] : lambda;
+        ep_row[x] = std::sqrt(dx * dx + dy * dy) + l * std::abs(dat);
+      }
+    }
+  });
+}
+
+//-----------------------------------------------------------------------------
+void occlusionCandidatesUniqunessMapping(ImageRaw32fC1& occ,
+                                         const ImageRaw32fC1& disp)
+{
+  CHECK_EQ(occ.size(), disp.size());
+  const RowAccess occ_rows(occ);
+  const RowAccess disp_rows(disp);
+  const uint32_t w = disp.width();
+  parallelForRowBands(disp.height(), c_min_band_rows, [&](uint32_t y_begin, uint32_t y_end)
+  {
+    for (uint32_t y = y_begin; y < y_end; ++y)
+    {
+      const float* d = disp_rows.data(y);
+      float* o = occ_rows.data(y);
+      // count how many pixels are mapped to every pixel of the moving image
+      std::fill(o, o + w, 0.0f);
+      for (uint32_t x = 0u; x < w; ++x)
+      {
+        const int wx = static_cast<int>(x) + static_cast<int>(d[x] + 0.5f);
+        if (wx > 0 && wx < static_cast<int>(w))
+        {
+          o[wx] += 1.0f;
+        }
+      }
+      // and clamp to a mask with 0 and 1 entries
+      for (uint32_t x = 0u; x < w; ++x)
+      {
+        o[x] = 1.0f - std::max(0.0f, std::min(1.0f, o[x] - 1.0f));
+      }
+    }
+  });
+}
+
+} // namespace ze
@@ -0,0 +1,348 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <imp/core/image.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/core/parallel.hpp>
+#include <imp/cpu_correspondence/variational_stereo_parameters.hpp>
+
+namespace ze {
+
+// Row kernels shared by the CPU stereo solvers, the counterpart of the
+// *_kernel.cuh files of imp_cu_correspondence. The inner loops run over
+// contiguous rows without branches on the pixel position, so that the
+// compiler vectorizes them.
+
+//! Row access without a virtual call per row.
+struct RowAccess
+{
+  RowAccess() = default;
+
+  explicit RowAccess(const Image32fC1& img)
+    : base(reinterpret_cast<uint8_t*>(const_cast<Pixel32fC1*>(img.data())))
+    , pitch(img.pitch())
+  {}
+
+  inline float* data(uint32_t y) const
+  {
+    return reinterpret_cast<float*>(base + y * pitch);
+  }
+
+  uint8_t* base = nullptr;
+  size_t pitch = 0u;
+};
+
+//! Returns the first row of every band followed by the image height. There
+//! are imageThreadPool().numThreads() + 1 bands, one per worker plus one for
+//! the calling thread, as long as bands have at least 16 rows.
+std::vector<uint32_t> stereoBandRows(uint32_t height);
+
+/**
+ * @brief Rows of the primal-dual variables of one level solver. The dual
+ *        variable p is stored planar. lix and c hold the linearized data
+ *        term of the current warp, lambda*ix and lambda*(it - ix*u0), so
+ *        that a pointwise lambda costs nothing in the iterations. step,
+ *        sigma_q, q and g are only used by the preconditioned solvers.
+ */
+struct StereoSolverState
+{
+  RowAccess u;
+  RowAccess u_bar;
+  RowAccess u0;
+  RowAccess p_x;
+  RowAccess p_y;
+  RowAccess lix;
+  RowAccess c;
+  RowAccess q;
+  RowAccess step; //!< tau/xi
+  RowAccess sigma_q;
+  RowAccess g; //!< edge weights
+  const std::vector<uint32_t>* band_rows;
+  float* halo; //!< First row of u_bar of every band except the first one.
+  const float* zeros; //!< Row of zeros standing in for p beyond the image border.
+  uint32_t width;
+  uint32_t height;
+
+  inline const float* pYPrev(uint32_t y) const
+  {
+    return (y == 0u) ? zeros : p_y.data(y - 1u);
+  }
+  inline const float* pY(uint32_t y) const
+  {
+    return (y == height - 1u) ? zeros : p_y.data(y);
+  }
+};
+
+/**
+ * @brief warpedGradients linearizes the data term around u0: ix is the
+ *        derivative of i2 at x+u0 and it = i2(x+u0) - i1(x), both linearly
+ *        interpolated along the row. Pixels whose warp leaves the image get
+ *        zero gradients, as in cu::k_warpedGradients.
+ * @param lambda_pointwise Per pixel lambda of the size of the level or nullptr.
+ */
+void warpedGradients(const StereoSolverState& s,
+                     const Image32fC1& i1, const Image32fC1& i2,
+                     float lambda, const ImageRaw32fC1* lambda_pointwise);
+
+//! Diagonal preconditioner of the Huber-L1 model, see cu::k_preconditioner.
+void preconditioner(const StereoSolverState& s, float tau, float sigma,
+                    bool weighted);
+
+//! dst = scale * src, point sampled like cu::resample(.., Point, false).
+void resamplePoint(ImageRaw32fC1& dst, const ImageRaw32fC1& src,
+                   float scale = 1.0f);
+
+//! Returns params.lambda_pointwise resampled to \a size, or nullptr.
+ImageRaw32fC1::Ptr levelLambda(const VariationalStereoParameters& params,
+                               const Size2u& size);
+
+//! Edge weights exp(-alpha |grad(G_sigma * img)|^q), see cu::naturalEdges.
+void naturalEdges(ImageRaw32fC1& g, const Image32fC1& img,
+                  float sigma, float alpha, float q);
+
+//! Pixel-wise |g grad(u)| + lambda |i2(x+u) - i1(x)|. g may be nullptr.
+void primalEnergy(ImageRaw32fC1& ep, const ImageRaw32fC1& u,
+                  const ImageRaw32fC1* g,
+                  const Image32fC1& i1, const Image32fC1& i2,
+                  float lambda, const ImageRaw32fC1* lambda_pointwise);
+
+//! Marks pixels of i2 that more than one pixel of i1 is mapped to with 0.
+void occlusionCandidatesUniqunessMapping(ImageRaw32fC1& occ,
+                                         const ImageRaw32fC1& disp);
+
+//-----------------------------------------------------------------------------
+//! p = proj((p + sigma g grad(u_bar)) / (1 + sigma eps_u)) for one row.
+//! u_bar_next is u_bar itself on the last row.
+template<bool weighted>
+inline void huberDualRow(const float* u_bar, const float* u_bar_next,
+                         const float* g, float* p_x, float* p_y,
+                         uint32_t width, float sigma, float eps_u)
+{
+  const float inv_denom = 1.0f / (1.0f + sigma * eps_u);
+  for (uint32_t x = 0u; x < width - 1u; ++x)
+  {
+    const float w = weighted ? sigma * g[x] : sigma;
+    const float px = (p_x[x] + w * (u_bar[x + 1u] - u_bar[x])) * inv_denom;
+    const float py = (p_y[x] + w * (u_bar_next[x] - u_bar[x])) * inv_denom;
+    const float scale = 1.0f / std::max(1.0f, std::sqrt(px * px + py * py));
+    p_x[x] = px * scale;
+    p_y[x] = py * scale;
+  }
+  const uint32_t x = width - 1u;
+  const float w = weighted ? sigma * g[x] : sigma;
+  const float px = p_x[x] * inv_denom;
+  const float py = (p_y[x] + w * (u_bar_next[x] - u_bar[x])) * inv_denom;
+  const float scale = 1.0f / std::max(1.0f, std::sqrt(px * px + py * py));
+  p_x[x] = px * scale;
+  p_y[x] = py * scale;
+}
+
+//-----------------------------------------------------------------------------
+//! Calls update(x, div) with the divergence of (g) p for all pixels of row
+//! y, using the adjoint boundary conditions of the forward differences.
+template<bool weighted, typename Update>
+inline void forEachDivergence(const StereoSolverState& s, uint32_t y,
+                              const Update& update)
+{
+  const uint32_t w = s.width;
+  const float* p_x = s.p_x.data(y);
+  const float* p_y = s.pY(y);
+  const float* p_y_prev = s.pYPrev(y);
+  if (weighted)
+  {
+    const float* g = s.g.data(y);
+    const float* g_prev = s.g.data((y == 0u) ? 0u : y - 1u);
+    update(0u, g[0] * (p_x[0] + p_y[0]) - g_prev[0] * p_y_prev[0]);
+    for (uint32_t x = 1u; x < w - 1u; ++x)
+    {
+      update(x, g[x] * (p_x[x] + p_y[x]) - g[x - 1u] * p_x[x - 1u]
+                - g_prev[x] * p_y_prev[x]);
+    }
+    update(w - 1u, g[w - 1u] * p_y[w - 1u] - g[w - 2u] * p_x[w - 2u]
+                   - g_prev[w - 1u] * p_y_prev[w - 1u]);
+  }
+  else
+  {
+    update(0u, p_x[0] + p_y[0] - p_y_prev[0]);
+    for (uint32_t x = 1u; x < w - 1u; ++x)
+    {
+      update(x, p_x[x] - p_x[x - 1u] + p_y[x] - p_y_prev[x]);
+    }
+    update(w - 1u, p_y[w - 1u] - p_x[w - 2u] - p_y_prev[w - 1u]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+//! Iteration of the Huber-L1 model with the L1 prox in the primal update,
+//! see cu::SolverStereoHuberL1.
+struct HuberL1Update
+{
+  float tau;
+  float sigma;
+  float eps_u;
+  float lin_step;
+
+  inline void dualRow(const StereoSolverState& s, uint32_t y,
+                      const float* u_bar_next) const
+  {
+    huberDualRow<false>(s.u_bar.data(y), u_bar_next, nullptr,
+                        s.p_x.data(y), s.p_y.data(y), s.width, sigma, eps_u);
+  }
+
+  inline void primalRow(const StereoSolverState& s, uint32_t y) const
+  {
+    float* u = s.u.data(y);
+    float* u_bar = s.u_bar.data(y);
+    const float* u0 = s.u0.data(y);
+    const float* lix = s.lix.data(y);
+    const float* c = s.c.data(y);
+    const float tau = this->tau;
+    const float lin_step = this->lin_step;
+    forEachDivergence<false>(s, y, [&](uint32_t x, float div)
+    {
+      const float u_prev = u[x];
+      const float u_tau = u_prev + tau * div;
+      const float l = lix[x];
+      const float rho = c[x] + l * u_tau;
+      const float tau_l2 = tau * l * l;
+      float u_new = (rho < -tau_l2) ? u_tau + tau * l
+                                    : (rho > tau_l2) ? u_tau - tau * l
+                                                     : u_tau - rho * l / std::max(1e-9f, l * l);
+      // The linearization is only valid in a small neighborhood of u0.
+      u_new = std::max(u0[x] - lin_step, std::min(u0[x] + lin_step, u_new));
+      u[x] = u_new;
+      u_bar[x] = 2.0f * u_new - u_prev;
+    });
+  }
+};
+
+//-----------------------------------------------------------------------------
+//! Iteration of the preconditioned Huber-L1 model with the dual variable q
+//! of the data term, see cu::SolverStereoPrecondHuberL1. The weighted
+//! variant applies the edge weights g in the gradient and its adjoint.
+template<bool weighted>
+struct PrecondHuberL1Update
+{
+  float sigma_by_eta;
+  float eps_u;
+  float lin_step;
+
+  inline void dualRow(const StereoSolverState& s, uint32_t y,
+                      const float* u_bar_next) const
+  {
+    const float* u_bar = s.u_bar.data(y);
+    huberDualRow<weighted>(u_bar, u_bar_next, weighted ? s.g.data(y) : nullptr,
+                           s.p_x.data(y), s.p_y.data(y), s.width,
+                           sigma_by_eta, eps_u);
+    float* q = s.q.data(y);
+    const float* sigma_q = s.sigma_q.data(y);
+    const float* lix = s.lix.data(y);
+    const float* c = s.c.data(y);
+    for (uint32_t x = 0u; x < s.width; ++x)
+    {
+      const float q_new = q[x] + sigma_q[x] * (c[x] + lix[x] * u_bar[x]);
+      q[x] = std::max(-1.0f, std::min(1.0f, q_new));
+    }
+  }
+
+  inline void primalRow(const StereoSolverState& s, uint32_t y) const
+  {
+    float* u = s.u.data(y);
+    float* u_bar = s.u_bar.data(y);
+    const float* u0 = s.u0.data(y);
+    const float* lix = s.lix.data(y);
+    const float* q = s.q.data(y);
+    const float* step = s.step.data(y);
+    const float lin_step = this->lin_step;
+    forEachDivergence<weighted>(s, y, [&](uint32_t x, float div)
+    {
+      const float u_prev = u[x];
+      float u_new = u_prev + step[x] * (div - lix[x] * q[x]);
+      u_new = std::max(u0[x] - lin_step, std::min(u0[x] + lin_step, u_new));
+      u[x] = u_new;
+      u_bar[x] = 2.0f * u_new - u_prev;
+    });
+  }
+};
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief iterate runs one primal-dual iteration of \a update on all bands.
+ *
+ * Every band is swept once: the dual update of a row is immediately followed
+ * by its primal update, so the variables are streamed through the cache
+ * once per iteration instead of once per kernel. The result equals the
+ * separate dual and primal passes of the CUDA solvers: the last dual row of
+ * a band reads the first row of u_bar of the next band from a halo copy, and
+ * the first primal row of every band except the first is updated after all
+ * bands finished, when p of the row above is final.
+ */
+template<typename Update>
+void iterate(const Update& update, const StereoSolverState& s)
+{
+  const std::vector<uint32_t>& band_rows = *s.band_rows;
+  const size_t num_bands = band_rows.size() - 1u;
+  const uint32_t w = s.width;
+  for (size_t k = 1u; k < num_bands; ++k)
+  {
+    std::memcpy(s.halo + (k - 1u) * w, s.u_bar.data(band_rows[k]), w * sizeof(float));
+  }
+
+  imageThreadPool().parallelFor(0u, num_bands, 1u, [&](size_t k_begin, size_t k_end)
+  {
+    for (size_t k = k_begin; k < k_end; ++k)
+    {
+      const uint32_t b = band_rows[k];
+      const uint32_t e = band_rows[k + 1u];
+      for (uint32_t y = b; y < e; ++y)
+      {
+        const float* u_bar_next = (y + 1u < e) ? s.u_bar.data(y + 1u)
+                                               : (e < s.height) ? s.halo + k * w
+                                                                : s.u_bar.data(y);
+        update.dualRow(s, y, u_bar_next);
+        if (k > 0u && y == b)
+        {
+          continue;
+        }
+        update.primalRow(s, y);
+      }
+    }
+  });
+
+  for (size_t k = 1u; k < num_bands; ++k)
+  {
+    update.primalRow(s, band_rows[k]);
+  }
+}
+
+} // namespace ze
@@ -0,0 +1,65 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_correspondence/solver_stereo_precond_huber_l1_weighted.hpp>
+
+#include <ze/common/logging.hpp>
+
+#include "solver_stereo_kernels.hpp"
+
+namespace ze {
+
+//------------------------------------------------------------------------------
+SolverStereoPrecondHuberL1Weighted::SolverStereoPrecondHuberL1Weighted(
+    const Parameters::Ptr& params,
+    ze::Size2u size,
+    size_t level)
+  : SolverStereoPrecondHuberL1(params, size, level)
+{
+  g_.reset(new ImageRaw32fC1(size));
+  occ_.reset(new ImageRaw32fC1(size));
+}
+
+//------------------------------------------------------------------------------
+void SolverStereoPrecondHuberL1Weighted::solve(
+    const std::vector<Image32fC1::Ptr>& images)
+{
+  CHECK_GE(images.size(), 2u);
+
+  // compute edge weight
+  naturalEdges(*g_, *images.at(0),
+               params_->edge_sigma, params_->edge_alpha, params_->edge_q);
+
+  SolverStereoPrecondHuberL1::solve(images);
+}
+
+//------------------------------------------------------------------------------
+ImageRaw32fC1::Ptr SolverStereoPrecondHuberL1Weighted::getOcclusion()
+{
+  occlusionCandidatesUniqunessMapping(*occ_, *u_);
+  return occ_;
+}
+
+} // namespace ze
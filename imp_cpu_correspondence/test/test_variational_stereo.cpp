@@ -0,0 +1,312 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include <ze/common/test_entrypoint.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_correspondence/variational_stereo.hpp>
+
+namespace {
+
+using namespace ze;
+
+constexpr uint32_t c_width = 160u;
+constexpr uint32_t c_height = 120u;
+constexpr uint32_t c_border = 12u;
+
+//! Smooth texture in [0, 1].
+float texture(float x, float y)
+{
+  return 0.5f + 0.2f * std::sin(0.31f * x + 0.1f * y)
+      + 0.15f * std::sin(0.13f * x - 0.27f * y + 1.0f)
+      + 0.1f * std::sin(0.53f * x + 0.41f * y);
+}
+
+//! Disparity of the synthetic scene, a plane slanted along y.
+float groundTruth(uint32_t y)
+{
+  return 1.0f + 4.0f * y / c_height;
+}
+
+//! Rectified pair with i2(x + d, y) = i1(x, y).
+void stereoPair(ImageRaw32fC1::Ptr& i1, ImageRaw32fC1::Ptr& i2)
+{
+  i1 = std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  i2 = std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      (*i1)(x, y) = texture(x, y);
+      (*i2)(x, y) = texture(x - groundTruth(y), y);
+    }
+  }
+}
+
+//! Mean absolute disparity error away from the image border.
+double meanError(const ImageRaw32fC1& disp, float scale)
+{
+  const uint32_t border = static_cast<uint32_t>(c_border * scale);
+  double sum = 0.0;
+  size_t n = 0u;
+  for (uint32_t y = border; y + border < disp.height(); ++y)
+  {
+    for (uint32_t x = border; x + border < disp.width(); ++x)
+    {
+      sum += std::abs(disp(x, y).x - scale * groundTruth(y / scale));
+      ++n;
+    }
+  }
+  return sum / n;
+}
+
+//! Straightforward port of the CUDA kernels of one warp of
+//! cu::SolverStereoPrecondHuberL1: full dual update, then full primal update.
+ImageRaw32fC1 referencePrecondHuberL1(const ImageRaw32fC1& i1,
+                                      const ImageRaw32fC1& i2,
+                                      float lambda, float eps_u, int iterations)
+{
+  const int w = i1.width();
+  const int h = i1.height();
+  const float tau = 0.95f;
+  const float sigma = 0.95f;
+  const float eta = 2.0f;
+  const float lin_step = 0.5f;
+  ImageRaw32fC1 u(i1.size()), u_prev(i1.size()), p_x(i1.size()), p_y(i1.size()),
+      q(i1.size()), ix(i1.size()), it(i1.size());
+  u.setValue(Pixel32fC1(0.0f));
+  u_prev.setValue(Pixel32fC1(0.0f));
+  p_x.setValue(Pixel32fC1(0.0f));
+  p_y.setValue(Pixel32fC1(0.0f));
+  q.setValue(Pixel32fC1(0.0f));
+
+  // u0 = 0: the warped image is i2 itself.
+  auto fetch = [&](float x, int y)
+  {
+    const int x0 = static_cast<int>(std::floor(x));
+    const float a = x - x0;
+    return (1.0f - a) * i2(std::max(0, std::min(w - 1, x0)), y).x
+        + a * i2(std::max(0, std::min(w - 1, x0 + 1)), y).x;
+  };
+  for (int y = 0; y < h; ++y)
+  {
+    for (int x = 0; x < w; ++x)
+    {
+      const bool inside = x > 0 && x < w - 1 && y > 0 && y < h - 1;
+      ix(x, y) = inside ? fetch(x + 0.5f, y) - fetch(x - 0.5f, y) : 0.0f;
+      it(x, y) = inside ? fetch(x, y) - i1(x, y).x : 0.0f;
+    }
+  }
+
+  for (int iter = 0; iter < iterations; ++iter)
+  {
+    for (int y = 0; y < h; ++y)
+    {
+      for (int x = 0; x < w; ++x)
+      {
+        const float s = sigma / eta;
+        const float c = u_prev(x, y).x;
+        const float dx = u_prev(std::min(x + 1, w - 1), y).x - c;
+        const float dy = u_prev(x, std::min(y + 1, h - 1)).x - c;
+        float px = (p_x(x, y).x + s * dx) / (1.0f + s * eps_u);
+        float py = (p_y(x, y).x + s * dy) / (1.0f + s * eps_u);
+        const float norm = std::max(1.0f, std::sqrt(px * px + py * py));
+        p_x(x, y) = px / norm;
+        p_y(x, y) = py / norm;
+        const float sigma_q = sigma / std::max(1e-6f, lambda * std::abs(ix(x, y).x));
+        const float q_new = q(x, y).x + lambda * sigma_q * (it(x, y).x + ix(x, y).x * c);
+        q(x, y) = std::max(-1.0f, std::min(1.0f, q_new));
+      }
+    }
+    for (int y = 0; y < h; ++y)
+    {
+      for (int x = 0; x < w; ++x)
+      {
+        const float div = ((x < w - 1) ? p_x(x, y).x : 0.0f) - ((x > 0) ? p_x(x - 1, y).x : 0.0f)
+                          + ((y < h - 1) ? p_y(x, y).x : 0.0f) - ((y > 0) ? p_y(x, y - 1).x : 0.0f);
+        const float xi = 4.0f + std::abs(lambda * ix(x, y).x);
+        const float u_old = u(x, y).x;
+        float u_new = u_old - tau / xi * (-div + lambda * ix(x, y).x * q(x, y).x);
+        u_new = std::max(-lin_step, std::min(lin_step, u_new));
+        u(x, y) = u_new;
+        u_prev(x, y) = 2.0f * u_new - u_old;
+      }
+    }
+  }
+  return u;
+}
+
+ImageRaw32fC1::Ptr solveStereo(const VariationalStereo::Parameters::Ptr& params)
+{
+  ImageRaw32fC1::Ptr i1, i2;
+  stereoPair(i1, i2);
+  VariationalStereo stereo(params);
+  stereo.addImage(i1);
+  stereo.addImage(i2);
+  stereo.solve();
+  return stereo.getDisparities();
+}
+
+} // unnamed namespace
+
+//-----------------------------------------------------------------------------
+class DenseStereoTests : public ::testing::TestWithParam<ze::StereoPDSolver>
+{ };
+
+//-----------------------------------------------------------------------------
+TEST_P(DenseStereoTests, SlantedPlane)
+{
+  auto params = std::make_shared<VariationalStereo::Parameters>();
+  params->solver = GetParam();
+  params->ctf.iters = 50u;
+  params->ctf.warps = 5u;
+
+  ImageRaw32fC1::Ptr disp = solveStereo(params);
+  ASSERT_TRUE(disp != nullptr);
+  EXPECT_EQ(disp->size(), Size2u(c_width, c_height));
+  EXPECT_LT(meanError(*disp, 1.0f), 0.05);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    DenseStereoSolverTests, DenseStereoTests,
+    ::testing::Values(ze::StereoPDSolver::HuberL1,
+                      ze::StereoPDSolver::PrecondHuberL1,
+                      ze::StereoPDSolver::PrecondHuberL1Weighted));
+
+//-----------------------------------------------------------------------------
+TEST(VariationalStereoTests, CoarseToFineLevels)
+{
+  auto params = std::make_shared<VariationalStereo::Parameters>();
+  params->ctf.iters = 50u;
+  params->ctf.warps = 5u;
+  params->ctf.finest_level = 1u;
+
+  ImageRaw32fC1::Ptr i1, i2;
+  stereoPair(i1, i2);
+  VariationalStereo stereo(params);
+  stereo.addImage(i1);
+  stereo.addImage(i2);
+  EXPECT_LT(params->ctf.levels, UINT32_MAX);
+  EXPECT_EQ(params->ctf.coarsest_level, params->ctf.levels - 1u);
+  stereo.solve();
+
+  // Levels finer than finest_level are not solved, level 1 is returned.
+  ImageRaw32fC1::Ptr disp = stereo.getDisparities(0u);
+  EXPECT_EQ(disp, stereo.getDisparities(1u));
+  EXPECT_EQ(disp->width(), 128u);
+  EXPECT_EQ(disp->height(), 96u);
+  EXPECT_LT(meanError(*disp, params->ctf.scale_factor), 0.05);
+
+  ImageRaw32fC1::Ptr energy = stereo.computePrimalEnergy(1u);
+  EXPECT_EQ(energy->size(), disp->size());
+  EXPECT_TRUE(stereo.getOcclusion(1u) == nullptr);
+}
+
+//-----------------------------------------------------------------------------
+TEST(VariationalStereoTests, BandedSweepMatchesReference)
+{
+  auto params = std::make_shared<VariationalStereo::Parameters>();
+  params->ctf.iters = 30u;
+  params->ctf.warps = 1u;
+  params->ctf.coarsest_level = 0u;
+
+  ImageRaw32fC1::Ptr i1, i2;
+  stereoPair(i1, i2);
+  VariationalStereo stereo(params);
+  stereo.addImage(i1);
+  stereo.addImage(i2);
+  stereo.solve();
+  ImageRaw32fC1::Ptr disp = stereo.getDisparities();
+
+  const ImageRaw32fC1 reference = referencePrecondHuberL1(
+        *i1, *i2, params->lambda, params->eps_u, params->ctf.iters);
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      EXPECT_NEAR((*disp)(x, y).x, reference(x, y).x, 1e-4f);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(VariationalStereoTests, PointwiseLambda)
+{
+  auto params = std::make_shared<VariationalStereo::Parameters>();
+  params->ctf.iters = 20u;
+  params->ctf.warps = 3u;
+  ImageRaw32fC1::Ptr disp = solveStereo(params);
+
+  // A constant pointwise lambda is resampled to every level and gives the
+  // result of the scalar lambda.
+  auto params_pointwise = std::make_shared<VariationalStereo::Parameters>();
+  params_pointwise->ctf.iters = 20u;
+  params_pointwise->ctf.warps = 3u;
+  params_pointwise->lambda = 1.0f;
+  params_pointwise->lambda_pointwise =
+      std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  params_pointwise->lambda_pointwise->setValue(Pixel32fC1(params->lambda));
+  ImageRaw32fC1::Ptr disp_pointwise = solveStereo(params_pointwise);
+
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      EXPECT_FLOAT_EQ((*disp)(x, y).x, (*disp_pointwise)(x, y).x);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(VariationalStereoTests, WeightedOcclusion)
+{
+  auto params = std::make_shared<VariationalStereo::Parameters>();
+  params->solver = StereoPDSolver::PrecondHuberL1Weighted;
+  params->ctf.iters = 20u;
+  params->ctf.warps = 3u;
+
+  ImageRaw32fC1::Ptr i1, i2;
+  stereoPair(i1, i2);
+  VariationalStereo stereo(params);
+  stereo.addImage(i1);
+  stereo.addImage(i2);
+  stereo.solve();
+
+  ImageRaw32fC1::Ptr occ = stereo.getOcclusion();
+  ASSERT_TRUE(occ != nullptr);
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      const float o = (*occ)(x, y).x;
+      EXPECT_TRUE(o == 0.0f || o == 1.0f);
+    }
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,108 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <memory>
+
+#include <imp/cpu_imgproc/stereo_rectification.hpp>
+#include <ze/geometry/epipolar_geometry.hpp>
+
+namespace ze {
+
+/**
+ * @brief The HorizontalStereoPairRectifier class is the CPU counterpart of
+ *        cu::HorizontalStereoPairRectifier: it rectifies the images of a
+ *        fully calibrated camera pair in horizontal stereo setting with the
+ *        parameters of computeHorizontalStereoParameters().
+ *
+ * The left and right images are rectified concurrently on
+ * imageThreadPool(), each of them again in parallel row bands.
+ */
+template<typename CameraModel,
+         typename DistortionModel,
+         typename Pixel>
+class HorizontalStereoPairRectifier
+{
+public:
+  /**
+   * @brief HorizontalStereoPairRectifier
+   * @param transformed_cam0_params The output camera 0 parameters
+   *        [fx, fy, cx, cy]^T in the rectified reference frame.
+   * @param transformed_cam1_params The output camera 1 parameters
+   *        [fx, fy, cx, cy]^T in the rectified reference frame.
+   * @param horizontal_offset Output horizontal offset in the rectified
+   *        reference system.
+   * @param img_size The size of the images to rectify.
+   * @param cam0_params The camera parameters [fx, fy, cx, cy]^T for camera 0.
+   * @param cam0_dist_coeffs The distortion coefficients for camera 0.
+   * @param cam1_params The camera parameters [fx, fy, cx, cy]^T for camera 1.
+   * @param cam1_dist_coeffs The distortion coefficients for camera 1.
+   * @param T_cam1_cam0 Transformation from cam0 to cam1 reference system.
+   */
+  HorizontalStereoPairRectifier(Vector4& transformed_cam0_params,
+                                Vector4& transformed_cam1_params,
+                                real_t& horizontal_offset,
+                                const Size2u& img_size,
+                                const Vector4& cam0_params,
+                                const Vector4& cam0_dist_coeffs,
+                                const Vector4& cam1_params,
+                                const Vector4& cam1_dist_coeffs,
+                                const Transformation& T_cam1_cam0);
+
+  ~HorizontalStereoPairRectifier() = default;
+
+  void rectify(Image<Pixel>& cam0_dst,
+               Image<Pixel>& cam1_dst,
+               const Image<Pixel>& cam0_src,
+               const Image<Pixel>& cam1_src) const;
+
+  /**
+   * @brief rectify the pair and emit the half-resolution rectified pair in
+   *        the same pass, see StereoRectifier::rectify().
+   */
+  void rectify(Image<Pixel>& cam0_dst,
+               Image<Pixel>& cam1_dst,
+               Image<Pixel>& cam0_dst_half,
+               Image<Pixel>& cam1_dst_half,
+               const Image<Pixel>& cam0_src,
+               const Image<Pixel>& cam1_src) const;
+
+  /**
+   * @brief Retrieves the computed undistortion-rectification maps
+   * @param cam_idx Camera index in (0, 1)
+   */
+  const ImageRaw32fC2& getUndistortRectifyMap(int8_t cam_idx) const;
+
+private:
+  std::unique_ptr<StereoRectifier<CameraModel, DistortionModel, Pixel>> rectifiers_[2];
+};
+
+using HorizontalStereoPairRectifierEquidist8uC1 = HorizontalStereoPairRectifier<PinholeGeometry, EquidistantDistortion, Pixel8uC1>;
+using HorizontalStereoPairRectifierEquidist32fC1 = HorizontalStereoPairRectifier<PinholeGeometry, EquidistantDistortion, Pixel32fC1>;
+using HorizontalStereoPairRectifierRadTan8uC1 = HorizontalStereoPairRectifier<PinholeGeometry, RadialTangentialDistortion, Pixel8uC1>;
+using HorizontalStereoPairRectifierRadTan32fC1 = HorizontalStereoPairRectifier<PinholeGeometry, RadialTangentialDistortion, Pixel32fC1>;
+
+} // namespace ze
@@ -0,0 +1,92 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <imp/core/image.hpp>
+#include <imp/core/pixel.hpp>
+
+namespace ze {
+
+// CPU counterparts of the filters in imp/cu_imgproc/cu_image_filter.cuh.
+// All functions work on the ROI of the source image and write to the ROI of
+// the same size in the destination (set to the source ROI if the sizes
+// differ). Rows are processed in parallel bands on imageThreadPool().
+
+//-----------------------------------------------------------------------------
+/** filterMedian3x3 performs a median filter on a 3x3 window.
+ * Pixels outside the ROI are clamped to the border, except for the outer
+ * diagonal neighbor of the four corner pixels that is set to the maximum
+ * value, as in the CUDA version. Multi-channel images are filtered per
+ * channel.
+ */
+template<typename Pixel>
+void filterMedian3x3(Image<Pixel>& dst,
+                     const Image<Pixel>& src);
+
+//-----------------------------------------------------------------------------
+/** filterGauss performs a gaussian smoothing filter on the given input image \a src
+ * @param[out] dst Gauss filtered result image
+ * @param[in] src Input image
+ * @param[in] sigma Gaussian kernel standard deviation
+ * @param[in] kernel_size Gaussian filter kernel size. (if default (0) computed automatically)
+ *
+ * The separable kernel is applied with a sliding window of kernel_size
+ * horizontally filtered rows, so every input row is converted and filtered
+ * once per band. Integer results are rounded and saturated.
+ */
+template<typename Pixel>
+void filterGauss(Image<Pixel>& dst,
+                 const Image<Pixel>& src,
+                 float sigma, int kernel_size=0);
+
+//-----------------------------------------------------------------------------
+/** filterBilateral performs an edge-preserving smoothing of \a src.
+ * @param[out] dst Filtered result image
+ * @param[in] src Input image
+ * @param[in] prior Image whose intensities define the edges (joint/cross
+ *            bilateral filter). If nullptr, the input of every iteration is
+ *            used.
+ * @param[in] iters Number of times the filter is applied to its own result
+ * @param[in] sigma_spatial Standard deviation of the spatial weight [pixels]
+ * @param[in] sigma_range Standard deviation of the intensity weight
+ * @param[in] radius Half size of the (2*radius+1)^2 filter window
+ *
+ * Same parameterization as cuFilterBilateral. Pixels outside the ROI are not
+ * part of the window. If the window covers the spatial Gaussian
+ * (radius >= 2*sigma_spatial) and sigma_spatial is at least two pixels, the
+ * filter is computed on a bilateral grid (Chen et al., SIGGRAPH 2007) with
+ * cells of sigma_spatial pixels and sigma_range intensity levels. Its cost
+ * does not grow with the window size and the result approximates the exact
+ * filter. Small windows are evaluated exactly.
+ */
+void filterBilateral(Image32fC1& dst,
+                     const Image32fC1& src,
+                     const Image32fC1* prior,
+                     int iters,
+                     float sigma_spatial, float sigma_range,
+                     int radius);
+
+} // namespace ze
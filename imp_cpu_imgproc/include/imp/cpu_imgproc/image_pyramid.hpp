@@ -0,0 +1,69 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <imp/core/image_pyramid.hpp>
+
+namespace ze {
+
+/**
+ * @brief createImagePyramidCpu is the CPU counterpart of
+ *        cu::createImagePyramidGpu(). Level 0 shares \a img_level0, the
+ *        coarser levels are allocated as ImageRaw and computed with reduce().
+ *        The ROI of \a img_level0 is propagated to all levels.
+ */
+template<typename Pixel>
+typename ImagePyramid<Pixel>::Ptr
+createImagePyramidCpu(
+    const typename Image<Pixel>::Ptr& img_level0, float scale_factor=0.5f,
+    uint32_t max_num_levels=UINT32_MAX, uint32_t size_bound=8u);
+
+/**
+ * @brief updateImagePyramidCpu replaces level 0 of \a pyr with
+ *        \a img_level0 and recomputes the coarser levels into their existing
+ *        buffers, so tracking a camera stream allocates no memory per frame.
+ *        The image must have the size of level 0.
+ */
+template<typename Pixel>
+void updateImagePyramidCpu(
+    ImagePyramid<Pixel>& pyr, const typename Image<Pixel>::Ptr& img_level0);
+
+/**
+ * @brief updateImagePyramidsCpu updates the pyramids of all cameras of a rig,
+ *        pyrs[i] from imgs[i]. The cameras are processed concurrently on
+ *        imageThreadPool() and idle threads help with the row bands of the
+ *        levels.
+ */
+template<typename Pixel>
+void updateImagePyramidsCpu(
+    const std::vector<std::shared_ptr<ImagePyramid<Pixel>>>& pyrs,
+    const std::vector<std::shared_ptr<Image<Pixel>>>& imgs);
+
+} // namespace ze
@@ -0,0 +1,68 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <imp/core/image.hpp>
+#include <imp/core/types.hpp>
+
+namespace ze {
+
+/**
+ * @brief Image reduction from \a src to the smaller \a dst image, CPU
+ *        counterpart of cu::reduce().
+ *
+ * Pixel x of dst samples src at x * src.width() / dst.width() (same for y),
+ * so level coordinates are aligned at pixel 0 as on the GPU. The ROI of
+ * \a src is propagated: the ROI of \a dst is set to all pixels that sample
+ * inside the source ROI, and only those are computed. Samples and filter
+ * taps are clamped to the source ROI.
+ *
+ * Halving (dst sizes of floor or ceil of half the src sizes) with
+ * gauss_prefilter and linear interpolation runs a fused kernel that
+ * evaluates the 5-tap binomial [1 4 6 4 1]/16 only at the even source
+ * pixels (8-bit images with 16-bit integer arithmetic). Other factors are
+ * prefiltered with filterGauss() (sigma = sqrt(sf^2 - 1) / 2) and resampled
+ * with point or bilinear interpolation.
+ */
+template<typename Pixel>
+void reduce(Image<Pixel>& dst,
+            const Image<Pixel>& src,
+            InterpolationMode interp = InterpolationMode::Linear,
+            bool gauss_prefilter = true);
+
+/**
+ * @brief reduce() for repeated reductions, e.g. of a camera stream. The
+ *        prefiltered source of the generic path is kept in \a prefiltered,
+ *        which is only allocated if it is null or not of the size of \a src.
+ */
+template<typename Pixel>
+void reduce(Image<Pixel>& dst,
+            const Image<Pixel>& src,
+            ImagePtr<Pixel>& prefiltered,
+            InterpolationMode interp = InterpolationMode::Linear,
+            bool gauss_prefilter = true);
+
+} // namespace ze
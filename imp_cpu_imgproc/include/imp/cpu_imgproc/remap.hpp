@@ -0,0 +1,105 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <imp/core/image.hpp>
+#include <imp/core/image_raw.hpp>
+
+namespace ze {
+
+/**
+ * @brief The RemapTable class stores a dense remap, dst(x, y) =
+ *        src(map(x, y)) with bilinear interpolation, as a compact lookup
+ *        table for repeated use on the CPU.
+ *
+ * Every destination pixel keeps the integer position of its top-left source
+ * pixel (2 x 16 bit) and the index of its quantized subpixel position
+ * (16 bit). The subpixel position is quantized to 1/32 pixel, as in the
+ * fixed-point remap of OpenCV, and selects one of 33 x 33 precomputed
+ * weight quadruples. With 6 bytes per pixel instead of a float map of 8,
+ * the table of a VGA image stays within the L2 cache of a core.
+ *
+ * 8-bit images are interpolated with 14-bit integer weights, 32-bit float
+ * images with float weights. Positions outside the source image are clamped
+ * to the border, like a texture fetch in clamp mode. Rows are remapped in
+ * parallel bands on imageThreadPool().
+ */
+class RemapTable
+{
+public:
+  static constexpr int c_frac_bits = 5;
+  static constexpr int c_frac_steps = 1 << c_frac_bits;
+  static constexpr int c_weight_bits = 14;
+
+  RemapTable() = default;
+  ~RemapTable() = default;
+
+  /**
+   * @brief RemapTable builds the table from a map of the same size as the
+   *        destination images that holds the source position of every pixel.
+   * @param map Source pixel coordinates (x, y) of every destination pixel
+   * @param src_size Size of the source images
+   */
+  RemapTable(const Image32fC2& map, const Size2u& src_size);
+
+  /** Remaps \a src to \a dst, the images must have the sizes of the table. */
+  template<typename Pixel>
+  void remap(Image<Pixel>& dst, const Image<Pixel>& src) const;
+
+  /**
+   * @brief remap only computes the rows [row_begin, row_end) of \a dst, on
+   *        the calling thread. Callers that process the remapped rows further
+   *        use it to do so while they are still in cache.
+   */
+  template<typename Pixel>
+  void remap(Image<Pixel>& dst, const Image<Pixel>& src,
+             uint32_t row_begin, uint32_t row_end) const;
+
+  /** Returns the quantized source position of the destination pixel (x, y). */
+  Pixel32fC2 sourcePosition(uint32_t x, uint32_t y) const;
+
+  inline const Size2u& size() const { return size_; }
+  inline const Size2u& srcSize() const { return src_size_; }
+  inline bool empty() const { return entries_.empty(); }
+
+private:
+  struct Entry
+  {
+    int16_t x;
+    int16_t y;
+    uint16_t frac; //!< (frac_y * (c_frac_steps + 1) + frac_x)
+  };
+  static_assert(sizeof(Entry) == 6u, "Unexpected padding in RemapTable::Entry.");
+
+  Size2u size_;
+  Size2u src_size_;
+  std::vector<Entry> entries_; //!< Row-major, one per destination pixel.
+};
+
+} // namespace ze
@@ -0,0 +1,65 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <memory>
+
+#include <imp/cpu_imgproc/variational_denoising.hpp>
+
+namespace ze {
+
+/**
+ * @brief The RofDenoising class is the CPU counterpart of cu::RofDenoising.
+ *        It minimizes TV(u) + lambda/2 ||u - f||^2.
+ */
+template<typename Pixel>
+class RofDenoising : public VariationalDenoising
+{
+public:
+  ZE_POINTER_TYPEDEFS(RofDenoising);
+  using Base = VariationalDenoising;
+
+public:
+  RofDenoising() = default;
+  virtual ~RofDenoising() = default;
+
+  virtual void denoise(const ImageBase::Ptr& dst,
+                       const ImageBase::Ptr& src) override;
+
+  void primalDualEnergy(double& primal_energy, double& dual_energy) const;
+
+protected:
+  virtual void print(std::ostream& os) const override;
+};
+
+//-----------------------------------------------------------------------------
+typedef RofDenoising<Pixel8uC1> RofDenoising8uC1;
+typedef RofDenoising<Pixel32fC1> RofDenoising32fC1;
+
+template <typename Pixel>
+using RofDenoisingPtr = typename std::shared_ptr<RofDenoising<Pixel>>;
+
+} // namespace ze
@@ -0,0 +1,98 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <imp/core/image.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/remap.hpp>
+#include <ze/cameras/camera_models.hpp>
+
+namespace ze {
+
+/**
+ * @brief The StereoRectifier class is the CPU counterpart of
+ *        cu::StereoRectifier. Undistortion and rectification are fused into
+ *        one map, computed once in the constructor exactly as on the GPU and
+ *        stored as a fixed-point RemapTable.
+ *
+ * rectify() can additionally emit the rectified image at half resolution in
+ * the same pass: every half-resolution pixel is the mean of a 2x2 block of
+ * the full-resolution output, computed while the two rows are still in
+ * cache. The half-resolution camera has the parameters
+ * [fx/2, fy/2, (cx+0.5)/2-0.5, (cy+0.5)/2-0.5] of the transformed camera.
+ */
+template<typename CameraModel,
+         typename DistortionModel,
+         typename Pixel>
+class StereoRectifier
+{
+public:
+  /**
+   * @brief StereoRectifier
+   * @param img_size The size of the images to rectify.
+   * @param camera_params The camera parameters [fx, fy, cx, cy]^T.
+   * @param transformed_camera_params The camera parameters [fx, fy, cx, cy]^T
+   *        in the rectified reference frame.
+   * @param dist_coeffs Camera distortion coefficients.
+   * @param inv_H Inverse of the rectifying homography.
+   */
+  StereoRectifier(const Size2u& img_size,
+                  const Vector4& camera_params,
+                  const Vector4& transformed_camera_params,
+                  const Vector4& dist_coeffs,
+                  const Matrix3& inv_H);
+
+  ~StereoRectifier() = default;
+
+  void rectify(Image<Pixel>& dst,
+               const Image<Pixel>& src) const;
+
+  /**
+   * @brief rectify
+   * @param dst Full resolution rectified image.
+   * @param dst_half Rectified image of size (width/2, height/2).
+   * @param src The image to rectify.
+   */
+  void rectify(Image<Pixel>& dst,
+               Image<Pixel>& dst_half,
+               const Image<Pixel>& src) const;
+
+  /** Returns the (unquantized) source position of every rectified pixel. */
+  const ImageRaw32fC2& getUndistortRectifyMap() const;
+
+  const RemapTable& getRemapTable() const;
+
+private:
+  ImageRaw32fC2 undistort_rectify_map_;
+  RemapTable remap_table_;
+};
+
+using EquidistStereoRectifier8uC1 = StereoRectifier<PinholeGeometry, EquidistantDistortion, Pixel8uC1>;
+using EquidistStereoRectifier32fC1 = StereoRectifier<PinholeGeometry, EquidistantDistortion, Pixel32fC1>;
+using RadTanStereoRectifier8uC1 = StereoRectifier<PinholeGeometry, RadialTangentialDistortion, Pixel8uC1>;
+using RadTanStereoRectifier32fC1 = StereoRectifier<PinholeGeometry, RadialTangentialDistortion, Pixel32fC1>;
+
+} // namespace ze
@@ -0,0 +1,73 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <imp/core/image.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/remap.hpp>
+#include <ze/cameras/camera_models.hpp>
+
+namespace ze {
+
+/**
+ * @brief The ImageUndistorter class is the CPU counterpart of
+ *        cu::ImageUndistorter. The undistortion map is computed once in the
+ *        constructor, exactly as on the GPU, and stored as a fixed-point
+ *        RemapTable; undistort() then only looks up and interpolates.
+ */
+template<typename CameraModel,
+         typename DistortionModel,
+         typename Pixel>
+class ImageUndistorter
+{
+public:
+  ImageUndistorter(
+      const Size2u& img_size,
+      const VectorX& camera_params,
+      const VectorX& dist_coeffs);
+
+  ~ImageUndistorter() = default;
+
+  void undistort(
+      Image<Pixel>& dst,
+      const Image<Pixel>& src) const;
+
+  /** Returns the (unquantized) source position of every undistorted pixel. */
+  const ImageRaw32fC2& getUndistortionMap() const;
+
+  const RemapTable& getRemapTable() const;
+
+private:
+  ImageRaw32fC2 undistortion_map_;
+  RemapTable remap_table_;
+};
+
+using EquidistUndistort8uC1 = ImageUndistorter<PinholeGeometry, EquidistantDistortion, Pixel8uC1>;
+using EquidistUndistort32fC1 = ImageUndistorter<PinholeGeometry, EquidistantDistortion, Pixel32fC1>;
+using RadTanUndistort8uC1 = ImageUndistorter<PinholeGeometry, RadialTangentialDistortion, Pixel8uC1>;
+using RadTanUndistort32fC1 = ImageUndistorter<PinholeGeometry, RadialTangentialDistortion, Pixel32fC1>;
+
+} // namespace ze
@@ -0,0 +1,154 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <imp/core/image_base.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/core/variational_denoising_params.hpp>
+#include <ze/common/macros.hpp>
+
+namespace ze {
+
+/**
+ * @brief The VariationalDenoising class is the CPU counterpart of
+ *        cu::VariationalDenoising and runs the same first-order primal-dual
+ *        iterations for TV regularized denoising.
+ *
+ * The image is split into horizontal bands, one per thread of
+ * imageThreadPool(). Every iteration sweeps each band once: the dual
+ * update of a row is immediately followed by the primal update of the row
+ * above, so that u, u_bar, p and f are streamed through the cache once per
+ * iteration instead of once per kernel. Only the first row of every band
+ * depends on the neighbouring band; its input row is copied to a halo
+ * buffer before the sweep and its primal update is done after all bands
+ * finished.
+ *
+ * If params().primal_dual_energy_check_iter and
+ * params().primal_dual_gap_tolerance are positive, the primal and dual
+ * energies are accumulated within the sweep of every check iteration and
+ * the iterations stop as soon as the primal-dual gap per pixel drops below
+ * the tolerance.
+ *
+ * The solver state is kept between calls with equally sized images, so
+ * that a sequence of images is denoised warm-started, as on the GPU.
+ * 8-bit images are processed in [0, 1].
+ */
+class VariationalDenoising
+{
+public:
+  ZE_POINTER_TYPEDEFS(VariationalDenoising);
+
+public:
+  VariationalDenoising() = default;
+  virtual ~VariationalDenoising() = default;
+
+  virtual void denoise(const ImageBase::Ptr& dst,
+                       const ImageBase::Ptr& src) = 0;
+
+  virtual inline VariationalDenoisingParams& params() { return params_; }
+
+  /** Number of iterations of the last denoise() call. */
+  inline uint16_t numIterations() const { return num_iter_; }
+
+  /**
+   * @brief primalDualGap returns the primal-dual gap per pixel of the last
+   *        energy check, or a negative value if there was none.
+   */
+  inline double primalDualGap() const { return primal_dual_gap_; }
+
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const VariationalDenoising& rhs);
+
+protected:
+  enum class DataTerm
+  {
+    L2, //!< ROF model
+    L1  //!< TV-L1 model
+  };
+
+  virtual void init(const Size2u& size);
+
+  /** Converts \a src to f_ and initializes the solver if the size changed. */
+  void setInput(const ImageBase& src);
+
+  /** Runs the primal-dual iterations with the initial step sizes. */
+  void solve(DataTerm data_term, float tau, float sigma);
+
+  /** Full evaluation of the primal and dual energy of the current state. */
+  void primalDualEnergy(DataTerm data_term,
+                        double& primal_energy, double& dual_energy) const;
+
+  /** Writes u_ to \a dst, scaled back to [0, 255] for 8-bit images. */
+  void writeResult(ImageBase& dst) const;
+
+  inline virtual void print(std::ostream& os) const
+  {
+    os << "  lambda: " << this->params_.lambda << std::endl
+       << "  max_iter: " << this->params_.max_iter << std::endl
+       << "  primal_dual_energy_check_iter: " << this->params_.primal_dual_energy_check_iter << std::endl
+       << "  primal_dual_gap_tolerance: " << this->params_.primal_dual_gap_tolerance << std::endl
+       << std::endl;
+  }
+
+  ImageRaw32fC1::Ptr f_;
+  ImageRaw32fC1::Ptr u_;
+  ImageRaw32fC1::Ptr u_bar_;
+  ImageRaw32fC1::Ptr p_x_; //!< Dual variable, stored planar for vectorization.
+  ImageRaw32fC1::Ptr p_y_;
+
+  Size2u size_;
+  float f_min_ = 0.0f;
+  float f_max_ = 0.0f;
+
+  //! First row of every band, followed by the image height.
+  std::vector<uint32_t> band_rows_;
+  //! Copy of the first row of u_bar_ of every band except the first one.
+  std::vector<float> halo_;
+  //! Primal and dual energy of every band, overwritten by each iteration.
+  std::vector<double> band_energies_;
+  //! Row of zeros standing in for p beyond the image border.
+  std::vector<float> zeros_;
+
+  uint16_t num_iter_ = 0;
+  double primal_dual_gap_ = -1.0;
+
+  // algorithm parameters
+  VariationalDenoisingParams params_;
+};
+
+inline std::ostream& operator<<(std::ostream& os,
+                                const VariationalDenoising& rhs)
+{
+  rhs.print(os);
+  return os;
+}
+
+} // namespace ze
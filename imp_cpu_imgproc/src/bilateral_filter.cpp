@@ -0,0 +1,341 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_imgproc/image_filter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <imp/core/image_raw.hpp>
+#include <imp/core/parallel.hpp>
+
+namespace ze {
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//! Exact (2*radius+1)^2 window, as in the CUDA kernel.
+void bilateralDirect(const ConstImageView<Pixel32fC1>& src,
+                     const ConstImageView<Pixel32fC1>& prior,
+                     const ImageView<Pixel32fC1>& dst,
+                     float sigma_spatial, float sigma_range, int radius)
+{
+  const int width = static_cast<int>(src.width());
+  const int height = static_cast<int>(src.height());
+  const int window = 2 * radius + 1;
+  std::vector<float> spatial_weights(window * window);
+  for (int l = -radius; l <= radius; ++l)
+  {
+    for (int k = -radius; k <= radius; ++k)
+    {
+      spatial_weights[(l + radius) * window + k + radius] =
+          std::exp(-(k*k + l*l) / (2.0f * sigma_spatial * sigma_spatial));
+    }
+  }
+  const float range_scale = -1.0f / (2.0f * sigma_range * sigma_range);
+
+  parallelForRowBands(src.height(), 8u, [&](size_t row_begin, size_t row_end)
+  {
+    for (int y = static_cast<int>(row_begin); y < static_cast<int>(row_end); ++y)
+    {
+      const float* p_row = reinterpret_cast<const float*>(prior.rowPtr(y));
+      float* out = reinterpret_cast<float*>(dst.rowPtr(y));
+      const int l_begin = std::max(-radius, -y);
+      const int l_end = std::min(radius, height - 1 - y);
+      for (int x = 0; x < width; ++x)
+      {
+        const float p = p_row[x];
+        const int k_begin = std::max(-radius, -x);
+        const int k_end = std::min(radius, width - 1 - x);
+        float sum_g = 0.0f;
+        float sum_val = 0.0f;
+        for (int l = l_begin; l <= l_end; ++l)
+        {
+          const float* s = reinterpret_cast<const float*>(src.rowPtr(y + l)) + x;
+          const float* q = reinterpret_cast<const float*>(prior.rowPtr(y + l)) + x;
+          const float* w = &spatial_weights[(l + radius) * window + radius];
+          for (int k = k_begin; k <= k_end; ++k)
+          {
+            const float d = p - q[k];
+            const float g = w[k] * std::exp(d * d * range_scale);
+            sum_g += g;
+            sum_val += g * s[k];
+          }
+        }
+        out[x] = sum_val / std::max(1e-6f, sum_g);
+      }
+    }
+  });
+}
+
+//-----------------------------------------------------------------------------
+//! Bilateral grid: splat (value, 1) to the nearest cell, blur the grid with
+//! the binomial kernel [1 4 6 4 1]/16 (standard deviation of one cell) along
+//! all three axes and slice it with trilinear interpolation at the prior
+//! intensity of every pixel.
+class BilateralGrid
+{
+public:
+  static constexpr int c_pad = 2; //!< Blur radius in cells.
+
+  BilateralGrid(const ConstImageView<Pixel32fC1>& prior,
+                float sigma_spatial, float sigma_range)
+    : inv_cell_xy_(1.0f / sigma_spatial)
+    , inv_cell_z_(1.0f / sigma_range)
+  {
+    min_ = max_ = prior(0u, 0u).x;
+    for (uint32_t y = 0u; y < prior.height(); ++y)
+    {
+      const float* p = reinterpret_cast<const float*>(prior.rowPtr(y));
+      for (uint32_t x = 0u; x < prior.width(); ++x)
+      {
+        min_ = std::min(min_, p[x]);
+        max_ = std::max(max_, p[x]);
+      }
+    }
+    auto cells = [](float extent, float inv_cell) {
+      return static_cast<int>(std::ceil(extent * inv_cell)) + 2 * c_pad + 1;
+    };
+    width_ = cells(prior.width() - 1.0f, inv_cell_xy_);
+    height_ = cells(prior.height() - 1.0f, inv_cell_xy_);
+    depth_ = cells(max_ - min_, inv_cell_z_);
+    grid_.assign(2u * width_ * height_ * depth_, 0.0f);
+    tmp_.resize(grid_.size());
+  }
+
+  void splat(const ConstImageView<Pixel32fC1>& src,
+             const ConstImageView<Pixel32fC1>& prior)
+  {
+    // Grid rows are splatted in parallel; every image row belongs to
+    // exactly one grid row, so bands never write the same cell.
+    std::vector<uint32_t> first_row(height_ + 1, src.height());
+    for (int y = static_cast<int>(src.height()) - 1; y >= 0; --y)
+    {
+      first_row[cellXY(y)] = y;
+    }
+    for (int gy = height_ - 1; gy >= 0; --gy)
+    {
+      first_row[gy] = std::min(first_row[gy], first_row[gy + 1]);
+    }
+    parallelForRowBands(height_, 1u, [&](size_t gy_begin, size_t gy_end)
+    {
+      for (uint32_t y = first_row[gy_begin]; y < first_row[gy_end]; ++y)
+      {
+        const float* s = reinterpret_cast<const float*>(src.rowPtr(y));
+        const float* p = reinterpret_cast<const float*>(prior.rowPtr(y));
+        float* row = &grid_[2u * cellXY(y) * width_ * depth_];
+        for (uint32_t x = 0u; x < src.width(); ++x)
+        {
+          const int gz = c_pad + static_cast<int>((p[x] - min_) * inv_cell_z_ + 0.5f);
+          float* cell = row + 2 * (cellXY(x) * depth_ + gz);
+          cell[0] += s[x];
+          cell[1] += 1.0f;
+        }
+      }
+    });
+  }
+
+  void blur()
+  {
+    const size_t cell = 2u;
+    const size_t row = cell * depth_;
+    const size_t slice = row * width_;
+    // Every pass writes one grid row (y slice) per task; the y pass reads
+    // the neighboring slices of the previous buffer.
+    blurPass([&](int gy, const float* in, float* out) {
+      blurLine(in, out, slice, gy, height_, slice);
+    });
+    blurPass([&](int, const float* in, float* out) {
+      for (int gx = 0; gx < width_; ++gx)
+      {
+        blurLine(in + gx * row, out + gx * row, row, gx, width_, row);
+      }
+    });
+    blurPass([&](int, const float* in, float* out) {
+      for (int i = 0; i < width_ * depth_; ++i)
+      {
+        blurLine(in + i * cell, out + i * cell, cell, i % depth_, depth_, cell);
+      }
+    });
+  }
+
+  void slice(const ConstImageView<Pixel32fC1>& prior,
+             const ImageView<Pixel32fC1>& dst) const
+  {
+    const size_t stride_x = 2u * depth_;
+    const size_t stride_y = 2u * width_ * depth_;
+    parallelForRowBands(dst.height(), 8u, [&](size_t row_begin, size_t row_end)
+    {
+      for (uint32_t y = row_begin; y < row_end; ++y)
+      {
+        const float fy = y * inv_cell_xy_ + c_pad;
+        const int gy = static_cast<int>(fy);
+        const float wy = fy - gy;
+        const float* p = reinterpret_cast<const float*>(prior.rowPtr(y));
+        float* out = reinterpret_cast<float*>(dst.rowPtr(y));
+        for (uint32_t x = 0u; x < dst.width(); ++x)
+        {
+          const float fx = x * inv_cell_xy_ + c_pad;
+          const float fz = (p[x] - min_) * inv_cell_z_ + c_pad;
+          const int gx = static_cast<int>(fx);
+          const int gz = static_cast<int>(fz);
+          const float wx = fx - gx;
+          const float wz = fz - gz;
+          const float* c = &grid_[gy * stride_y + gx * stride_x + 2 * gz];
+          float val = 0.0f;
+          float weight = 0.0f;
+          for (int j = 0; j < 8; ++j)
+          {
+            const int dx = j & 1, dy = (j >> 1) & 1, dz = j >> 2;
+            const float w = (dx ? wx : 1.0f - wx) * (dy ? wy : 1.0f - wy)
+                            * (dz ? wz : 1.0f - wz);
+            const float* cell = c + dy * stride_y + dx * stride_x + 2 * dz;
+            val += w * cell[0];
+            weight += w * cell[1];
+          }
+          out[x] = val / std::max(1e-6f, weight);
+        }
+      }
+    });
+  }
+
+private:
+  inline int cellXY(uint32_t v) const
+  {
+    return c_pad + static_cast<int>(v * inv_cell_xy_ + 0.5f);
+  }
+
+  //! out[i] = [1 4 6 4 1]/16 * in[i + k*stride], k = -2..2, for i < n,
+  //! where pos is the index of in along the blurred axis of the given size.
+  //! Neighbors outside the grid are zero.
+  static void blurLine(const float* in, float* out, size_t stride,
+                       int pos, int size, size_t n)
+  {
+    const float w_m2 = (pos >= 2) ? 1.0f / 16.0f : 0.0f;
+    const float w_m1 = (pos >= 1) ? 4.0f / 16.0f : 0.0f;
+    const float w_p1 = (pos + 1 < size) ? 4.0f / 16.0f : 0.0f;
+    const float w_p2 = (pos + 2 < size) ? 1.0f / 16.0f : 0.0f;
+    // Unavailable neighbors point to the center and get a zero weight.
+    const float* m2 = (pos >= 2) ? in - 2u * stride : in;
+    const float* m1 = (pos >= 1) ? in - stride : in;
+    const float* p1 = (pos + 1 < size) ? in + stride : in;
+    const float* p2 = (pos + 2 < size) ? in + 2u * stride : in;
+#pragma GCC ivdep
+    for (size_t i = 0u; i < n; ++i)
+    {
+      out[i] = w_m2 * m2[i] + w_m1 * m1[i] + (6.0f / 16.0f) * in[i]
+               + w_p1 * p1[i] + w_p2 * p2[i];
+    }
+  }
+
+  //! Calls fn(gy, grid slice gy, tmp slice gy) for all grid rows in parallel
+  //! and swaps the buffers.
+  template<typename Fn>
+  void blurPass(const Fn& fn)
+  {
+    const size_t slice = 2u * width_ * depth_;
+    parallelForRowBands(height_, 1u, [&](size_t gy_begin, size_t gy_end)
+    {
+      for (size_t gy = gy_begin; gy < gy_end; ++gy)
+      {
+        fn(static_cast<int>(gy), &grid_[gy * slice], &tmp_[gy * slice]);
+      }
+    });
+    grid_.swap(tmp_);
+  }
+
+  float inv_cell_xy_;
+  float inv_cell_z_;
+  float min_;
+  float max_;
+  int width_;
+  int height_;
+  int depth_;
+  //! Interleaved (value, weight) cells, depth fastest, then x, then y.
+  std::vector<float> grid_;
+  std::vector<float> tmp_;
+};
+
+} // unnamed namespace
+
+//-----------------------------------------------------------------------------
+void filterBilateral(Image32fC1& dst,
+                     const Image32fC1& src,
+                     const Image32fC1* prior,
+                     int iters,
+                     float sigma_spatial, float sigma_range,
+                     int radius)
+{
+  CHECK_GT(sigma_spatial, 0.0f);
+  CHECK_GT(sigma_range, 0.0f);
+  CHECK_GE(radius, 0);
+  if (dst.roi().size() != src.roi().size())
+  {
+    dst.setRoi(src.roi());
+  }
+  ConstImageView<Pixel32fC1> src_view = src.roiView();
+  ImageView<Pixel32fC1> dst_view = dst.roiView();
+  if (src_view.empty() || iters <= 0)
+  {
+    return;
+  }
+  CHECK(src_view.data() != dst_view.data()) << "In-place filtering is not supported.";
+  if (prior)
+  {
+    CHECK_EQ(prior->roi().size(), src.roi().size());
+  }
+
+  const bool use_grid = sigma_spatial >= 2.0f && radius >= 2.0f * sigma_spatial;
+  ImageRaw32fC1::Ptr tmp;
+  ConstImageView<Pixel32fC1> in = src_view;
+  for (int iter = 0; iter < iters; ++iter)
+  {
+    if (iter > 0)
+    {
+      if (!tmp)
+      {
+        tmp = std::make_shared<ImageRaw32fC1>(src.roi().size());
+      }
+      copy(ConstImageView<Pixel32fC1>(dst_view), tmp->view());
+      in = tmp->view();
+    }
+    ConstImageView<Pixel32fC1> prior_view = prior ? prior->roiView() : in;
+    if (use_grid)
+    {
+      BilateralGrid grid(prior_view, sigma_spatial, sigma_range);
+      grid.splat(in, prior_view);
+      grid.blur();
+      grid.slice(prior_view, dst_view);
+    }
+    else
+    {
+      bilateralDirect(in, prior_view, dst_view, sigma_spatial, sigma_range, radius);
+    }
+  }
+}
+
+} // namespace ze
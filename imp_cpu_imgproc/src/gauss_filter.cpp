@@ -0,0 +1,203 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_imgproc/image_filter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <imp/core/image_copy.hpp>
+#include <imp/core/parallel.hpp>
+
+namespace ze {
+
+namespace {
+
+//! Filters the output rows [row_begin, row_end) of dst. Every input row in
+//! [row_begin - r, row_end + r) (clamped) is converted to float, padded and
+//! filtered horizontally once into a ring buffer of kernel_size rows; each
+//! output row is then the vertical weighted sum of the rows in the ring.
+template<typename Pixel>
+void gaussRows(const ConstImageView<Pixel>& src, const ImageView<Pixel>& dst,
+               const std::vector<float>& weights,
+               uint32_t row_begin, uint32_t row_end)
+{
+  using T = typename Pixel::T;
+  constexpr int c_channels = sizeof(Pixel) / sizeof(T);
+  const int r = static_cast<int>(weights.size()) - 1;
+  const int kernel_size = 2 * r + 1;
+  const int height = static_cast<int>(src.height());
+  const size_t n = size_t{src.width()} * c_channels;
+  const size_t pad = static_cast<size_t>(r) * c_channels;
+
+  std::vector<float> padded(n + 2u * pad);
+  std::vector<float> ring(kernel_size * n);
+  std::vector<float> acc(n);
+
+  // Row v of the sliding window lives in slot (v - first) % kernel_size.
+  const int first = static_cast<int>(row_begin) - r;
+  auto slot = [&](int v) { return &ring[((v - first) % kernel_size) * n]; };
+
+  auto filterRowHorizontally = [&](int v)
+  {
+    const T* in = reinterpret_cast<const T*>(
+          src.rowPtr(static_cast<uint32_t>(std::min(std::max(v, 0), height - 1))));
+    float* p = padded.data() + pad;
+    for (size_t i = 0u; i < n; ++i)
+    {
+      p[i] = static_cast<float>(in[i]);
+    }
+    for (size_t i = 0u; i < pad; ++i)
+    {
+      padded[i] = p[i % c_channels];
+      p[n + i] = p[n - c_channels + i % c_channels];
+    }
+    float* out = slot(v);
+    const float w0 = weights[0];
+#pragma GCC ivdep
+    for (size_t i = 0u; i < n; ++i)
+    {
+      out[i] = w0 * p[i];
+    }
+    for (int k = 1; k <= r; ++k)
+    {
+      const float wk = weights[k];
+      const float* left = p - k * c_channels;
+      const float* right = p + k * c_channels;
+#pragma GCC ivdep
+      for (size_t i = 0u; i < n; ++i)
+      {
+        out[i] += wk * (left[i] + right[i]);
+      }
+    }
+  };
+
+  // Prime the window with the rows above the first output row.
+  for (int v = first; v < static_cast<int>(row_begin) + r; ++v)
+  {
+    filterRowHorizontally(v);
+  }
+  for (int y = static_cast<int>(row_begin); y < static_cast<int>(row_end); ++y)
+  {
+    // Slide: the incoming row replaces the one that just left the window.
+    filterRowHorizontally(y + r);
+
+    const float* center = slot(y);
+    const float w0 = weights[0];
+#pragma GCC ivdep
+    for (size_t i = 0u; i < n; ++i)
+    {
+      acc[i] = w0 * center[i];
+    }
+    for (int k = 1; k <= r; ++k)
+    {
+      const float wk = weights[k];
+      const float* above = slot(y - k);
+      const float* below = slot(y + k);
+#pragma GCC ivdep
+      for (size_t i = 0u; i < n; ++i)
+      {
+        acc[i] += wk * (above[i] + below[i]);
+      }
+    }
+    T* out = reinterpret_cast<T*>(dst.rowPtr(static_cast<uint32_t>(y)));
+    for (size_t i = 0u; i < n; ++i)
+    {
+      out[i] = internal::saturateCast<T>(acc[i]);
+    }
+  }
+}
+
+} // unnamed namespace
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void filterGauss(Image<Pixel>& dst,
+                 const Image<Pixel>& src,
+                 float sigma, int kernel_size)
+{
+  CHECK_GT(sigma, 0.0f);
+  if (kernel_size == 0)
+  {
+    kernel_size = std::max(5, static_cast<int>(std::ceil(sigma*3)*2 + 1));
+  }
+  if (kernel_size % 2 == 0)
+  {
+    ++kernel_size;
+  }
+  if (dst.roi().size() != src.roi().size())
+  {
+    dst.setRoi(src.roi());
+  }
+  ConstImageView<Pixel> src_view = src.roiView();
+  ImageView<Pixel> dst_view = dst.roiView();
+  CHECK(src_view.data() != dst_view.data()) << "In-place filtering is not supported.";
+
+  // Normalized half kernel, the same weights as the c0/c1 recursion of the
+  // CUDA kernel: exp(-i^2 / (2 sigma^2)).
+  const int r = (kernel_size - 1) / 2;
+  std::vector<float> weights(r + 1);
+  float sum = 0.0f;
+  for (int i = 0; i <= r; ++i)
+  {
+    weights[i] = std::exp(-0.5f * i * i / (sigma * sigma));
+    sum += (i == 0) ? weights[i] : 2.0f * weights[i];
+  }
+  for (float& w : weights)
+  {
+    w /= sum;
+  }
+
+  parallelForRowBands(src_view.height(), 4u * kernel_size,
+                      [&](size_t row_begin, size_t row_end)
+  {
+    gaussRows(src_view, dst_view, weights,
+              static_cast<uint32_t>(row_begin), static_cast<uint32_t>(row_end));
+  });
+}
+
+//==============================================================================
+//
+// template instantiations for all our image types
+//
+
+template void filterGauss(Image8uC1& dst, const Image8uC1& src, float sigma, int kernel_size);
+template void filterGauss(Image8uC2& dst, const Image8uC2& src, float sigma, int kernel_size);
+template void filterGauss(Image8uC4& dst, const Image8uC4& src, float sigma, int kernel_size);
+
+template void filterGauss(Image16uC1& dst, const Image16uC1& src, float sigma, int kernel_size);
+template void filterGauss(Image16uC2& dst, const Image16uC2& src, float sigma, int kernel_size);
+template void filterGauss(Image16uC4& dst, const Image16uC4& src, float sigma, int kernel_size);
+
+template void filterGauss(Image32sC1& dst, const Image32sC1& src, float sigma, int kernel_size);
+template void filterGauss(Image32sC2& dst, const Image32sC2& src, float sigma, int kernel_size);
+template void filterGauss(Image32sC4& dst, const Image32sC4& src, float sigma, int kernel_size);
+
+template void filterGauss(Image32fC1& dst, const Image32fC1& src, float sigma, int kernel_size);
+template void filterGauss(Image32fC2& dst, const Image32fC2& src, float sigma, int kernel_size);
+template void filterGauss(Image32fC4& dst, const Image32fC4& src, float sigma, int kernel_size);
+
+} // namespace ze
@@ -0,0 +1,211 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_imgproc/image_pyramid.hpp>
+
+#include <imp/core/image_raw.hpp>
+#include <imp/core/parallel.hpp>
+#include <imp/cpu_imgproc/reduce.hpp>
+
+namespace ze {
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+typename ImagePyramid<Pixel>::Ptr
+createImagePyramidCpu(
+    const typename Image<Pixel>::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound)
+{
+  CHECK(img_level0);
+  CHECK(!img_level0->isGpuMemory());
+  using Pyr = ImagePyramid<Pixel>;
+  auto pyr = std::make_shared<Pyr>(
+        img_level0->size(), scale_factor, size_bound, max_num_levels);
+
+  // Same level sizes as on the GPU.
+  pyr->push_back(img_level0);
+  const Size2u sz0 = img_level0->size();
+  for (size_t i = 1; i < pyr->numLevels(); ++i)
+  {
+    Size2u sz(static_cast<uint32_t>(sz0.width() * pyr->scaleFactor(i) + 0.5f),
+              static_cast<uint32_t>(sz0.height() * pyr->scaleFactor(i) + 0.5f));
+    pyr->emplace_back(std::make_shared<ImageRaw<Pixel>>(sz));
+  }
+  updateImagePyramidCpu(*pyr, img_level0);
+  return pyr;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void updateImagePyramidCpu(
+    ImagePyramid<Pixel>& pyr, const typename Image<Pixel>::Ptr& img_level0)
+{
+  CHECK(img_level0);
+  CHECK(!pyr.levels().empty());
+  CHECK_EQ(pyr.size(0), img_level0->size());
+  pyr.levels()[0] = img_level0;
+  pyr.scratch().resize(pyr.levels().size());
+  for (size_t i = 1; i < pyr.levels().size(); ++i)
+  {
+    VLOG(300) << "Creating CPU ImagePyramid Level " << i << " of size " << pyr.size(i);
+    reduce(pyr[i], pyr[i-1], pyr.scratch()[i], InterpolationMode::Linear, true);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void updateImagePyramidsCpu(
+    const std::vector<std::shared_ptr<ImagePyramid<Pixel>>>& pyrs,
+    const std::vector<std::shared_ptr<Image<Pixel>>>& imgs)
+{
+  CHECK_EQ(pyrs.size(), imgs.size());
+  TaskGroup group(imageThreadPool());
+  for (size_t i = 1; i < pyrs.size(); ++i)
+  {
+    ImagePyramid<Pixel>* pyr = pyrs[i].get();
+    const typename Image<Pixel>::Ptr* img = &imgs[i];
+    group.run([pyr, img]() { updateImagePyramidCpu(*pyr, *img); });
+  }
+  if (!pyrs.empty())
+  {
+    updateImagePyramidCpu(*pyrs[0], imgs[0]);
+  }
+  group.wait();
+}
+
+//==============================================================================
+//
+// template instantiations for all our image types
+//
+
+template ImagePyramid8uC1::Ptr createImagePyramidCpu<Pixel8uC1>(
+    const Image8uC1::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel8uC1>(
+    ImagePyramid8uC1& pyr, const Image8uC1::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel8uC1>(
+    const std::vector<ImagePyramid8uC1::Ptr>& pyrs,
+    const std::vector<Image8uC1::Ptr>& imgs);
+
+template ImagePyramid8uC2::Ptr createImagePyramidCpu<Pixel8uC2>(
+    const Image8uC2::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel8uC2>(
+    ImagePyramid8uC2& pyr, const Image8uC2::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel8uC2>(
+    const std::vector<ImagePyramid8uC2::Ptr>& pyrs,
+    const std::vector<Image8uC2::Ptr>& imgs);
+
+template ImagePyramid8uC4::Ptr createImagePyramidCpu<Pixel8uC4>(
+    const Image8uC4::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel8uC4>(
+    ImagePyramid8uC4& pyr, const Image8uC4::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel8uC4>(
+    const std::vector<ImagePyramid8uC4::Ptr>& pyrs,
+    const std::vector<Image8uC4::Ptr>& imgs);
+
+template ImagePyramid16uC1::Ptr createImagePyramidCpu<Pixel16uC1>(
+    const Image16uC1::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel16uC1>(
+    ImagePyramid16uC1& pyr, const Image16uC1::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel16uC1>(
+    const std::vector<ImagePyramid16uC1::Ptr>& pyrs,
+    const std::vector<Image16uC1::Ptr>& imgs);
+
+template ImagePyramid16uC2::Ptr createImagePyramidCpu<Pixel16uC2>(
+    const Image16uC2::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel16uC2>(
+    ImagePyramid16uC2& pyr, const Image16uC2::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel16uC2>(
+    const std::vector<ImagePyramid16uC2::Ptr>& pyrs,
+    const std::vector<Image16uC2::Ptr>& imgs);
+
+template ImagePyramid16uC4::Ptr createImagePyramidCpu<Pixel16uC4>(
+    const Image16uC4::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel16uC4>(
+    ImagePyramid16uC4& pyr, const Image16uC4::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel16uC4>(
+    const std::vector<ImagePyramid16uC4::Ptr>& pyrs,
+    const std::vector<Image16uC4::Ptr>& imgs);
+
+template ImagePyramid32sC1::Ptr createImagePyramidCpu<Pixel32sC1>(
+    const Image32sC1::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel32sC1>(
+    ImagePyramid32sC1& pyr, const Image32sC1::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel32sC1>(
+    const std::vector<ImagePyramid32sC1::Ptr>& pyrs,
+    const std::vector<Image32sC1::Ptr>& imgs);
+
+template ImagePyramid32sC2::Ptr createImagePyramidCpu<Pixel32sC2>(
+    const Image32sC2::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel32sC2>(
+    ImagePyramid32sC2& pyr, const Image32sC2::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel32sC2>(
+    const std::vector<ImagePyramid32sC2::Ptr>& pyrs,
+    const std::vector<Image32sC2::Ptr>& imgs);
+
+template ImagePyramid32sC4::Ptr createImagePyramidCpu<Pixel32sC4>(
+    const Image32sC4::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel32sC4>(
+    ImagePyramid32sC4& pyr, const Image32sC4::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel32sC4>(
+    const std::vector<ImagePyramid32sC4::Ptr>& pyrs,
+    const std::vector<Image32sC4::Ptr>& imgs);
+
+template ImagePyramid32fC1::Ptr createImagePyramidCpu<Pixel32fC1>(
+    const Image32fC1::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel32fC1>(
+    ImagePyramid32fC1& pyr, const Image32fC1::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel32fC1>(
+    const std::vector<ImagePyramid32fC1::Ptr>& pyrs,
+    const std::vector<Image32fC1::Ptr>& imgs);
+
+template ImagePyramid32fC2::Ptr createImagePyramidCpu<Pixel32fC2>(
+    const Image32fC2::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel32fC2>(
+    ImagePyramid32fC2& pyr, const Image32fC2::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel32fC2>(
+    const std::vector<ImagePyramid32fC2::Ptr>& pyrs,
+    const std::vector<Image32fC2::Ptr>& imgs);
+
+template ImagePyramid32fC4::Ptr createImagePyramidCpu<Pixel32fC4>(
+    const Image32fC4::Ptr& img_level0, float scale_factor,
+    uint32_t max_num_levels, uint32_t size_bound);
+template void updateImagePyramidCpu<Pixel32fC4>(
+    ImagePyramid32fC4& pyr, const Image32fC4::Ptr& img_level0);
+template void updateImagePyramidsCpu<Pixel32fC4>(
+    const std::vector<ImagePyramid32fC4::Ptr>& pyrs,
+    const std::vector<Image32fC4::Ptr>& imgs);
+
+} // namespace ze
@@ -0,0 +1,192 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_imgproc/image_filter.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <imp/core/parallel.hpp>
+
+namespace ze {
+
+namespace {
+
+template<typename T>
+inline T med3(T a, T b, T c)
+{
+  return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+//! Filters the output rows [row_begin, row_end) of dst. The median of a 3x3
+//! window is med3(max of the column minima, med3 of the column medians,
+//! min of the column maxima), so every input column is sorted only once per
+//! output row instead of sorting nine values per pixel.
+template<typename Pixel>
+void median3x3Rows(const ConstImageView<Pixel>& src, const ImageView<Pixel>& dst,
+                   uint32_t row_begin, uint32_t row_end)
+{
+  using T = typename Pixel::T;
+  constexpr size_t c_channels = sizeof(Pixel) / sizeof(T);
+  const size_t n = size_t{src.width()} * c_channels;
+  const uint32_t height = src.height();
+
+  // Sorted columns with one replicated pixel on either side.
+  std::vector<T> lo(n + 2u * c_channels);
+  std::vector<T> mid(n + 2u * c_channels);
+  std::vector<T> hi(n + 2u * c_channels);
+
+  for (uint32_t y = row_begin; y < row_end; ++y)
+  {
+    const T* above = reinterpret_cast<const T*>(src.rowPtr(y > 0u ? y - 1u : 0u));
+    const T* center = reinterpret_cast<const T*>(src.rowPtr(y));
+    const T* below = reinterpret_cast<const T*>(
+          src.rowPtr(y + 1u < height ? y + 1u : height - 1u));
+    T* l = lo.data() + c_channels;
+    T* m = mid.data() + c_channels;
+    T* h = hi.data() + c_channels;
+#pragma GCC ivdep
+    for (size_t i = 0u; i < n; ++i)
+    {
+      const T a = above[i];
+      const T b = center[i];
+      const T c = below[i];
+      l[i] = std::min(std::min(a, b), c);
+      m[i] = med3(a, b, c);
+      h[i] = std::max(std::max(a, b), c);
+    }
+    for (size_t c = 0u; c < c_channels; ++c)
+    {
+      lo[c] = l[c];
+      mid[c] = m[c];
+      hi[c] = h[c];
+      l[n + c] = l[n - c_channels + c];
+      m[n + c] = m[n - c_channels + c];
+      h[n + c] = h[n - c_channels + c];
+    }
+
+    T* out = reinterpret_cast<T*>(dst.rowPtr(y));
+#pragma GCC ivdep
+    for (size_t i = 0u; i < n; ++i)
+    {
+      const T max_lo = std::max(std::max(l[i - c_channels], l[i]), l[i + c_channels]);
+      const T med_mid = med3(m[i - c_channels], m[i], m[i + c_channels]);
+      const T min_hi = std::min(std::min(h[i - c_channels], h[i]), h[i + c_channels]);
+      out[i] = med3(max_lo, med_mid, min_hi);
+    }
+  }
+}
+
+//! Recomputes the corner pixel (x, y) with the outer diagonal neighbor
+//! (x + dx, y + dy) set to the maximum value instead of clamping it, so that
+//! the corner pixel itself is not counted four times.
+template<typename Pixel>
+void median3x3Corner(const ConstImageView<Pixel>& src, const ImageView<Pixel>& dst,
+                     uint32_t x, uint32_t y, int dx, int dy)
+{
+  using T = typename Pixel::T;
+  constexpr size_t c_channels = sizeof(Pixel) / sizeof(T);
+  const int width = static_cast<int>(src.width());
+  const int height = static_cast<int>(src.height());
+  for (size_t c = 0u; c < c_channels; ++c)
+  {
+    T values[9];
+    int k = 0;
+    for (int v = -1; v <= 1; ++v)
+    {
+      for (int u = -1; u <= 1; ++u)
+      {
+        if (u == dx && v == dy)
+        {
+          values[k++] = std::numeric_limits<T>::max();
+          continue;
+        }
+        const int xx = std::min(std::max(static_cast<int>(x) + u, 0), width - 1);
+        const int yy = std::min(std::max(static_cast<int>(y) + v, 0), height - 1);
+        values[k++] = src(xx, yy).c[c];
+      }
+    }
+    std::nth_element(values, values + 4, values + 9);
+    dst(x, y).c[c] = values[4];
+  }
+}
+
+} // unnamed namespace
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void filterMedian3x3(Image<Pixel>& dst,
+                     const Image<Pixel>& src)
+{
+  if (dst.roi().size() != src.roi().size())
+  {
+    dst.setRoi(src.roi());
+  }
+  ConstImageView<Pixel> src_view = src.roiView();
+  ImageView<Pixel> dst_view = dst.roiView();
+  if (src_view.empty())
+  {
+    return;
+  }
+  CHECK(src_view.data() != dst_view.data()) << "In-place filtering is not supported.";
+
+  parallelForRowBands(src_view.height(), 32u,
+                      [&](size_t row_begin, size_t row_end)
+  {
+    median3x3Rows(src_view, dst_view,
+                  static_cast<uint32_t>(row_begin), static_cast<uint32_t>(row_end));
+  });
+
+  const uint32_t x1 = src_view.width() - 1u;
+  const uint32_t y1 = src_view.height() - 1u;
+  median3x3Corner(src_view, dst_view, 0u, 0u, -1, -1);
+  median3x3Corner(src_view, dst_view, x1, 0u, 1, -1);
+  median3x3Corner(src_view, dst_view, 0u, y1, -1, 1);
+  median3x3Corner(src_view, dst_view, x1, y1, 1, 1);
+}
+
+//==============================================================================
+//
+// template instantiations for all our image types
+//
+
+template void filterMedian3x3(Image8uC1& dst, const Image8uC1& src);
+template void filterMedian3x3(Image8uC2& dst, const Image8uC2& src);
+template void filterMedian3x3(Image8uC4& dst, const Image8uC4& src);
+
+template void filterMedian3x3(Image16uC1& dst, const Image16uC1& src);
+template void filterMedian3x3(Image16uC2& dst, const Image16uC2& src);
+template void filterMedian3x3(Image16uC4& dst, const Image16uC4& src);
+
+template void filterMedian3x3(Image32sC1& dst, const Image32sC1& src);
+template void filterMedian3x3(Image32sC2& dst, const Image32sC2& src);
+template void filterMedian3x3(Image32sC4& dst, const Image32sC4& src);
+
+template void filterMedian3x3(Image32fC1& dst, const Image32fC1& src);
+template void filterMedian3x3(Image32fC2& dst, const Image32fC2& src);
+template void filterMedian3x3(Image32fC4& dst, const Image32fC4& src);
+
+} // namespace ze
@@ -0,0 +1,314 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_imgproc/reduce.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <imp/core/image_copy.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/core/parallel.hpp>
+#include <imp/cpu_imgproc/image_filter.hpp>
+
+namespace ze {
+
+namespace {
+
+//! Accumulator of the fused [1 4 6 4 1] x [1 4 6 4 1] kernel, the sum of
+//! all weights is 256.
+template<typename T>
+struct HalfSampleTraits
+{
+  using Acc = float;
+  static inline T normalize(float sum)
+  {
+    return internal::saturateCast<T>(sum * (1.0f / 256.0f));
+  }
+};
+
+//! 16 * 255 after the vertical and 256 * 255 after the horizontal pass both
+//! fit into 16 bits, so 8-bit images are reduced with exact integer rounding.
+template<>
+struct HalfSampleTraits<uint8_t>
+{
+  using Acc = uint16_t;
+  static inline uint8_t normalize(uint16_t sum)
+  {
+    return static_cast<uint8_t>((sum + 128u) >> 8);
+  }
+};
+
+//! Sets the ROI of dst to all pixels x with x * src_size / dst_size inside
+//! the source ROI (in both dimensions).
+template<typename Pixel>
+void propagateRoi(Image<Pixel>& dst, const Image<Pixel>& src,
+                  uint64_t num_x, uint64_t den_x, uint64_t num_y, uint64_t den_y)
+{
+  auto range = [](uint64_t begin, uint64_t end, uint64_t num, uint64_t den,
+                  uint64_t size, uint32_t& dst_begin, uint32_t& dst_length)
+  {
+    // x * num / den >= begin and x * num / den <= end - 1.
+    const uint64_t first = (begin * den + num - 1u) / num;
+    const uint64_t last = std::min((end - 1u) * den / num + 1u, size);
+    dst_begin = static_cast<uint32_t>(std::min(first, size));
+    dst_length = static_cast<uint32_t>(last > first ? last - first : 0u);
+  };
+  const Roi2u& roi = src.roi();
+  Roi2u dst_roi;
+  range(roi.x(), roi.x() + roi.width(), num_x, den_x, dst.width(),
+        dst_roi.x(), dst_roi.width());
+  range(roi.y(), roi.y() + roi.height(), num_y, den_y, dst.height(),
+        dst_roi.y(), dst_roi.height());
+  dst.setRoi(dst_roi);
+}
+
+//-----------------------------------------------------------------------------
+//! Fused 5-tap binomial blur and decimation by two: dst(x, y) is the blurred
+//! src at (2x, 2y). Every band keeps one vertically filtered source row, the
+//! horizontal pass is only evaluated at the even columns.
+template<typename Pixel>
+void halfSample(Image<Pixel>& dst, const Image<Pixel>& src)
+{
+  using T = typename Pixel::T;
+  using Acc = typename HalfSampleTraits<T>::Acc;
+  constexpr size_t c_channels = sizeof(Pixel) / sizeof(T);
+
+  propagateRoi(dst, src, 2u, 1u, 2u, 1u);
+  const Roi2u src_roi = src.roi();
+  const Roi2u dst_roi = dst.roi();
+  if (dst_roi.width() == 0u || dst_roi.height() == 0u)
+  {
+    return;
+  }
+  ConstImageView<Pixel> src_view = src.view();
+  ImageView<Pixel> dst_view = dst.view();
+  const int src_y0 = src_roi.y();
+  const int src_y1 = src_roi.y() + src_roi.height() - 1u;
+  const size_t n = size_t{src_roi.width()} * c_channels;
+  const size_t pad = 2u * c_channels;
+
+  parallelForRowBands(dst_roi.height(), 8u, [&](size_t row_begin, size_t row_end)
+  {
+    std::vector<Acc> column_sums(n + 2u * pad);
+    Acc* v = column_sums.data() + pad;
+    for (uint32_t y = dst_roi.y() + row_begin; y < dst_roi.y() + row_end; ++y)
+    {
+      const T* r[5];
+      for (int k = 0; k < 5; ++k)
+      {
+        const int yy = std::min(std::max(static_cast<int>(2u * y) + k - 2, src_y0), src_y1);
+        r[k] = reinterpret_cast<const T*>(src_view.rowPtr(yy)) + src_roi.x() * c_channels;
+      }
+#pragma GCC ivdep
+      for (size_t i = 0u; i < n; ++i)
+      {
+        v[i] = static_cast<Acc>(Acc(r[0][i]) + Acc(r[4][i])
+                                + 4 * (Acc(r[1][i]) + Acc(r[3][i])) + 6 * Acc(r[2][i]));
+      }
+      for (size_t i = 0u; i < pad; ++i)
+      {
+        column_sums[i] = v[i % c_channels];
+        v[n + i] = v[n - c_channels + i % c_channels];
+      }
+
+      T* out = reinterpret_cast<T*>(dst_view.rowPtr(y)) + dst_roi.x() * c_channels;
+      const Acc* center = v + (2u * dst_roi.x() - src_roi.x()) * c_channels;
+      const size_t m = size_t{dst_roi.width()} * c_channels;
+      constexpr ptrdiff_t c_step = c_channels;
+      for (size_t i = 0u; i < m; ++i)
+      {
+        // Channel c of output pixel x is at element 2 * x * c_channels + c.
+        const Acc* s = center + 2u * i - i % c_channels;
+        out[i] = HalfSampleTraits<T>::normalize(static_cast<Acc>(
+              s[-2 * c_step] + s[2 * c_step] + 4 * (s[-c_step] + s[c_step]) + 6 * s[0]));
+      }
+    }
+  });
+}
+
+//-----------------------------------------------------------------------------
+//! Point or bilinear resampling at x * src.width() / dst.width().
+template<typename Pixel>
+void resample(Image<Pixel>& dst, const Image<Pixel>& src,
+              InterpolationMode interp)
+{
+  using T = typename Pixel::T;
+  constexpr size_t c_channels = sizeof(Pixel) / sizeof(T);
+
+  propagateRoi(dst, src, src.width(), dst.width(), src.height(), dst.height());
+  const Roi2u src_roi = src.roi();
+  const Roi2u dst_roi = dst.roi();
+  if (dst_roi.width() == 0u || dst_roi.height() == 0u)
+  {
+    return;
+  }
+  const float sf_x = static_cast<float>(src.width()) / dst.width();
+  const float sf_y = static_cast<float>(src.height()) / dst.height();
+  const bool linear = (interp == InterpolationMode::Linear);
+
+  // Source columns and weights are the same for all rows.
+  auto sample = [&](float pos, uint32_t begin, uint32_t length,
+                    uint32_t& i0, uint32_t& i1, float& w1)
+  {
+    const uint32_t last = begin + length - 1u;
+    if (linear)
+    {
+      i0 = std::min(static_cast<uint32_t>(pos), last);
+      i1 = std::min(i0 + 1u, last);
+      w1 = pos - i0;
+    }
+    else
+    {
+      i0 = i1 = std::min(static_cast<uint32_t>(pos + 0.5f), last);
+      w1 = 0.0f;
+    }
+  };
+  std::vector<uint32_t> x0(dst_roi.width()), x1(dst_roi.width());
+  std::vector<float> wx(dst_roi.width());
+  for (uint32_t x = 0u; x < dst_roi.width(); ++x)
+  {
+    sample((dst_roi.x() + x) * sf_x, src_roi.x(), src_roi.width(), x0[x], x1[x], wx[x]);
+  }
+
+  ConstImageView<Pixel> src_view = src.view();
+  ImageView<Pixel> dst_view = dst.view();
+  parallelForRowBands(dst_roi.height(), 8u, [&](size_t row_begin, size_t row_end)
+  {
+    for (uint32_t y = dst_roi.y() + row_begin; y < dst_roi.y() + row_end; ++y)
+    {
+      uint32_t y0, y1;
+      float wy;
+      sample(y * sf_y, src_roi.y(), src_roi.height(), y0, y1, wy);
+      const T* r0 = reinterpret_cast<const T*>(src_view.rowPtr(y0));
+      const T* r1 = reinterpret_cast<const T*>(src_view.rowPtr(y1));
+      T* out = reinterpret_cast<T*>(dst_view.rowPtr(y)) + dst_roi.x() * c_channels;
+      for (uint32_t x = 0u; x < dst_roi.width(); ++x)
+      {
+        const size_t i0 = x0[x] * c_channels;
+        const size_t i1 = x1[x] * c_channels;
+        for (size_t c = 0u; c < c_channels; ++c)
+        {
+          const float top = r0[i0 + c] + wx[x] * (r0[i1 + c] - static_cast<float>(r0[i0 + c]));
+          const float bottom = r1[i0 + c] + wx[x] * (r1[i1 + c] - static_cast<float>(r1[i0 + c]));
+          out[x * c_channels + c] = internal::saturateCast<T>(top + wy * (bottom - top));
+        }
+      }
+    }
+  });
+}
+
+} // unnamed namespace
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void reduce(Image<Pixel>& dst,
+            const Image<Pixel>& src,
+            InterpolationMode interp, bool gauss_prefilter)
+{
+  ImagePtr<Pixel> prefiltered;
+  reduce(dst, src, prefiltered, interp, gauss_prefilter);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void reduce(Image<Pixel>& dst,
+            const Image<Pixel>& src,
+            ImagePtr<Pixel>& prefiltered,
+            InterpolationMode interp, bool gauss_prefilter)
+{
+  CHECK(interp == InterpolationMode::Point || interp == InterpolationMode::Linear)
+      << "unsupported interpolation type";
+  CHECK_GT(dst.width(), 0u);
+  CHECK_GT(dst.height(), 0u);
+
+  auto isHalf = [](uint32_t src_size, uint32_t dst_size) {
+    return dst_size == src_size / 2u || dst_size == (src_size + 1u) / 2u;
+  };
+  if (gauss_prefilter && interp == InterpolationMode::Linear
+      && isHalf(src.width(), dst.width()) && isHalf(src.height(), dst.height()))
+  {
+    halfSample(dst, src);
+    return;
+  }
+
+  const float sf = 0.5f * (static_cast<float>(src.width()) / dst.width()
+                           + static_cast<float>(src.height()) / dst.height());
+  if (gauss_prefilter && sf > 1.0f)
+  {
+    if (!prefiltered || prefiltered->size() != src.size())
+    {
+      prefiltered = std::make_shared<ImageRaw<Pixel>>(src.size());
+    }
+    CHECK(!prefiltered->isGpuMemory());
+    prefiltered->setRoi(src.roi());
+    // Standard deviation that, together with the interpolation, is close to
+    // the binomial kernel when halving.
+    filterGauss(*prefiltered, src, 0.5f * std::sqrt(sf * sf - 1.0f));
+    resample(dst, *prefiltered, interp);
+  }
+  else
+  {
+    resample(dst, src, interp);
+  }
+}
+
+//==============================================================================
+//
+// template instantiations for all our image types
+//
+
+template void reduce(Image8uC1& dst, const Image8uC1& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image8uC1& dst, const Image8uC1& src, Image8uC1::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image8uC2& dst, const Image8uC2& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image8uC2& dst, const Image8uC2& src, Image8uC2::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image8uC4& dst, const Image8uC4& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image8uC4& dst, const Image8uC4& src, Image8uC4::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+
+template void reduce(Image16uC1& dst, const Image16uC1& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image16uC1& dst, const Image16uC1& src, Image16uC1::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image16uC2& dst, const Image16uC2& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image16uC2& dst, const Image16uC2& src, Image16uC2::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image16uC4& dst, const Image16uC4& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image16uC4& dst, const Image16uC4& src, Image16uC4::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+
+template void reduce(Image32sC1& dst, const Image32sC1& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image32sC1& dst, const Image32sC1& src, Image32sC1::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image32sC2& dst, const Image32sC2& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image32sC2& dst, const Image32sC2& src, Image32sC2::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image32sC4& dst, const Image32sC4& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image32sC4& dst, const Image32sC4& src, Image32sC4::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+
+template void reduce(Image32fC1& dst, const Image32fC1& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image32fC1& dst, const Image32fC1& src, Image32fC1::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image32fC2& dst, const Image32fC2& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image32fC2& dst, const Image32fC2& src, Image32fC2::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image32fC4& dst, const Image32fC4& src, InterpolationMode interp, bool gauss_prefilter);
+template void reduce(Image32fC4& dst, const Image32fC4& src, Image32fC4::Ptr& prefiltered, InterpolationMode interp, bool gauss_prefilter);
+
+} // namespace ze
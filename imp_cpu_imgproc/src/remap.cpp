@@ -0,0 +1,213 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_imgproc/remap.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <imp/core/parallel.hpp>
+
+namespace ze {
+
+namespace {
+
+//! Subpixel positions 0, 1/32, ..., 32/32: a position on the last row or
+//! column is stored relative to the pixel before it with weight 1.
+constexpr int c_steps = RemapTable::c_frac_steps + 1;
+
+struct WeightTables
+{
+  int16_t fixed[c_steps * c_steps][4];
+  float real[c_steps * c_steps][4];
+
+  WeightTables()
+  {
+    for (int fy = 0; fy < c_steps; ++fy)
+    {
+      for (int fx = 0; fx < c_steps; ++fx)
+      {
+        const float wx = static_cast<float>(fx) / RemapTable::c_frac_steps;
+        const float wy = static_cast<float>(fy) / RemapTable::c_frac_steps;
+        const int i = fy * c_steps + fx;
+        real[i][0] = (1.0f - wx) * (1.0f - wy);
+        real[i][1] = wx * (1.0f - wy);
+        real[i][2] = (1.0f - wx) * wy;
+        real[i][3] = wx * wy;
+
+        // Round and give the rounding error to the largest weight, so that
+        // the fixed-point weights sum up to exactly one.
+        int sum = 0;
+        int largest = 0;
+        for (int k = 0; k < 4; ++k)
+        {
+          fixed[i][k] = static_cast<int16_t>(
+                std::lround(real[i][k] * (1 << RemapTable::c_weight_bits)));
+          sum += fixed[i][k];
+          largest = (real[i][k] > real[i][largest]) ? k : largest;
+        }
+        fixed[i][largest] += (1 << RemapTable::c_weight_bits) - sum;
+      }
+    }
+  }
+};
+
+const WeightTables& weightTables()
+{
+  static const WeightTables tables;
+  return tables;
+}
+
+template<typename T>
+struct RemapTraits;
+
+template<>
+struct RemapTraits<uint8_t>
+{
+  static inline uint8_t interpolate(const int16_t* w, uint8_t p00, uint8_t p01,
+                                    uint8_t p10, uint8_t p11)
+  {
+    const int sum = w[0] * p00 + w[1] * p01 + w[2] * p10 + w[3] * p11;
+    return static_cast<uint8_t>((sum + (1 << (RemapTable::c_weight_bits - 1)))
+                                >> RemapTable::c_weight_bits);
+  }
+  static inline const int16_t* weights(const WeightTables& tables, uint16_t frac)
+  {
+    return tables.fixed[frac];
+  }
+};
+
+template<>
+struct RemapTraits<float>
+{
+  static inline float interpolate(const float* w, float p00, float p01,
+                                  float p10, float p11)
+  {
+    return w[0] * p00 + w[1] * p01 + w[2] * p10 + w[3] * p11;
+  }
+  static inline const float* weights(const WeightTables& tables, uint16_t frac)
+  {
+    return tables.real[frac];
+  }
+};
+
+} // unnamed namespace
+
+//-----------------------------------------------------------------------------
+RemapTable::RemapTable(const Image32fC2& map, const Size2u& src_size)
+  : size_(map.size())
+  , src_size_(src_size)
+{
+  CHECK_GE(src_size.width(), 2u);
+  CHECK_GE(src_size.height(), 2u);
+  CHECK_LE(src_size.width(), static_cast<uint32_t>(std::numeric_limits<int16_t>::max()));
+  CHECK_LE(src_size.height(), static_cast<uint32_t>(std::numeric_limits<int16_t>::max()));
+
+  entries_.resize(size_.area());
+  auto quantize = [](float pos, uint32_t size, int16_t& i, int& frac)
+  {
+    const float last = static_cast<float>(size - 1u);
+    pos = std::isfinite(pos) ? std::min(std::max(pos, 0.0f), last) : 0.0f;
+    i = static_cast<int16_t>(std::min(static_cast<uint32_t>(pos), size - 2u));
+    frac = static_cast<int>(std::lround((pos - i) * c_frac_steps));
+  };
+  for (uint32_t y = 0u; y < size_.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < size_.width(); ++x)
+    {
+      const Pixel32fC2& px = map(x, y);
+      Entry& e = entries_[y * size_.width() + x];
+      int frac_x, frac_y;
+      quantize(px.x, src_size.width(), e.x, frac_x);
+      quantize(px.y, src_size.height(), e.y, frac_y);
+      e.frac = static_cast<uint16_t>(frac_y * c_steps + frac_x);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+Pixel32fC2 RemapTable::sourcePosition(uint32_t x, uint32_t y) const
+{
+  const Entry& e = entries_.at(y * size_.width() + x);
+  return Pixel32fC2(e.x + static_cast<float>(e.frac % c_steps) / c_frac_steps,
+                    e.y + static_cast<float>(e.frac / c_steps) / c_frac_steps);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void RemapTable::remap(Image<Pixel>& dst, const Image<Pixel>& src) const
+{
+  CHECK_EQ(dst.size(), size_);
+  CHECK_EQ(src.size(), src_size_);
+  parallelForRowBands(size_.height(), 16u, [&](size_t row_begin, size_t row_end)
+  {
+    remap(dst, src, row_begin, row_end);
+  });
+}
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void RemapTable::remap(Image<Pixel>& dst, const Image<Pixel>& src,
+                       uint32_t row_begin, uint32_t row_end) const
+{
+  using T = typename Pixel::T;
+  CHECK_EQ(dst.size(), size_);
+  CHECK_EQ(src.size(), src_size_);
+  CHECK_LE(row_end, size_.height());
+  ConstImageView<Pixel> src_view = src.view();
+  ImageView<Pixel> dst_view = dst.view();
+  const uint8_t* src_data = reinterpret_cast<const uint8_t*>(src_view.data());
+  const size_t src_pitch = src_view.pitch();
+  const WeightTables& tables = weightTables();
+
+  for (uint32_t y = row_begin; y < row_end; ++y)
+  {
+    const Entry* e = &entries_[y * size_.width()];
+    T* out = reinterpret_cast<T*>(dst_view.rowPtr(y));
+    for (uint32_t x = 0u; x < size_.width(); ++x)
+    {
+      const T* r0 = reinterpret_cast<const T*>(src_data + e[x].y * src_pitch) + e[x].x;
+      const T* r1 = reinterpret_cast<const T*>(
+            reinterpret_cast<const uint8_t*>(r0) + src_pitch);
+      out[x] = RemapTraits<T>::interpolate(
+            RemapTraits<T>::weights(tables, e[x].frac), r0[0], r0[1], r1[0], r1[1]);
+    }
+  }
+}
+
+//==============================================================================
+//
+// template instantiations for all supported image types
+//
+
+template void RemapTable::remap(Image8uC1& dst, const Image8uC1& src) const;
+template void RemapTable::remap(Image32fC1& dst, const Image32fC1& src) const;
+template void RemapTable::remap(Image8uC1& dst, const Image8uC1& src,
+                                uint32_t row_begin, uint32_t row_end) const;
+template void RemapTable::remap(Image32fC1& dst, const Image32fC1& src,
+                                uint32_t row_begin, uint32_t row_end) const;
+
+} // namespace ze
@@ -0,0 +1,173 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_imgproc/stereo_rectification.hpp>
+
+#include <imp/core/parallel.hpp>
+
+namespace ze {
+
+namespace {
+
+//! Source position of every pixel of the rectified image, with the same
+//! float arithmetic as k_computeUndistortRectifyMap.
+template<typename CameraModel,
+         typename DistortionModel>
+ImageRaw32fC2 computeUndistortRectifyMap(
+    const Size2u& img_size,
+    const Vector4& camera_params,
+    const Vector4& transformed_camera_params,
+    const Vector4& dist_coeffs,
+    const Matrix3& inv_H)
+{
+  const Eigen::Vector4f cp_flt = camera_params.cast<float>();
+  const Eigen::Vector4f tcp_flt = transformed_camera_params.cast<float>();
+  const Eigen::Vector4f dist_flt = dist_coeffs.cast<float>();
+  const Eigen::Matrix3f inv_H_flt = inv_H.cast<float>();
+  ImageRaw32fC2 map(img_size);
+  for (uint32_t v = 0u; v < img_size.height(); ++v)
+  {
+    for (uint32_t u = 0u; u < img_size.width(); ++u)
+    {
+      float px[2]{static_cast<float>(u), static_cast<float>(v)};
+      CameraModel::backProject(tcp_flt.data(), px);
+      const float x = inv_H_flt(0, 0) * px[0] + inv_H_flt(0, 1) * px[1] + inv_H_flt(0, 2);
+      const float y = inv_H_flt(1, 0) * px[0] + inv_H_flt(1, 1) * px[1] + inv_H_flt(1, 2);
+      const float w = inv_H_flt(2, 0) * px[0] + inv_H_flt(2, 1) * px[1] + inv_H_flt(2, 2);
+      px[0] = x / w;
+      px[1] = y / w;
+      DistortionModel::distort(dist_flt.data(), px);
+      CameraModel::project(cp_flt.data(), px);
+      map(u, v) = Pixel32fC2(px[0], px[1]);
+    }
+  }
+  return map;
+}
+
+//! Mean of a 2x2 block, rounded to nearest for integer pixels.
+inline uint8_t mean2x2(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+{
+  return static_cast<uint8_t>((a + b + c + d + 2) >> 2);
+}
+
+inline float mean2x2(float a, float b, float c, float d)
+{
+  return 0.25f * ((a + b) + (c + d));
+}
+
+} // unnamed namespace
+
+template <typename CameraModel,
+          typename DistortionModel,
+          typename Pixel>
+StereoRectifier<CameraModel, DistortionModel, Pixel>::StereoRectifier(
+    const Size2u& img_size,
+    const Vector4& camera_params,
+    const Vector4& transformed_camera_params,
+    const Vector4& dist_coeffs,
+    const Matrix3& inv_H)
+  : undistort_rectify_map_(computeUndistortRectifyMap<CameraModel, DistortionModel>(
+                             img_size, camera_params, transformed_camera_params,
+                             dist_coeffs, inv_H))
+  , remap_table_(undistort_rectify_map_, img_size)
+{
+}
+
+template <typename CameraModel,
+          typename DistortionModel,
+          typename Pixel>
+void StereoRectifier<CameraModel, DistortionModel, Pixel>::rectify(
+    Image<Pixel>& dst,
+    const Image<Pixel>& src) const
+{
+  CHECK_EQ(src.size(), dst.size());
+  remap_table_.remap(dst, src);
+}
+
+template <typename CameraModel,
+          typename DistortionModel,
+          typename Pixel>
+void StereoRectifier<CameraModel, DistortionModel, Pixel>::rectify(
+    Image<Pixel>& dst,
+    Image<Pixel>& dst_half,
+    const Image<Pixel>& src) const
+{
+  using T = typename Pixel::T;
+  CHECK_EQ(src.size(), dst.size());
+  CHECK_EQ(dst_half.width(), dst.width() / 2u);
+  CHECK_EQ(dst_half.height(), dst.height() / 2u);
+  ImageView<Pixel> dst_view = dst.view();
+  ImageView<Pixel> half_view = dst_half.view();
+  const uint32_t height = dst.height();
+  const uint32_t half_width = dst_half.width();
+  const uint32_t half_height = dst_half.height();
+
+  // Bands of row pairs, so that every half-resolution row is computed by the
+  // band that has just remapped its two source rows.
+  const uint32_t num_pairs = (height + 1u) / 2u;
+  parallelForRowBands(num_pairs, 8u, [&](size_t pair_begin, size_t pair_end)
+  {
+    for (size_t p = pair_begin; p < pair_end; ++p)
+    {
+      const uint32_t y = 2u * p;
+      remap_table_.remap(dst, src, y, std::min(y + 2u, height));
+      if (p >= half_height)
+      {
+        continue;
+      }
+      const T* r0 = reinterpret_cast<const T*>(dst_view.rowPtr(y));
+      const T* r1 = reinterpret_cast<const T*>(dst_view.rowPtr(y + 1u));
+      T* out = reinterpret_cast<T*>(half_view.rowPtr(p));
+      for (uint32_t x = 0u; x < half_width; ++x)
+      {
+        out[x] = mean2x2(r0[2u * x], r0[2u * x + 1u], r1[2u * x], r1[2u * x + 1u]);
+      }
+    }
+  });
+}
+
+template <typename CameraModel,
+          typename DistortionModel,
+          typename Pixel>
+const ImageRaw32fC2& StereoRectifier<CameraModel, DistortionModel, Pixel>::getUndistortRectifyMap() const
+{
+  return undistort_rectify_map_;
+}
+
+template <typename CameraModel,
+          typename DistortionModel,
+          typename Pixel>
+const RemapTable& StereoRectifier<CameraModel, DistortionModel, Pixel>::getRemapTable() const
+{
+  return remap_table_;
+}
+
+// Explicit template instantiations
+template class StereoRectifier<PinholeGeometry, EquidistantDistortion, Pixel8uC1>;
+template class StereoRectifier<PinholeGeometry, EquidistantDistortion, Pixel32fC1>;
+template class StereoRectifier<PinholeGeometry, RadialTangentialDistortion, Pixel8uC1>;
+template class StereoRectifier<PinholeGeometry, RadialTangentialDistortion, Pixel32fC1>;
+
+} // namespace ze
@@ -0,0 +1,69 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_imgproc/tvl1_denoising.hpp>
+
+#include <cmath>
+
+namespace ze {
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void TvL1Denoising<Pixel>::denoise(const ImageBase::Ptr& dst,
+                                   const ImageBase::Ptr& src)
+{
+  VLOG(100) << "[Solver @cpu] TvL1Denoising::denoise:";
+  CHECK(src);
+  CHECK(dst);
+  CHECK_EQ(src->size(), dst->size());
+  CHECK(src->pixelType() == pixel_type<Pixel>::type);
+
+  this->setInput(*src);
+  // Same step sizes as on the GPU.
+  this->solve(DataTerm::L1, 1.0f / 8.0f, 1.0f / std::sqrt(8.0f));
+  this->writeResult(*dst);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void TvL1Denoising<Pixel>::primalDualEnergy(
+    double& primal_energy, double& dual_energy) const
+{
+  Base::primalDualEnergy(DataTerm::L1, primal_energy, dual_energy);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+void TvL1Denoising<Pixel>::print(std::ostream& os) const
+{
+  os << "TvL1 Denoising:" << std::endl;
+  this->Base::print(os);
+}
+
+//=============================================================================
+template class TvL1Denoising<Pixel8uC1>;
+template class TvL1Denoising<Pixel32fC1>;
+
+} // namespace ze
@@ -0,0 +1,106 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_imgproc/undistortion.hpp>
+
+namespace ze {
+
+namespace {
+
+//! Source position of every pixel of the undistorted image, with the same
+//! float arithmetic as k_computeUndistortionMap.
+template<typename CameraModel,
+         typename DistortionModel>
+ImageRaw32fC2 computeUndistortionMap(
+    const Size2u& img_size,
+    const VectorX& camera_params,
+    const VectorX& dist_coeffs)
+{
+  const Eigen::VectorXf cp_flt = camera_params.cast<float>();
+  const Eigen::VectorXf dist_flt = dist_coeffs.cast<float>();
+  ImageRaw32fC2 map(img_size);
+  for (uint32_t y = 0u; y < img_size.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < img_size.width(); ++x)
+    {
+      float px[2]{static_cast<float>(x), static_cast<float>(y)};
+      CameraModel::backProject(cp_flt.data(), px);
+      DistortionModel::distort(dist_flt.data(), px);
+      CameraModel::project(cp_flt.data(), px);
+      map(x, y) = Pixel32fC2(px[0], px[1]);
+    }
+  }
+  return map;
+}
+
+} // unnamed namespace
+
+template <typename CameraModel,
+          typename DistortionModel,
+          typename Pixel>
+ImageUndistorter<CameraModel, DistortionModel, Pixel>::ImageUndistorter(
+    const Size2u& img_size,
+    const VectorX& camera_params,
+    const VectorX& dist_coeffs)
+  : undistortion_map_(computeUndistortionMap<CameraModel, DistortionModel>(
+                        img_size, camera_params, dist_coeffs))
+  , remap_table_(undistortion_map_, img_size)
+{
+}
+
+template <typename CameraModel,
+          typename DistortionModel,
+          typename Pixel>
+void ImageUndistorter<CameraModel, DistortionModel, Pixel>::undistort(
+    Image<Pixel>& dst,
+    const Image<Pixel>& src) const
+{
+  CHECK_EQ(src.size(), dst.size());
+  remap_table_.remap(dst, src);
+}
+
+template <typename CameraModel,
+          typename DistortionModel,
+          typename Pixel>
+const ImageRaw32fC2& ImageUndistorter<CameraModel, DistortionModel, Pixel>::getUndistortionMap() const
+{
+  return undistortion_map_;
+}
+
+template <typename CameraModel,
+          typename DistortionModel,
+          typename Pixel>
+const RemapTable& ImageUndistorter<CameraModel, DistortionModel, Pixel>::getRemapTable() const
+{
+  return remap_table_;
+}
+
+// Explicit template instantiations
+template class ImageUndistorter<PinholeGeometry, EquidistantDistortion, Pixel8uC1>;
+template class ImageUndistorter<PinholeGeometry, EquidistantDistortion, Pixel32fC1>;
+template class ImageUndistorter<PinholeGeometry, RadialTangentialDistortion, Pixel8uC1>;
+template class ImageUndistorter<PinholeGeometry, RadialTangentialDistortion, Pixel32fC1>;
+
+} // namespace ze
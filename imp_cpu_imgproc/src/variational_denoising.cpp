@@ -0,0 +1,484 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/cpu_imgproc/variational_denoising.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <imp/core/image_copy.hpp>
+#include <imp/core/parallel.hpp>
+
+namespace ze {
+
+namespace {
+
+//! Bands have at least this many rows, there is one per thread otherwise.
+constexpr uint32_t c_min_band_rows = 16u;
+
+//! Quadratic data term of the ROF model, lambda/2 (u-f)^2.
+struct L2DataTerm
+{
+  float lambda;
+
+  inline float prox(float u, float f, float tau) const
+  {
+    return (u + tau * lambda * f) / (1.0f + tau * lambda);
+  }
+
+  inline float primalEnergy(float u, float f) const
+  {
+    return 0.5f * lambda * (u - f) * (u - f);
+  }
+
+  //! min_u -u div + lambda/2 (u-f)^2
+  inline float dualEnergy(float div, float f) const
+  {
+    return -div * div / (2.0f * lambda) - div * f;
+  }
+};
+
+//! L1 data term of the TV-L1 model, lambda |u-f|.
+struct L1DataTerm
+{
+  float lambda;
+  float lo; //!< Range of the solution, bounds the dual energy.
+  float hi;
+
+  inline float prox(float u, float f, float tau) const
+  {
+    const float tau_lambda = tau * lambda;
+    const float residual = u - f;
+    return (residual < -tau_lambda) ? u + tau_lambda
+                                    : (residual > tau_lambda) ? u - tau_lambda : f;
+  }
+
+  inline float primalEnergy(float u, float f) const
+  {
+    return lambda * std::abs(u - f);
+  }
+
+  //! min_u -u div + lambda |u-f| for u in [lo, hi], i.e. at a bound or at f.
+  inline float dualEnergy(float div, float f) const
+  {
+    const float e_lo = -lo * div + lambda * (f - lo);
+    const float e_hi = -hi * div + lambda * (hi - f);
+    return std::min(std::min(e_lo, e_hi), -f * div);
+  }
+};
+
+//! p = proj(p + sigma grad(u_bar)) for one row. u_bar_next is u_bar itself
+//! on the last row, so that the vertical derivative vanishes.
+inline void dualRow(const float* u_bar, const float* u_bar_next,
+                    float* p_x, float* p_y, uint32_t width, float sigma)
+{
+  for (uint32_t x = 0u; x < width - 1u; ++x)
+  {
+    const float px = p_x[x] + sigma * (u_bar[x + 1u] - u_bar[x]);
+    const float py = p_y[x] + sigma * (u_bar_next[x] - u_bar[x]);
+    const float scale = 1.0f / std::max(1.0f, std::sqrt(px * px + py * py));
+    p_x[x] = px * scale;
+    p_y[x] = py * scale;
+  }
+  const uint32_t x = width - 1u;
+  const float px = p_x[x];
+  const float py = p_y[x] + sigma * (u_bar_next[x] - u_bar[x]);
+  const float scale = 1.0f / std::max(1.0f, std::sqrt(px * px + py * py));
+  p_x[x] = px * scale;
+  p_y[x] = py * scale;
+}
+
+//! Primal update and over-relaxation of one row. p_y and p_y_prev point to
+//! zeros beyond the image border. Returns the dual energy of the row if
+//! with_energy is set.
+template<typename DataTerm, bool with_energy>
+inline float primalRow(const DataTerm& term,
+                       const float* p_x, const float* p_y, const float* p_y_prev,
+                       const float* f, float* u, float* u_bar, uint32_t width,
+                       float tau, float theta)
+{
+  float energy = 0.0f;
+  auto update = [&](uint32_t x, float div_x)
+  {
+    const float div = div_x + p_y[x] - p_y_prev[x];
+    const float u_prev = u[x];
+    const float u_new = term.prox(u_prev + tau * div, f[x], tau);
+    u[x] = u_new;
+    u_bar[x] = u_new + theta * (u_new - u_prev);
+    if (with_energy)
+    {
+      energy += term.dualEnergy(div, f[x]);
+    }
+  };
+  update(0u, p_x[0]);
+  for (uint32_t x = 1u; x < width - 1u; ++x)
+  {
+    update(x, p_x[x] - p_x[x - 1u]);
+  }
+  update(width - 1u, -p_x[width - 2u]);
+  return energy;
+}
+
+//! Primal energy of one row, u_next is u itself on the last row.
+template<typename DataTerm>
+inline float primalEnergyRow(const DataTerm& term, const float* u,
+                             const float* u_next, const float* f, uint32_t width)
+{
+  float energy = 0.0f;
+  for (uint32_t x = 0u; x < width - 1u; ++x)
+  {
+    const float dx = u[x + 1u] - u[x];
+    const float dy = u_next[x] - u[x];
+    energy += std::sqrt(dx * dx + dy * dy) + term.primalEnergy(u[x], f[x]);
+  }
+  const uint32_t x = width - 1u;
+  energy += std::abs(u_next[x] - u[x]) + term.primalEnergy(u[x], f[x]);
+  return energy;
+}
+
+struct EnergySums
+{
+  double primal = 0.0;
+  double dual = 0.0;
+};
+
+//! Row access without a virtual call per row.
+struct Rows
+{
+  explicit Rows(const ImageRaw32fC1& img)
+    : base(reinterpret_cast<uint8_t*>(const_cast<Pixel32fC1*>(img.data())))
+    , pitch(img.pitch())
+  {}
+
+  inline float* data(uint32_t y) const
+  {
+    return reinterpret_cast<float*>(base + y * pitch);
+  }
+
+  uint8_t* base;
+  size_t pitch;
+};
+
+//! Rows and band layout of the solver state.
+struct SolverState
+{
+  Rows f;
+  Rows u;
+  Rows u_bar;
+  Rows p_x;
+  Rows p_y;
+  const std::vector<uint32_t>& band_rows;
+  float* halo;
+  double* band_energies; //!< Primal and dual energy of every band.
+  const float* zeros;
+  uint32_t width;
+  uint32_t height;
+
+  inline const float* pYPrev(uint32_t y) const
+  {
+    return (y == 0u) ? zeros : p_y.data(y - 1u);
+  }
+  inline const float* pY(uint32_t y) const
+  {
+    return (y == height - 1u) ? zeros : p_y.data(y);
+  }
+  inline const float* uNext(uint32_t y) const
+  {
+    return (y == height - 1u) ? u.data(y) : u.data(y + 1u);
+  }
+};
+
+//! One primal-dual iteration, see VariationalDenoising.
+template<typename DataTerm, bool with_energy>
+EnergySums iterate(const DataTerm& term, SolverState& s,
+                   float tau, float sigma, float theta)
+{
+  const size_t num_bands = s.band_rows.size() - 1u;
+  const uint32_t w = s.width;
+
+  // Halo exchange: the last dual row of band k needs the u_bar row that the
+  // first primal row of band k+1 overwrites.
+  for (size_t k = 1u; k < num_bands; ++k)
+  {
+    std::memcpy(s.halo + (k - 1u) * w, s.u_bar.data(s.band_rows[k]), w * sizeof(float));
+  }
+
+  imageThreadPool().parallelFor(0u, num_bands, 1u, [&](size_t k_begin, size_t k_end)
+  {
+    for (size_t k = k_begin; k < k_end; ++k)
+    {
+      const uint32_t b = s.band_rows[k];
+      const uint32_t e = s.band_rows[k + 1u];
+      // The primal energy of row y-1 needs u of row y, it lags one row.
+      const uint32_t first_energy_row = (k == 0u) ? b : b + 1u;
+      double primal = 0.0;
+      double dual = 0.0;
+      for (uint32_t y = b; y < e; ++y)
+      {
+        const float* u_bar_next = (y + 1u < e) ? s.u_bar.data(y + 1u)
+                                               : (e < s.height) ? s.halo + k * w
+                                                                : s.u_bar.data(y);
+        dualRow(s.u_bar.data(y), u_bar_next, s.p_x.data(y), s.p_y.data(y), w, sigma);
+        if (k > 0u && y == b)
+        {
+          continue;
+        }
+        dual += primalRow<DataTerm, with_energy>(
+              term, s.p_x.data(y), s.pY(y), s.pYPrev(y), s.f.data(y),
+              s.u.data(y), s.u_bar.data(y), w, tau, theta);
+        if (with_energy && y > first_energy_row)
+        {
+          primal += primalEnergyRow(term, s.u.data(y - 1u), s.u.data(y),
+                                    s.f.data(y - 1u), w);
+        }
+      }
+      if (with_energy && e == s.height)
+      {
+        primal += primalEnergyRow(term, s.u.data(e - 1u), s.u.data(e - 1u),
+                                  s.f.data(e - 1u), w);
+      }
+      s.band_energies[2u * k] = primal;
+      s.band_energies[2u * k + 1u] = dual;
+    }
+  });
+
+  // First rows of the bands, now that p of the rows above is final.
+  EnergySums sums;
+  for (size_t k = 1u; k < num_bands; ++k)
+  {
+    const uint32_t y = s.band_rows[k];
+    sums.dual += primalRow<DataTerm, with_energy>(
+          term, s.p_x.data(y), s.pY(y), s.pYPrev(y), s.f.data(y),
+          s.u.data(y), s.u_bar.data(y), w, tau, theta);
+  }
+  if (with_energy)
+  {
+    for (size_t k = 1u; k < num_bands; ++k)
+    {
+      const uint32_t b = s.band_rows[k];
+      sums.primal += primalEnergyRow(term, s.u.data(b - 1u), s.u.data(b),
+                                     s.f.data(b - 1u), w);
+      sums.primal += primalEnergyRow(term, s.u.data(b), s.uNext(b), s.f.data(b), w);
+    }
+    for (size_t k = 0u; k < num_bands; ++k)
+    {
+      sums.primal += s.band_energies[2u * k];
+      sums.dual += s.band_energies[2u * k + 1u];
+    }
+  }
+  return sums;
+}
+
+template<typename DataTerm>
+void runIterations(const DataTerm& term, SolverState& s,
+                   const VariationalDenoisingParams& params, float tau, float sigma,
+                   uint16_t& num_iter, double& primal_dual_gap)
+{
+  const bool check_gap = params.primal_dual_energy_check_iter > 0
+                         && params.primal_dual_gap_tolerance > 0.0;
+  const double num_pixels = static_cast<double>(s.width) * s.height;
+  num_iter = params.max_iter;
+  primal_dual_gap = -1.0;
+  for (uint16_t iter = 0; iter < params.max_iter; ++iter)
+  {
+    const float theta = (sigma < 1000.0f)
+                        ? 1.0f / std::sqrt(1.0f + 0.7f * params.lambda * tau)
+                        : 1.0f;
+
+    VLOG(101) << "(cpu primal-dual solver) iter: " << iter << "; tau: " << tau
+              << "; sigma: " << sigma << "; theta: " << theta;
+
+    if (check_gap && (iter + 1) % params.primal_dual_energy_check_iter == 0)
+    {
+      const EnergySums sums = iterate<DataTerm, true>(term, s, tau, sigma, theta);
+      primal_dual_gap = (sums.primal - sums.dual) / num_pixels;
+      VLOG(102) << "ENERGIES: primal: " << sums.primal << "; dual: " << sums.dual;
+      if (primal_dual_gap < params.primal_dual_gap_tolerance)
+      {
+        num_iter = iter + 1;
+        break;
+      }
+    }
+    else
+    {
+      iterate<DataTerm, false>(term, s, tau, sigma, theta);
+    }
+
+    sigma /= theta;
+    tau *= theta;
+  }
+}
+
+//! Energies of the current state in a separate pass, for reference.
+template<typename DataTerm>
+void evaluateEnergies(const DataTerm& term, const SolverState& s,
+                      double& primal_energy, double& dual_energy)
+{
+  primal_energy = 0.0;
+  dual_energy = 0.0;
+  for (uint32_t y = 0u; y < s.height; ++y)
+  {
+    primal_energy += primalEnergyRow(term, s.u.data(y), s.uNext(y), s.f.data(y), s.width);
+    const float* p_x = s.p_x.data(y);
+    const float* p_y = s.pY(y);
+    const float* p_y_prev = s.pYPrev(y);
+    const float* f = s.f.data(y);
+    for (uint32_t x = 0u; x < s.width; ++x)
+    {
+      const float div_x = (x == 0u) ? p_x[0]
+                                    : (x + 1u == s.width) ? -p_x[x - 1u]
+                                                          : p_x[x] - p_x[x - 1u];
+      dual_energy += term.dualEnergy(div_x + p_y[x] - p_y_prev[x], f[x]);
+    }
+  }
+}
+
+} // unnamed namespace
+
+//-----------------------------------------------------------------------------
+void VariationalDenoising::init(const Size2u& size)
+{
+  CHECK_GE(size.width(), 2u);
+  CHECK_GE(size.height(), 2u);
+  size_ = size;
+
+  u_ = std::make_shared<ImageRaw32fC1>(size);
+  u_bar_ = std::make_shared<ImageRaw32fC1>(size);
+  p_x_ = std::make_shared<ImageRaw32fC1>(size);
+  p_y_ = std::make_shared<ImageRaw32fC1>(size);
+  u_->copyFrom(*f_);
+  u_bar_->copyFrom(*f_);
+  p_x_->setValue(Pixel32fC1(0.0f));
+  p_y_->setValue(Pixel32fC1(0.0f));
+
+  const size_t num_bands = std::max<size_t>(
+        1u, std::min<size_t>(imageThreadPool().numThreads() + 1u,
+                             size.height() / c_min_band_rows));
+  band_rows_.resize(num_bands + 1u);
+  for (size_t k = 0u; k <= num_bands; ++k)
+  {
+    band_rows_[k] = static_cast<uint32_t>(k * size.height() / num_bands);
+  }
+  halo_.resize((num_bands - 1u) * size.width());
+  band_energies_.resize(2u * num_bands);
+  zeros_.assign(size.width(), 0.0f);
+}
+
+//-----------------------------------------------------------------------------
+void VariationalDenoising::setInput(const ImageBase& src)
+{
+  if (!f_ || f_->size() != src.size())
+  {
+    f_ = std::make_shared<ImageRaw32fC1>(src.size());
+  }
+  switch (src.pixelType())
+  {
+  case PixelType::i8uC1:
+    convert(dynamic_cast<const Image8uC1&>(src).view(), f_->view(), 1.0f / 255.0f);
+    break;
+  case PixelType::i32fC1:
+    f_->copyFrom(dynamic_cast<const Image32fC1&>(src));
+    break;
+  default:
+    LOG(FATAL) << "Unsupported pixel type.";
+    break;
+  }
+
+  const Rows f_rows(*f_);
+  f_min_ = f_max_ = f_rows.data(0u)[0];
+  for (uint32_t y = 0u; y < f_->height(); ++y)
+  {
+    const float* f = f_rows.data(y);
+    for (uint32_t x = 0u; x < f_->width(); ++x)
+    {
+      f_min_ = std::min(f_min_, f[x]);
+      f_max_ = std::max(f_max_, f[x]);
+    }
+  }
+
+  if (size_ != f_->size())
+  {
+    this->init(f_->size());
+  }
+}
+
+//-----------------------------------------------------------------------------
+void VariationalDenoising::solve(DataTerm data_term, float tau, float sigma)
+{
+  SolverState state{Rows(*f_), Rows(*u_), Rows(*u_bar_), Rows(*p_x_), Rows(*p_y_),
+                    band_rows_, halo_.data(), band_energies_.data(), zeros_.data(),
+                    size_.width(), size_.height()};
+  switch (data_term)
+  {
+  case DataTerm::L2:
+    runIterations(L2DataTerm{params_.lambda}, state, params_, tau, sigma,
+                  num_iter_, primal_dual_gap_);
+    break;
+  case DataTerm::L1:
+    runIterations(L1DataTerm{params_.lambda, f_min_, f_max_}, state, params_,
+                  tau, sigma, num_iter_, primal_dual_gap_);
+    break;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void VariationalDenoising::primalDualEnergy(
+    DataTerm data_term, double& primal_energy, double& dual_energy) const
+{
+  CHECK(u_);
+  const SolverState state{Rows(*f_), Rows(*u_), Rows(*u_bar_), Rows(*p_x_), Rows(*p_y_),
+                          band_rows_, nullptr, nullptr, zeros_.data(), size_.width(), size_.height()};
+  switch (data_term)
+  {
+  case DataTerm::L2:
+    evaluateEnergies(L2DataTerm{params_.lambda}, state, primal_energy, dual_energy);
+    break;
+  case DataTerm::L1:
+    evaluateEnergies(L1DataTerm{params_.lambda, f_min_, f_max_}, state,
+                     primal_energy, dual_energy);
+    break;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void VariationalDenoising::writeResult(ImageBase& dst) const
+{
+  CHECK_EQ(dst.size(), size_);
+  switch (dst.pixelType())
+  {
+  case PixelType::i8uC1:
+    convert(u_->view(), dynamic_cast<Image8uC1&>(dst).view(), 255.0f);
+    break;
+  case PixelType::i32fC1:
+    u_->copyTo(dynamic_cast<Image32fC1&>(dst));
+    break;
+  default:
+    LOG(FATAL) << "Unsupported pixel type.";
+    break;
+  }
+}
+
+} // namespace ze
@@ -0,0 +1,290 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <ze/common/test_entrypoint.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/image_filter.hpp>
+
+namespace {
+
+using namespace ze;
+
+template<typename Pixel>
+void setRandom(ImageRaw<Pixel>& img, float max_value, uint32_t seed = 42u)
+{
+  using T = typename Pixel::T;
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(0.0f, max_value);
+  constexpr size_t c_channels = sizeof(Pixel) / sizeof(T);
+  for (uint32_t y = 0u; y < img.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < img.width(); ++x)
+    {
+      for (size_t c = 0u; c < c_channels; ++c)
+      {
+        img(x, y).c[c] = static_cast<T>(dist(gen));
+      }
+    }
+  }
+}
+
+template<typename Pixel>
+typename Pixel::T clampedAt(const ImageRaw<Pixel>& img, int x, int y, size_t c)
+{
+  x = std::min(std::max(x, 0), static_cast<int>(img.width()) - 1);
+  y = std::min(std::max(y, 0), static_cast<int>(img.height()) - 1);
+  return img(x, y).c[c];
+}
+
+//! Direct 2D convolution with the normalized Gaussian and clamped borders.
+template<typename Pixel>
+float gaussReference(const ImageRaw<Pixel>& img, int x, int y, size_t c,
+                     float sigma, int kernel_size)
+{
+  const int r = (kernel_size - 1) / 2;
+  float sum_w = 0.0f;
+  float sum = 0.0f;
+  for (int v = -r; v <= r; ++v)
+  {
+    for (int u = -r; u <= r; ++u)
+    {
+      const float w = std::exp(-0.5f * (u*u + v*v) / (sigma * sigma));
+      sum_w += w;
+      sum += w * clampedAt(img, x + u, y + v, c);
+    }
+  }
+  return sum / sum_w;
+}
+
+template<typename Pixel>
+typename Pixel::T medianReference(const ImageRaw<Pixel>& img, int x, int y, size_t c)
+{
+  using T = typename Pixel::T;
+  const int x1 = static_cast<int>(img.width()) - 1;
+  const int y1 = static_cast<int>(img.height()) - 1;
+  std::vector<T> values;
+  for (int v = -1; v <= 1; ++v)
+  {
+    for (int u = -1; u <= 1; ++u)
+    {
+      // Outer diagonal neighbor of a corner pixel.
+      const bool outer_corner = (x + u < 0 || x + u > x1) && (y + v < 0 || y + v > y1)
+          && (x == 0 || x == x1) && (y == 0 || y == y1);
+      values.push_back(outer_corner ? std::numeric_limits<T>::max()
+                                    : clampedAt(img, x + u, y + v, c));
+    }
+  }
+  std::sort(values.begin(), values.end());
+  return values[4];
+}
+
+//! Brute-force bilateral filter as in the CUDA kernel.
+float bilateralReference(const ImageRaw32fC1& img, int x, int y,
+                         float sigma_spatial, float sigma_range, int radius)
+{
+  const float p = img(x, y).x;
+  float sum_g = 0.0f;
+  float sum_val = 0.0f;
+  for (int l = -radius; l <= radius; ++l)
+  {
+    for (int k = -radius; k <= radius; ++k)
+    {
+      const int xx = x + k;
+      const int yy = y + l;
+      if (xx >= 0 && yy >= 0 && xx < static_cast<int>(img.width())
+          && yy < static_cast<int>(img.height()))
+      {
+        const float d = p - img(xx, yy).x;
+        const float g = std::exp(-(k*k + l*l) / (2.0f * sigma_spatial * sigma_spatial)
+                                 - d * d / (2.0f * sigma_range * sigma_range));
+        sum_g += g;
+        sum_val += g * img(xx, yy).x;
+      }
+    }
+  }
+  return sum_val / std::max(1e-6f, sum_g);
+}
+
+} // unnamed namespace
+
+TEST(ImageFilterTest, testGauss32fC1)
+{
+  ImageRaw32fC1 src(67u, 45u);
+  setRandom(src, 1.0f);
+  ImageRaw32fC1 dst(67u, 45u);
+  for (int kernel_size : {3, 7, 0})
+  {
+    const float sigma = 1.5f;
+    filterGauss(dst, src, sigma, kernel_size);
+    const int k = (kernel_size == 0) ? 11 : kernel_size;
+    for (uint32_t y = 0u; y < src.height(); ++y)
+    {
+      for (uint32_t x = 0u; x < src.width(); ++x)
+      {
+        EXPECT_NEAR(gaussReference(src, x, y, 0u, sigma, k), dst(x, y).x, 1e-5f);
+      }
+    }
+  }
+}
+
+TEST(ImageFilterTest, testGauss8uC4)
+{
+  ImageRaw8uC4 src(40u, 31u);
+  setRandom(src, 255.0f);
+  ImageRaw8uC4 dst(40u, 31u);
+  filterGauss(dst, src, 1.0f);
+  for (uint32_t y = 0u; y < src.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < src.width(); ++x)
+    {
+      for (size_t c = 0u; c < 4u; ++c)
+      {
+        EXPECT_NEAR(gaussReference(src, x, y, c, 1.0f, 7), dst(x, y).c[c], 0.5f + 1e-3f);
+      }
+    }
+  }
+}
+
+TEST(ImageFilterTest, testMedian3x3)
+{
+  ImageRaw32fC1 src(33u, 17u);
+  setRandom(src, 1.0f);
+  ImageRaw32fC1 dst(33u, 17u);
+  filterMedian3x3(dst, src);
+  for (uint32_t y = 0u; y < src.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < src.width(); ++x)
+    {
+      EXPECT_EQ(medianReference(src, x, y, 0u), dst(x, y).x);
+    }
+  }
+
+  ImageRaw8uC2 src2(19u, 23u);
+  setRandom(src2, 255.0f);
+  ImageRaw8uC2 dst2(19u, 23u);
+  filterMedian3x3(dst2, src2);
+  for (uint32_t y = 0u; y < src2.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < src2.width(); ++x)
+    {
+      EXPECT_EQ(medianReference(src2, x, y, 0u), dst2(x, y).c[0]);
+      EXPECT_EQ(medianReference(src2, x, y, 1u), dst2(x, y).c[1]);
+    }
+  }
+}
+
+TEST(ImageFilterTest, testMedian3x3Roi)
+{
+  ImageRaw16uC1 src(50u, 40u);
+  setRandom(src, 1000.0f);
+  const Roi2u roi(5u, 7u, 20u, 15u);
+  src.setRoi(roi);
+  ImageRaw16uC1 dst(50u, 40u);
+  dst.setValue(Pixel16uC1(7u));
+  filterMedian3x3(dst, src);
+  EXPECT_EQ(roi, dst.roi());
+
+  // Reference on a copy of the ROI only.
+  ImageRaw16uC1 src_roi(roi.size());
+  src.copyTo(src_roi);
+  dst.setRoi(Roi2u(0u, 0u, dst.width(), dst.height()));
+  for (uint32_t y = 0u; y < dst.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < dst.width(); ++x)
+    {
+      if (x >= roi.x() && x < roi.x() + roi.width()
+          && y >= roi.y() && y < roi.y() + roi.height())
+      {
+        EXPECT_EQ(medianReference(src_roi, x - roi.x(), y - roi.y(), 0u), dst(x, y).x);
+      }
+      else
+      {
+        EXPECT_EQ(7u, dst(x, y).x);
+      }
+    }
+  }
+}
+
+TEST(ImageFilterTest, testBilateralDirect)
+{
+  ImageRaw32fC1 src(41u, 29u);
+  setRandom(src, 1.0f);
+  ImageRaw32fC1 dst(41u, 29u);
+  filterBilateral(dst, src, nullptr, 1, 1.0f, 0.2f, 2);
+  for (uint32_t y = 0u; y < src.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < src.width(); ++x)
+    {
+      EXPECT_NEAR(bilateralReference(src, x, y, 1.0f, 0.2f, 2), dst(x, y).x, 1e-5f);
+    }
+  }
+}
+
+TEST(ImageFilterTest, testBilateralGrid)
+{
+  // Noisy step edge.
+  ImageRaw32fC1 src(96u, 64u);
+  std::mt19937 gen(7u);
+  std::normal_distribution<float> noise(0.0f, 0.05f);
+  for (uint32_t y = 0u; y < src.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < src.width(); ++x)
+    {
+      src(x, y) = ((x < 48u) ? 0.2f : 0.8f) + noise(gen);
+    }
+  }
+  const float sigma_spatial = 3.0f;
+  const float sigma_range = 0.1f;
+  const int radius = 9;
+  ImageRaw32fC1 dst(96u, 64u);
+  filterBilateral(dst, src, nullptr, 1, sigma_spatial, sigma_range, radius);
+
+  double abs_error = 0.0;
+  double noise_after = 0.0;
+  for (uint32_t y = 0u; y < src.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < src.width(); ++x)
+    {
+      const float ref = bilateralReference(src, x, y, sigma_spatial, sigma_range, radius);
+      abs_error += std::abs(ref - dst(x, y).x);
+      noise_after += std::abs(((x < 48u) ? 0.2f : 0.8f) - dst(x, y).x);
+    }
+    // The edge survives.
+    EXPECT_LT(dst(46u, y).x, 0.35f);
+    EXPECT_GT(dst(49u, y).x, 0.65f);
+  }
+  const double numel = src.numel();
+  EXPECT_LT(abs_error / numel, 0.01);
+  // Mean absolute noise of the input is about 0.04.
+  EXPECT_LT(noise_after / numel, 0.015);
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,269 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <ze/common/test_entrypoint.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/image_pyramid.hpp>
+#include <imp/cpu_imgproc/reduce.hpp>
+
+namespace {
+
+using namespace ze;
+
+template<typename Pixel>
+typename ImageRaw<Pixel>::Ptr randomImage(uint32_t width, uint32_t height,
+                                          float max_value, uint32_t seed = 42u)
+{
+  using T = typename Pixel::T;
+  constexpr size_t c_channels = sizeof(Pixel) / sizeof(T);
+  auto img = std::make_shared<ImageRaw<Pixel>>(width, height);
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(0.0f, max_value);
+  for (uint32_t y = 0u; y < height; ++y)
+  {
+    for (uint32_t x = 0u; x < width; ++x)
+    {
+      for (size_t c = 0u; c < c_channels; ++c)
+      {
+        (*img)(x, y).c[c] = static_cast<T>(dist(gen));
+      }
+    }
+  }
+  return img;
+}
+
+//! [1 4 6 4 1] x [1 4 6 4 1] at (2x, 2y), clamped to the given source ROI,
+//! not normalized.
+template<typename Pixel>
+float binomialAt(const Image<Pixel>& img, const Roi2u& roi, int x, int y, size_t c)
+{
+  const float w[5] = {1.0f, 4.0f, 6.0f, 4.0f, 1.0f};
+  float sum = 0.0f;
+  for (int v = -2; v <= 2; ++v)
+  {
+    for (int u = -2; u <= 2; ++u)
+    {
+      const int xx = std::min(std::max(2 * x + u, static_cast<int>(roi.x())),
+                              static_cast<int>(roi.x() + roi.width()) - 1);
+      const int yy = std::min(std::max(2 * y + v, static_cast<int>(roi.y())),
+                              static_cast<int>(roi.y() + roi.height()) - 1);
+      sum += w[u + 2] * w[v + 2] * img(xx, yy).c[c];
+    }
+  }
+  return sum;
+}
+
+} // unnamed namespace
+
+TEST(ImagePyramidCpuTest, testHalfSample8uC1)
+{
+  auto src = randomImage<Pixel8uC1>(75u, 41u, 255.0f);
+  ImageRaw8uC1 dst(38u, 21u);
+  reduce(dst, *src);
+  const Roi2u roi = src->roi();
+  for (uint32_t y = 0u; y < dst.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < dst.width(); ++x)
+    {
+      // Integer rounding must be exact.
+      const int expected = (static_cast<int>(binomialAt(*src, roi, x, y, 0u)) + 128) >> 8;
+      EXPECT_EQ(expected, dst(x, y).x);
+    }
+  }
+}
+
+TEST(ImagePyramidCpuTest, testHalfSample32fC2)
+{
+  auto src = randomImage<Pixel32fC2>(64u, 50u, 1.0f);
+  ImageRaw32fC2 dst(32u, 25u);
+  reduce(dst, *src);
+  const Roi2u roi = src->roi();
+  for (uint32_t y = 0u; y < dst.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < dst.width(); ++x)
+    {
+      EXPECT_NEAR(binomialAt(*src, roi, x, y, 0u) / 256.0f, dst(x, y).c[0], 1e-5f);
+      EXPECT_NEAR(binomialAt(*src, roi, x, y, 1u) / 256.0f, dst(x, y).c[1], 1e-5f);
+    }
+  }
+}
+
+TEST(ImagePyramidCpuTest, testResampleLinearRamp)
+{
+  // Bilinear sampling reproduces a linear ramp at x * sf.
+  ImageRaw32fC1 src(100u, 80u);
+  for (uint32_t y = 0u; y < src.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < src.width(); ++x)
+    {
+      src(x, y) = 2.0f * x + 0.5f * y;
+    }
+  }
+  ImageRaw32fC1 dst(80u, 64u);
+  reduce(dst, src, InterpolationMode::Linear, false);
+  const float sf = 100.0f / 80.0f;
+  for (uint32_t y = 0u; y < dst.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < dst.width(); ++x)
+    {
+      EXPECT_NEAR(2.0f * x * sf + 0.5f * y * sf, dst(x, y).x, 1e-3f);
+    }
+  }
+
+  // Prefiltering keeps a constant image constant.
+  ImageRaw8uC1 constant(100u, 80u);
+  constant.setValue(Pixel8uC1(77u));
+  ImageRaw8uC1 constant_dst(80u, 64u);
+  reduce(constant_dst, constant);
+  for (uint32_t y = 0u; y < constant_dst.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < constant_dst.width(); ++x)
+    {
+      EXPECT_EQ(77u, constant_dst(x, y).x);
+    }
+  }
+}
+
+TEST(ImagePyramidCpuTest, testPyramidSizesAndReuse)
+{
+  auto img = randomImage<Pixel8uC1>(752u, 480u, 255.0f);
+  auto pyr = createImagePyramidCpu<Pixel8uC1>(img, 0.5f, 4u);
+  ASSERT_EQ(4u, pyr->numLevels());
+  EXPECT_EQ(img.get(), &pyr->at(0));
+  EXPECT_EQ(Size2u(376u, 240u), pyr->size(1));
+  EXPECT_EQ(Size2u(188u, 120u), pyr->size(2));
+  EXPECT_EQ(Size2u(94u, 60u), pyr->size(3));
+
+  // A new frame is reduced into the existing level buffers.
+  std::vector<const Pixel8uC1*> buffers;
+  for (size_t i = 1u; i < pyr->numLevels(); ++i)
+  {
+    buffers.push_back(pyr->at(i).data());
+  }
+  auto img2 = randomImage<Pixel8uC1>(752u, 480u, 255.0f, 7u);
+  updateImagePyramidCpu(*pyr, img2);
+  auto ref = createImagePyramidCpu<Pixel8uC1>(img2, 0.5f, 4u);
+  EXPECT_EQ(img2.get(), &pyr->at(0));
+  for (size_t i = 1u; i < pyr->numLevels(); ++i)
+  {
+    EXPECT_EQ(buffers[i - 1u], pyr->at(i).data());
+    for (uint32_t y = 0u; y < pyr->size(i).height(); ++y)
+    {
+      for (uint32_t x = 0u; x < pyr->size(i).width(); ++x)
+      {
+        EXPECT_EQ(ref->at(i)(x, y), pyr->at(i)(x, y));
+      }
+    }
+  }
+
+  // Other factors use the generic resampler.
+  auto pyr_08 = createImagePyramidCpu<Pixel8uC1>(img, 0.8f, 5u);
+  ASSERT_EQ(5u, pyr_08->numLevels());
+  EXPECT_EQ(Size2u(602u, 384u), pyr_08->size(1));
+  EXPECT_EQ(Size2u(308u, 197u), pyr_08->size(4));
+
+  // Their prefiltered levels are kept between updates.
+  std::vector<const Pixel8uC1*> scratch;
+  for (size_t i = 1u; i < pyr_08->numLevels(); ++i)
+  {
+    ASSERT_TRUE(pyr_08->scratch()[i] != nullptr);
+    scratch.push_back(pyr_08->scratch()[i]->data());
+  }
+  updateImagePyramidCpu(*pyr_08, img2);
+  auto ref_08 = createImagePyramidCpu<Pixel8uC1>(img2, 0.8f, 5u);
+  for (size_t i = 1u; i < pyr_08->numLevels(); ++i)
+  {
+    EXPECT_EQ(scratch[i - 1u], pyr_08->scratch()[i]->data());
+    for (uint32_t y = 0u; y < pyr_08->size(i).height(); ++y)
+    {
+      for (uint32_t x = 0u; x < pyr_08->size(i).width(); ++x)
+      {
+        EXPECT_EQ(ref_08->at(i)(x, y), pyr_08->at(i)(x, y));
+      }
+    }
+  }
+}
+
+TEST(ImagePyramidCpuTest, testRoiPropagation)
+{
+  auto full = randomImage<Pixel32fC1>(160u, 120u, 1.0f);
+  auto img = randomImage<Pixel32fC1>(160u, 120u, 1.0f);
+  img->copyFrom(*full);
+  const Roi2u roi(21u, 10u, 90u, 71u);
+  img->setRoi(roi);
+  auto pyr = createImagePyramidCpu<Pixel32fC1>(img, 0.5f, 3u);
+  auto ref = createImagePyramidCpu<Pixel32fC1>(full, 0.5f, 3u);
+
+  // Level 1 contains the pixels x with 2x inside the ROI of level 0.
+  EXPECT_EQ(Roi2u(11u, 5u, 45u, 36u), pyr->at(1).roi());
+  EXPECT_EQ(Roi2u(6u, 3u, 22u, 18u), pyr->at(2).roi());
+
+  // Away from the ROI borders the results equal the full pyramid.
+  const Image32fC1& level1 = pyr->at(1);
+  const Roi2u& r1 = level1.roi();
+  for (uint32_t y = r1.y() + 1u; y + 1u < r1.y() + r1.height(); ++y)
+  {
+    for (uint32_t x = r1.x() + 1u; x + 1u < r1.x() + r1.width(); ++x)
+    {
+      EXPECT_NEAR(ref->at(1)(x, y).x, level1(x, y).x, 1e-5f);
+    }
+  }
+}
+
+TEST(ImagePyramidCpuTest, testRig)
+{
+  constexpr size_t c_num_cameras = 5u;
+  std::vector<ImagePyramid8uC1::Ptr> pyrs;
+  std::vector<Image8uC1::Ptr> imgs;
+  for (size_t i = 0u; i < c_num_cameras; ++i)
+  {
+    pyrs.push_back(createImagePyramidCpu<Pixel8uC1>(
+                     randomImage<Pixel8uC1>(320u, 240u, 255.0f, i), 0.5f, 4u));
+    imgs.push_back(randomImage<Pixel8uC1>(320u, 240u, 255.0f, 100u + i));
+  }
+  updateImagePyramidsCpu(pyrs, imgs);
+  for (size_t i = 0u; i < c_num_cameras; ++i)
+  {
+    auto ref = createImagePyramidCpu<Pixel8uC1>(imgs[i], 0.5f, 4u);
+    EXPECT_EQ(imgs[i].get(), &pyrs[i]->at(0));
+    for (size_t l = 1u; l < ref->numLevels(); ++l)
+    {
+      for (uint32_t y = 0u; y < ref->size(l).height(); ++y)
+      {
+        for (uint32_t x = 0u; x < ref->size(l).width(); ++x)
+        {
+          EXPECT_EQ(ref->at(l)(x, y), pyrs[i]->at(l)(x, y));
+        }
+      }
+    }
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,219 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cmath>
+
+#include <ze/common/test_entrypoint.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/horizontal_stereo_pair_rectifier.hpp>
+#include <imp/cpu_imgproc/stereo_rectification.hpp>
+
+namespace {
+
+using namespace ze;
+
+constexpr uint32_t c_width = 752u;
+constexpr uint32_t c_height = 480u;
+
+Vector4 cameraParams(real_t fx, real_t cx)
+{
+  return (Vector4() << fx, fx + 0.1, cx, 228.63874151).finished();
+}
+
+Vector4 distortionParams()
+{
+  return (Vector4() << -0.28340811, 0.07395907, 0.00019359, 1.76187114e-05).finished();
+}
+
+//! T_cam1_cam0 of a rig with an 11cm baseline and a slight misalignment.
+Transformation stereoExtrinsics()
+{
+  const Quaternion q = Quaternion::exp(Vector3(0.01, -0.02, 0.005));
+  return Transformation(q, Vector3(-0.11, 0.002, -0.001));
+}
+
+template<typename Pixel>
+ImageRaw<Pixel> testImage(const Size2u& size, uint32_t seed)
+{
+  ImageRaw<Pixel> img(size);
+  for (uint32_t y = 0u; y < size.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < size.width(); ++x)
+    {
+      img(x, y).x = static_cast<typename Pixel::T>(
+            127.5f + 127.0f * std::sin(0.05f * x + seed) * std::cos(0.07f * y));
+    }
+  }
+  return img;
+}
+
+//! Rectified pixel of a pixel in the original image.
+Vector2 rectifyPoint(const Vector2& px, const Vector4& cam_params,
+                     const Vector4& dist_coeffs, const Matrix3& H,
+                     const Vector4& transformed_cam_params)
+{
+  Vector3 p(px(0), px(1), 1.0);
+  PinholeGeometry::backProject(cam_params.data(), p.data());
+  RadialTangentialDistortion::undistort(dist_coeffs.data(), p.data());
+  p = H * Vector3(p(0), p(1), 1.0);
+  p /= p(2);
+  PinholeGeometry::project(transformed_cam_params.data(), p.data());
+  return p.head<2>();
+}
+
+} // unnamed namespace
+
+TEST(StereoRectifierCpuTest, horizontalStereoPairMaps)
+{
+  const Size2u size(c_width, c_height);
+  const Vector4 cam0_params = cameraParams(471.69, 371.09);
+  const Vector4 cam1_params = cameraParams(470.12, 368.45);
+  const Vector4 dist_coeffs = distortionParams();
+  const Transformation T_cam1_cam0 = stereoExtrinsics();
+
+  Vector4 transformed_cam0_params;
+  Vector4 transformed_cam1_params;
+  real_t horizontal_offset;
+  HorizontalStereoPairRectifierRadTan32fC1 rectifier(
+        transformed_cam0_params, transformed_cam1_params, horizontal_offset,
+        size, cam0_params, dist_coeffs, cam1_params, dist_coeffs, T_cam1_cam0);
+
+  Matrix3 cam0_H, cam1_H;
+  std::tie(cam0_H, cam1_H, std::ignore, std::ignore, std::ignore) =
+      computeHorizontalStereoParameters<PinholeGeometry, RadialTangentialDistortion>(
+        size, cam0_params, dist_coeffs, cam1_params, dist_coeffs, T_cam1_cam0);
+
+  // A landmark seen by both cameras lies on the same row of the rectified
+  // pair, and the maps point back to where it was observed.
+  const ImageRaw32fC2& map0 = rectifier.getUndistortRectifyMap(0);
+  const ImageRaw32fC2& map1 = rectifier.getUndistortRectifyMap(1);
+  for (real_t x : {-0.8, -0.3, 0.1, 0.6})
+  {
+    for (real_t y : {-0.4, 0.0, 0.35})
+    {
+      const Vector3 p_cam0(x, y, 2.5);
+      const Vector3 p_cam1 = T_cam1_cam0.transform(p_cam0);
+      Vector2 px0 = p_cam0.head<2>() / p_cam0(2);
+      Vector2 px1 = p_cam1.head<2>() / p_cam1(2);
+      RadialTangentialDistortion::distort(dist_coeffs.data(), px0.data());
+      RadialTangentialDistortion::distort(dist_coeffs.data(), px1.data());
+      PinholeGeometry::project(cam0_params.data(), px0.data());
+      PinholeGeometry::project(cam1_params.data(), px1.data());
+
+      const Vector2 rect0 =
+          rectifyPoint(px0, cam0_params, dist_coeffs, cam0_H, transformed_cam0_params);
+      const Vector2 rect1 =
+          rectifyPoint(px1, cam1_params, dist_coeffs, cam1_H, transformed_cam1_params);
+      EXPECT_NEAR(rect0(1), rect1(1), 0.01);
+
+      const Pixel32fC2& m0 = map0(std::lround(rect0(0)), std::lround(rect0(1)));
+      const Pixel32fC2& m1 = map1(std::lround(rect1(0)), std::lround(rect1(1)));
+      EXPECT_NEAR(px0(0), m0.x, 1.0);
+      EXPECT_NEAR(px0(1), m0.y, 1.0);
+      EXPECT_NEAR(px1(0), m1.x, 1.0);
+      EXPECT_NEAR(px1(1), m1.y, 1.0);
+    }
+  }
+}
+
+TEST(StereoRectifierCpuTest, pairAndHalfResolution8uC1)
+{
+  const Size2u size(c_width, c_height);
+  const Vector4 cam0_params = cameraParams(471.69, 371.09);
+  const Vector4 cam1_params = cameraParams(470.12, 368.45);
+  const Vector4 dist_coeffs = distortionParams();
+
+  Vector4 transformed_cam0_params;
+  Vector4 transformed_cam1_params;
+  real_t horizontal_offset;
+  HorizontalStereoPairRectifierRadTan8uC1 rectifier(
+        transformed_cam0_params, transformed_cam1_params, horizontal_offset,
+        size, cam0_params, dist_coeffs, cam1_params, dist_coeffs,
+        stereoExtrinsics());
+
+  const ImageRaw8uC1 src0 = testImage<Pixel8uC1>(size, 0u);
+  const ImageRaw8uC1 src1 = testImage<Pixel8uC1>(size, 1u);
+  ImageRaw8uC1 dst0(size), dst1(size);
+  ImageRaw8uC1 half0(size.width() / 2u, size.height() / 2u);
+  ImageRaw8uC1 half1(size.width() / 2u, size.height() / 2u);
+  rectifier.rectify(dst0, dst1, half0, half1, src0, src1);
+
+  // Same as remapping each camera on its own.
+  ImageRaw8uC1 ref0(size), ref1(size);
+  RemapTable(rectifier.getUndistortRectifyMap(0), size).remap(ref0, src0);
+  RemapTable(rectifier.getUndistortRectifyMap(1), size).remap(ref1, src1);
+  for (uint32_t y = 0u; y < size.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < size.width(); ++x)
+    {
+      ASSERT_EQ(ref0(x, y).x, dst0(x, y).x);
+      ASSERT_EQ(ref1(x, y).x, dst1(x, y).x);
+    }
+  }
+  for (uint32_t y = 0u; y < half0.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < half0.width(); ++x)
+    {
+      const int sum0 = dst0(2u*x, 2u*y).x + dst0(2u*x+1u, 2u*y).x
+                       + dst0(2u*x, 2u*y+1u).x + dst0(2u*x+1u, 2u*y+1u).x;
+      const int sum1 = dst1(2u*x, 2u*y).x + dst1(2u*x+1u, 2u*y).x
+                       + dst1(2u*x, 2u*y+1u).x + dst1(2u*x+1u, 2u*y+1u).x;
+      ASSERT_EQ((sum0 + 2) / 4, half0(x, y).x);
+      ASSERT_EQ((sum1 + 2) / 4, half1(x, y).x);
+    }
+  }
+}
+
+TEST(StereoRectifierCpuTest, halfResolutionOddSize32fC1)
+{
+  const Size2u size(101u, 51u);
+  const Vector4 cam_params = (Vector4() << 60.0, 60.0, 50.0, 25.0).finished();
+  const Vector4 dist_coeffs = Vector4::Zero();
+  RadTanStereoRectifier32fC1 rectifier(
+        size, cam_params, cam_params, dist_coeffs, Matrix3::Identity());
+
+  const ImageRaw32fC1 src = testImage<Pixel32fC1>(size, 0u);
+  ImageRaw32fC1 dst(size);
+  ImageRaw32fC1 half(50u, 25u);
+  rectifier.rectify(dst, half, src);
+  for (uint32_t y = 0u; y < size.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < size.width(); ++x)
+    {
+      EXPECT_NEAR(src(x, y).x, dst(x, y).x, 1e-3f);
+    }
+  }
+  for (uint32_t y = 0u; y < half.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < half.width(); ++x)
+    {
+      const float mean = 0.25f * (src(2u*x, 2u*y).x + src(2u*x+1u, 2u*y).x
+                                  + src(2u*x, 2u*y+1u).x + src(2u*x+1u, 2u*y+1u).x);
+      EXPECT_NEAR(mean, half(x, y).x, 1e-3f);
+    }
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
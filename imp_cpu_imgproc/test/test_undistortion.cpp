@@ -0,0 +1,196 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cmath>
+#include <random>
+
+#include <ze/common/test_entrypoint.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/remap.hpp>
+#include <imp/cpu_imgproc/undistortion.hpp>
+
+namespace {
+
+using namespace ze;
+
+constexpr uint32_t c_width = 752u;
+constexpr uint32_t c_height = 480u;
+
+VectorX cameraParams()
+{
+  VectorX cam_params(4);
+  cam_params << 471.690643292, 471.765601046, 371.087464172, 228.63874151;
+  return cam_params;
+}
+
+//! Smooth image with some texture, values in [0, 255].
+template<typename Pixel>
+ImageRaw<Pixel> testImage()
+{
+  ImageRaw<Pixel> img(c_width, c_height);
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      img(x, y).x = static_cast<typename Pixel::T>(
+            127.5f + 127.0f * std::sin(0.05f * x) * std::cos(0.07f * y));
+    }
+  }
+  return img;
+}
+
+//! Bilinear interpolation at a clamped position.
+template<typename Pixel>
+float bilinear(const Image<Pixel>& img, float x, float y)
+{
+  x = std::min(std::max(x, 0.0f), img.width() - 1.0f);
+  y = std::min(std::max(y, 0.0f), img.height() - 1.0f);
+  const uint32_t x0 = std::min(static_cast<uint32_t>(x), img.width() - 2u);
+  const uint32_t y0 = std::min(static_cast<uint32_t>(y), img.height() - 2u);
+  const float wx = x - x0;
+  const float wy = y - y0;
+  return (1.0f - wy) * ((1.0f - wx) * img(x0, y0).x + wx * img(x0 + 1u, y0).x)
+         + wy * ((1.0f - wx) * img(x0, y0 + 1u).x + wx * img(x0 + 1u, y0 + 1u).x);
+}
+
+} // unnamed namespace
+
+TEST(ImageUndistorterCpuTest, radTan32fC1_zeroDistortion)
+{
+  VectorX dist_coeffs(4);
+  dist_coeffs << 0.0, 0.0, 0.0, 0.0;
+  ImageRaw32fC1 src = testImage<Pixel32fC1>();
+  ImageRaw32fC1 dst(src.size());
+  RadTanUndistort32fC1 undistorter(src.size(), cameraParams(), dist_coeffs);
+  undistorter.undistort(dst, src);
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      EXPECT_FLOAT_EQ(src(x, y).x, dst(x, y).x);
+    }
+  }
+}
+
+TEST(ImageUndistorterCpuTest, equidist_testMap)
+{
+  VectorX dist_coeffs(4);
+  dist_coeffs << 0.00676530475436, -0.000811126898338, 0.0166458761987, -0.0172655346139;
+  EquidistUndistort32fC1 undistorter(Size2u(c_width, c_height), cameraParams(), dist_coeffs);
+
+  Eigen::VectorXf cp_flt = cameraParams().cast<float>();
+  Eigen::VectorXf dist_flt = dist_coeffs.cast<float>();
+  const ImageRaw32fC2& map = undistorter.getUndistortionMap();
+  const RemapTable& table = undistorter.getRemapTable();
+  const float quantization = 0.5f / RemapTable::c_frac_steps + 1e-4f;
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      float px[2] = {static_cast<float>(x), static_cast<float>(y)};
+      PinholeGeometry::backProject(cp_flt.data(), px);
+      EquidistantDistortion::distort(dist_flt.data(), px);
+      PinholeGeometry::project(cp_flt.data(), px);
+      EXPECT_NEAR(px[0], map(x, y).x, 0.0005);
+      EXPECT_NEAR(px[1], map(x, y).y, 0.0005);
+      if (px[0] >= 0.0f && px[0] <= c_width - 1.0f
+          && px[1] >= 0.0f && px[1] <= c_height - 1.0f)
+      {
+        const Pixel32fC2 quantized = table.sourcePosition(x, y);
+        EXPECT_NEAR(px[0], quantized.x, quantization);
+        EXPECT_NEAR(px[1], quantized.y, quantization);
+      }
+    }
+  }
+}
+
+TEST(ImageUndistorterCpuTest, radTan8uC1And32fC1)
+{
+  VectorX dist_coeffs(4);
+  dist_coeffs << -0.28340811, 0.07395907, 0.00019359, 1.76187114e-05;
+  const Size2u size(c_width, c_height);
+  RadTanUndistort8uC1 undistorter_8u(size, cameraParams(), dist_coeffs);
+  RadTanUndistort32fC1 undistorter_32f(size, cameraParams(), dist_coeffs);
+  ImageRaw8uC1 src_8u = testImage<Pixel8uC1>();
+  ImageRaw32fC1 src_32f = testImage<Pixel32fC1>();
+  ImageRaw8uC1 dst_8u(size);
+  ImageRaw32fC1 dst_32f(size);
+  undistorter_8u.undistort(dst_8u, src_8u);
+  undistorter_32f.undistort(dst_32f, src_32f);
+
+  const RemapTable& table = undistorter_32f.getRemapTable();
+  const ImageRaw32fC2& map = undistorter_32f.getUndistortionMap();
+  double abs_error_sum = 0.0;
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      // Exact for the quantized positions.
+      const Pixel32fC2 q = table.sourcePosition(x, y);
+      EXPECT_NEAR(bilinear(src_32f, q.x, q.y), dst_32f(x, y).x, 1e-3f);
+      EXPECT_NEAR(bilinear(src_8u, q.x, q.y), dst_8u(x, y).x, 0.5f + 1e-3f);
+      abs_error_sum += std::abs(bilinear(src_32f, map(x, y).x, map(x, y).y)
+                                - dst_32f(x, y).x);
+    }
+  }
+  // Quantization error relative to the float map, the test image changes by
+  // at most about 9 per pixel.
+  EXPECT_LT(abs_error_sum / size.area(), 0.1);
+}
+
+TEST(RemapTableTest, testPitchedAndBorder)
+{
+  // Shifts by (-1.5, 0.25) on a pitched source, positions outside are
+  // clamped to the border.
+  ImageRaw32fC2 map(20u, 10u);
+  for (uint32_t y = 0u; y < map.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < map.width(); ++x)
+    {
+      map(x, y) = Pixel32fC2(x - 1.5f, y + 0.25f);
+    }
+  }
+  std::vector<Pixel32fC1> data(32u * 10u, Pixel32fC1(-1.0f));
+  ImageRaw32fC1 src(data.data(), 20u, 10u, 32u * sizeof(Pixel32fC1), true);
+  for (uint32_t y = 0u; y < src.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < src.width(); ++x)
+    {
+      src(x, y) = static_cast<float>(x + 100u * y);
+    }
+  }
+  RemapTable table(map, src.size());
+  ImageRaw32fC1 dst(20u, 10u);
+  table.remap(dst, src);
+  for (uint32_t y = 0u; y < dst.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < dst.width(); ++x)
+    {
+      EXPECT_NEAR(bilinear(src, x - 1.5f, y + 0.25f), dst(x, y).x, 1e-3f);
+    }
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,246 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+
+#include <ze/common/test_entrypoint.hpp>
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/rof_denoising.hpp>
+#include <imp/cpu_imgproc/tvl1_denoising.hpp>
+
+namespace {
+
+using namespace ze;
+
+constexpr uint32_t c_width = 97u;
+constexpr uint32_t c_height = 70u;
+
+//! Piecewise constant image in [0, 1] and a noisy copy.
+void testImages(ImageRaw32fC1& clean, ImageRaw32fC1& noisy)
+{
+  std::mt19937 gen(42);
+  std::normal_distribution<float> noise(0.0f, 0.1f);
+  for (uint32_t y = 0u; y < clean.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < clean.width(); ++x)
+    {
+      const float v = (x < 40u) ? 0.2f : ((y < 30u) ? 0.8f : 0.5f);
+      clean(x, y) = v;
+      noisy(x, y) = v + noise(gen);
+    }
+  }
+}
+
+double meanAbsDiff(const ImageRaw32fC1& a, const ImageRaw32fC1& b)
+{
+  double sum = 0.0;
+  for (uint32_t y = 0u; y < a.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < a.width(); ++x)
+    {
+      sum += std::abs(a(x, y).x - b(x, y).x);
+    }
+  }
+  return sum / a.size().area();
+}
+
+//! Straightforward port of the CUDA kernels: full dual update, then full
+//! primal update with the given proximal map.
+ImageRaw32fC1 referencePrimalDual(
+    const ImageRaw32fC1& f, int iterations, float lambda, float tau, float sigma,
+    const std::function<float(float, float, float)>& prox)
+{
+  const int w = f.width();
+  const int h = f.height();
+  ImageRaw32fC1 u(f.size()), u_bar(f.size()), p_x(f.size()), p_y(f.size());
+  u.copyFrom(f);
+  u_bar.copyFrom(f);
+  p_x.setValue(Pixel32fC1(0.0f));
+  p_y.setValue(Pixel32fC1(0.0f));
+  auto val = [&](const ImageRaw32fC1& img, int x, int y)
+  {
+    return img(std::min(std::max(x, 0), w - 1), std::min(std::max(y, 0), h - 1)).x;
+  };
+  for (int iter = 0; iter < iterations; ++iter)
+  {
+    const float theta = 1.0f / std::sqrt(1.0f + 0.7f * lambda * tau);
+    for (int y = 0; y < h; ++y)
+    {
+      for (int x = 0; x < w; ++x)
+      {
+        const float px = p_x(x, y).x + sigma * (val(u_bar, x + 1, y) - u_bar(x, y).x);
+        const float py = p_y(x, y).x + sigma * (val(u_bar, x, y + 1) - u_bar(x, y).x);
+        const float scale = 1.0f / std::max(1.0f, std::sqrt(px * px + py * py));
+        p_x(x, y) = px * scale;
+        p_y(x, y) = py * scale;
+      }
+    }
+    for (int y = 0; y < h; ++y)
+    {
+      for (int x = 0; x < w; ++x)
+      {
+        const float c_x = (x == w - 1) ? 0.0f : p_x(x, y).x;
+        const float w_x = (x == 0) ? 0.0f : p_x(x - 1, y).x;
+        const float c_y = (y == h - 1) ? 0.0f : p_y(x, y).x;
+        const float n_y = (y == 0) ? 0.0f : p_y(x, y - 1).x;
+        const float div = c_x - w_x + c_y - n_y;
+        const float u_prev = u(x, y).x;
+        const float u_new = prox(u_prev + tau * div, f(x, y).x, tau);
+        u(x, y) = u_new;
+        u_bar(x, y) = u_new + theta * (u_new - u_prev);
+      }
+    }
+    sigma /= theta;
+    tau *= theta;
+  }
+  return u;
+}
+
+} // unnamed namespace
+
+TEST(VariationalDenoisingCpuTest, rofMatchesReference)
+{
+  auto clean = std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  auto noisy = std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  auto denoised = std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  testImages(*clean, *noisy);
+
+  RofDenoising32fC1 rof;
+  rof.params().lambda = 8.0f;
+  rof.params().max_iter = 50;
+  rof.denoise(denoised, noisy);
+  EXPECT_EQ(50, rof.numIterations());
+
+  const float lambda = rof.params().lambda;
+  ImageRaw32fC1 reference = referencePrimalDual(
+        *noisy, 50, lambda, 1.0f / std::sqrt(8.0f), 1.0f / std::sqrt(8.0f),
+        [lambda](float u, float f, float tau)
+  {
+    return (u + tau * lambda * f) / (1.0f + tau * lambda);
+  });
+  EXPECT_LT(meanAbsDiff(reference, *denoised), 1e-6);
+  EXPECT_LT(meanAbsDiff(*clean, *denoised), 0.5 * meanAbsDiff(*clean, *noisy));
+}
+
+TEST(VariationalDenoisingCpuTest, tvl1MatchesReference)
+{
+  auto clean = std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  auto noisy = std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  auto denoised = std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  testImages(*clean, *noisy);
+
+  TvL1Denoising32fC1 tvl1;
+  tvl1.params().lambda = 1.5f;
+  tvl1.params().max_iter = 50;
+  tvl1.denoise(denoised, noisy);
+
+  const float lambda = tvl1.params().lambda;
+  ImageRaw32fC1 reference = referencePrimalDual(
+        *noisy, 50, lambda, 1.0f / 8.0f, 1.0f / std::sqrt(8.0f),
+        [lambda](float u, float f, float tau)
+  {
+    const float tau_lambda = tau * lambda;
+    const float residual = u - f;
+    return (residual < -tau_lambda) ? u + tau_lambda
+                                    : (residual > tau_lambda) ? u - tau_lambda : f;
+  });
+  EXPECT_LT(meanAbsDiff(reference, *denoised), 1e-6);
+}
+
+TEST(VariationalDenoisingCpuTest, incrementalPrimalDualGap)
+{
+  auto clean = std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  auto noisy = std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  auto denoised = std::make_shared<ImageRaw32fC1>(c_width, c_height);
+  testImages(*clean, *noisy);
+
+  // Check the energies on the last iteration only, with a tolerance that is
+  // not reached, and compare to a full evaluation of the final state.
+  RofDenoising32fC1 rof;
+  rof.params().max_iter = 30;
+  rof.params().primal_dual_energy_check_iter = 30;
+  rof.params().primal_dual_gap_tolerance = 1e-12;
+  rof.denoise(denoised, noisy);
+  EXPECT_EQ(30, rof.numIterations());
+  double primal_energy, dual_energy;
+  rof.primalDualEnergy(primal_energy, dual_energy);
+  EXPECT_GE(primal_energy, dual_energy);
+  EXPECT_NEAR((primal_energy - dual_energy) / clean->size().area(),
+              rof.primalDualGap(), 1e-5);
+
+  TvL1Denoising32fC1 tvl1;
+  tvl1.params().lambda = 1.5f;
+  tvl1.params().max_iter = 30;
+  tvl1.params().primal_dual_energy_check_iter = 30;
+  tvl1.params().primal_dual_gap_tolerance = 1e-12;
+  tvl1.denoise(denoised, noisy);
+  tvl1.primalDualEnergy(primal_energy, dual_energy);
+  EXPECT_GE(primal_energy, dual_energy);
+  EXPECT_NEAR((primal_energy - dual_energy) / clean->size().area(),
+              tvl1.primalDualGap(), 1e-5);
+}
+
+TEST(VariationalDenoisingCpuTest, earlyExit8uC1)
+{
+  ImageRaw32fC1 clean(c_width, c_height);
+  ImageRaw32fC1 noisy_32f(c_width, c_height);
+  testImages(clean, noisy_32f);
+  auto noisy = std::make_shared<ImageRaw8uC1>(c_width, c_height);
+  auto denoised = std::make_shared<ImageRaw8uC1>(c_width, c_height);
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      noisy->pixel(x, y) = static_cast<uint8_t>(
+            std::min(std::max(noisy_32f(x, y).x, 0.0f), 1.0f) * 255.0f + 0.5f);
+    }
+  }
+
+  RofDenoising8uC1 rof;
+  rof.params().max_iter = 500;
+  rof.params().primal_dual_energy_check_iter = 10;
+  rof.params().primal_dual_gap_tolerance = 1e-3;
+  rof.denoise(denoised, noisy);
+  EXPECT_LT(rof.numIterations(), 500);
+  EXPECT_EQ(0, rof.numIterations() % 10);
+  EXPECT_GE(rof.primalDualGap(), 0.0);
+  EXPECT_LT(rof.primalDualGap(), 1e-3);
+
+  double error_noisy = 0.0, error_denoised = 0.0;
+  for (uint32_t y = 0u; y < c_height; ++y)
+  {
+    for (uint32_t x = 0u; x < c_width; ++x)
+    {
+      error_noisy += std::abs(noisy->pixel(x, y).x - 255.0f * clean(x, y).x);
+      error_denoised += std::abs(denoised->pixel(x, y).x - 255.0f * clean(x, y).x);
+    }
+  }
+  EXPECT_LT(error_denoised, 0.5 * error_noisy);
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -24,17 +24,12 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <imp/core/variational_stereo_params.hpp>
+
 namespace ze {
 namespace cu {
 
-enum class StereoPDSolver
-{
-  HuberL1, //!< Huber regularization + pointwise L1 intensity matching costs
-  PrecondHuberL1, //!< Huber regularization + pointwise L1 intensity matching costs
-  PrecondHuberL1Weighted, //!< weighted Huber regularization + pointwise L1 intensity matching costs
-  EpipolarPrecondHuberL1 //!< Huber regularization + pointwise L1 intensity matching costs applied on generic images with known epipolar geometry (not rectified)
-};
+using StereoPDSolver = ze::StereoPDSolver;
 
 } // namespace cu
 } // namespace ze
-
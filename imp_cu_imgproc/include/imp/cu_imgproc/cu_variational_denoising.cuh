@@ -27,6 +27,7 @@
 #include <memory>
 #include <cuda_runtime_api.h>
 #include <imp/core/image_base.hpp>
+#include <imp/core/variational_denoising_params.hpp>
 #include <imp/cu_core/cu_image_gpu.cuh>
 #include <imp/cu_core/cu_utils.hpp>
 #include <ze/common/macros.hpp>
@@ -37,13 +38,7 @@ namespace cu {
 // forward declarations
 class Texture2D;
 
-struct VariationalDenoisingParams
-{
-  float lambda = 10.f;
-  std::uint16_t max_iter = 100;
-  std::uint16_t primal_dual_energy_check_iter = 0;
-  double primal_dual_gap_tolerance = 0.0;
-};
+using VariationalDenoisingParams = ze::VariationalDenoisingParams;
 
 /**
  * @brief The VariationalDenoising class
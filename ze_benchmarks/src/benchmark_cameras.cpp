@@ -0,0 +1,193 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <functional>
+
+#include <ze/cameras/camera_impl.hpp>
+#include <ze/cameras/camera_utils.hpp>
+#include <ze/common/auto_diff.hpp>
+#include <ze/common/benchmark.hpp>
+#include <ze/common/numerical_derivative.hpp>
+
+namespace ze {
+namespace {
+
+template<typename CameraType>
+void benchmarkProjectVectorized(const CameraType& cam, BenchmarkState& state)
+{
+  const Keypoints px = generateRandomKeypoints(cam.size(), 10u, state.arg());
+  const Bearings f = cam.backProjectVectorized(px);
+  Keypoints px_projected(2, px.cols());
+  while (state.keepRunning())
+  {
+    px_projected = cam.projectVectorized(f);
+    doNotOptimizeAway(px_projected);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+
+template<typename CameraType>
+void benchmarkBackProjectVectorized(const CameraType& cam, BenchmarkState& state)
+{
+  const Keypoints px = generateRandomKeypoints(cam.size(), 10u, state.arg());
+  Bearings f(3, px.cols());
+  while (state.keepRunning())
+  {
+    f = cam.backProjectVectorized(px);
+    doNotOptimizeAway(f);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+
+//! Jacobian of the projection with respect to the landmark, computed with the
+//! analytical, the automatic and the numerical derivative.
+enum class JacobianMethod { Analytical, AutoDiff, Numerical };
+
+template<class Distortion>
+void benchmarkProjectJacobian(const PinholeProjection<Distortion>& cam,
+                              JacobianMethod method, BenchmarkState& state)
+{
+  const Keypoints px = generateRandomKeypoints(cam.size(), 10u, state.arg());
+  const Bearings f = cam.backProjectVectorized(px);
+  const std::function<Keypoint(const Vector3&)> project =
+      [&cam](const Vector3& pos) -> Keypoint { return cam.project(pos); };
+  const ProjectFunctor<Distortion> project_functor(cam);
+  Matrix23 J;
+  while (state.keepRunning())
+  {
+    for (int i = 0; i < f.cols(); ++i)
+    {
+      const Vector3 pos = f.col(i);
+      switch (method)
+      {
+        case JacobianMethod::Analytical:
+          J = cam.dProject_dLandmark(pos);
+          break;
+        case JacobianMethod::AutoDiff:
+          J = autoDiff(project_functor, pos);
+          break;
+        case JacobianMethod::Numerical:
+          J = numericalDerivative<Vector2, Vector3>(project, pos);
+          break;
+      }
+      doNotOptimizeAway(J);
+    }
+  }
+  state.setItemsPerIteration(state.arg());
+}
+
+PinholeCamera pinholeCamera()
+{
+  return createPinholeCamera(752, 480, 310, 320, 376.0, 240.0);
+}
+
+FovCamera fovCamera()
+{
+  return createFovCamera(752, 480, 310, 320, 376.0, 240.0, 0.947367);
+}
+
+RadTanCamera radTanCamera()
+{
+  return createRadTanCamera(752, 480, 310, 320, 376.0, 240.0,
+                            -0.2834, 0.0739, 0.00019, 1.76e-05);
+}
+
+EquidistantCamera equidistantCamera()
+{
+  return createEquidistantCamera(752, 480, 310, 320, 376.0, 240.0,
+                                 -0.00279, 0.02414, -0.04304, 0.03118);
+}
+
+void benchmarkProjectPinhole(BenchmarkState& state)
+{
+  benchmarkProjectVectorized(pinholeCamera(), state);
+}
+ZE_BENCHMARK(benchmarkProjectPinhole, "cameras/pinhole/project")->args({100, 1000});
+
+void benchmarkBackProjectPinhole(BenchmarkState& state)
+{
+  benchmarkBackProjectVectorized(pinholeCamera(), state);
+}
+ZE_BENCHMARK(benchmarkBackProjectPinhole, "cameras/pinhole/back_project")->args({100, 1000});
+
+void benchmarkProjectFov(BenchmarkState& state)
+{
+  benchmarkProjectVectorized(fovCamera(), state);
+}
+ZE_BENCHMARK(benchmarkProjectFov, "cameras/fov/project")->args({100, 1000});
+
+void benchmarkBackProjectFov(BenchmarkState& state)
+{
+  benchmarkBackProjectVectorized(fovCamera(), state);
+}
+ZE_BENCHMARK(benchmarkBackProjectFov, "cameras/fov/back_project")->args({100, 1000});
+
+void benchmarkProjectRadTan(BenchmarkState& state)
+{
+  benchmarkProjectVectorized(radTanCamera(), state);
+}
+ZE_BENCHMARK(benchmarkProjectRadTan, "cameras/radtan/project")->args({100, 1000});
+
+void benchmarkBackProjectRadTan(BenchmarkState& state)
+{
+  benchmarkBackProjectVectorized(radTanCamera(), state);
+}
+ZE_BENCHMARK(benchmarkBackProjectRadTan, "cameras/radtan/back_project")->args({100, 1000});
+
+void benchmarkProjectEquidistant(BenchmarkState& state)
+{
+  benchmarkProjectVectorized(equidistantCamera(), state);
+}
+ZE_BENCHMARK(benchmarkProjectEquidistant, "cameras/equidistant/project")->args({100, 1000});
+
+void benchmarkBackProjectEquidistant(BenchmarkState& state)
+{
+  benchmarkBackProjectVectorized(equidistantCamera(), state);
+}
+ZE_BENCHMARK(benchmarkBackProjectEquidistant, "cameras/equidistant/back_project")->args({100, 1000});
+
+void benchmarkJacobianAnalyticalRadTan(BenchmarkState& state)
+{
+  benchmarkProjectJacobian(radTanCamera(), JacobianMethod::Analytical, state);
+}
+ZE_BENCHMARK(benchmarkJacobianAnalyticalRadTan,
+             "cameras/radtan/d_project_d_landmark/analytical")->args({1000});
+
+void benchmarkJacobianAutoDiffRadTan(BenchmarkState& state)
+{
+  benchmarkProjectJacobian(radTanCamera(), JacobianMethod::AutoDiff, state);
+}
+ZE_BENCHMARK(benchmarkJacobianAutoDiffRadTan,
+             "cameras/radtan/d_project_d_landmark/auto_diff")->args({1000});
+
+void benchmarkJacobianNumericalRadTan(BenchmarkState& state)
+{
+  benchmarkProjectJacobian(radTanCamera(), JacobianMethod::Numerical, state);
+}
+ZE_BENCHMARK(benchmarkJacobianNumericalRadTan,
+             "cameras/radtan/d_project_d_landmark/numerical")->args({1000});
+
+} // anonymous namespace
+} // namespace ze
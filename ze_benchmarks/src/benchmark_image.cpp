@@ -0,0 +1,193 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstring>
+#include <vector>
+
+#include <imp/core/image_raw.hpp>
+#include <imp/core/image_view.hpp>
+#include <ze/common/benchmark.hpp>
+
+namespace ze {
+namespace {
+
+//! Image of arg x (3/4 arg) pixels with 64 bytes of padding per row, so that
+//! copies cannot fall back to a single contiguous block.
+struct PitchedImage
+{
+  PitchedImage(int64_t width)
+    : width(width)
+    , height(width * 3 / 4)
+    , stride(width + 64)
+    , data(stride * height, Pixel32fC1(1.0f))
+    , image(data.data(), width, height, stride * sizeof(Pixel32fC1), true)
+  {}
+
+  uint32_t width;
+  uint32_t height;
+  uint32_t stride;
+  std::vector<Pixel32fC1> data;
+  ImageRaw32fC1 image;
+};
+
+void benchmarkImageSumPixelAccessor(BenchmarkState& state)
+{
+  PitchedImage src(state.arg());
+  const Image32fC1& img = src.image;
+  while (state.keepRunning())
+  {
+    float sum = 0.0f;
+    for (uint32_t y = 0u; y < img.height(); ++y)
+    {
+      for (uint32_t x = 0u; x < img.width(); ++x)
+      {
+        sum += img.pixel(x, y);
+      }
+    }
+    doNotOptimizeAway(sum);
+  }
+  state.setItemsPerIteration(src.image.numel());
+}
+ZE_BENCHMARK(benchmarkImageSumPixelAccessor, "image/sum/pixel_accessor")->args({640, 1920});
+
+void benchmarkImageSumView(BenchmarkState& state)
+{
+  PitchedImage src(state.arg());
+  const Image32fC1& img = src.image;
+  while (state.keepRunning())
+  {
+    float sum = 0.0f;
+    ConstImageView<Pixel32fC1> view = img.view();
+    for (uint32_t y = 0u; y < view.height(); ++y)
+    {
+      for (const Pixel32fC1& px : view.row(y))
+      {
+        sum += px;
+      }
+    }
+    doNotOptimizeAway(sum);
+  }
+  state.setItemsPerIteration(src.image.numel());
+}
+ZE_BENCHMARK(benchmarkImageSumView, "image/sum/view")->args({640, 1920});
+
+//! The former Image::copyTo() fallback for images with different pitches.
+void benchmarkImageCopyPixelLoop(BenchmarkState& state)
+{
+  PitchedImage src(state.arg());
+  ImageRaw32fC1 dst(src.width, src.height);
+  while (state.keepRunning())
+  {
+    for (uint32_t y = 0u; y < src.image.height(); ++y)
+    {
+      for (uint32_t x = 0u; x < src.image.width(); ++x)
+      {
+        dst[y][x] = src.image.pixel(x, y);
+      }
+    }
+    doNotOptimizeAway(dst);
+  }
+  state.setItemsPerIteration(src.image.numel());
+}
+ZE_BENCHMARK(benchmarkImageCopyPixelLoop, "image/copy_pitched/pixel_loop")->args({640, 1920});
+
+void benchmarkImageCopyView(BenchmarkState& state)
+{
+  PitchedImage src(state.arg());
+  ImageRaw32fC1 dst(src.width, src.height);
+  while (state.keepRunning())
+  {
+    src.image.copyTo(dst);
+    doNotOptimizeAway(dst);
+  }
+  state.setItemsPerIteration(src.image.numel());
+}
+ZE_BENCHMARK(benchmarkImageCopyView, "image/copy_pitched/view")->args({640, 1920, 4096});
+
+//! Single-threaded row-wise memcpy, the baseline for the copy in Image.
+void benchmarkImageCopyRowMemcpy(BenchmarkState& state)
+{
+  PitchedImage src(state.arg());
+  ImageRaw32fC1 dst(src.width, src.height);
+  while (state.keepRunning())
+  {
+    ConstImageView<Pixel32fC1> s = src.image.view();
+    ImageView<Pixel32fC1> d = dst.view();
+    for (uint32_t y = 0u; y < s.height(); ++y)
+    {
+      std::memcpy(d.rowPtr(y), s.rowPtr(y), s.rowBytes());
+    }
+    doNotOptimizeAway(dst);
+  }
+  state.setItemsPerIteration(src.image.numel());
+}
+ZE_BENCHMARK(benchmarkImageCopyRowMemcpy, "image/copy_pitched/row_memcpy")->args({640, 1920, 4096});
+
+//! 8uC1 -> 32fC1 in [0, 1] as a copy followed by a normalization pass.
+void benchmarkImageConvertTwoPass(BenchmarkState& state)
+{
+  ImageRaw8uC1 src(state.arg(), state.arg() * 3 / 4);
+  src.setValue(Pixel8uC1(128u));
+  ImageRaw32fC1 dst(src.width(), src.height());
+  while (state.keepRunning())
+  {
+    ImageView<Pixel32fC1> d = dst.view();
+    ConstImageView<Pixel8uC1> s = src.view();
+    for (uint32_t y = 0u; y < d.height(); ++y)
+    {
+      for (uint32_t x = 0u; x < d.width(); ++x)
+      {
+        d(x, y).x = s(x, y).x;
+      }
+    }
+    for (uint32_t y = 0u; y < d.height(); ++y)
+    {
+      for (Pixel32fC1& px : d.row(y))
+      {
+        px.x *= 1.0f / 255.0f;
+      }
+    }
+    doNotOptimizeAway(dst);
+  }
+  state.setItemsPerIteration(src.numel());
+}
+ZE_BENCHMARK(benchmarkImageConvertTwoPass, "image/convert_8u_32f/two_pass")->args({640, 1920, 4096});
+
+void benchmarkImageConvertFused(BenchmarkState& state)
+{
+  ImageRaw8uC1 src(state.arg(), state.arg() * 3 / 4);
+  src.setValue(Pixel8uC1(128u));
+  ImageRaw32fC1 dst(src.width(), src.height());
+  while (state.keepRunning())
+  {
+    src.convertTo(dst, 1.0f / 255.0f);
+    doNotOptimizeAway(dst);
+  }
+  state.setItemsPerIteration(src.numel());
+}
+ZE_BENCHMARK(benchmarkImageConvertFused, "image/convert_8u_32f/convert_to")->args({640, 1920, 4096});
+
+} // anonymous namespace
+} // namespace ze
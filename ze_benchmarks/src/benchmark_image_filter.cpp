@@ -0,0 +1,120 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <random>
+
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/image_filter.hpp>
+#include <ze/common/benchmark.hpp>
+
+namespace ze {
+namespace {
+
+//! Random image of arg x (3/4 arg) pixels.
+template<typename Pixel>
+ImageRaw<Pixel> randomImage(int64_t width, float max_value)
+{
+  ImageRaw<Pixel> img(width, width * 3 / 4);
+  std::mt19937 gen(42u);
+  std::uniform_real_distribution<float> dist(0.0f, max_value);
+  for (uint32_t y = 0u; y < img.height(); ++y)
+  {
+    for (uint32_t x = 0u; x < img.width(); ++x)
+    {
+      img(x, y).x = static_cast<typename Pixel::T>(dist(gen));
+    }
+  }
+  return img;
+}
+
+void benchmarkFilterGauss8uC1(BenchmarkState& state)
+{
+  ImageRaw8uC1 src = randomImage<Pixel8uC1>(state.arg(), 255.0f);
+  ImageRaw8uC1 dst(src.size());
+  while (state.keepRunning())
+  {
+    filterGauss(dst, src, 2.0f);
+    doNotOptimizeAway(dst);
+  }
+  state.setItemsPerIteration(src.numel());
+}
+ZE_BENCHMARK(benchmarkFilterGauss8uC1, "image_filter/gauss/8uC1")->args({640, 1920});
+
+void benchmarkFilterGauss32fC1(BenchmarkState& state)
+{
+  ImageRaw32fC1 src = randomImage<Pixel32fC1>(state.arg(), 1.0f);
+  ImageRaw32fC1 dst(src.size());
+  while (state.keepRunning())
+  {
+    filterGauss(dst, src, 2.0f);
+    doNotOptimizeAway(dst);
+  }
+  state.setItemsPerIteration(src.numel());
+}
+ZE_BENCHMARK(benchmarkFilterGauss32fC1, "image_filter/gauss/32fC1")->args({640, 1920});
+
+void benchmarkFilterMedian8uC1(BenchmarkState& state)
+{
+  ImageRaw8uC1 src = randomImage<Pixel8uC1>(state.arg(), 255.0f);
+  ImageRaw8uC1 dst(src.size());
+  while (state.keepRunning())
+  {
+    filterMedian3x3(dst, src);
+    doNotOptimizeAway(dst);
+  }
+  state.setItemsPerIteration(src.numel());
+}
+ZE_BENCHMARK(benchmarkFilterMedian8uC1, "image_filter/median3x3/8uC1")->args({640, 1920});
+
+//! sigma_spatial = 3 with a 13x13 window: once exactly (radius just below
+//! the grid threshold) and once on the bilateral grid.
+void benchmarkFilterBilateralDirect(BenchmarkState& state)
+{
+  ImageRaw32fC1 src = randomImage<Pixel32fC1>(state.arg(), 1.0f);
+  ImageRaw32fC1 dst(src.size());
+  while (state.keepRunning())
+  {
+    filterBilateral(dst, src, nullptr, 1, 3.01f, 0.1f, 6);
+    doNotOptimizeAway(dst);
+  }
+  state.setItemsPerIteration(src.numel());
+}
+ZE_BENCHMARK(benchmarkFilterBilateralDirect, "image_filter/bilateral/direct")->args({640});
+
+void benchmarkFilterBilateralGrid(BenchmarkState& state)
+{
+  ImageRaw32fC1 src = randomImage<Pixel32fC1>(state.arg(), 1.0f);
+  ImageRaw32fC1 dst(src.size());
+  while (state.keepRunning())
+  {
+    filterBilateral(dst, src, nullptr, 1, 3.0f, 0.1f, 6);
+    doNotOptimizeAway(dst);
+  }
+  state.setItemsPerIteration(src.numel());
+}
+ZE_BENCHMARK(benchmarkFilterBilateralGrid, "image_filter/bilateral/grid")->args({640, 1920});
+
+} // anonymous namespace
+} // namespace ze
@@ -0,0 +1,151 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <random>
+#include <vector>
+
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/image_filter.hpp>
+#include <imp/cpu_imgproc/image_pyramid.hpp>
+#include <imp/cpu_imgproc/reduce.hpp>
+#include <ze/common/benchmark.hpp>
+
+namespace ze {
+namespace {
+
+constexpr uint32_t c_num_levels = 4u;
+constexpr size_t c_num_cameras = 8u;
+
+//! Random 8-bit image of arg x (3/4 arg) pixels.
+ImageRaw8uC1::Ptr randomImage(int64_t width, uint32_t seed = 42u)
+{
+  auto img = std::make_shared<ImageRaw8uC1>(width, width * 3 / 4);
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (uint32_t y = 0u; y < img->height(); ++y)
+  {
+    for (uint32_t x = 0u; x < img->width(); ++x)
+    {
+      (*img)(x, y).x = static_cast<uint8_t>(dist(gen));
+    }
+  }
+  return img;
+}
+
+//! Gaussian filter and point decimation as separate passes into a
+//! temporary image, the structure of the GPU reduce().
+void benchmarkPyramidTwoPass(BenchmarkState& state)
+{
+  ImageRaw8uC1::Ptr img = randomImage(state.arg());
+  ImagePyramid8uC1::Ptr pyr = createImagePyramidCpu<Pixel8uC1>(img, 0.5f, c_num_levels);
+  std::vector<ImageRaw8uC1> filtered;
+  for (size_t i = 0u; i + 1u < pyr->numLevels(); ++i)
+  {
+    filtered.emplace_back(pyr->size(i));
+  }
+  while (state.keepRunning())
+  {
+    for (size_t i = 1u; i < pyr->numLevels(); ++i)
+    {
+      filterGauss(filtered[i - 1u], pyr->at(i - 1u), 1.0f);
+      reduce(pyr->at(i), filtered[i - 1u], InterpolationMode::Point, false);
+    }
+    doNotOptimizeAway(pyr);
+  }
+  state.setItemsPerIteration(img->numel());
+}
+ZE_BENCHMARK(benchmarkPyramidTwoPass, "image_pyramid/8uC1/two_pass")->args({752, 1920});
+
+void benchmarkPyramidFused(BenchmarkState& state)
+{
+  ImageRaw8uC1::Ptr img = randomImage(state.arg());
+  ImagePyramid8uC1::Ptr pyr = createImagePyramidCpu<Pixel8uC1>(img, 0.5f, c_num_levels);
+  while (state.keepRunning())
+  {
+    updateImagePyramidCpu(*pyr, Image8uC1::Ptr(img));
+    doNotOptimizeAway(pyr);
+  }
+  state.setItemsPerIteration(img->numel());
+}
+ZE_BENCHMARK(benchmarkPyramidFused, "image_pyramid/8uC1/fused")->args({752, 1920});
+
+void benchmarkPyramidGeneric(BenchmarkState& state)
+{
+  ImageRaw8uC1::Ptr img = randomImage(state.arg());
+  ImagePyramid8uC1::Ptr pyr = createImagePyramidCpu<Pixel8uC1>(img, 0.7f, c_num_levels);
+  while (state.keepRunning())
+  {
+    updateImagePyramidCpu(*pyr, Image8uC1::Ptr(img));
+    doNotOptimizeAway(pyr);
+  }
+  state.setItemsPerIteration(img->numel());
+}
+ZE_BENCHMARK(benchmarkPyramidGeneric, "image_pyramid/8uC1/factor_0.7")->args({752});
+
+//! All cameras of a rig, one after the other or concurrently.
+struct RigPyramids
+{
+  RigPyramids(int64_t width)
+  {
+    for (size_t i = 0u; i < c_num_cameras; ++i)
+    {
+      imgs.push_back(randomImage(width, i));
+      pyrs.push_back(createImagePyramidCpu<Pixel8uC1>(imgs.back(), 0.5f, c_num_levels));
+    }
+  }
+
+  std::vector<Image8uC1::Ptr> imgs;
+  std::vector<ImagePyramid8uC1::Ptr> pyrs;
+};
+
+void benchmarkPyramidRigSequential(BenchmarkState& state)
+{
+  RigPyramids rig(state.arg());
+  while (state.keepRunning())
+  {
+    for (size_t i = 0u; i < c_num_cameras; ++i)
+    {
+      updateImagePyramidCpu(*rig.pyrs[i], rig.imgs[i]);
+    }
+    doNotOptimizeAway(rig.pyrs);
+  }
+  state.setItemsPerIteration(c_num_cameras);
+}
+ZE_BENCHMARK(benchmarkPyramidRigSequential, "image_pyramid/rig/sequential")->args({752});
+
+void benchmarkPyramidRigConcurrent(BenchmarkState& state)
+{
+  RigPyramids rig(state.arg());
+  while (state.keepRunning())
+  {
+    updateImagePyramidsCpu(rig.pyrs, rig.imgs);
+    doNotOptimizeAway(rig.pyrs);
+  }
+  state.setItemsPerIteration(c_num_cameras);
+}
+ZE_BENCHMARK(benchmarkPyramidRigConcurrent, "image_pyramid/rig/concurrent")->args({752});
+
+} // anonymous namespace
+} // namespace ze
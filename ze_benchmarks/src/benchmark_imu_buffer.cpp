@@ -0,0 +1,126 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/time_conversions.hpp>
+#include <ze/imu/imu_buffer.hpp>
+
+namespace ze {
+namespace {
+
+ImuModel::Ptr createImuModel()
+{
+  std::shared_ptr<ImuIntrinsicModelCalibrated> intrinsics =
+      std::make_shared<ImuIntrinsicModelCalibrated>();
+  std::shared_ptr<ImuNoiseNone> noise = std::make_shared<ImuNoiseNone>();
+  AccelerometerModel::Ptr a_model =
+      std::make_shared<AccelerometerModel>(intrinsics, noise);
+  GyroscopeModel::Ptr g_model =
+      std::make_shared<GyroscopeModel>(intrinsics, noise);
+  return std::make_shared<ImuModel>(a_model, g_model);
+}
+
+//! Fills the buffer with 10s of measurements at 200 Hz, with the
+//! accelerometer and gyroscope slightly out of sync.
+template<typename Buffer>
+void fillImuBuffer(Buffer* buffer)
+{
+  for (int i = 0; i < 2000; ++i)
+  {
+    buffer->insertAccelerometerMeasurement(secToNanosec(i * 0.005),
+                                           Vector3::Random());
+    buffer->insertGyroscopeMeasurement(secToNanosec(i * 0.005 + 0.001),
+                                       Vector3::Random());
+  }
+}
+
+void benchmarkInsert(BenchmarkState& state)
+{
+  ImuBufferLinear2000 buffer(createImuModel());
+  const ImuAccGyr value = ImuAccGyr::Random();
+  int64_t stamp = 0;
+  while (state.keepRunning())
+  {
+    buffer.insertImuMeasurement(++stamp, value);
+  }
+  state.setItemsPerIteration(1);
+}
+ZE_BENCHMARK(benchmarkInsert, "imu_buffer/insert");
+
+void benchmarkGet(BenchmarkState& state)
+{
+  ImuBufferLinear2000 buffer(createImuModel());
+  fillImuBuffer(&buffer);
+  ImuAccGyr value;
+  int64_t stamp = secToNanosec(1.0);
+  while (state.keepRunning())
+  {
+    // Walk through the buffer to not always hit the same cache lines.
+    stamp = stamp < secToNanosec(9.0) ? stamp + 1700000 : secToNanosec(1.0);
+    buffer.get(stamp, value);
+    doNotOptimizeAway(value);
+  }
+  state.setItemsPerIteration(1);
+}
+ZE_BENCHMARK(benchmarkGet, "imu_buffer/get");
+
+//! Preintegration window of arg milliseconds, e.g. between two frames.
+template<typename Buffer>
+void benchmarkBetweenValues(BenchmarkState& state, bool lock_free_reads)
+{
+  Buffer buffer(createImuModel(), lock_free_reads);
+  fillImuBuffer(&buffer);
+  const int64_t begin = secToNanosec(5.0025);
+  const int64_t end = begin + millisecToNanosec(state.arg());
+  while (state.keepRunning())
+  {
+    auto result = buffer.getBetweenValuesInterpolated(begin, end);
+    doNotOptimizeAway(result);
+  }
+}
+
+void benchmarkBetweenValuesLinear(BenchmarkState& state)
+{
+  benchmarkBetweenValues<ImuBufferLinear2000>(state, false);
+}
+ZE_BENCHMARK(benchmarkBetweenValuesLinear,
+             "imu_buffer/between_values_linear")->args({50, 1000});
+
+void benchmarkBetweenValuesLinearLockFree(BenchmarkState& state)
+{
+  benchmarkBetweenValues<ImuBufferLinear2000>(state, true);
+}
+ZE_BENCHMARK(benchmarkBetweenValuesLinearLockFree,
+             "imu_buffer/between_values_linear_lock_free")->args({50, 1000});
+
+void benchmarkBetweenValuesDiff(BenchmarkState& state)
+{
+  benchmarkBetweenValues<ImuBufferDiff2000>(state, false);
+}
+ZE_BENCHMARK(benchmarkBetweenValuesDiff,
+             "imu_buffer/between_values_diff")->args({50, 1000});
+
+} // anonymous namespace
+} // namespace ze
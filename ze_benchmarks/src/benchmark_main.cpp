@@ -0,0 +1,89 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <iostream>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <ze/common/benchmark.hpp>
+
+DEFINE_string(filter, "", "Run only cases whose name contains this string, e.g. 'ringbuffer/'.");
+DEFINE_bool(list, false, "List the registered cases and exit.");
+DEFINE_int32(epochs, 50, "Number of timed epochs per case.");
+DEFINE_int32(warmup_epochs, 2, "Number of untimed epochs per case.");
+DEFINE_double(min_epoch_ms, 1.0, "Minimal duration of an epoch, used to calibrate the iterations.");
+DEFINE_int32(cpu, -1, "Pin the benchmark thread to this CPU.");
+DEFINE_string(json_out, "", "Save the results as JSON to this file.");
+DEFINE_string(baseline, "", "Compare the results with this JSON file.");
+DEFINE_double(tolerance, 0.05, "Relative slowdown of the median that counts as a regression.");
+
+int main(int argc, char** argv)
+{
+  google::InitGoogleLogging(argv[0]);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InstallFailureSignalHandler();
+  FLAGS_alsologtostderr = true;
+  FLAGS_colorlogtostderr = true;
+
+  if (FLAGS_list)
+  {
+    for (const ze::Benchmark* benchmark : ze::registeredBenchmarks())
+    {
+      std::cout << benchmark->name();
+      for (int64_t arg : benchmark->arguments())
+      {
+        std::cout << " " << arg;
+      }
+      std::cout << "\n";
+    }
+    return 0;
+  }
+
+  ze::BenchmarkOptions options;
+  options.num_epochs = FLAGS_epochs;
+  options.num_warmup_epochs = FLAGS_warmup_epochs;
+  options.min_epoch_ns = static_cast<int64_t>(FLAGS_min_epoch_ms * 1e6);
+  options.cpu = FLAGS_cpu;
+  const std::vector<ze::BenchmarkResult> results =
+      ze::runRegisteredBenchmarks(FLAGS_filter, options);
+
+  if (!FLAGS_json_out.empty())
+  {
+    ze::saveBenchmarkResults(FLAGS_json_out, results);
+  }
+
+  if (!FLAGS_baseline.empty())
+  {
+    const size_t num_regressions = ze::compareBenchmarkResults(
+          results, ze::loadBenchmarkResults(FLAGS_baseline), FLAGS_tolerance,
+          std::cout);
+    if (num_regressions > 0u)
+    {
+      LOG(ERROR) << num_regressions << " benchmarks regressed.";
+      return 1;
+    }
+  }
+  return 0;
+}
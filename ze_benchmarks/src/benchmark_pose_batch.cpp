@@ -0,0 +1,170 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/pose_batch.hpp>
+#include <ze/common/transformation.hpp>
+
+namespace ze {
+namespace {
+
+TransformationVector randomPoses(int64_t n)
+{
+  TransformationVector T(n);
+  for (Transformation& T_i : T)
+  {
+    T_i.setRandom(10.0);
+  }
+  return T;
+}
+
+void benchmarkVectorCompose(BenchmarkState& state)
+{
+  const TransformationVector T_A_B = randomPoses(state.arg());
+  const TransformationVector T_B_C = randomPoses(state.arg());
+  TransformationVector T_A_C(state.arg());
+  while (state.keepRunning())
+  {
+    for (size_t i = 0; i < T_A_C.size(); ++i)
+    {
+      T_A_C[i] = T_A_B[i] * T_B_C[i];
+    }
+    doNotOptimizeAway(T_A_C);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkVectorCompose, "transformation_vector/compose")->args({1000, 100000});
+
+void benchmarkBatchCompose(BenchmarkState& state)
+{
+  const PoseBatch T_A_B(randomPoses(state.arg()));
+  const PoseBatch T_B_C(randomPoses(state.arg()));
+  PoseBatch T_A_C(state.arg());
+  while (state.keepRunning())
+  {
+    composePoses(T_A_B, T_B_C, &T_A_C);
+    doNotOptimizeAway(T_A_C);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkBatchCompose, "pose_batch/compose")->args({1000, 100000});
+
+void benchmarkVectorRelative(BenchmarkState& state)
+{
+  const TransformationVector T_A_B = randomPoses(state.arg());
+  const TransformationVector T_A_C = randomPoses(state.arg());
+  TransformationVector T_B_C(state.arg());
+  while (state.keepRunning())
+  {
+    for (size_t i = 0; i < T_B_C.size(); ++i)
+    {
+      T_B_C[i] = T_A_B[i].inverse() * T_A_C[i];
+    }
+    doNotOptimizeAway(T_B_C);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkVectorRelative, "transformation_vector/relative")->args({1000, 100000});
+
+void benchmarkBatchRelative(BenchmarkState& state)
+{
+  const PoseBatch T_A_B(randomPoses(state.arg()));
+  const PoseBatch T_A_C(randomPoses(state.arg()));
+  PoseBatch T_B_C(state.arg());
+  while (state.keepRunning())
+  {
+    relativePoses(T_A_B, T_A_C, &T_B_C);
+    doNotOptimizeAway(T_B_C);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkBatchRelative, "pose_batch/relative")->args({1000, 100000});
+
+void benchmarkVectorLogExp(BenchmarkState& state)
+{
+  const TransformationVector T = randomPoses(state.arg());
+  TransformationVector T_exp(state.arg());
+  while (state.keepRunning())
+  {
+    for (size_t i = 0; i < T.size(); ++i)
+    {
+      T_exp[i] = Transformation::exp(T[i].log());
+    }
+    doNotOptimizeAway(T_exp);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkVectorLogExp, "transformation_vector/log_exp")->args({1000, 100000});
+
+void benchmarkBatchLogExp(BenchmarkState& state)
+{
+  const PoseBatch T(randomPoses(state.arg()));
+  PoseBatch T_exp(state.arg());
+  Matrix6X tangents(6, state.arg());
+  while (state.keepRunning())
+  {
+    logPoses(T, &tangents);
+    expPoses(tangents, &T_exp);
+    doNotOptimizeAway(T_exp);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkBatchLogExp, "pose_batch/log_exp")->args({1000, 100000});
+
+void benchmarkVectorTransformAllPairs(BenchmarkState& state)
+{
+  const TransformationVector T_A_B = randomPoses(state.arg());
+  const Positions p_B = Positions::Random(3, 100);
+  Positions p_A(3, state.arg() * p_B.cols());
+  while (state.keepRunning())
+  {
+    for (size_t i = 0; i < T_A_B.size(); ++i)
+    {
+      p_A.middleCols(i * p_B.cols(), p_B.cols()) = T_A_B[i].transformVectorized(p_B);
+    }
+    doNotOptimizeAway(p_A);
+  }
+  state.setItemsPerIteration(state.arg() * p_B.cols());
+}
+ZE_BENCHMARK(benchmarkVectorTransformAllPairs,
+             "transformation_vector/transform_100_points")->args({1000});
+
+void benchmarkBatchTransformAllPairs(BenchmarkState& state)
+{
+  const PoseBatch T_A_B(randomPoses(state.arg()));
+  const Positions p_B = Positions::Random(3, 100);
+  Positions p_A(3, state.arg() * p_B.cols());
+  while (state.keepRunning())
+  {
+    transformPointsAllPairs(T_A_B, p_B, &p_A);
+    doNotOptimizeAway(p_A);
+  }
+  state.setItemsPerIteration(state.arg() * p_B.cols());
+}
+ZE_BENCHMARK(benchmarkBatchTransformAllPairs,
+             "pose_batch/transform_100_points")->args({1000});
+
+} // anonymous namespace
+} // namespace ze
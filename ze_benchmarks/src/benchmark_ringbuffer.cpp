@@ -0,0 +1,123 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/ringbuffer.hpp>
+#include <ze/common/time_conversions.hpp>
+
+namespace ze {
+namespace {
+
+using BenchmarkRingbuffer = Ringbuffer<real_t, 3, 2048>;
+
+//! Fills the buffer with samples at 200 Hz.
+void fillRingbuffer(BenchmarkRingbuffer* buffer)
+{
+  for (int i = 0; i < 2048; ++i)
+  {
+    buffer->insert(secToNanosec(i * 0.005), Vector3::Random());
+  }
+}
+
+//! Stamps at 3x the buffer rate, within the buffer range.
+Eigen::Matrix<int64_t, Eigen::Dynamic, 1> resamplingStamps(int64_t n)
+{
+  CHECK_LE(n, 6000);
+  Eigen::Matrix<int64_t, Eigen::Dynamic, 1> stamps(n);
+  for (int i = 0; i < stamps.size(); ++i)
+  {
+    stamps(i) = secToNanosec(0.001 + i * 0.0017);
+  }
+  return stamps;
+}
+
+void benchmarkInsert(BenchmarkState& state)
+{
+  BenchmarkRingbuffer buffer;
+  const Vector3 value = Vector3::Random();
+  int64_t stamp = 0;
+  while (state.keepRunning())
+  {
+    buffer.insert(++stamp, value);
+  }
+  state.setItemsPerIteration(1);
+}
+ZE_BENCHMARK(benchmarkInsert, "ringbuffer/insert");
+
+void benchmarkInterpolatePerStamp(BenchmarkState& state)
+{
+  BenchmarkRingbuffer buffer;
+  fillRingbuffer(&buffer);
+  const Eigen::Matrix<int64_t, Eigen::Dynamic, 1> stamps =
+      resamplingStamps(state.arg());
+  Eigen::Matrix<real_t, 3, Eigen::Dynamic> values(3, stamps.size());
+  while (state.keepRunning())
+  {
+    for (int i = 0; i < stamps.size(); ++i)
+    {
+      buffer.getValueInterpolated(stamps(i), values.col(i));
+    }
+    doNotOptimizeAway(values);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkInterpolatePerStamp,
+             "ringbuffer/interpolate_per_stamp")->args({100, 6000});
+
+void benchmarkInterpolateBatch(BenchmarkState& state)
+{
+  BenchmarkRingbuffer buffer;
+  fillRingbuffer(&buffer);
+  const Eigen::Matrix<int64_t, Eigen::Dynamic, 1> stamps =
+      resamplingStamps(state.arg());
+  Eigen::Matrix<real_t, 3, Eigen::Dynamic> values(3, stamps.size());
+  while (state.keepRunning())
+  {
+    buffer.getValuesInterpolated(stamps, values);
+    doNotOptimizeAway(values);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkInterpolateBatch,
+             "ringbuffer/interpolate_batch")->args({100, 6000});
+
+void benchmarkBetweenValues(BenchmarkState& state)
+{
+  BenchmarkRingbuffer buffer;
+  fillRingbuffer(&buffer);
+  // Window of arg milliseconds in the middle of the buffer.
+  const int64_t begin = secToNanosec(5.0025);
+  const int64_t end = begin + millisecToNanosec(state.arg());
+  while (state.keepRunning())
+  {
+    auto result = buffer.getBetweenValuesInterpolated(begin, end);
+    doNotOptimizeAway(result);
+  }
+}
+ZE_BENCHMARK(benchmarkBetweenValues,
+             "ringbuffer/between_values_interpolated")->args({10, 1000});
+
+} // anonymous namespace
+} // namespace ze
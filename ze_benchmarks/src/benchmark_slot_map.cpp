@@ -0,0 +1,200 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <unordered_map>
+#include <vector>
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/slot_map.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+namespace {
+
+using LandmarkHandle = VersionedSlotHandle<uint32_t, 24, 8>;
+using LandmarkSlotMap = SlotMap<Position, LandmarkHandle>;
+using LandmarkHashMap = std::unordered_map<uint32_t, Position>;
+
+//! Inserts arg landmarks, the keys of the hash map are running ids.
+void fill(int64_t n, LandmarkSlotMap* slot_map, std::vector<LandmarkHandle>* handles)
+{
+  for (int64_t i = 0; i < n; ++i)
+  {
+    handles->push_back(slot_map->insert(Position::Constant(i)));
+  }
+}
+
+void fill(int64_t n, LandmarkHashMap* hash_map, std::vector<uint32_t>* keys)
+{
+  for (int64_t i = 0; i < n; ++i)
+  {
+    keys->push_back(static_cast<uint32_t>(i));
+    hash_map->emplace(static_cast<uint32_t>(i), Position::Constant(i));
+  }
+}
+
+void benchmarkSlotMapInsert(BenchmarkState& state)
+{
+  while (state.keepRunning())
+  {
+    LandmarkSlotMap map;
+    std::vector<LandmarkHandle> handles;
+    fill(state.arg(), &map, &handles);
+    doNotOptimizeAway(map);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkSlotMapInsert, "slot_map/insert")->args({1000, 100000});
+
+void benchmarkHashMapInsert(BenchmarkState& state)
+{
+  while (state.keepRunning())
+  {
+    LandmarkHashMap map;
+    std::vector<uint32_t> keys;
+    fill(state.arg(), &map, &keys);
+    doNotOptimizeAway(map);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkHashMapInsert, "unordered_map/insert")->args({1000, 100000});
+
+void benchmarkSlotMapLookup(BenchmarkState& state)
+{
+  LandmarkSlotMap map;
+  std::vector<LandmarkHandle> handles;
+  fill(state.arg(), &map, &handles);
+  while (state.keepRunning())
+  {
+    real_t sum = 0.0;
+    for (const LandmarkHandle h : handles)
+    {
+      sum += map[h](0);
+    }
+    doNotOptimizeAway(sum);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkSlotMapLookup, "slot_map/lookup")->args({1000, 100000});
+
+void benchmarkHashMapLookup(BenchmarkState& state)
+{
+  LandmarkHashMap map;
+  std::vector<uint32_t> keys;
+  fill(state.arg(), &map, &keys);
+  while (state.keepRunning())
+  {
+    real_t sum = 0.0;
+    for (const uint32_t key : keys)
+    {
+      sum += map.find(key)->second(0);
+    }
+    doNotOptimizeAway(sum);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkHashMapLookup, "unordered_map/lookup")->args({1000, 100000});
+
+void benchmarkSlotMapIterate(BenchmarkState& state)
+{
+  LandmarkSlotMap map;
+  std::vector<LandmarkHandle> handles;
+  fill(state.arg(), &map, &handles);
+  while (state.keepRunning())
+  {
+    real_t sum = 0.0;
+    for (const Position& p : map)
+    {
+      sum += p(0);
+    }
+    doNotOptimizeAway(sum);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkSlotMapIterate, "slot_map/iterate")->args({1000, 100000});
+
+void benchmarkHashMapIterate(BenchmarkState& state)
+{
+  LandmarkHashMap map;
+  std::vector<uint32_t> keys;
+  fill(state.arg(), &map, &keys);
+  while (state.keepRunning())
+  {
+    real_t sum = 0.0;
+    for (const auto& it : map)
+    {
+      sum += it.second(0);
+    }
+    doNotOptimizeAway(sum);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkHashMapIterate, "unordered_map/iterate")->args({1000, 100000});
+
+//! Per frame, a tenth of the tracks is lost and as many new tracks appear.
+void benchmarkSlotMapChurn(BenchmarkState& state)
+{
+  LandmarkSlotMap map;
+  std::vector<LandmarkHandle> handles;
+  fill(state.arg(), &map, &handles);
+  size_t next = 0u;
+  while (state.keepRunning())
+  {
+    for (int64_t i = 0; i < state.arg() / 10; ++i)
+    {
+      LandmarkHandle& h = handles[next];
+      map.erase(h);
+      h = map.insert(Position::Zero());
+      next = (next + 7u) % handles.size();
+    }
+  }
+  state.setItemsPerIteration(state.arg() / 10);
+}
+ZE_BENCHMARK(benchmarkSlotMapChurn, "slot_map/churn")->args({1000, 100000});
+
+void benchmarkHashMapChurn(BenchmarkState& state)
+{
+  LandmarkHashMap map;
+  std::vector<uint32_t> keys;
+  fill(state.arg(), &map, &keys);
+  size_t next = 0u;
+  uint32_t next_key = static_cast<uint32_t>(state.arg());
+  while (state.keepRunning())
+  {
+    for (int64_t i = 0; i < state.arg() / 10; ++i)
+    {
+      uint32_t& key = keys[next];
+      map.erase(key);
+      key = next_key++;
+      map.emplace(key, Position::Zero());
+      next = (next + 7u) % keys.size();
+    }
+  }
+  state.setItemsPerIteration(state.arg() / 10);
+}
+ZE_BENCHMARK(benchmarkHashMapChurn, "unordered_map/churn")->args({1000, 100000});
+
+} // anonymous namespace
+} // namespace ze
@@ -0,0 +1,128 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <random>
+
+#include <ze/cameras/camera_impl.hpp>
+#include <ze/cameras/camera_utils.hpp>
+#include <ze/common/benchmark.hpp>
+#include <ze/common/transformation.hpp>
+#include <ze/geometry/align_points.hpp>
+#include <ze/geometry/pose_optimizer.hpp>
+
+namespace ze {
+namespace {
+
+//! Pose optimization with arg noisy bearing measurements, as in
+//! test_pose_optimizer.
+void benchmarkPoseOptimizer(BenchmarkState& state)
+{
+  Transformation T_C_B, T_B_W;
+  T_C_B.setRandom();
+  T_B_W.setRandom();
+
+  const uint32_t n = state.arg();
+  PinholeCamera cam = createTestPinholeCamera();
+  Keypoints px;
+  Bearings f;
+  Positions pos_C;
+  std::tie(px, f, pos_C) = generateRandomVisible3dPoints(cam, n, 10u, 1.0, 3.0);
+  std::ranlux24 gen;
+  std::normal_distribution<real_t> px_noise(0.0, 1.0);
+  for (uint32_t i = 0u; i < n; ++i)
+  {
+    px(0, i) += px_noise(gen);
+    px(1, i) += px_noise(gen);
+  }
+
+  PoseOptimizerFrameData data;
+  data.f = cam.backProjectVectorized(px);
+  data.kp_idx = KeypointIndices(n, 1);
+  data.p_W = (T_B_W.inverse() * T_C_B.inverse()).transformVectorized(pos_C);
+  data.T_C_B = T_C_B;
+  data.scale = VectorX::Ones(n);
+  data.type = PoseOptimizerResidualType::UnitPlane;
+  PoseOptimizerFrameDataVec data_vec = { data };
+
+  const Transformation T_B_W_perturbed =
+      T_B_W * Transformation::exp((Vector6() << 0.1, 0.1, 0.1, 0.1, 0.1, 0.1).finished());
+  Transformation T_B_W_estimate;
+  while (state.keepRunning())
+  {
+    PoseOptimizer optimizer(
+          PoseOptimizer::getDefaultSolverOptions(),
+          data_vec, T_B_W, 0.0, 0.0);
+    T_B_W_estimate = T_B_W_perturbed;
+    optimizer.optimize(T_B_W_estimate);
+    doNotOptimizeAway(T_B_W_estimate);
+  }
+  state.setItemsPerIteration(n);
+}
+ZE_BENCHMARK(benchmarkPoseOptimizer, "solvers/pose_optimizer")->args({50, 500});
+
+//! Closed form and iterative alignment of arg points.
+void setupAlignment(int64_t n, Positions* p_A, Positions* p_B,
+                    Transformation* T_A_B)
+{
+  T_A_B->setRandom();
+  *p_B = Positions::Random(3, n);
+  *p_A = T_A_B->transformVectorized(*p_B) + 0.01 * Positions::Random(3, n);
+}
+
+void benchmarkAlignSE3(BenchmarkState& state)
+{
+  Positions p_A, p_B;
+  Transformation T_A_B;
+  setupAlignment(state.arg(), &p_A, &p_B, &T_A_B);
+  while (state.keepRunning())
+  {
+    Transformation T = alignSE3(p_B, p_A);
+    doNotOptimizeAway(T);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkAlignSE3, "solvers/align_se3")->args({100, 10000});
+
+void benchmarkPointAligner(BenchmarkState& state)
+{
+  Positions p_A, p_B;
+  Transformation T_A_B;
+  setupAlignment(state.arg(), &p_A, &p_B, &T_A_B);
+  const Transformation T_A_B_perturbed =
+      T_A_B * Transformation::exp((Vector6() << 0.1, 0.1, 0.1, 0.1, 0.1, 0.1).finished());
+  Transformation T_A_B_estimate;
+  while (state.keepRunning())
+  {
+    PointAligner problem(p_A, p_B);
+    T_A_B_estimate = T_A_B_perturbed;
+    problem.optimize(T_A_B_estimate);
+    doNotOptimizeAway(T_A_B_estimate);
+  }
+  state.setItemsPerIteration(state.arg());
+}
+ZE_BENCHMARK(benchmarkPointAligner, "solvers/point_aligner")->args({100, 10000});
+
+} // anonymous namespace
+} // namespace ze
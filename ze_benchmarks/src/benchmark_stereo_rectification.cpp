@@ -0,0 +1,134 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/horizontal_stereo_pair_rectifier.hpp>
+#include <ze/common/benchmark.hpp>
+
+namespace ze {
+namespace {
+
+//! 752x480 stereo rig with an 11cm baseline, scaled to arg pixels wide.
+template<typename Pixel>
+struct StereoRectificationSetup
+{
+  StereoRectificationSetup(int64_t width)
+    : size(width, width * 480 / 752)
+    , half_size(size.width() / 2u, size.height() / 2u)
+    , src0(size), src1(size), dst0(size), dst1(size)
+    , half0(half_size), half1(half_size)
+    , rectifier(transformed_cam0_params, transformed_cam1_params,
+                horizontal_offset, size,
+                cameraParams(width, 471.69, 371.09), distortionParams(),
+                cameraParams(width, 470.12, 368.45), distortionParams(),
+                Transformation(Quaternion::exp(Vector3(0.01, -0.02, 0.005)),
+                               Vector3(-0.11, 0.002, -0.001)))
+  {
+    for (uint32_t y = 0u; y < size.height(); ++y)
+    {
+      for (uint32_t x = 0u; x < size.width(); ++x)
+      {
+        src0(x, y).x = static_cast<typename Pixel::T>((x * 7u + y * 3u) % 256u);
+        src1(x, y).x = static_cast<typename Pixel::T>((x * 5u + y * 3u) % 256u);
+      }
+    }
+  }
+
+  static Vector4 cameraParams(int64_t width, real_t fx, real_t cx)
+  {
+    const real_t s = width / 752.0;
+    return (Vector4() << fx * s, fx * s, cx * s, 228.63874151 * s).finished();
+  }
+
+  static Vector4 distortionParams()
+  {
+    return (Vector4() << -0.28340811, 0.07395907, 0.00019359, 1.76187114e-05).finished();
+  }
+
+  Size2u size;
+  Size2u half_size;
+  ImageRaw<Pixel> src0, src1, dst0, dst1, half0, half1;
+  Vector4 transformed_cam0_params;
+  Vector4 transformed_cam1_params;
+  real_t horizontal_offset;
+  HorizontalStereoPairRectifier<PinholeGeometry, RadialTangentialDistortion, Pixel> rectifier;
+};
+
+void benchmarkRectifyPair8uC1(BenchmarkState& state)
+{
+  StereoRectificationSetup<Pixel8uC1> setup(state.arg());
+  while (state.keepRunning())
+  {
+    setup.rectifier.rectify(setup.dst0, setup.dst1, setup.src0, setup.src1);
+    doNotOptimizeAway(setup.dst0);
+    doNotOptimizeAway(setup.dst1);
+  }
+  state.setItemsPerIteration(2u * setup.size.area());
+}
+ZE_BENCHMARK(benchmarkRectifyPair8uC1, "stereo_rectification/8uC1/pair")->args({752, 1280});
+
+void benchmarkRectifyPairWithHalf8uC1(BenchmarkState& state)
+{
+  StereoRectificationSetup<Pixel8uC1> setup(state.arg());
+  while (state.keepRunning())
+  {
+    setup.rectifier.rectify(setup.dst0, setup.dst1, setup.half0, setup.half1,
+                            setup.src0, setup.src1);
+    doNotOptimizeAway(setup.half0);
+    doNotOptimizeAway(setup.half1);
+  }
+  state.setItemsPerIteration(2u * setup.size.area());
+}
+ZE_BENCHMARK(benchmarkRectifyPairWithHalf8uC1, "stereo_rectification/8uC1/pair_with_half")->args({752, 1280});
+
+void benchmarkRectifyPair32fC1(BenchmarkState& state)
+{
+  StereoRectificationSetup<Pixel32fC1> setup(state.arg());
+  while (state.keepRunning())
+  {
+    setup.rectifier.rectify(setup.dst0, setup.dst1, setup.src0, setup.src1);
+    doNotOptimizeAway(setup.dst0);
+    doNotOptimizeAway(setup.dst1);
+  }
+  state.setItemsPerIteration(2u * setup.size.area());
+}
+ZE_BENCHMARK(benchmarkRectifyPair32fC1, "stereo_rectification/32fC1/pair")->args({752, 1280});
+
+void benchmarkRectifyPairWithHalf32fC1(BenchmarkState& state)
+{
+  StereoRectificationSetup<Pixel32fC1> setup(state.arg());
+  while (state.keepRunning())
+  {
+    setup.rectifier.rectify(setup.dst0, setup.dst1, setup.half0, setup.half1,
+                            setup.src0, setup.src1);
+    doNotOptimizeAway(setup.half0);
+    doNotOptimizeAway(setup.half1);
+  }
+  state.setItemsPerIteration(2u * setup.size.area());
+}
+ZE_BENCHMARK(benchmarkRectifyPairWithHalf32fC1, "stereo_rectification/32fC1/pair_with_half")->args({752, 1280});
+
+} // anonymous namespace
+} // namespace ze
@@ -0,0 +1,134 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <cmath>
+
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/undistortion.hpp>
+#include <ze/common/benchmark.hpp>
+
+namespace ze {
+namespace {
+
+//! Camera of the imp_cu_imgproc undistortion tests, scaled to arg pixels wide.
+template<typename Pixel>
+struct UndistortionSetup
+{
+  UndistortionSetup(int64_t width)
+    : size(width, width * 480 / 752)
+    , src(size)
+    , dst(size)
+    , undistorter(size, cameraParams(width), distortionParams())
+  {
+    for (uint32_t y = 0u; y < size.height(); ++y)
+    {
+      for (uint32_t x = 0u; x < size.width(); ++x)
+      {
+        src(x, y).x = static_cast<typename Pixel::T>((x * 7u + y * 3u) % 256u);
+      }
+    }
+  }
+
+  static VectorX cameraParams(int64_t width)
+  {
+    const real_t s = width / 752.0;
+    VectorX cam_params(4);
+    cam_params << 471.690643292 * s, 471.765601046 * s, 371.087464172 * s, 228.63874151 * s;
+    return cam_params;
+  }
+
+  static VectorX distortionParams()
+  {
+    VectorX dist_coeffs(4);
+    dist_coeffs << -0.28340811, 0.07395907, 0.00019359, 1.76187114e-05;
+    return dist_coeffs;
+  }
+
+  Size2u size;
+  ImageRaw<Pixel> src;
+  ImageRaw<Pixel> dst;
+  ImageUndistorter<PinholeGeometry, RadialTangentialDistortion, Pixel> undistorter;
+};
+
+//! Bilinear lookup in the float map, what a straightforward port of the
+//! CUDA remap kernel does per pixel.
+void benchmarkUndistortFloatMap(BenchmarkState& state)
+{
+  UndistortionSetup<Pixel32fC1> setup(state.arg());
+  const ImageRaw32fC2& map = setup.undistorter.getUndistortionMap();
+  const int w = setup.size.width();
+  const int h = setup.size.height();
+  while (state.keepRunning())
+  {
+    for (int y = 0; y < h; ++y)
+    {
+      for (int x = 0; x < w; ++x)
+      {
+        const Pixel32fC2& p = map(x, y);
+        const float px = std::min(std::max(p.x, 0.0f), w - 1.0f);
+        const float py = std::min(std::max(p.y, 0.0f), h - 1.0f);
+        const int x0 = std::min(static_cast<int>(px), w - 2);
+        const int y0 = std::min(static_cast<int>(py), h - 2);
+        const float wx = px - x0;
+        const float wy = py - y0;
+        const ImageRaw32fC1& s = setup.src;
+        setup.dst(x, y) =
+            (1.0f - wy) * ((1.0f - wx) * s(x0, y0).x + wx * s(x0 + 1, y0).x)
+            + wy * ((1.0f - wx) * s(x0, y0 + 1).x + wx * s(x0 + 1, y0 + 1).x);
+      }
+    }
+    doNotOptimizeAway(setup.dst);
+  }
+  state.setItemsPerIteration(setup.size.area());
+}
+ZE_BENCHMARK(benchmarkUndistortFloatMap, "undistortion/32fC1/float_map")->args({752, 1920});
+
+void benchmarkUndistort32fC1(BenchmarkState& state)
+{
+  UndistortionSetup<Pixel32fC1> setup(state.arg());
+  while (state.keepRunning())
+  {
+    setup.undistorter.undistort(setup.dst, setup.src);
+    doNotOptimizeAway(setup.dst);
+  }
+  state.setItemsPerIteration(setup.size.area());
+}
+ZE_BENCHMARK(benchmarkUndistort32fC1, "undistortion/32fC1/remap_table")->args({752, 1920});
+
+void benchmarkUndistort8uC1(BenchmarkState& state)
+{
+  UndistortionSetup<Pixel8uC1> setup(state.arg());
+  while (state.keepRunning())
+  {
+    setup.undistorter.undistort(setup.dst, setup.src);
+    doNotOptimizeAway(setup.dst);
+  }
+  state.setItemsPerIteration(setup.size.area());
+}
+ZE_BENCHMARK(benchmarkUndistort8uC1, "undistortion/8uC1/remap_table")->args({752, 1920});
+
+} // anonymous namespace
+} // namespace ze
@@ -0,0 +1,137 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_imgproc/rof_denoising.hpp>
+#include <imp/cpu_imgproc/tvl1_denoising.hpp>
+#include <ze/common/benchmark.hpp>
+
+namespace ze {
+namespace {
+
+constexpr uint16_t c_iterations = 100u;
+
+ImageRaw32fC1::Ptr noisyImage(int64_t width)
+{
+  auto img = std::make_shared<ImageRaw32fC1>(width, width * 480 / 752);
+  for (uint32_t y = 0u; y < img->height(); ++y)
+  {
+    for (uint32_t x = 0u; x < img->width(); ++x)
+    {
+      (*img)(x, y) = 0.5f + 0.3f * std::sin(0.05f * x) + 0.01f * ((x * 7u + y * 13u) % 11u);
+    }
+  }
+  return img;
+}
+
+//! ROF with one pass over the image for the dual and one for the primal
+//! update per iteration, what a straightforward port of the CUDA kernels
+//! does.
+void benchmarkRofTwoPass(BenchmarkState& state)
+{
+  ImageRaw32fC1::Ptr f = noisyImage(state.arg());
+  const uint32_t w = f->width();
+  const uint32_t h = f->height();
+  const float lambda = 10.0f;
+  std::vector<float> f_data(w * h), u(w * h), u_bar(w * h), p_x(w * h), p_y(w * h);
+  for (uint32_t y = 0u; y < h; ++y)
+  {
+    for (uint32_t x = 0u; x < w; ++x)
+    {
+      f_data[y * w + x] = (*f)(x, y).x;
+    }
+  }
+  while (state.keepRunning())
+  {
+    u = f_data;
+    u_bar = f_data;
+    std::fill(p_x.begin(), p_x.end(), 0.0f);
+    std::fill(p_y.begin(), p_y.end(), 0.0f);
+    float tau = 1.0f / std::sqrt(8.0f);
+    float sigma = tau;
+    for (uint16_t iter = 0u; iter < c_iterations; ++iter)
+    {
+      const float theta = 1.0f / std::sqrt(1.0f + 0.7f * lambda * tau);
+      for (uint32_t y = 0u; y < h; ++y)
+      {
+        for (uint32_t x = 0u; x < w; ++x)
+        {
+          const size_t i = y * w + x;
+          const float gx = (x + 1u < w) ? u_bar[i + 1u] - u_bar[i] : 0.0f;
+          const float gy = (y + 1u < h) ? u_bar[i + w] - u_bar[i] : 0.0f;
+          const float px = p_x[i] + sigma * gx;
+          const float py = p_y[i] + sigma * gy;
+          const float scale = 1.0f / std::max(1.0f, std::sqrt(px * px + py * py));
+          p_x[i] = px * scale;
+          p_y[i] = py * scale;
+        }
+      }
+      for (uint32_t y = 0u; y < h; ++y)
+      {
+        for (uint32_t x = 0u; x < w; ++x)
+        {
+          const size_t i = y * w + x;
+          const float div = ((x + 1u < w) ? p_x[i] : 0.0f) - ((x > 0u) ? p_x[i - 1u] : 0.0f)
+                            + ((y + 1u < h) ? p_y[i] : 0.0f) - ((y > 0u) ? p_y[i - w] : 0.0f);
+          const float u_prev = u[i];
+          const float u_new = (u_prev + tau * (div + lambda * f_data[i]))
+                              / (1.0f + tau * lambda);
+          u[i] = u_new;
+          u_bar[i] = u_new + theta * (u_new - u_prev);
+        }
+      }
+      sigma /= theta;
+      tau *= theta;
+    }
+    doNotOptimizeAway(u);
+  }
+  state.setItemsPerIteration(f->size().area() * c_iterations);
+}
+ZE_BENCHMARK(benchmarkRofTwoPass, "variational_denoising/rof/two_pass")->args({752, 1280});
+
+template<typename Solver>
+void benchmarkDenoising(BenchmarkState& state)
+{
+  ImageRaw32fC1::Ptr f = noisyImage(state.arg());
+  auto u = std::make_shared<ImageRaw32fC1>(f->size());
+  while (state.keepRunning())
+  {
+    // A new solver per run, so that every run starts cold.
+    Solver solver;
+    solver.params().max_iter = c_iterations;
+    solver.denoise(u, f);
+    doNotOptimizeAway(*u);
+  }
+  state.setItemsPerIteration(f->size().area() * c_iterations);
+}
+ZE_BENCHMARK(benchmarkDenoising<RofDenoising32fC1>, "variational_denoising/rof/fused")->args({752, 1280});
+ZE_BENCHMARK(benchmarkDenoising<TvL1Denoising32fC1>, "variational_denoising/tvl1/fused")->args({752, 1280});
+
+} // anonymous namespace
+} // namespace ze
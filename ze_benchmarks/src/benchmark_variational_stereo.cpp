@@ -0,0 +1,92 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cmath>
+#include <memory>
+
+#include <imp/core/image_raw.hpp>
+#include <imp/cpu_correspondence/variational_stereo.hpp>
+#include <ze/common/benchmark.hpp>
+
+namespace ze {
+namespace {
+
+constexpr uint32_t c_iterations = 20u;
+constexpr uint32_t c_warps = 5u;
+
+float texture(float x, float y)
+{
+  return 0.5f + 0.2f * std::sin(0.31f * x + 0.1f * y)
+      + 0.15f * std::sin(0.13f * x - 0.27f * y + 1.0f)
+      + 0.1f * std::sin(0.53f * x + 0.41f * y);
+}
+
+//! Rectified pair of a plane slanted along y, disparities in [1, 9].
+void stereoPair(int64_t width, ImageRaw32fC1::Ptr& i1, ImageRaw32fC1::Ptr& i2)
+{
+  const uint32_t height = width * 480 / 752;
+  i1 = std::make_shared<ImageRaw32fC1>(width, height);
+  i2 = std::make_shared<ImageRaw32fC1>(width, height);
+  for (uint32_t y = 0u; y < height; ++y)
+  {
+    const float disparity = 1.0f + 8.0f * y / height;
+    for (uint32_t x = 0u; x < i1->width(); ++x)
+    {
+      (*i1)(x, y) = texture(x, y);
+      (*i2)(x, y) = texture(x - disparity, y);
+    }
+  }
+}
+
+template<StereoPDSolver solver>
+void benchmarkVariationalStereo(BenchmarkState& state)
+{
+  ImageRaw32fC1::Ptr i1, i2;
+  stereoPair(state.arg(), i1, i2);
+  auto params = std::make_shared<VariationalStereo::Parameters>();
+  params->solver = solver;
+  params->ctf.iters = c_iterations;
+  params->ctf.warps = c_warps;
+  while (state.keepRunning())
+  {
+    // A new pipeline per run, so that the pyramid and the solvers are built
+    // from scratch as for a new stereo pair.
+    VariationalStereo stereo(params);
+    stereo.addImage(i1);
+    stereo.addImage(i2);
+    stereo.solve();
+    doNotOptimizeAway(*stereo.getDisparities());
+  }
+  state.setItemsPerIteration(i1->size().area());
+}
+ZE_BENCHMARK(benchmarkVariationalStereo<StereoPDSolver::HuberL1>,
+             "variational_stereo/huber_l1")->args({376, 752});
+ZE_BENCHMARK(benchmarkVariationalStereo<StereoPDSolver::PrecondHuberL1>,
+             "variational_stereo/precond_huber_l1")->args({376, 752});
+ZE_BENCHMARK(benchmarkVariationalStereo<StereoPDSolver::PrecondHuberL1Weighted>,
+             "variational_stereo/precond_huber_l1_weighted")->args({376, 752});
+
+} // anonymous namespace
+} // namespace ze
@@ -96,6 +96,28 @@ public:
     return J;
   }
 
+  //! Same as project() for a generic scalar type, e.g. ze::Dual to compute
+  //! Jacobians with autoDiff(). The parameters are converted on every call.
+  template<typename T>
+  Eigen::Matrix<T, 2, 1> projectGeneric(const Eigen::Matrix<T, 3, 1>& pos) const
+  {
+    T projection_params[4];
+    T distortion_params[4];
+    for (int i = 0; i < 4; ++i)
+    {
+      projection_params[i] = T(this->projection_params_[i]);
+    }
+    DEBUG_CHECK_LE(this->distortion_params_.size(), 4);
+    for (int i = 0; i < this->distortion_params_.size(); ++i)
+    {
+      distortion_params[i] = T(this->distortion_params_[i]);
+    }
+    Eigen::Matrix<T, 2, 1> px = pos.template head<2>() / pos(2);
+    Distortion::distort(distortion_params, px.data());
+    PinholeGeometry::project(projection_params, px.data());
+    return px;
+  }
+
   std::pair<Keypoint, Matrix23> projectWithJacobian(
         const Eigen::Ref<const Position>& pos) const
   {
@@ -124,6 +146,25 @@ public:
   }
 };
 
+//-----------------------------------------------------------------------------
+//! Projection as functor for autoDiff(), e.g.:
+//!   Matrix23 J = autoDiff(ProjectFunctor<RadialTangentialDistortion>(cam), pos);
+template<class Distortion>
+struct ProjectFunctor
+{
+  explicit ProjectFunctor(const PinholeProjection<Distortion>& cam)
+    : cam(cam)
+  {}
+
+  template<typename T>
+  Eigen::Matrix<T, 2, 1> operator()(const Eigen::Matrix<T, 3, 1>& pos) const
+  {
+    return cam.projectGeneric(pos);
+  }
+
+  const PinholeProjection<Distortion>& cam;
+};
+
 //-----------------------------------------------------------------------------
 // Convenience typedefs.
 // (sync with explicit template class instantiations at the end of the cpp file)
@@ -41,7 +41,9 @@ namespace ze {
 
 // Pure static camera projection and distortion models, intended to be used in
 // both GPU and CPU code. Parameter checking should be performed in interface
-// classes.
+// classes. Math functions are called unqualified, after a using-declaration,
+// so that the models can also be evaluated with ze::Dual for automatic
+// differentiation.
 
 // Pinhole projection model.
 struct PinholeGeometry
@@ -135,12 +137,15 @@ struct FovDistortion
   CUDA_HOST CUDA_DEVICE
   static void distort(const T* params, T* px, T* jac_colmajor = nullptr)
   {
+    using std::sqrt;
+    using std::atan;
+    using std::tan;
     const T x = px[0];
     const T y = px[1];
     const T s = params[0];
     const T tan_s_half_x2 = params[1];
-    const T rad = std::sqrt(x * x + y * y);
-    const T factor = (rad < 0.001) ? 1.0 : std::atan(rad * tan_s_half_x2) / (s * rad);
+    const T rad = sqrt(x * x + y * y);
+    const T factor = (rad < 0.001) ? 1.0 : atan(rad * tan_s_half_x2) / (s * rad);
     px[0] *= factor;
     px[1] *= factor;
 
@@ -163,7 +168,7 @@ struct FovDistortion
       else if(rad_sq < 1e-5)
       {
         // Projection very close to image center
-        J_00 = 2.0 * std::tan(s / 2.0) / s;
+        J_00 = 2.0 * tan(s / 2.0) / s;
         J_11 = J_00;
         J_01 = 0.0;
         J_10 = 0.0;
@@ -172,8 +177,8 @@ struct FovDistortion
       {
         // Standard case
         const T xy = x * y;
-        const T rad = std::sqrt(rad_sq);
-        const T nominator = std::atan(tan_s_half_x2 * rad);
+        const T rad = sqrt(rad_sq);
+        const T nominator = atan(tan_s_half_x2 * rad);
         const T scale =
             tan_s_half_x2 / (s * (xx + yy) * (tan_s_half_x2 * tan_s_half_x2 * (xx + yy) + 1.0))
             - factor * 1.0  / rad_sq;
@@ -189,10 +194,12 @@ struct FovDistortion
   CUDA_HOST CUDA_DEVICE
   static void undistort(const T* params, T* px)
   {
+    using std::sqrt;
+    using std::tan;
     const T s = params[0];
     const T tan_s_half_x2 = params[1];
-    const T rad = std::sqrt(px[0] * px[0] + px[1] * px[1]);
-    const T factor = (rad < 0.001) ? 1.0 : (std::tan(rad * s) / tan_s_half_x2) / rad;
+    const T rad = sqrt(px[0] * px[0] + px[1] * px[1]);
+    const T factor = (rad < 0.001) ? 1.0 : (tan(rad * s) / tan_s_half_x2) / rad;
     px[0] *= factor;
     px[1] *= factor;
   }
@@ -297,6 +304,8 @@ struct EquidistantDistortion
   CUDA_HOST CUDA_DEVICE
   static void distort(const T* params, T* px, T* jac_colmajor = nullptr)
   {
+    using std::sqrt;
+    using std::atan;
     const T x = px[0];
     const T y = px[1];
     const T k1 = params[0];
@@ -304,8 +313,8 @@ struct EquidistantDistortion
     const T k3 = params[2];
     const T k4 = params[3];
     const T r_sqr = x * x + y * y;
-    const T r = std::sqrt(r_sqr);
-    const T theta = std::atan(r);
+    const T r = sqrt(r_sqr);
+    const T theta = atan(r);
     const T theta2 = theta * theta;
     const T theta4 = theta2 * theta2;
     const T theta6 = theta4 * theta2;
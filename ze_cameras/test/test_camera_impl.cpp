@@ -28,6 +28,7 @@
 #include <iostream>
 #include <functional>
 
+#include <ze/common/auto_diff.hpp>
 #include <ze/common/benchmark.hpp>
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/test_utils.hpp>
@@ -252,6 +253,21 @@ private:
   std::string test_name_;
 };
 
+template<class Distortion>
+void testAutoDiffJacobian(const PinholeProjection<Distortion>& cam)
+{
+  SCOPED_TRACE("AutoDiffJacobian");
+  Vector3 bearing = cam.backProject(Vector2(200, 300));
+  Vector2 px;
+  Matrix23 H_autodiff = autoDiff(ProjectFunctor<Distortion>(cam), bearing, &px);
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(px, cam.project(bearing), 1e-10));
+#ifndef ZE_SINGLE_PRECISION_FLOAT
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(cam.dProject_dLandmark(bearing), H_autodiff, 1e-10));
+#else
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(cam.dProject_dLandmark(bearing), H_autodiff, 1e-4));
+#endif
+}
+
 } // namespace ze
 
 TEST(CameraImplTests, testPinhole)
@@ -260,6 +276,7 @@ TEST(CameraImplTests, testPinhole)
   PinholeCamera cam = createPinholeCamera(752, 480, 310, 320, 376.0, 240.0);
   CameraTestHarness test(cam, 300, "Pinhole");
   test.testAll();
+  testAutoDiffJacobian(cam);
   CameraBenchmark benchmark(cam, 300, "Pinhole");
   benchmark.benchmarkAll();
 }
@@ -270,6 +287,7 @@ TEST(CameraImplTests, testFov)
   FovCamera cam = createFovCamera(752, 480, 310, 320, 376.0, 240.0, 0.947367);
   CameraTestHarness test(cam, 300, "Fov");
   test.testAll();
+  testAutoDiffJacobian(cam);
   CameraBenchmark benchmark(cam, 300, "Fov");
   benchmark.benchmarkAll();
 }
@@ -281,6 +299,7 @@ TEST(CameraImplTests, testRadTan)
                                         -0.2834, 0.0739, 0.00019, 1.76e-05);
   CameraTestHarness test(cam, 300, "RadTan");
   test.testAll();
+  testAutoDiffJacobian(cam);
   CameraBenchmark benchmark(cam, 300, "RadTan");
   benchmark.benchmarkAll();
 }
@@ -292,6 +311,7 @@ TEST(CameraImplTests, testEquidistant)
                                                   -0.00279, 0.02414, -0.04304, 0.03118);
   CameraTestHarness test(cam, 300, "Equidistant");
   test.testAll();
+  testAutoDiffJacobian(cam);
   CameraBenchmark benchmark(cam, 300, "Equidistant");
   benchmark.benchmarkAll();
 }
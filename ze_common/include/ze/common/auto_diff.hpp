@@ -0,0 +1,173 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include <ze/common/dual.hpp>
+#include <ze/common/manifold.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+
+namespace internal {
+
+//! Maps the real_t input and output types of a function to their Dual
+//! counterparts. Supported are real_t and fixed-size Eigen matrices, i.e. the
+//! vector space types of manifold.hpp. Matrices are (un)rolled in column-major
+//! order, as in traits<Matrix>::local().
+template<typename T, int N> struct DualOf;
+
+template<int N>
+struct DualOf<real_t, N>
+{
+  typedef Dual<real_t, N> type;
+  enum { dimension = 1 };
+
+  static void seed(const real_t x, int offset, type* x_dual)
+  {
+    *x_dual = type(x, offset);
+  }
+};
+
+template<int R, int C, int Options, int MaxRows, int MaxCols, int N>
+struct DualOf<Eigen::Matrix<real_t, R, C, Options, MaxRows, MaxCols>, N>
+{
+  static_assert(R != Eigen::Dynamic && C != Eigen::Dynamic,
+                "autoDiff needs fixed-size inputs.");
+  typedef Eigen::Matrix<Dual<real_t, N>, R, C, Options, MaxRows, MaxCols> type;
+  enum { dimension = R * C };
+
+  static void seed(const Eigen::Matrix<real_t, R, C, Options, MaxRows, MaxCols>& x,
+                   int offset, type* x_dual)
+  {
+    for (int i = 0; i < R * C; ++i)
+    {
+      (*x_dual)(i) = Dual<real_t, N>(x(i), offset + i);
+    }
+  }
+};
+
+//! Reads value and Jacobian back from the Dual valued output of a function.
+template<typename T> struct DualValue;
+
+template<int N>
+struct DualValue<Dual<real_t, N>>
+{
+  typedef real_t type;
+  enum { dimension = 1 };
+
+  template<typename Jacobian>
+  static void extract(const Dual<real_t, N>& y, type* value, Jacobian* J)
+  {
+    *value = y.a;
+    J->row(0) = y.v.transpose();
+  }
+};
+
+template<int R, int C, int Options, int MaxRows, int MaxCols, int N>
+struct DualValue<Eigen::Matrix<Dual<real_t, N>, R, C, Options, MaxRows, MaxCols>>
+{
+  static_assert(R != Eigen::Dynamic && C != Eigen::Dynamic,
+                "autoDiff needs fixed-size outputs.");
+  typedef Eigen::Matrix<real_t, R, C, Options, MaxRows, MaxCols> type;
+  enum { dimension = R * C };
+
+  template<typename Jacobian>
+  static void extract(
+      const Eigen::Matrix<Dual<real_t, N>, R, C, Options, MaxRows, MaxCols>& y,
+      type* value, Jacobian* J)
+  {
+    for (int i = 0; i < R * C; ++i)
+    {
+      (*value)(i) = y(i).a;
+      J->row(i) = y(i).v.transpose();
+    }
+  }
+};
+
+template<typename Functor, typename X>
+struct AutoDiffTraits
+{
+  enum { input_dimension = traits<X>::dimension };
+  typedef typename DualOf<X, input_dimension>::type DualX;
+  typedef typename std::decay<decltype(
+      std::declval<const Functor&>()(std::declval<const DualX&>()))>::type DualY;
+  typedef typename DualValue<DualY>::type Y;
+  enum { output_dimension = DualValue<DualY>::dimension };
+  typedef Eigen::Matrix<real_t, output_dimension, input_dimension> Jacobian;
+};
+
+} // namespace internal
+
+//! Computes the Jacobian dh(x)/dx with forward-mode automatic differentiation.
+//! h is a functor with a templated call operator, such that it can be
+//! evaluated with Dual numbers:
+//!
+//!   struct Square
+//!   {
+//!     template<typename T>
+//!     Eigen::Matrix<T, 2, 1> operator()(const Eigen::Matrix<T, 2, 1>& x) const
+//!     {
+//!       return x.cwiseProduct(x);
+//!     }
+//!   };
+//!   Matrix2 J = autoDiff(Square(), Vector2(1, 2));
+//!
+//! In contrast to numericalDerivative(), h is evaluated once, the result is
+//! exact up to floating point precision, and nothing is allocated. X and the
+//! output of h must be real_t or fixed-size Eigen matrices. For rotations and
+//! transformations, write h as a function of the tangent-space perturbation
+//! and evaluate it at zero; this yields the same Jacobian as
+//! numericalDerivative() with the traits of manifold.hpp.
+//! If hx is given, it is set to h(x).
+template<typename Functor, typename X>
+typename internal::AutoDiffTraits<Functor, X>::Jacobian
+autoDiff(const Functor& h, const X& x,
+         typename internal::AutoDiffTraits<Functor, X>::Y* hx = nullptr)
+{
+  typedef internal::AutoDiffTraits<Functor, X> AutoDiffTraits;
+  typedef typename AutoDiffTraits::DualX DualX;
+  typedef typename AutoDiffTraits::DualY DualY;
+  typedef typename AutoDiffTraits::Y Y;
+  typedef typename AutoDiffTraits::Jacobian Jacobian;
+
+  DualX x_dual;
+  internal::DualOf<X, AutoDiffTraits::input_dimension>::seed(x, 0, &x_dual);
+  const DualY y_dual = h(x_dual);
+
+  Y y;
+  Jacobian J;
+  internal::DualValue<DualY>::extract(y_dual, &y, &J);
+  if (hx)
+  {
+    *hx = y;
+  }
+  return J;
+}
+
+} // namespace ze
@@ -25,58 +25,250 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <initializer_list>
 #include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
 
 #include <ze/common/logging.hpp>
+#include <ze/common/macros.hpp>
 #include <ze/common/types.hpp>
 #include <ze/common/time_conversions.hpp>
 #include <ze/common/timer.hpp>
 
 namespace ze {
 
-//! Benchmark utilty for unit tests. Runs a function many times and reports the
-//! minimum time. See test_benchmark.cpp for usage examples.
-template <typename Lambda>
-uint64_t runTimingBenchmark(
-    const Lambda& benchmark_fun, uint32_t num_iter_per_epoch, uint32_t num_epochs,
-    const std::string& benchmark_name = "", bool print_results = false)
+//! Statistics of a benchmark case. Times are per iteration in nanoseconds,
+//! computed over the epochs.
+struct BenchmarkResult
 {
-  // Define lambda that runs experiment num_iter_per_epoch times and measures.
-  auto executeFunMultipleTimes = [=]() -> int64_t
+  std::string name;
+  uint64_t num_iterations = 0u;   //!< Iterations per epoch.
+  uint32_t num_epochs = 0u;
+  uint32_t num_outliers = 0u;     //!< Epochs excluded from mean and stddev.
+  double min_ns = 0.0;
+  double median_ns = 0.0;
+  double p90_ns = 0.0;
+  double p99_ns = 0.0;
+  double max_ns = 0.0;
+  double mean_ns = 0.0;           //!< Without outliers.
+  double stddev_ns = 0.0;         //!< Without outliers.
+  double items_per_iteration = 0.0;
+
+  //! Items per second at the median time, 0 if no items were set.
+  inline double throughput() const
   {
-    Timer t;
-    // Measurement starts.
-    for (uint32_t i = 0; i < num_iter_per_epoch; ++i)
+    return median_ns > 0.0 ? items_per_iteration * 1e9 / median_ns : 0.0;
+  }
+};
+
+std::ostream& operator<<(std::ostream& out, const BenchmarkResult& result);
+
+struct BenchmarkOptions
+{
+  //! Untimed epochs before measuring, after calibration.
+  uint32_t num_warmup_epochs = 2u;
+  uint32_t num_epochs = 50u;
+  //! Iterations per epoch, 0 doubles them until an epoch takes min_epoch_ns.
+  uint64_t num_iterations = 0u;
+  int64_t min_epoch_ns = 1000000;
+  //! Epochs slower than median + outlier_threshold * 1.4826 * MAD are
+  //! outliers, e.g. due to preemption.
+  double outlier_threshold = 5.0;
+  //! Pin the benchmark thread to this CPU, -1 to leave the affinity.
+  int cpu = -1;
+};
+
+/*! Passed to a benchmark case. Everything outside of the keepRunning() loop
+ * is fixture code and not timed:
+\code{.cpp}
+  void benchmarkFoo(BenchmarkState& state)
+  {
+    std::vector<real_t> data = setupData(state.arg());
+    while (state.keepRunning())
     {
-      benchmark_fun();
+      doNotOptimizeAway(foo(data));
+    }
+    state.setItemsPerIteration(data.size());
+  }
+  ZE_BENCHMARK(benchmarkFoo, "suite/foo")->args({100, 1000});
+\endcode
+*/
+class BenchmarkState
+{
+public:
+  BenchmarkState(uint64_t num_iterations, int64_t arg)
+    : remaining_(num_iterations)
+    , arg_(arg)
+  {}
+
+  //! Returns true num_iterations times. Timing starts with the first call.
+  inline bool keepRunning()
+  {
+    if (LIKELY(remaining_ != 0u))
+    {
+      if (UNLIKELY(!running_))
+      {
+        running_ = true;
+        timer_.start();
+      }
+      --remaining_;
+      return true;
+    }
+    if (running_)
+    {
+      elapsed_ns_ += timer_.stopAndGetNanoseconds();
+      running_ = false;
     }
-    // Measurement ends.
-    return t.stopAndGetNanoseconds();
-  };
+    return false;
+  }
 
-  uint64_t min_time = std::numeric_limits<uint64_t>::max();
-  for (uint32_t i = 0; i < num_epochs; ++i)
+  //! Excludes per-iteration setup inside the loop from the timing.
+  inline void pauseTiming()
   {
-    // Call function.
-    uint64_t timing = executeFunMultipleTimes();
+    DEBUG_CHECK(running_);
+    elapsed_ns_ += timer_.stopAndGetNanoseconds();
+  }
+
+  inline void resumeTiming()
+  {
+    timer_.start();
+  }
+
+  //! Parameter of the case, 0 if it was registered without arguments.
+  inline int64_t arg() const { return arg_; }
+
+  //! E.g. the number of processed elements, used to report the throughput.
+  inline void setItemsPerIteration(double items) { items_per_iteration_ = items; }
+  inline double itemsPerIteration() const { return items_per_iteration_; }
+
+  inline int64_t elapsedNanoseconds() const { return elapsed_ns_; }
+
+private:
+  Timer timer_;
+  uint64_t remaining_;
+  int64_t arg_;
+  int64_t elapsed_ns_ = 0;
+  bool running_ = false;
+  double items_per_iteration_ = 0.0;
+};
+
+using BenchmarkFunction = std::function<void(BenchmarkState&)>;
 
-    // According to Andrei Alexandrescu, the best measure is to take the minimum.
-    // See talk: https://www.youtube.com/watch?v=vrfYLlR8X8k
-    min_time = std::min(timing, min_time);
+//! Keeps the compiler from optimizing away a computation whose result is
+//! otherwise unused.
+template<typename T>
+inline void doNotOptimizeAway(T&& value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+//! A registered benchmark case, optionally run for several arguments.
+class Benchmark
+{
+public:
+  Benchmark(const std::string& name, const BenchmarkFunction& fun)
+    : name_(name)
+    , fun_(fun)
+  {}
+
+  inline Benchmark* arg(int64_t a) { args_.push_back(a); return this; }
+  inline Benchmark* args(std::initializer_list<int64_t> a)
+  {
+    args_.insert(args_.end(), a.begin(), a.end());
+    return this;
   }
 
+  inline const std::string& name() const { return name_; }
+  inline const BenchmarkFunction& function() const { return fun_; }
+  inline const std::vector<int64_t>& arguments() const { return args_; }
+
+private:
+  std::string name_;
+  BenchmarkFunction fun_;
+  std::vector<int64_t> args_;
+};
+
+//! Registers a case in the global registry, see ZE_BENCHMARK.
+Benchmark* registerBenchmark(const std::string& name, const BenchmarkFunction& fun);
+
+std::vector<const Benchmark*> registeredBenchmarks();
+
+//! Calibrates, warms up and times a single case.
+BenchmarkResult runBenchmark(
+    const std::string& name, const BenchmarkFunction& fun, int64_t arg,
+    const BenchmarkOptions& options);
+
+//! Runs all registered cases whose name (with argument, e.g.
+//! "ringbuffer/insert/1000") contains filter.
+std::vector<BenchmarkResult> runRegisteredBenchmarks(
+    const std::string& filter, const BenchmarkOptions& options,
+    bool print_results = true);
+
+//! Writes results as JSON, see loadBenchmarkResults().
+void writeBenchmarkResults(
+    std::ostream& out, const std::vector<BenchmarkResult>& results);
+
+void saveBenchmarkResults(
+    const std::string& filename, const std::vector<BenchmarkResult>& results);
+
+std::vector<BenchmarkResult> loadBenchmarkResults(const std::string& filename);
+
+//! Compares the median times with a baseline and prints a table. Returns
+//! the number of cases that are slower than (1 + tolerance) * baseline.
+size_t compareBenchmarkResults(
+    const std::vector<BenchmarkResult>& results,
+    const std::vector<BenchmarkResult>& baseline,
+    double tolerance, std::ostream& out);
+
+//! Pins the calling thread to a CPU. Returns false if not supported.
+bool pinThreadToCpu(int cpu);
+
+//! Runs benchmark_fun num_iter_per_epoch times per epoch and returns the
+//! fastest epoch in nanoseconds.
+template <typename Lambda>
+uint64_t runTimingBenchmark(
+    const Lambda& benchmark_fun, uint32_t num_iter_per_epoch, uint32_t num_epochs,
+    const std::string& benchmark_name = "", bool print_results = false)
+{
+  BenchmarkOptions options;
+  options.num_warmup_epochs = 0u;
+  options.num_epochs = num_epochs;
+  options.num_iterations = num_iter_per_epoch;
+  const BenchmarkResult result = runBenchmark(
+        benchmark_name, [&](BenchmarkState& state) {
+    while (state.keepRunning())
+    {
+      benchmark_fun();
+    }
+  }, 0, options);
+
+  // According to Andrei Alexandrescu, the best measure is to take the minimum.
+  // See talk: https://www.youtube.com/watch?v=vrfYLlR8X8k
+  const uint64_t min_time =
+      static_cast<uint64_t>(result.min_ns * num_iter_per_epoch + 0.5);
   if(print_results)
   {
     VLOG(1) << "Benchmark: " << benchmark_name << "\n"
             << "> Time for " << num_iter_per_epoch << " iterations: "
             << nanosecToMillisecTrunc(min_time) << " milliseconds\n"
             << "> Time for 1 iteration: "
-            << nanosecToMillisecTrunc(min_time) / num_iter_per_epoch << " milliseconds";
+            << nanosecToMillisecTrunc(min_time) / num_iter_per_epoch << " milliseconds\n"
+            << "> " << result;
   }
-
   return min_time;
 }
 
-
 } // namespace ze
+
+#define ZE_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define ZE_BENCHMARK_CONCAT(a, b) ZE_BENCHMARK_CONCAT_IMPL(a, b)
+
+//! Registers fun as benchmark case with a "suite/case" name. Arguments can be
+//! chained: ZE_BENCHMARK(fun, "suite/case")->args({10, 100});
+#define ZE_BENCHMARK(fun, name)                                             \
+  static ::ze::Benchmark* ZE_BENCHMARK_CONCAT(ze_benchmark_, __LINE__)     \
+      __attribute__((unused)) = ::ze::registerBenchmark(name, fun)
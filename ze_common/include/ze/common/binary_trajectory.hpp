@@ -0,0 +1,175 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <string>
+
+#include <ze/common/buffer.hpp>
+#include <ze/common/macros.hpp>
+#include <ze/common/mapped_file.hpp>
+#include <ze/common/noncopyable.hpp>
+#include <ze/common/transformation.hpp>
+#include <ze/common/types.hpp>
+
+//! @file binary_trajectory.hpp
+//! Versioned binary container for stamped poses that is memory mapped for
+//! reading, so loading a trajectory does not involve parsing.
+//!
+//! Layout: A 128 byte header (BinaryTrajectoryHeader), followed by arrays that
+//! each start at a multiple of 64 bytes:
+//!   - stamps [int64_t x n]
+//!   - positions [real_t 3 x n, column major]
+//!   - quaternions [real_t 4 x n, column major, (qx, qy, qz, qw)]
+//!   - optional velocities, gyroscope and accelerometer biases [real_t 3 x n]
+//! The file is written in host byte order and with the precision of real_t,
+//! both are checked when reading.
+
+namespace ze {
+
+// fwd
+class PoseSeries;
+
+struct BinaryTrajectoryHeader
+{
+  static constexpr uint32_t c_version = 1u;
+  static constexpr uint32_t c_byte_order_mark = 0x01020304u;
+
+  //! Flags
+  static constexpr uint32_t c_has_velocity_and_bias = 1u;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order_mark;
+  uint32_t scalar_size;
+  uint32_t flags;
+  uint64_t num_poses;
+  uint64_t stamps_offset;
+  uint64_t positions_offset;
+  uint64_t quaternions_offset;
+  uint64_t velocities_offset;
+  uint64_t gyro_biases_offset;
+  uint64_t accel_biases_offset;
+  uint8_t reserved[48];
+};
+static_assert(sizeof(BinaryTrajectoryHeader) == 128u,
+              "Binary trajectory header must be 128 bytes.");
+
+//! Writes a binary trajectory. The velocity and bias arrays are optional and
+//! either all or none of them have to be passed.
+void saveBinaryTrajectory(
+    const std::string& filename,
+    const Eigen::Ref<const Eigen::Matrix<int64_t, Eigen::Dynamic, 1>>& stamps,
+    const Eigen::Ref<const Positions>& positions,
+    const Eigen::Ref<const Matrix4X>& quaternions,
+    const Matrix3X* velocities = nullptr,
+    const Matrix3X* gyro_biases = nullptr,
+    const Matrix3X* accel_biases = nullptr);
+
+void saveBinaryTrajectory(
+    const std::string& filename,
+    const StampedTransformationVector& stamped_poses);
+
+//! Converts a loaded csv series. Velocities and biases are stored if series
+//! is a SWEResultSeries.
+void saveBinaryTrajectory(
+    const std::string& filename,
+    const PoseSeries& series);
+
+//! Zero-copy reader: The arrays are views into the mapped file and valid as
+//! long as the reader exists.
+class BinaryTrajectory : Noncopyable
+{
+public:
+  ZE_POINTER_TYPEDEFS(BinaryTrajectory);
+
+  using StampMap = Eigen::Map<const Eigen::Matrix<int64_t, Eigen::Dynamic, 1>>;
+  using Matrix3XMap = Eigen::Map<const Matrix3X>;
+  using Matrix4XMap = Eigen::Map<const Matrix4X>;
+
+  BinaryTrajectory() = default;
+
+  //! Fails with a CHECK if the file cannot be read.
+  explicit BinaryTrajectory(const std::string& filename);
+
+  //! Returns false if the file does not exist or is not a valid trajectory
+  //! of this version.
+  bool open(const std::string& filename);
+
+  inline size_t size() const { return header_.num_poses; }
+  inline bool hasVelocityAndBias() const
+  {
+    return header_.flags & BinaryTrajectoryHeader::c_has_velocity_and_bias;
+  }
+
+  inline StampMap stamps() const
+  {
+    return StampMap(array<int64_t>(header_.stamps_offset), size());
+  }
+  inline Matrix3XMap positions() const
+  {
+    return Matrix3XMap(array<real_t>(header_.positions_offset), 3, size());
+  }
+  //! Columns are (qx, qy, qz, qw), as Eigen::Quaternion::coeffs().
+  inline Matrix4XMap quaternions() const
+  {
+    return Matrix4XMap(array<real_t>(header_.quaternions_offset), 4, size());
+  }
+  inline Matrix3XMap velocities() const
+  {
+    DEBUG_CHECK(hasVelocityAndBias());
+    return Matrix3XMap(array<real_t>(header_.velocities_offset), 3, size());
+  }
+  inline Matrix3XMap gyroBiases() const
+  {
+    DEBUG_CHECK(hasVelocityAndBias());
+    return Matrix3XMap(array<real_t>(header_.gyro_biases_offset), 3, size());
+  }
+  inline Matrix3XMap accelBiases() const
+  {
+    DEBUG_CHECK(hasVelocityAndBias());
+    return Matrix3XMap(array<real_t>(header_.accel_biases_offset), 3, size());
+  }
+
+  Transformation transformation(size_t i) const;
+
+  StampedTransformationVector getStampedTransformationVector() const;
+
+  //! Inserts the poses in the layout of PoseSeries, i.e. [x, y, z, qx, qy,
+  //! qz, qw], e.g. to evaluate them with tools that work on a PoseSeries.
+  void insertInto(Buffer<real_t, 7>& pose_buffer) const;
+
+private:
+  template<typename T>
+  inline const T* array(uint64_t offset) const
+  {
+    return reinterpret_cast<const T*>(file_.data() + offset);
+  }
+
+  MappedFile file_;
+  BinaryTrajectoryHeader header_;
+};
+
+} // namespace ze
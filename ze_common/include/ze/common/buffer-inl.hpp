@@ -43,9 +43,9 @@ Buffer<Scalar,Dim>::getNearestValue(int64_t stamp)
   }
 
   auto it_before = iterator_equal_or_before(stamp);
-  if(it_before->first == stamp)
+  if(it_before != buffer_.end() && it_before->first == stamp)
   {
-    return std::make_tuple(it_before->first, it_before->second, true);
+    return std::make_tuple(it_before->first, Vector(it_before->second), true);
   }
 
   // Compute time difference between stamp and closest entries.
@@ -69,17 +69,17 @@ Buffer<Scalar,Dim>::getNearestValue(int64_t stamp)
   }
   else if(dt_after < 0)
   {
-    return std::make_tuple(it_before->first, it_before->second, true);
+    return std::make_tuple(it_before->first, Vector(it_before->second), true);
   }
   else if(dt_before < 0)
   {
-    return std::make_tuple(it_after->first, it_after->second, true);
+    return std::make_tuple(it_after->first, Vector(it_after->second), true);
   }
   else if(dt_after > 0 && dt_before > 0 && dt_after < dt_before)
   {
-    return std::make_tuple(it_after->first, it_after->second, true);
+    return std::make_tuple(it_after->first, Vector(it_after->second), true);
   }
-  return std::make_tuple(it_before->first, it_before->second, true);
+  return std::make_tuple(it_before->first, Vector(it_before->second), true);
 }
 
 template <typename Scalar, int Dim>
@@ -90,7 +90,7 @@ std::pair<Eigen::Matrix<Scalar, Dim, 1>, bool> Buffer<Scalar,Dim>::getOldestValu
   {
     return std::make_pair(Vector(), false);
   }
-  return std::make_pair(buffer_.begin()->second, true);
+  return std::make_pair(Vector(buffer_.begin()->second), true);
 }
 
 template <typename Scalar, int Dim>
@@ -101,7 +101,7 @@ std::pair<Eigen::Matrix<Scalar, Dim, 1>, bool> Buffer<Scalar,Dim>::getNewestValu
   {
     return std::make_pair(Vector(), false);
   }
-  return std::make_pair(buffer_.rbegin()->second, true);
+  return std::make_pair(Vector(buffer_.rbegin()->second), true);
 }
 
 template <typename Scalar, int Dim>
@@ -112,7 +112,7 @@ std::tuple<int64_t, int64_t, bool> Buffer<Scalar,Dim>::getOldestAndNewestStamp()
   {
     return std::make_tuple(-1, -1, false);
   }
-  return std::make_tuple(buffer_.begin()->first, buffer_.rbegin()->first, true);
+  return std::make_tuple(buffer_.oldestStamp(), buffer_.newestStamp(), true);
 }
 
 template <typename Scalar, int Dim>
@@ -131,8 +131,8 @@ Buffer<Scalar,Dim>::getBetweenValuesInterpolated(int64_t stamp_from, int64_t sta
     return std::make_pair(stamps, values); // return empty means unsuccessful.
   }
 
-  const int64_t oldest_stamp = buffer_.begin()->first;
-  const int64_t newest_stamp = buffer_.rbegin()->first;
+  const int64_t oldest_stamp = buffer_.oldestStamp();
+  const int64_t newest_stamp = buffer_.newestStamp();
   if(stamp_from < oldest_stamp)
   {
     LOG(WARNING) << "Requests older timestamp than in buffer.";
@@ -158,15 +158,8 @@ Buffer<Scalar,Dim>::getBetweenValuesInterpolated(int64_t stamp_from, int64_t sta
     return std::make_pair(stamps, values); // return empty means unsuccessful.
   }
 
-  // Count number of measurements.
-  size_t n = 0;
-  auto it = it_from_after;
-  while(it != it_to_after)
-  {
-    ++n;
-    ++it;
-  }
-  n += 2;
+  // Number of measurements, the iterators are random access.
+  const size_t n = (it_to_after - it_from_after) + 2;
 
   // Interpolate values at start and end and copy in output vector.
   stamps.resize(n);
@@ -206,13 +199,13 @@ typename Buffer<Scalar,Dim>::VectorBuffer::iterator Buffer<Scalar,Dim>::iterator
   DEBUG_CHECK(!mutex_.try_lock()) << "Call lock() before accessing data.";
   auto it = buffer_.lower_bound(stamp);
 
-  if(it->first == stamp)
+  if(it == buffer_.end())
   {
-    return it; // Return iterator to key if exact key exists.
+    return (--buffer_.end()); // Pointer to last value.
   }
-  if(stamp > buffer_.rbegin()->first)
+  if(it->first == stamp)
   {
-    return (--buffer_.end()); // Pointer to last value.
+    return it; // Return iterator to key if exact key exists.
   }
   if(it == buffer_.begin())
   {
@@ -25,25 +25,27 @@
 
 #pragma once
 
-#include <map>
 #include <tuple>
 #include <thread>
 #include <utility>
 #include <mutex>
 
 #include <ze/common/logging.hpp>
+#include <ze/common/sorted_time_series.hpp>
 #include <ze/common/types.hpp>
 #include <ze/common/time_conversions.hpp>
 
 namespace ze {
 
 // Oldest entry: buffer.begin(), newest entry: buffer.rbegin()
+// The samples are stored sorted and contiguously (see SortedTimeSeries), so
+// in-order insertion is amortized O(1) and lookups are binary searches.
 template <typename Scalar, int Dim>
 class Buffer
 {
 public:
   using Vector = Eigen::Matrix<Scalar, Dim, 1>;
-  using VectorBuffer = std::map<int64_t, Vector, std::less<int64_t>, Eigen::aligned_allocator<std::pair<const int64_t,Vector>>>;
+  using VectorBuffer = SortedTimeSeries<Scalar, Dim>;
 
   static constexpr int kDim = Dim;
 
@@ -65,15 +67,35 @@ public:
   inline void insert(int64_t stamp, const Vector& data)
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    buffer_[stamp] = data;
+    buffer_.insert(stamp, data);
     if(buffer_size_nanosec_ > 0)
     {
       removeDataBeforeTimestamp_impl(
-            buffer_.rbegin()->first - buffer_size_nanosec_);
+            buffer_.newestStamp() - buffer_size_nanosec_);
 
     }
   }
 
+  //! Inserts n samples at once, values holds Dim scalars per sample. Ordered
+  //! samples are appended in bulk.
+  inline void insert(const int64_t* stamps, const Scalar* values, size_t n)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer_.insert(stamps, values, n);
+    if(buffer_size_nanosec_ > 0 && !buffer_.empty())
+    {
+      removeDataBeforeTimestamp_impl(
+            buffer_.newestStamp() - buffer_size_nanosec_);
+    }
+  }
+
+  //! Preallocates memory for n samples, e.g. before loading a file.
+  inline void reserve(size_t n)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer_.reserve(n);
+  }
+
   //! Get value with timestamp closest to stamp. Boolean in returns if successful.
   std::tuple<int64_t, Vector, bool> getNearestValue(int64_t stamp);
 
@@ -126,7 +148,7 @@ public:
       return;
 
     removeDataBeforeTimestamp_impl(
-          buffer_.rbegin()->first - secToNanosec(seconds));
+          buffer_.newestStamp() - secToNanosec(seconds));
   }
 
   inline void lock() const
@@ -156,8 +178,7 @@ protected:
 
   inline void removeDataBeforeTimestamp_impl(int64_t stamp)
   {
-    auto it = buffer_.lower_bound(stamp);
-    buffer_.erase(buffer_.begin(), it);
+    buffer_.eraseBefore(buffer_.lower_bound(stamp));
   }
 };
 
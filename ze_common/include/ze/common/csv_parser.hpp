@@ -0,0 +1,265 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+//! @file csv_parser.hpp
+//! Allocation-free number parsing on character ranges, e.g. memory mapped
+//! csv files. In contrast to std::stod and std::stoll, no std::string has to
+//! be constructed per field.
+
+namespace ze {
+
+namespace internal {
+
+inline bool isDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+inline const char* skipBlanks(const char* begin, const char* end)
+{
+  while (begin != end && (*begin == ' ' || *begin == '\t'))
+  {
+    ++begin;
+  }
+  return begin;
+}
+
+//! Fallback for numbers the fast path cannot round exactly.
+inline const char* parseDoubleSlow(const char* begin, const char* end,
+                                   double* value)
+{
+  char buffer[64];
+  const size_t length = static_cast<size_t>(end - begin);
+  std::string long_token;
+  const char* token = buffer;
+  if (length < sizeof(buffer))
+  {
+    std::memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+  }
+  else
+  {
+    long_token.assign(begin, end);
+    token = long_token.c_str();
+  }
+  char* token_end;
+  *value = std::strtod(token, &token_end);
+  if (token_end == token)
+  {
+    return nullptr;
+  }
+  return begin + (token_end - token);
+}
+
+//! Mantissas of up to 19 digits (e.g. values printed with 17 significant
+//! digits) do not fit into a double but into an 80-bit long double, as do
+//! powers of ten up to 1e27. The single rounded operation in long double is
+//! then only rounded again to double if that cannot be a double rounding
+//! error, i.e. if the result is not within the long double error of a
+//! midpoint between two doubles. Returns false otherwise.
+inline bool parseDoubleExtended(uint64_t mantissa, int exponent, double* value)
+{
+  static constexpr long double c_exact_powers_of_ten[] = {
+    1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L,
+    1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L,
+    1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L };
+  if (std::numeric_limits<long double>::digits < 64
+      || exponent < -27 || exponent > 27)
+  {
+    return false;
+  }
+  long double result = static_cast<long double>(mantissa);
+  if (exponent < 0)
+  {
+    result /= c_exact_powers_of_ten[-exponent];
+  }
+  else
+  {
+    result *= c_exact_powers_of_ten[exponent];
+  }
+  const double rounded = static_cast<double>(result);
+  const double neighbour = std::nextafter(
+        rounded, result > rounded ? std::numeric_limits<double>::infinity()
+                                  : -std::numeric_limits<double>::infinity());
+  const long double midpoint =
+      (static_cast<long double>(rounded) + neighbour) / 2.0L;
+  if (std::abs(result - midpoint)
+      <= std::abs(result) * std::numeric_limits<long double>::epsilon())
+  {
+    return false;
+  }
+  *value = rounded;
+  return true;
+}
+
+} // namespace internal
+
+//! Parses a decimal integer at the beginning of [begin, end), leading blanks
+//! are skipped. Returns a pointer past the last digit or nullptr if there is
+//! no number. Like std::stoll, trailing characters are not consumed.
+inline const char* parseInt64(const char* begin, const char* end,
+                              int64_t* value)
+{
+  const char* p = internal::skipBlanks(begin, end);
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+  if (p == end || !internal::isDigit(*p))
+  {
+    return nullptr;
+  }
+  uint64_t result = 0u;
+  for (; p != end && internal::isDigit(*p); ++p)
+  {
+    result = result * 10u + static_cast<uint64_t>(*p - '0');
+  }
+  *value = negative ? -static_cast<int64_t>(result)
+                    : static_cast<int64_t>(result);
+  return p;
+}
+
+//! Parses a floating point number at the beginning of [begin, end), leading
+//! blanks are skipped. Returns a pointer past the number or nullptr if there
+//! is none. The result is correctly rounded: Numbers whose mantissa and power
+//! of ten are exact doubles take a single multiplication or division, numbers
+//! with at most 19 significant digits mostly go through long double, and all
+//! others through std::strtod.
+inline const char* parseDouble(const char* begin, const char* end,
+                               double* value)
+{
+  static constexpr double c_exact_powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+  static constexpr uint64_t c_max_exact_mantissa = uint64_t{1} << 53;
+
+  const char* token = internal::skipBlanks(begin, end);
+  const char* p = token;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  uint64_t mantissa = 0u;
+  int num_significant = 0;
+  int exponent = 0;
+  bool has_digits = false;
+  bool truncated = false;
+  for (; p != end && internal::isDigit(*p); ++p)
+  {
+    has_digits = true;
+    if (num_significant < 19)
+    {
+      mantissa = mantissa * 10u + static_cast<uint64_t>(*p - '0');
+      num_significant += (mantissa != 0u);
+    }
+    else
+    {
+      truncated = true;
+    }
+  }
+  if (p != end && *p == '.')
+  {
+    for (++p; p != end && internal::isDigit(*p); ++p)
+    {
+      has_digits = true;
+      if (num_significant < 19)
+      {
+        mantissa = mantissa * 10u + static_cast<uint64_t>(*p - '0');
+        num_significant += (mantissa != 0u);
+        --exponent;
+      }
+      else
+      {
+        truncated = true;
+      }
+    }
+  }
+  if (!has_digits)
+  {
+    // nan, inf or no number at all.
+    return internal::parseDoubleSlow(token, end, value);
+  }
+  if (p != end && (*p == 'e' || *p == 'E'))
+  {
+    const char* exponent_begin = p + 1;
+    bool negative_exponent = false;
+    if (exponent_begin != end
+        && (*exponent_begin == '-' || *exponent_begin == '+'))
+    {
+      negative_exponent = (*exponent_begin == '-');
+      ++exponent_begin;
+    }
+    if (exponent_begin != end && internal::isDigit(*exponent_begin))
+    {
+      int explicit_exponent = 0;
+      for (p = exponent_begin; p != end && internal::isDigit(*p); ++p)
+      {
+        if (explicit_exponent < 100000)
+        {
+          explicit_exponent = explicit_exponent * 10 + (*p - '0');
+        }
+      }
+      exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+    }
+  }
+
+  double result;
+  if (!truncated && mantissa <= c_max_exact_mantissa
+      && exponent >= -22 && exponent <= 22)
+  {
+    result = static_cast<double>(mantissa);
+    if (exponent < 0)
+    {
+      result /= c_exact_powers_of_ten[-exponent];
+    }
+    else
+    {
+      result *= c_exact_powers_of_ten[exponent];
+    }
+  }
+  else if (truncated
+           || !internal::parseDoubleExtended(mantissa, exponent, &result))
+  {
+    return internal::parseDoubleSlow(token, p, value) ? p : nullptr;
+  }
+  *value = negative ? -result : result;
+  return p;
+}
+
+} // namespace ze
@@ -25,6 +25,9 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+
 #include <ze/common/buffer.hpp>
 #include <ze/common/file_utils.hpp>
 #include <ze/common/macros.hpp>
@@ -42,21 +45,28 @@ public:
   ZE_POINTER_TYPEDEFS(CSVTrajectory);
 
   virtual void load(const std::string& in_file_path) = 0;
+
+  //! Called by load() with the stamp field of every row. Parses integer
+  //! nanoseconds like std::stoll, override it for other stamp formats.
   virtual int64_t getTimeStamp(const std::string& ts_str) const;
 
+  //! Splits large files into chunks that are parsed in parallel by
+  //! num_threads threads. Default is a single thread.
+  inline void setNumLoadThreads(size_t num_threads)
+  {
+    num_load_threads_ = num_threads;
+  }
+
 protected:
   CSVTrajectory() = default;
 
-  void readHeader(const std::string& in_file_path);
-  Vector3 readTranslation(const std::vector<std::string>& items);
-  Vector4 readOrientation(const std::vector<std::string>& items);
-  Vector7 readPose(const std::vector<std::string>& items);
-
-  std::ifstream in_str_;
   std::map<std::string, int> order_;
   std::string header_;
   const char delimiter_{','};
   size_t num_tokens_in_line_;
+  //! Lines starting with one of these characters are skipped.
+  std::string comment_chars_{"%#"};
+  size_t num_load_threads_{1u};
 };
 
 class PositionSeries : public CSVTrajectory
@@ -94,7 +104,19 @@ protected:
 class SWEResultSeries : public PoseSeries
 {
 public:
+  ZE_POINTER_TYPEDEFS(SWEResultSeries);
+
   SWEResultSeries();
+
+  //! Loads the poses and the velocity and bias columns.
+  virtual void load(const std::string& in_file_path) override;
+
+  //! Velocity, gyroscope bias and accelerometer bias for each pose stamp.
+  const Buffer<real_t, 9>& getVelocityAndBiasBuffer() const;
+  Buffer<real_t, 9>& getVelocityAndBiasBuffer();
+
+protected:
+  Buffer<real_t, 9> velocity_bias_buf_;
 };
 
 class SWEGlobalSeries : public PoseSeries
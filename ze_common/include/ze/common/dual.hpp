@@ -0,0 +1,304 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <ostream>
+
+#include <Eigen/Core>
+
+namespace ze {
+
+//! Dual number for forward-mode automatic differentiation. Holds the value a
+//! and the N partial derivatives v with respect to the seeded inputs. The
+//! size is known at compile time, so all arithmetic stays on the stack and is
+//! vectorized by Eigen.
+//!
+//! Dual works as scalar type T of the template<typename T> kernels, e.g. in
+//! camera_models.hpp, as long as these call the math functions unqualified
+//! (using std::sqrt; sqrt(x);) such that argument dependent lookup finds the
+//! overloads below. See autoDiff() in auto_diff.hpp.
+template<typename Scalar, int N>
+struct Dual
+{
+  typedef Eigen::Matrix<Scalar, N, 1> Derivatives;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  Scalar a;
+  Derivatives v;
+
+  //! Zero value and zero derivatives.
+  Dual()
+    : a(Scalar(0))
+  {
+    v.setZero();
+  }
+
+  //! Constant: zero derivatives. Implicit, such that literals in the kernels
+  //! can be used as in scalar code.
+  Dual(Scalar value)
+    : a(value)
+  {
+    v.setZero();
+  }
+
+  //! Input variable: derivative one with respect to the i-th input.
+  Dual(Scalar value, int i)
+    : a(value)
+  {
+    v.setZero();
+    v(i) = Scalar(1);
+  }
+
+  template<typename Derived>
+  Dual(Scalar value, const Eigen::MatrixBase<Derived>& derivatives)
+    : a(value)
+    , v(derivatives)
+  {}
+
+  // ---------------------------------------------------------------------------
+  // Compound assignment.
+
+  inline Dual& operator+=(const Dual& y)
+  {
+    a += y.a;
+    v += y.v;
+    return *this;
+  }
+
+  inline Dual& operator-=(const Dual& y)
+  {
+    a -= y.a;
+    v -= y.v;
+    return *this;
+  }
+
+  inline Dual& operator*=(const Dual& y)
+  {
+    v = v * y.a + y.v * a;
+    a *= y.a;
+    return *this;
+  }
+
+  inline Dual& operator/=(const Dual& y)
+  {
+    const Scalar inv = Scalar(1) / y.a;
+    a *= inv;
+    v = (v - y.v * a) * inv;
+    return *this;
+  }
+
+  inline Dual& operator+=(Scalar s) { a += s; return *this; }
+  inline Dual& operator-=(Scalar s) { a -= s; return *this; }
+  inline Dual& operator*=(Scalar s) { a *= s; v *= s; return *this; }
+  inline Dual& operator/=(Scalar s) { return *this *= Scalar(1) / s; }
+
+  // ---------------------------------------------------------------------------
+  // Arithmetic. Defined as friends so that mixed expressions with scalars of
+  // other types (e.g. 2 * x, 1.0 / x) resolve by implicit conversion.
+
+  friend inline Dual operator+(const Dual& x) { return x; }
+  friend inline Dual operator-(const Dual& x) { return Dual(-x.a, -x.v); }
+
+  friend inline Dual operator+(const Dual& x, const Dual& y)
+  {
+    return Dual(x.a + y.a, x.v + y.v);
+  }
+  friend inline Dual operator+(const Dual& x, Scalar s) { return Dual(x.a + s, x.v); }
+  friend inline Dual operator+(Scalar s, const Dual& x) { return Dual(s + x.a, x.v); }
+
+  friend inline Dual operator-(const Dual& x, const Dual& y)
+  {
+    return Dual(x.a - y.a, x.v - y.v);
+  }
+  friend inline Dual operator-(const Dual& x, Scalar s) { return Dual(x.a - s, x.v); }
+  friend inline Dual operator-(Scalar s, const Dual& x) { return Dual(s - x.a, -x.v); }
+
+  friend inline Dual operator*(const Dual& x, const Dual& y)
+  {
+    return Dual(x.a * y.a, x.v * y.a + y.v * x.a);
+  }
+  friend inline Dual operator*(const Dual& x, Scalar s) { return Dual(x.a * s, x.v * s); }
+  friend inline Dual operator*(Scalar s, const Dual& x) { return Dual(s * x.a, x.v * s); }
+
+  friend inline Dual operator/(const Dual& x, const Dual& y)
+  {
+    const Scalar inv = Scalar(1) / y.a;
+    const Scalar value = x.a * inv;
+    return Dual(value, (x.v - y.v * value) * inv);
+  }
+  friend inline Dual operator/(const Dual& x, Scalar s)
+  {
+    const Scalar inv = Scalar(1) / s;
+    return Dual(x.a * inv, x.v * inv);
+  }
+  friend inline Dual operator/(Scalar s, const Dual& x)
+  {
+    const Scalar inv = Scalar(1) / x.a;
+    const Scalar value = s * inv;
+    return Dual(value, x.v * (-value * inv));
+  }
+
+  // ---------------------------------------------------------------------------
+  // Comparisons only look at the value, which keeps the branches of the
+  // kernels (e.g. rad < 0.001) identical to the scalar code.
+
+#define ZE_DUAL_COMPARISON(OP)                                                 \
+  friend inline bool operator OP(const Dual& x, const Dual& y) { return x.a OP y.a; } \
+  friend inline bool operator OP(const Dual& x, Scalar s) { return x.a OP s; } \
+  friend inline bool operator OP(Scalar s, const Dual& x) { return s OP x.a; }
+
+  ZE_DUAL_COMPARISON(<)
+  ZE_DUAL_COMPARISON(<=)
+  ZE_DUAL_COMPARISON(>)
+  ZE_DUAL_COMPARISON(>=)
+  ZE_DUAL_COMPARISON(==)
+  ZE_DUAL_COMPARISON(!=)
+#undef ZE_DUAL_COMPARISON
+
+  // ---------------------------------------------------------------------------
+  // Math functions, found by argument dependent lookup.
+
+  friend inline Dual abs(const Dual& x)
+  {
+    return x.a < Scalar(0) ? -x : x;
+  }
+
+  friend inline Dual sqrt(const Dual& x)
+  {
+    const Scalar s = std::sqrt(x.a);
+    return Dual(s, x.v * (Scalar(0.5) / s));
+  }
+
+  friend inline Dual exp(const Dual& x)
+  {
+    const Scalar e = std::exp(x.a);
+    return Dual(e, x.v * e);
+  }
+
+  friend inline Dual log(const Dual& x)
+  {
+    return Dual(std::log(x.a), x.v * (Scalar(1) / x.a));
+  }
+
+  friend inline Dual pow(const Dual& x, Scalar p)
+  {
+    const Scalar x_pow = std::pow(x.a, p - Scalar(1));
+    return Dual(x_pow * x.a, x.v * (p * x_pow));
+  }
+
+  friend inline Dual sin(const Dual& x)
+  {
+    return Dual(std::sin(x.a), x.v * std::cos(x.a));
+  }
+
+  friend inline Dual cos(const Dual& x)
+  {
+    return Dual(std::cos(x.a), x.v * (-std::sin(x.a)));
+  }
+
+  friend inline Dual tan(const Dual& x)
+  {
+    const Scalar t = std::tan(x.a);
+    return Dual(t, x.v * (Scalar(1) + t * t));
+  }
+
+  friend inline Dual asin(const Dual& x)
+  {
+    return Dual(std::asin(x.a), x.v * (Scalar(1) / std::sqrt(Scalar(1) - x.a * x.a)));
+  }
+
+  friend inline Dual acos(const Dual& x)
+  {
+    return Dual(std::acos(x.a), x.v * (Scalar(-1) / std::sqrt(Scalar(1) - x.a * x.a)));
+  }
+
+  friend inline Dual atan(const Dual& x)
+  {
+    return Dual(std::atan(x.a), x.v * (Scalar(1) / (Scalar(1) + x.a * x.a)));
+  }
+
+  friend inline Dual atan2(const Dual& y, const Dual& x)
+  {
+    const Scalar inv = Scalar(1) / (x.a * x.a + y.a * y.a);
+    return Dual(std::atan2(y.a, x.a), (y.v * x.a - x.v * y.a) * inv);
+  }
+
+  friend inline std::ostream& operator<<(std::ostream& out, const Dual& x)
+  {
+    out << "[" << x.a << "; " << x.v.transpose() << "]";
+    return out;
+  }
+};
+
+} // namespace ze
+
+namespace Eigen {
+
+//! Allows Dual as scalar of Eigen matrices.
+template<typename Scalar, int N>
+struct NumTraits<ze::Dual<Scalar, N>> : NumTraits<Scalar>
+{
+  typedef ze::Dual<Scalar, N> Real;
+  typedef ze::Dual<Scalar, N> NonInteger;
+  typedef ze::Dual<Scalar, N> Nested;
+  typedef ze::Dual<Scalar, N> Literal;
+
+  enum {
+    IsComplex = 0,
+    IsInteger = 0,
+    IsSigned = 1,
+    RequireInitialization = 1,
+    ReadCost = (N + 1) * NumTraits<Scalar>::ReadCost,
+    AddCost = (N + 1) * NumTraits<Scalar>::AddCost,
+    MulCost = (2 * N + 1) * NumTraits<Scalar>::MulCost
+  };
+
+  static inline Real epsilon() { return Real(NumTraits<Scalar>::epsilon()); }
+  static inline Real dummy_precision() { return Real(NumTraits<Scalar>::dummy_precision()); }
+  static inline Real highest() { return Real(NumTraits<Scalar>::highest()); }
+  static inline Real lowest() { return Real(NumTraits<Scalar>::lowest()); }
+  static inline int digits10() { return NumTraits<Scalar>::digits10(); }
+};
+
+#if EIGEN_VERSION_AT_LEAST(3,3,0)
+//! Allows to mix Dual and Scalar in Eigen expressions, e.g. dual_vec * 2.0.
+template<typename Scalar, int N, typename BinaryOp>
+struct ScalarBinaryOpTraits<ze::Dual<Scalar, N>, Scalar, BinaryOp>
+{
+  typedef ze::Dual<Scalar, N> ReturnType;
+};
+
+template<typename Scalar, int N, typename BinaryOp>
+struct ScalarBinaryOpTraits<Scalar, ze::Dual<Scalar, N>, BinaryOp>
+{
+  typedef ze::Dual<Scalar, N> ReturnType;
+};
+#endif
+
+} // namespace Eigen
@@ -0,0 +1,253 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include <ze/common/logging.hpp>
+#include <ze/common/noncopyable.hpp>
+#include <ze/common/types.hpp>
+
+//! @file frame_arena.hpp
+//! Monotonic arena for temporaries that live at most as long as one frame.
+//!
+//! Usage:
+//!   FrameScope scope;  // Everything allocated below is released at scope exit.
+//!   auto p_C = arenaMatrix<Positions>(scope.arena(), 3, n);
+//!   FrameVector<uint32_t> indices(scope.allocator<uint32_t>());
+//!
+//! Allocation bumps a pointer, deallocation is a no-op and leaving a scope
+//! rewinds the arena in O(1). When the outermost scope of a thread ends, the
+//! chunks that were needed during the frame are merged into one, so that once
+//! the peak memory use of a frame is reached, frames do not touch the heap.
+
+namespace ze {
+
+class MonotonicArena : Noncopyable
+{
+public:
+  //! Alignment of all allocations unless a larger one is requested.
+  static constexpr size_t c_default_alignment = 64u;
+
+  //! Position in the arena, used to rewind nested scopes.
+  struct Marker
+  {
+    size_t chunk;
+    size_t offset;
+  };
+
+  explicit MonotonicArena(size_t initial_capacity = 64u * 1024u);
+
+  ~MonotonicArena();
+
+  //! @return Uninitialized memory, valid until the arena is rewound past it.
+  void* allocate(size_t num_bytes, size_t alignment = c_default_alignment);
+
+  template<typename T>
+  inline T* allocate(size_t n)
+  {
+    return static_cast<T*>(allocate(n * sizeof(T), c_default_alignment));
+  }
+
+  inline Marker mark() const
+  {
+    return Marker { current_, offset_ };
+  }
+
+  //! Releases everything allocated after the marker was taken.
+  inline void rewind(const Marker& marker)
+  {
+    DEBUG_CHECK(marker.chunk < current_
+                || (marker.chunk == current_ && marker.offset <= offset_));
+    current_ = marker.chunk;
+    offset_ = marker.offset;
+  }
+
+  //! Releases everything. If the last frame needed more than one chunk, the
+  //! chunks are replaced by a single one of the total size.
+  void reset();
+
+  //! Bytes handed out since the last reset, including alignment padding.
+  size_t bytesUsed() const;
+
+  //! Sum of all chunk sizes.
+  size_t capacity() const;
+
+  inline size_t numChunks() const { return chunks_.size(); }
+
+  //! Number of chunks requested from the heap over the lifetime of the arena.
+  inline size_t numHeapAllocations() const { return num_heap_allocations_; }
+
+private:
+  struct Chunk
+  {
+    char* data;
+    size_t size;
+  };
+
+  void* allocateSlow(size_t num_bytes, size_t alignment);
+  void freeChunks();
+
+  std::vector<Chunk> chunks_;
+  size_t current_ = 0u;
+  size_t offset_ = 0u;
+  size_t num_heap_allocations_ = 0u;
+};
+
+//! @return Frame arena of the calling thread.
+MonotonicArena& threadFrameArena();
+
+// -----------------------------------------------------------------------------
+//! STL allocator adapter. Deallocation is a no-op, memory is returned when the
+//! arena is rewound. Containers must not outlive the scope they were created in.
+template<typename T>
+class ArenaAllocator
+{
+public:
+  typedef T value_type;
+
+  explicit ArenaAllocator(MonotonicArena& arena)
+    : arena_(&arena)
+  {}
+
+  template<typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other)
+    : arena_(other.arena())
+  {}
+
+  inline T* allocate(size_t n)
+  {
+    static_assert(alignof(T) <= MonotonicArena::c_default_alignment,
+                  "Over-aligned type.");
+    return arena_->allocate<T>(n);
+  }
+
+  inline void deallocate(T* /*p*/, size_t /*n*/)
+  {}
+
+  inline MonotonicArena* arena() const { return arena_; }
+
+private:
+  MonotonicArena* arena_;
+};
+
+template<typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+  return lhs.arena() == rhs.arena();
+}
+
+template<typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template<typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+// -----------------------------------------------------------------------------
+//! Rewinds the arena to the state it had at construction. The outermost scope
+//! of an arena resets it.
+class FrameScope : Noncopyable
+{
+public:
+  FrameScope()
+    : FrameScope(threadFrameArena())
+  {}
+
+  explicit FrameScope(MonotonicArena& arena)
+    : arena_(arena)
+    , marker_(arena.mark())
+  {}
+
+  ~FrameScope()
+  {
+    if (marker_.chunk == 0u && marker_.offset == 0u)
+    {
+      arena_.reset();
+    }
+    else
+    {
+      arena_.rewind(marker_);
+    }
+  }
+
+  inline MonotonicArena& arena() { return arena_; }
+
+  template<typename T>
+  inline ArenaAllocator<T> allocator() { return ArenaAllocator<T>(arena_); }
+
+private:
+  MonotonicArena& arena_;
+  const MonotonicArena::Marker marker_;
+};
+
+// -----------------------------------------------------------------------------
+// Eigen helpers.
+
+template<typename MatrixType>
+using ArenaMap = Eigen::Map<MatrixType, Eigen::Aligned16>;
+
+//! @return Uninitialized matrix in the arena. Fixed dimensions of MatrixType
+//! must agree with rows and cols.
+template<typename MatrixType>
+ArenaMap<MatrixType> arenaMatrix(MonotonicArena& arena, int rows, int cols)
+{
+  DEBUG_CHECK(MatrixType::RowsAtCompileTime == Eigen::Dynamic
+              || MatrixType::RowsAtCompileTime == rows);
+  DEBUG_CHECK(MatrixType::ColsAtCompileTime == Eigen::Dynamic
+              || MatrixType::ColsAtCompileTime == cols);
+  typedef typename MatrixType::Scalar Scalar;
+  return ArenaMap<MatrixType>(
+        arena.allocate<Scalar>(static_cast<size_t>(rows) * cols), rows, cols);
+}
+
+//! @return Uninitialized vector in the arena.
+template<typename VectorType>
+ArenaMap<VectorType> arenaVector(MonotonicArena& arena, int size)
+{
+  typedef typename VectorType::Scalar Scalar;
+  return ArenaMap<VectorType>(arena.allocate<Scalar>(size), size);
+}
+
+//! @return Evaluates the expression into a matrix in the arena.
+template<typename Derived>
+ArenaMap<typename Derived::PlainObject> arenaCopy(
+    MonotonicArena& arena, const Eigen::MatrixBase<Derived>& expression)
+{
+  ArenaMap<typename Derived::PlainObject> m =
+      arenaMatrix<typename Derived::PlainObject>(
+        arena, expression.rows(), expression.cols());
+  m = expression;
+  return m;
+}
+
+} // namespace ze
@@ -0,0 +1,871 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <ze/common/noncopyable.hpp>
+
+namespace ze {
+
+namespace internal {
+
+constexpr size_t c_cache_line_size = 64u;
+
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+//! Waits for a condition by spinning first and parking on a condition variable
+//! only if the condition does not become true quickly. notifyAll() is a single
+//! atomic load as long as no thread is parked.
+class SpinParkWaiter : Noncopyable
+{
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  //! Blocks until ready() returns true.
+  template<typename Pred>
+  void wait(const Pred& ready)
+  {
+    if (spin(ready))
+    {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    num_parked_.fetch_add(1u);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    cond_.wait(lock, ready);
+    num_parked_.fetch_sub(1u);
+  }
+
+  //! Blocks until ready() returns true or the deadline passed.
+  //! Returns the last value of ready().
+  template<typename Pred>
+  bool waitUntil(const Pred& ready, const Clock::time_point& deadline)
+  {
+    if (spin(ready))
+    {
+      return true;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    num_parked_.fetch_add(1u);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool result = cond_.wait_until(lock, deadline, ready);
+    num_parked_.fetch_sub(1u);
+    return result;
+  }
+
+  //! Wakes all parked threads. Must be called after the state that ready()
+  //! checks was published.
+  inline void notifyAll()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (num_parked_.load(std::memory_order_relaxed) > 0u)
+    {
+      // Taking the lock ensures that a thread between checking ready() and
+      // going to sleep does not miss the notification.
+      std::lock_guard<std::mutex> lock(mutex_);
+      cond_.notify_all();
+    }
+  }
+
+private:
+  static constexpr int c_spin_iterations = 256;
+  static constexpr int c_yield_iterations = 16;
+
+  template<typename Pred>
+  bool spin(const Pred& ready)
+  {
+    for (int i = 0; i < c_spin_iterations; ++i)
+    {
+      if (ready())
+      {
+        return true;
+      }
+      cpuRelax();
+    }
+    for (int i = 0; i < c_yield_iterations; ++i)
+    {
+      if (ready())
+      {
+        return true;
+      }
+      std::this_thread::yield();
+    }
+    return false;
+  }
+
+  std::atomic<unsigned> num_parked_ { 0u };
+  std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
+inline SpinParkWaiter::Clock::time_point deadlineFromTimeout(unsigned timeout_ms)
+{
+  return SpinParkWaiter::Clock::now() + std::chrono::milliseconds(timeout_ms);
+}
+
+} // namespace internal
+
+/*!
+ * @brief Lock-free FIFO for exactly one writer and one reader thread.
+ *
+ * Drop-in alternative to ThreadSafeFifo for single-producer/single-consumer
+ * hand-offs. write() and read() only touch two atomic indices, blocking calls
+ * spin briefly before they park the thread.
+ *
+ * In contrast to ThreadSafeFifo, all Capacity slots can be used. Capacity must
+ * be a power of two. The object class must be <default constructible> and
+ * <move assignable>. Elements are moved out of the buffer when read.
+ *
+ * writeBatch() and readBatch() transfer multiple elements with a single
+ * publication of the index, i.e. one synchronization per batch.
+ *
+ * clear() may only be called from the reader thread.
+ **/
+template <class T, unsigned Capacity>
+class LockFreeSpscFifo : Noncopyable
+{
+  static_assert(Capacity > 0u && (Capacity & (Capacity - 1u)) == 0u,
+                "Capacity must be a power of two.");
+public:
+
+  LockFreeSpscFifo() = default;
+  ~LockFreeSpscFifo() = default;
+
+  /*!
+   * @name Status
+   * The returned values are snapshots if called concurrently.
+   **/
+  //@{
+  bool empty() const { return size() == 0u; }
+  bool full() const { return size() == Capacity; }
+  unsigned size() const;
+  static constexpr unsigned capacity() { return Capacity; }
+  //@} // Status
+
+  /*!
+   * @name Data Access
+   * Semantics are the same as in ThreadSafeFifo. Timeouts are in milliseconds.
+   **/
+  //@{
+  void write(const T& data);
+  void write(T&& data);
+  bool nonBlockingWrite(const T& data);
+  bool nonBlockingWrite(T&& data);
+  bool timedWrite(const T& data, unsigned timeout);
+  bool timedWrite(T&& data, unsigned timeout);
+
+  T read();
+  bool nonBlockingRead(T& data);
+  bool timedRead(T& data, unsigned timeout);
+
+  void clear();
+  //@} // Data Access
+
+  /*!
+   * @name Batch Access
+   **/
+  //@{
+
+  //! Moves all n elements into the buffer, blocks while the buffer is full.
+  void writeBatch(T* data, size_t n);
+
+  //! Moves as many of the n elements as fit into the buffer.
+  //! Returns the number of written elements.
+  size_t nonBlockingWriteBatch(T* data, size_t n);
+
+  //! Reads at least one and up to max_n elements, blocks while the buffer is
+  //! empty. Returns the number of read elements.
+  size_t readBatch(T* data, size_t max_n);
+
+  //! Reads up to max_n available elements. Returns the number of read elements.
+  size_t nonBlockingReadBatch(T* data, size_t max_n);
+
+  //! Reads up to max_n elements, waits for the specified timeout if the buffer
+  //! is empty. Returns the number of read elements.
+  size_t timedReadBatch(T* data, size_t max_n, unsigned timeout);
+  //@} // Batch Access
+
+private:
+  static constexpr size_t c_mask = Capacity - 1u;
+
+  template<typename U> bool tryWrite(U&& data);
+  bool tryRead(T& data);
+
+  inline size_t freeSlots() const
+  {
+    return Capacity - (tail_.load(std::memory_order_relaxed)
+                       - head_.load(std::memory_order_acquire));
+  }
+
+  inline size_t availableSlots() const
+  {
+    return tail_.load(std::memory_order_acquire)
+        - head_.load(std::memory_order_relaxed);
+  }
+
+  // Reader and writer indices on separate cache lines to avoid false sharing.
+  // Both grow monotonically, the slot is index & c_mask.
+  std::atomic<size_t> head_ { 0u };
+  char pad0_[internal::c_cache_line_size - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> tail_ { 0u };
+  char pad1_[internal::c_cache_line_size - sizeof(std::atomic<size_t>)];
+
+  std::array<T, Capacity> buf_;
+
+  internal::SpinParkWaiter not_empty_;
+  internal::SpinParkWaiter not_full_;
+}; // LockFreeSpscFifo
+
+/*!
+ * @brief Bounded lock-free FIFO for an arbitrary number of writer and reader
+ * threads.
+ *
+ * Every slot carries a sequence number that tells whether it is ready to be
+ * written or read in the current lap (D. Vyukov's bounded MPMC queue). Writers
+ * and readers claim positions with a CAS on their respective index and never
+ * block each other unless the buffer is full or empty.
+ *
+ * Capacity must be a power of two and all slots can be used. The object class
+ * must be <default constructible> and <move assignable>.
+ *
+ * writeBatch() and readBatch() claim a contiguous range of positions with one
+ * CAS. Within a claimed range, a slot may still be in use by a slower thread of
+ * the previous lap, in which case the batch operation spins on that slot.
+ **/
+template <class T, unsigned Capacity>
+class LockFreeMpmcFifo : Noncopyable
+{
+  static_assert(Capacity > 1u && (Capacity & (Capacity - 1u)) == 0u,
+                "Capacity must be a power of two.");
+public:
+
+  LockFreeMpmcFifo();
+  ~LockFreeMpmcFifo() = default;
+
+  /*!
+   * @name Status
+   * The returned values are snapshots if called concurrently.
+   **/
+  //@{
+  bool empty() const { return size() == 0u; }
+  bool full() const { return size() == Capacity; }
+  unsigned size() const;
+  static constexpr unsigned capacity() { return Capacity; }
+  //@} // Status
+
+  /*!
+   * @name Data Access
+   * Semantics are the same as in ThreadSafeFifo. Timeouts are in milliseconds.
+   **/
+  //@{
+  void write(const T& data);
+  void write(T&& data);
+  bool nonBlockingWrite(const T& data);
+  bool nonBlockingWrite(T&& data);
+  bool timedWrite(const T& data, unsigned timeout);
+  bool timedWrite(T&& data, unsigned timeout);
+
+  T read();
+  bool nonBlockingRead(T& data);
+  bool timedRead(T& data, unsigned timeout);
+
+  //! Reads and discards all elements that are currently available.
+  void clear();
+  //@} // Data Access
+
+  /*!
+   * @name Batch Access
+   * Same semantics as in LockFreeSpscFifo.
+   **/
+  //@{
+  void writeBatch(T* data, size_t n);
+  size_t nonBlockingWriteBatch(T* data, size_t n);
+  size_t readBatch(T* data, size_t max_n);
+  size_t nonBlockingReadBatch(T* data, size_t max_n);
+  size_t timedReadBatch(T* data, size_t max_n, unsigned timeout);
+  //@} // Batch Access
+
+private:
+  static constexpr size_t c_mask = Capacity - 1u;
+
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+  template<typename U> bool tryWrite(U&& data);
+  bool tryRead(T& data);
+
+  inline size_t freeSlots() const
+  {
+    const size_t dequeue = dequeue_pos_.load(std::memory_order_acquire);
+    const size_t enqueue = enqueue_pos_.load(std::memory_order_acquire);
+    return (enqueue - dequeue >= Capacity) ? 0u : Capacity - (enqueue - dequeue);
+  }
+
+  inline size_t availableSlots() const
+  {
+    const size_t dequeue = dequeue_pos_.load(std::memory_order_acquire);
+    const size_t enqueue = enqueue_pos_.load(std::memory_order_acquire);
+    return (enqueue > dequeue) ? enqueue - dequeue : 0u;
+  }
+
+  std::array<Cell, Capacity> buf_;
+  char pad0_[internal::c_cache_line_size];
+  std::atomic<size_t> enqueue_pos_ { 0u };
+  char pad1_[internal::c_cache_line_size - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> dequeue_pos_ { 0u };
+  char pad2_[internal::c_cache_line_size - sizeof(std::atomic<size_t>)];
+
+  internal::SpinParkWaiter not_empty_;
+  internal::SpinParkWaiter not_full_;
+}; // LockFreeMpmcFifo
+
+// -----------------------------------------------------------------------------
+// LockFreeSpscFifo
+
+template<typename T, unsigned Capacity>
+unsigned LockFreeSpscFifo<T, Capacity>::size() const
+{
+  return static_cast<unsigned>(tail_.load(std::memory_order_acquire)
+                               - head_.load(std::memory_order_acquire));
+}
+
+template<typename T, unsigned Capacity>
+template<typename U>
+bool LockFreeSpscFifo<T, Capacity>::tryWrite(U&& data)
+{
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) == Capacity)
+  {
+    return false;
+  }
+  buf_[tail & c_mask] = std::forward<U>(data);
+  tail_.store(tail + 1u, std::memory_order_release);
+  not_empty_.notifyAll();
+  return true;
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeSpscFifo<T, Capacity>::tryRead(T& data)
+{
+  const size_t head = head_.load(std::memory_order_relaxed);
+  if (tail_.load(std::memory_order_acquire) == head)
+  {
+    return false;
+  }
+  data = std::move(buf_[head & c_mask]);
+  head_.store(head + 1u, std::memory_order_release);
+  not_full_.notifyAll();
+  return true;
+}
+
+template<typename T, unsigned Capacity>
+void LockFreeSpscFifo<T, Capacity>::write(const T& data)
+{
+  while (!tryWrite(data))
+  {
+    not_full_.wait([this]{ return freeSlots() > 0u; });
+  }
+}
+
+template<typename T, unsigned Capacity>
+void LockFreeSpscFifo<T, Capacity>::write(T&& data)
+{
+  not_full_.wait([this]{ return freeSlots() > 0u; });
+  tryWrite(std::move(data));
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeSpscFifo<T, Capacity>::nonBlockingWrite(const T& data)
+{
+  return tryWrite(data);
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeSpscFifo<T, Capacity>::nonBlockingWrite(T&& data)
+{
+  return tryWrite(std::move(data));
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeSpscFifo<T, Capacity>::timedWrite(const T& data, unsigned timeout)
+{
+  if (!not_full_.waitUntil([this]{ return freeSlots() > 0u; },
+                           internal::deadlineFromTimeout(timeout)))
+  {
+    return false;
+  }
+  return tryWrite(data);
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeSpscFifo<T, Capacity>::timedWrite(T&& data, unsigned timeout)
+{
+  if (!not_full_.waitUntil([this]{ return freeSlots() > 0u; },
+                           internal::deadlineFromTimeout(timeout)))
+  {
+    return false;
+  }
+  return tryWrite(std::move(data));
+}
+
+template<typename T, unsigned Capacity>
+T LockFreeSpscFifo<T, Capacity>::read()
+{
+  not_empty_.wait([this]{ return availableSlots() > 0u; });
+  T data;
+  tryRead(data);
+  return data;
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeSpscFifo<T, Capacity>::nonBlockingRead(T& data)
+{
+  return tryRead(data);
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeSpscFifo<T, Capacity>::timedRead(T& data, unsigned timeout)
+{
+  if (!not_empty_.waitUntil([this]{ return availableSlots() > 0u; },
+                            internal::deadlineFromTimeout(timeout)))
+  {
+    return false;
+  }
+  return tryRead(data);
+}
+
+template<typename T, unsigned Capacity>
+void LockFreeSpscFifo<T, Capacity>::clear()
+{
+  const size_t tail = tail_.load(std::memory_order_acquire);
+  for (size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+  {
+    buf_[i & c_mask] = T();
+  }
+  head_.store(tail, std::memory_order_release);
+  not_full_.notifyAll();
+}
+
+template<typename T, unsigned Capacity>
+size_t LockFreeSpscFifo<T, Capacity>::nonBlockingWriteBatch(T* data, size_t n)
+{
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  const size_t num = std::min(n, freeSlots());
+  for (size_t i = 0u; i < num; ++i)
+  {
+    buf_[(tail + i) & c_mask] = std::move(data[i]);
+  }
+  if (num > 0u)
+  {
+    tail_.store(tail + num, std::memory_order_release);
+    not_empty_.notifyAll();
+  }
+  return num;
+}
+
+template<typename T, unsigned Capacity>
+void LockFreeSpscFifo<T, Capacity>::writeBatch(T* data, size_t n)
+{
+  size_t written = nonBlockingWriteBatch(data, n);
+  while (written < n)
+  {
+    not_full_.wait([this]{ return freeSlots() > 0u; });
+    written += nonBlockingWriteBatch(data + written, n - written);
+  }
+}
+
+template<typename T, unsigned Capacity>
+size_t LockFreeSpscFifo<T, Capacity>::nonBlockingReadBatch(T* data, size_t max_n)
+{
+  const size_t head = head_.load(std::memory_order_relaxed);
+  const size_t num = std::min(max_n, availableSlots());
+  for (size_t i = 0u; i < num; ++i)
+  {
+    data[i] = std::move(buf_[(head + i) & c_mask]);
+  }
+  if (num > 0u)
+  {
+    head_.store(head + num, std::memory_order_release);
+    not_full_.notifyAll();
+  }
+  return num;
+}
+
+template<typename T, unsigned Capacity>
+size_t LockFreeSpscFifo<T, Capacity>::readBatch(T* data, size_t max_n)
+{
+  if (max_n == 0u)
+  {
+    return 0u;
+  }
+  not_empty_.wait([this]{ return availableSlots() > 0u; });
+  return nonBlockingReadBatch(data, max_n);
+}
+
+template<typename T, unsigned Capacity>
+size_t LockFreeSpscFifo<T, Capacity>::timedReadBatch(
+    T* data, size_t max_n, unsigned timeout)
+{
+  if (max_n == 0u
+      || !not_empty_.waitUntil([this]{ return availableSlots() > 0u; },
+                               internal::deadlineFromTimeout(timeout)))
+  {
+    return 0u;
+  }
+  return nonBlockingReadBatch(data, max_n);
+}
+
+// -----------------------------------------------------------------------------
+// LockFreeMpmcFifo
+
+template<typename T, unsigned Capacity>
+LockFreeMpmcFifo<T, Capacity>::LockFreeMpmcFifo()
+{
+  for (size_t i = 0u; i < Capacity; ++i)
+  {
+    buf_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+template<typename T, unsigned Capacity>
+unsigned LockFreeMpmcFifo<T, Capacity>::size() const
+{
+  return static_cast<unsigned>(std::min<size_t>(availableSlots(), Capacity));
+}
+
+template<typename T, unsigned Capacity>
+template<typename U>
+bool LockFreeMpmcFifo<T, Capacity>::tryWrite(U&& data)
+{
+  Cell* cell;
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  while (true)
+  {
+    cell = &buf_[pos & c_mask];
+    const size_t seq = cell->sequence.load(std::memory_order_acquire);
+    const std::ptrdiff_t diff =
+        static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+    if (diff == 0)
+    {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1u,
+                                             std::memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (diff < 0)
+    {
+      return false; // full
+    }
+    else
+    {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  cell->data = std::forward<U>(data);
+  cell->sequence.store(pos + 1u, std::memory_order_release);
+  not_empty_.notifyAll();
+  return true;
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeMpmcFifo<T, Capacity>::tryRead(T& data)
+{
+  Cell* cell;
+  size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  while (true)
+  {
+    cell = &buf_[pos & c_mask];
+    const size_t seq = cell->sequence.load(std::memory_order_acquire);
+    const std::ptrdiff_t diff =
+        static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1u);
+    if (diff == 0)
+    {
+      if (dequeue_pos_.compare_exchange_weak(pos, pos + 1u,
+                                             std::memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (diff < 0)
+    {
+      return false; // empty
+    }
+    else
+    {
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  data = std::move(cell->data);
+  cell->sequence.store(pos + Capacity, std::memory_order_release);
+  not_full_.notifyAll();
+  return true;
+}
+
+template<typename T, unsigned Capacity>
+void LockFreeMpmcFifo<T, Capacity>::write(const T& data)
+{
+  while (!tryWrite(data))
+  {
+    not_full_.wait([this]{ return freeSlots() > 0u; });
+  }
+}
+
+template<typename T, unsigned Capacity>
+void LockFreeMpmcFifo<T, Capacity>::write(T&& data)
+{
+  // tryWrite() only moves from data on success.
+  while (!tryWrite(std::move(data)))
+  {
+    not_full_.wait([this]{ return freeSlots() > 0u; });
+  }
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeMpmcFifo<T, Capacity>::nonBlockingWrite(const T& data)
+{
+  return tryWrite(data);
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeMpmcFifo<T, Capacity>::nonBlockingWrite(T&& data)
+{
+  return tryWrite(std::move(data));
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeMpmcFifo<T, Capacity>::timedWrite(const T& data, unsigned timeout)
+{
+  const auto deadline = internal::deadlineFromTimeout(timeout);
+  while (!tryWrite(data))
+  {
+    if (!not_full_.waitUntil([this]{ return freeSlots() > 0u; }, deadline))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeMpmcFifo<T, Capacity>::timedWrite(T&& data, unsigned timeout)
+{
+  const auto deadline = internal::deadlineFromTimeout(timeout);
+  while (!tryWrite(std::move(data)))
+  {
+    if (!not_full_.waitUntil([this]{ return freeSlots() > 0u; }, deadline))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<typename T, unsigned Capacity>
+T LockFreeMpmcFifo<T, Capacity>::read()
+{
+  T data;
+  while (!tryRead(data))
+  {
+    not_empty_.wait([this]{ return availableSlots() > 0u; });
+  }
+  return data;
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeMpmcFifo<T, Capacity>::nonBlockingRead(T& data)
+{
+  return tryRead(data);
+}
+
+template<typename T, unsigned Capacity>
+bool LockFreeMpmcFifo<T, Capacity>::timedRead(T& data, unsigned timeout)
+{
+  const auto deadline = internal::deadlineFromTimeout(timeout);
+  while (!tryRead(data))
+  {
+    if (!not_empty_.waitUntil([this]{ return availableSlots() > 0u; }, deadline))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<typename T, unsigned Capacity>
+void LockFreeMpmcFifo<T, Capacity>::clear()
+{
+  T data;
+  while (tryRead(data))
+  {
+    data = T();
+  }
+}
+
+template<typename T, unsigned Capacity>
+size_t LockFreeMpmcFifo<T, Capacity>::nonBlockingWriteBatch(T* data, size_t n)
+{
+  // Claim a contiguous range of positions with a single CAS.
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  size_t num;
+  while (true)
+  {
+    const size_t dequeue = dequeue_pos_.load(std::memory_order_acquire);
+    if (dequeue > pos)
+    {
+      // Stale enqueue position.
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+      continue;
+    }
+    const size_t used = pos - dequeue;
+    num = (used >= Capacity) ? 0u : std::min(n, Capacity - used);
+    if (num == 0u)
+    {
+      return 0u;
+    }
+    if (enqueue_pos_.compare_exchange_weak(pos, pos + num,
+                                           std::memory_order_relaxed))
+    {
+      break;
+    }
+  }
+
+  for (size_t i = 0u; i < num; ++i)
+  {
+    Cell& cell = buf_[(pos + i) & c_mask];
+    // A reader of the previous lap may not yet have released the slot.
+    while (cell.sequence.load(std::memory_order_acquire) != pos + i)
+    {
+      internal::cpuRelax();
+    }
+    cell.data = std::move(data[i]);
+    cell.sequence.store(pos + i + 1u, std::memory_order_release);
+  }
+  not_empty_.notifyAll();
+  return num;
+}
+
+template<typename T, unsigned Capacity>
+void LockFreeMpmcFifo<T, Capacity>::writeBatch(T* data, size_t n)
+{
+  size_t written = nonBlockingWriteBatch(data, n);
+  while (written < n)
+  {
+    not_full_.wait([this]{ return freeSlots() > 0u; });
+    written += nonBlockingWriteBatch(data + written, n - written);
+  }
+}
+
+template<typename T, unsigned Capacity>
+size_t LockFreeMpmcFifo<T, Capacity>::nonBlockingReadBatch(T* data, size_t max_n)
+{
+  size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  size_t num;
+  while (true)
+  {
+    const size_t enqueue = enqueue_pos_.load(std::memory_order_acquire);
+    num = (enqueue > pos) ? std::min(max_n, enqueue - pos) : 0u;
+    if (num == 0u)
+    {
+      return 0u;
+    }
+    if (dequeue_pos_.compare_exchange_weak(pos, pos + num,
+                                           std::memory_order_relaxed))
+    {
+      break;
+    }
+  }
+
+  for (size_t i = 0u; i < num; ++i)
+  {
+    Cell& cell = buf_[(pos + i) & c_mask];
+    // The writer that claimed the slot may still be filling it.
+    while (cell.sequence.load(std::memory_order_acquire) != pos + i + 1u)
+    {
+      internal::cpuRelax();
+    }
+    data[i] = std::move(cell.data);
+    cell.sequence.store(pos + i + Capacity, std::memory_order_release);
+  }
+  not_full_.notifyAll();
+  return num;
+}
+
+template<typename T, unsigned Capacity>
+size_t LockFreeMpmcFifo<T, Capacity>::readBatch(T* data, size_t max_n)
+{
+  if (max_n == 0u)
+  {
+    return 0u;
+  }
+  size_t num;
+  while ((num = nonBlockingReadBatch(data, max_n)) == 0u)
+  {
+    not_empty_.wait([this]{ return availableSlots() > 0u; });
+  }
+  return num;
+}
+
+template<typename T, unsigned Capacity>
+size_t LockFreeMpmcFifo<T, Capacity>::timedReadBatch(
+    T* data, size_t max_n, unsigned timeout)
+{
+  if (max_n == 0u)
+  {
+    return 0u;
+  }
+  const auto deadline = internal::deadlineFromTimeout(timeout);
+  size_t num;
+  while ((num = nonBlockingReadBatch(data, max_n)) == 0u)
+  {
+    if (!not_empty_.waitUntil([this]{ return availableSlots() > 0u; }, deadline))
+    {
+      return 0u;
+    }
+  }
+  return num;
+}
+
+} // namespace ze
@@ -0,0 +1,66 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <string>
+
+#include <ze/common/noncopyable.hpp>
+
+//! @file mapped_file.hpp
+//! Read-only memory mapping of files.
+
+namespace ze {
+
+//! Maps a whole file read-only into memory. The pages are loaded lazily by
+//! the kernel, so parsing a large file does not need a copy into user space.
+class MappedFile : Noncopyable
+{
+public:
+  MappedFile() = default;
+
+  //! Maps the file, fails with a CHECK if it cannot be opened.
+  explicit MappedFile(const std::string& filename);
+
+  ~MappedFile();
+
+  //! Returns false if the file cannot be opened or mapped.
+  bool open(const std::string& filename);
+
+  void close();
+
+  inline bool isOpen() const { return fd_ >= 0; }
+  inline const char* data() const { return data_; }
+  inline size_t size() const { return size_; }
+  inline const char* begin() const { return data_; }
+  inline const char* end() const { return data_ + size_; }
+
+private:
+  int fd_ = -1;
+  const char* data_ = nullptr;
+  size_t size_ = 0u;
+};
+
+} // namespace ze
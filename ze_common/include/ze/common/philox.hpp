@@ -0,0 +1,298 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <ze/common/logging.hpp>
+#include <ze/common/types.hpp>
+
+//! @file philox.hpp
+//! Counter-based Philox4x32-10 random number generator (Salmon et al.,
+//! "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11).
+//!
+//! The n-th output of a Philox generator is a pure function of (seed, stream,
+//! n). Creating a generator is therefore free and any number of independent
+//! streams can be used, e.g. one per work item. Results of a parallel loop
+//! that seeds one stream per item do not depend on the number of threads.
+
+namespace ze {
+
+class Philox4x32
+{
+public:
+  typedef uint32_t result_type;
+  typedef std::array<uint32_t, 4> Counter;
+  typedef std::array<uint32_t, 2> Key;
+
+  //! Number of 32-bit words generated per counter increment.
+  static constexpr size_t c_block_size = 4u;
+
+  explicit Philox4x32(uint64_t seed = 0u, uint64_t stream = 0u)
+  {
+    key_[0] = static_cast<uint32_t>(seed);
+    key_[1] = static_cast<uint32_t>(seed >> 32);
+    counter_[0] = 0u;
+    counter_[1] = 0u;
+    counter_[2] = static_cast<uint32_t>(stream);
+    counter_[3] = static_cast<uint32_t>(stream >> 32);
+  }
+
+  static constexpr result_type min() { return 0u; }
+  static constexpr result_type max() { return std::numeric_limits<uint32_t>::max(); }
+
+  //! Random123 Philox4x32 with 10 rounds. Pure function of counter and key.
+  static inline Counter block(Counter ctr, Key key)
+  {
+    for (int round = 0; round < 10; ++round)
+    {
+      if (round > 0)
+      {
+        key[0] += c_weyl_0;
+        key[1] += c_weyl_1;
+      }
+      const uint64_t p0 = static_cast<uint64_t>(c_multiplier_0) * ctr[0];
+      const uint64_t p1 = static_cast<uint64_t>(c_multiplier_1) * ctr[2];
+      ctr = {{ static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+               static_cast<uint32_t>(p1),
+               static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+               static_cast<uint32_t>(p0) }};
+    }
+    return ctr;
+  }
+
+  inline result_type operator()()
+  {
+    if (buffer_pos_ == c_block_size)
+    {
+      refill();
+    }
+    return buffer_[buffer_pos_++];
+  }
+
+  //! Skips n outputs of 32 bit in constant time.
+  inline void discard(uint64_t n)
+  {
+    const uint64_t pos = position() + n;
+    setBlockIndex(pos / c_block_size);
+    buffer_pos_ = c_block_size;
+    if (pos % c_block_size != 0u)
+    {
+      refill();
+      buffer_pos_ = pos % c_block_size;
+    }
+  }
+
+  //! Number of 32-bit words generated so far.
+  inline uint64_t position() const
+  {
+    return blockIndex() * c_block_size - (c_block_size - buffer_pos_);
+  }
+
+  inline uint64_t seed() const
+  {
+    return static_cast<uint64_t>(key_[1]) << 32 | key_[0];
+  }
+
+  inline uint64_t stream() const
+  {
+    return static_cast<uint64_t>(counter_[3]) << 32 | counter_[2];
+  }
+
+  //! Fills out with n words. Equivalent to n calls of operator(), but whole
+  //! counter blocks are written directly without going through the buffer.
+  inline void fillBits(uint32_t* out, size_t n)
+  {
+    while (n > 0u && buffer_pos_ < c_block_size)
+    {
+      *out++ = buffer_[buffer_pos_++];
+      --n;
+    }
+    uint64_t block_index = blockIndex();
+    for (; n >= c_block_size; n -= c_block_size, out += c_block_size)
+    {
+      const Counter ctr = {{ static_cast<uint32_t>(block_index),
+                             static_cast<uint32_t>(block_index >> 32),
+                             counter_[2], counter_[3] }};
+      const Counter r = block(ctr, key_);
+      std::memcpy(out, r.data(), sizeof(r));
+      ++block_index;
+    }
+    setBlockIndex(block_index);
+    while (n > 0u)
+    {
+      *out++ = (*this)();
+      --n;
+    }
+  }
+
+  //! @return Uniform sample in [0, 1). Consumes one word for float and two
+  //! words for double.
+  template<typename Scalar>
+  inline Scalar uniform()
+  {
+    return toUniform<Scalar>(*this);
+  }
+
+  //! Fills out with n uniform samples in [from, to). Same sequence as n calls
+  //! of uniform<Scalar>().
+  template<typename Scalar>
+  void fillUniform(Scalar* out, size_t n, Scalar from = Scalar{0}, Scalar to = Scalar{1});
+
+  //! Fills out with n samples of a normal distribution. Uses the Box-Muller
+  //! transform on blocks of c_box_muller_block samples, the log, sqrt and
+  //! trigonometric functions are evaluated with vectorized Eigen array
+  //! expressions. Words are always consumed for whole blocks.
+  template<typename Scalar>
+  void fillNormal(Scalar* out, size_t n, Scalar mean = Scalar{0}, Scalar sigma = Scalar{1});
+
+  //! @return One sample of a normal distribution. Convenient but slower than
+  //! fillNormal(), the second Box-Muller sample is discarded.
+  template<typename Scalar>
+  inline Scalar normal(Scalar mean = Scalar{0}, Scalar sigma = Scalar{1})
+  {
+    const Scalar u1 = Scalar{1} - uniform<Scalar>();
+    const Scalar u2 = uniform<Scalar>();
+    return mean + sigma * std::sqrt(Scalar{-2} * std::log(u1))
+        * std::cos(Scalar{2 * M_PI} * u2);
+  }
+
+  //! Number of samples computed per Box-Muller block in fillNormal().
+  static constexpr size_t c_box_muller_block = 64u;
+
+private:
+  static constexpr uint32_t c_multiplier_0 = 0xD2511F53u;
+  static constexpr uint32_t c_multiplier_1 = 0xCD9E8D57u;
+  static constexpr uint32_t c_weyl_0 = 0x9E3779B9u;
+  static constexpr uint32_t c_weyl_1 = 0xBB67AE85u;
+
+  template<typename Scalar, typename WordFn>
+  static inline typename std::enable_if<std::is_same<Scalar, float>::value, Scalar>::type
+  toUniform(WordFn&& next)
+  {
+    return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+  }
+
+  template<typename Scalar, typename WordFn>
+  static inline typename std::enable_if<std::is_same<Scalar, double>::value, Scalar>::type
+  toUniform(WordFn&& next)
+  {
+    const uint64_t lo = next();
+    const uint64_t hi = next();
+    return static_cast<double>((hi << 32 | lo) >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  template<typename Scalar>
+  static constexpr size_t wordsPerSample()
+  {
+    return sizeof(Scalar) > 4u ? 2u : 1u;
+  }
+
+  inline uint64_t blockIndex() const
+  {
+    return static_cast<uint64_t>(counter_[1]) << 32 | counter_[0];
+  }
+
+  inline void setBlockIndex(uint64_t i)
+  {
+    counter_[0] = static_cast<uint32_t>(i);
+    counter_[1] = static_cast<uint32_t>(i >> 32);
+  }
+
+  inline void refill()
+  {
+    buffer_ = block(counter_, key_);
+    setBlockIndex(blockIndex() + 1u);
+    buffer_pos_ = 0u;
+  }
+
+  Key key_;
+  //! Words 0 and 1 hold the index of the next block, words 2 and 3 the stream.
+  Counter counter_;
+  Counter buffer_;
+  size_t buffer_pos_ = c_block_size;
+};
+
+// -----------------------------------------------------------------------------
+template<typename Scalar>
+void Philox4x32::fillUniform(Scalar* out, size_t n, Scalar from, Scalar to)
+{
+  static_assert(std::is_floating_point<Scalar>::value, "Only float and double.");
+  constexpr size_t c_words = wordsPerSample<Scalar>();
+  constexpr size_t c_chunk = 256u;
+  uint32_t words[c_chunk * c_words];
+  const Scalar range = to - from;
+  for (size_t i = 0u; i < n; i += c_chunk)
+  {
+    const size_t m = std::min(c_chunk, n - i);
+    fillBits(words, m * c_words);
+    const uint32_t* w = words;
+    for (size_t k = 0u; k < m; ++k)
+    {
+      out[i + k] = from + range * toUniform<Scalar>([&w]() { return *w++; });
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+template<typename Scalar>
+void Philox4x32::fillNormal(Scalar* out, size_t n, Scalar mean, Scalar sigma)
+{
+  static_assert(std::is_floating_point<Scalar>::value, "Only float and double.");
+  constexpr size_t c_half = c_box_muller_block / 2u;
+  constexpr size_t c_words = wordsPerSample<Scalar>();
+  typedef Eigen::Array<Scalar, c_half, 1> Block;
+  constexpr size_t c_block = c_box_muller_block;
+  uint32_t words[c_block * c_words];
+  Block u1, u2;
+  Eigen::Array<Scalar, c_block, 1> z;
+  for (size_t i = 0u; i < n; i += c_block)
+  {
+    fillBits(words, c_block * c_words);
+    const uint32_t* w = words;
+    auto next = [&w]() { return *w++; };
+    for (size_t k = 0u; k < c_half; ++k)
+    {
+      // 1 - u is in (0, 1], which keeps the logarithm finite.
+      u1(k) = Scalar{1} - toUniform<Scalar>(next);
+      u2(k) = toUniform<Scalar>(next);
+    }
+    const Block r = sigma * (Scalar{-2} * u1.log()).sqrt();
+    const Block theta = Scalar{2 * M_PI} * u2;
+    z.template head<c_half>() = mean + r * theta.cos();
+    z.template tail<c_half>() = mean + r * theta.sin();
+    const size_t m = std::min(c_block, n - i);
+    std::memcpy(out + i, z.data(), m * sizeof(Scalar));
+  }
+}
+
+} // namespace ze
@@ -0,0 +1,140 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <ze/common/logging.hpp>
+#include <ze/common/transformation.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+
+//! Batch of rigid-body transformations stored as structure of arrays: one
+//! contiguous column per quaternion coefficient and per translation
+//! coordinate. The batch kernels below loop over the columns, so the compiler
+//! vectorizes them across poses, in contrast to looping over a
+//! TransformationVector one kindr object at a time.
+//!
+//! Quaternions follow the Eigen / kindr convention (Hamilton, q = [x y z w])
+//! and are not re-normalized by the kernels.
+class PoseBatch
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  //! Column order: qx, qy, qz, qw, px, py, pz.
+  typedef Eigen::Matrix<real_t, Eigen::Dynamic, 7> Storage;
+  typedef Storage::ColXpr Column;
+  typedef Storage::ConstColXpr ConstColumn;
+
+  PoseBatch() = default;
+
+  //! Batch of n identity transformations.
+  explicit PoseBatch(int n);
+
+  explicit PoseBatch(const TransformationVector& T);
+
+  //! Drops the stamps.
+  explicit PoseBatch(const StampedTransformationVector& stamped_T);
+
+  inline int size() const { return data_.rows(); }
+  inline bool empty() const { return data_.rows() == 0; }
+
+  //! Content is undefined after resizing.
+  inline void resize(int n) { data_.resize(n, Eigen::NoChange); }
+
+  void setIdentity();
+
+  Transformation at(int i) const;
+
+  void set(int i, const Transformation& T);
+
+  TransformationVector toTransformationVector() const;
+
+  StampedTransformationVector toStampedTransformationVector(
+      const std::vector<int64_t>& stamps) const;
+
+  inline Column qx() { return data_.col(0); }
+  inline Column qy() { return data_.col(1); }
+  inline Column qz() { return data_.col(2); }
+  inline Column qw() { return data_.col(3); }
+  inline Column px() { return data_.col(4); }
+  inline Column py() { return data_.col(5); }
+  inline Column pz() { return data_.col(6); }
+  inline ConstColumn qx() const { return data_.col(0); }
+  inline ConstColumn qy() const { return data_.col(1); }
+  inline ConstColumn qz() const { return data_.col(2); }
+  inline ConstColumn qw() const { return data_.col(3); }
+  inline ConstColumn px() const { return data_.col(4); }
+  inline ConstColumn py() const { return data_.col(5); }
+  inline ConstColumn pz() const { return data_.col(6); }
+
+  inline const Storage& data() const { return data_; }
+  inline Storage& data() { return data_; }
+
+private:
+  Storage data_;
+};
+
+// -----------------------------------------------------------------------------
+// Batch kernels. Outputs are resized if needed and, except for
+// transformPointsAllPairs(), may alias the inputs.
+
+//! T_A_C[i] = T_A_B[i] * T_B_C[i].
+void composePoses(const PoseBatch& T_A_B, const PoseBatch& T_B_C,
+                  PoseBatch* T_A_C);
+
+//! T_A_C[i] = T_A_B * T_B_C[i], e.g. to align a whole trajectory.
+void composePoses(const Transformation& T_A_B, const PoseBatch& T_B_C,
+                  PoseBatch* T_A_C);
+
+//! T_B_A[i] = T_A_B[i].inverse().
+void invertPoses(const PoseBatch& T_A_B, PoseBatch* T_B_A);
+
+//! T_B_C[i] = T_A_B[i].inverse() * T_A_C[i], without forming the inverse.
+void relativePoses(const PoseBatch& T_A_B, const PoseBatch& T_A_C,
+                   PoseBatch* T_B_C);
+
+//! Column i is T[i].log(), i.e. [translation; rotation vector] as in kindr.
+void logPoses(const PoseBatch& T, Matrix6X* tangents);
+
+//! T[i] = Transformation::exp(tangents.col(i)).
+void expPoses(const Eigen::Ref<const Matrix6X>& tangents, PoseBatch* T);
+
+//! p_A.col(i) = T_A_B[i] * p_B.col(i).
+void transformPoints(const PoseBatch& T_A_B,
+                     const Eigen::Ref<const Positions>& p_B,
+                     Positions* p_A);
+
+//! Transforms all points with all poses:
+//! p_A.col(i * p_B.cols() + j) = T_A_B[i] * p_B.col(j).
+void transformPointsAllPairs(const PoseBatch& T_A_B,
+                             const Eigen::Ref<const Positions>& p_B,
+                             Positions* p_A);
+
+} // namespace ze
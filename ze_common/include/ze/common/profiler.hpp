@@ -0,0 +1,243 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <ze/common/noncopyable.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+
+//! A finished zone, i.e. a Chrome trace "complete" event.
+struct ProfilerEvent
+{
+  const char* name;
+  int64_t begin_ns;
+  int64_t end_ns;
+  uint32_t depth;     //!< Number of enclosing zones on the same thread.
+  uint32_t thread;    //!< Index of the recording thread.
+};
+
+//! Ring buffer of events recorded by a single thread. Only the owning thread
+//! writes, readers take a consistent snapshot without locking: events that
+//! were overwritten while copying them are detected and dropped, similar to
+//! a seqlock.
+class ProfilerThreadLog : Noncopyable
+{
+public:
+  ProfilerThreadLog(size_t capacity, uint32_t thread_index);
+
+  //! Called by the owning thread only.
+  inline void record(const char* name, int64_t begin_ns, int64_t end_ns,
+                     uint32_t depth)
+  {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[head & mask_];
+    // Announce that event head - capacity is being overwritten, readers
+    // check reserved_ after copying.
+    reserved_.store(head + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+    slot.end_ns.store(end_ns, std::memory_order_relaxed);
+    slot.depth.store(depth, std::memory_order_relaxed);
+    head_.store(head + 1u, std::memory_order_release);
+  }
+
+  //! Appends the events that are still in the ring buffer, oldest first.
+  void snapshot(std::vector<ProfilerEvent>* events) const;
+
+  //! Drops all events recorded so far, may be called from any thread.
+  void clear();
+
+  inline uint32_t threadIndex() const { return thread_index_; }
+  inline size_t capacity() const { return slots_.size(); }
+
+  //! Number of events that were overwritten before being read.
+  uint64_t numDropped() const;
+
+private:
+  struct Slot
+  {
+    std::atomic<const char*> name { nullptr };
+    std::atomic<int64_t> begin_ns { 0 };
+    std::atomic<int64_t> end_ns { 0 };
+    std::atomic<uint32_t> depth { 0u };
+  };
+
+  std::vector<Slot> slots_;
+  const uint64_t mask_;
+  const uint32_t thread_index_;
+  std::atomic<uint64_t> head_ { 0u };      //!< Number of written events.
+  std::atomic<uint64_t> reserved_ { 0u };  //!< Number of started writes.
+  std::atomic<uint64_t> cleared_ { 0u };
+};
+
+//! Per-thread state. Trivially constructible, so that accessing it does not
+//! need a guard.
+struct ProfilerThreadState
+{
+  ProfilerThreadLog* log = nullptr;
+  uint32_t depth = 0u;
+};
+
+inline ProfilerThreadState& profilerThreadState()
+{
+  static thread_local ProfilerThreadState state;
+  return state;
+}
+
+/*! Records nested, named zones per thread into lock-free ring buffers and
+ * exports them in the Chrome trace format (chrome://tracing, Perfetto).
+ *
+ * Recording is disabled by default and then costs a relaxed atomic load and
+ * a thread-local increment per zone, so zones can stay compiled into release
+ * builds.
+ *
+\code{.cpp}
+  Profiler::setEnabled(true);
+  Profiler::setThreadName("optimizer");
+  {
+    ZE_PROFILE_SCOPE("optimize");
+    ...
+  }
+  Profiler::saveChromeTrace("/tmp/trace.json");
+\endcode
+ *
+ * Timers declared with DECLARE_TIMER record a zone with the timer name as
+ * well. Zone names are not copied: Pass string literals or names returned by
+ * internName().
+ *
+ * When a thread exits, its ring buffer is kept for export and handed to the
+ * next thread that records with the same capacity, like the OS reuses thread
+ * ids. Memory is thus bounded by the peak number of recording threads.
+ */
+class Profiler
+{
+public:
+  //! Clock of all event stamps, in nanoseconds.
+  using Clock = std::chrono::steady_clock;
+
+  static inline int64_t now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          Clock::now().time_since_epoch()).count();
+  }
+
+  static inline bool isEnabled()
+  {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  static void setEnabled(bool enabled);
+
+  //! Ring buffer size of threads that record their first event after this
+  //! call. Rounded up to a power of two.
+  static void setEventCapacity(size_t capacity);
+
+  //! Name of the calling thread in the exported trace.
+  static void setThreadName(const std::string& name);
+
+  //! Returns a pointer to a copy of name that lives until the program exits.
+  static const char* internName(const std::string& name);
+
+  //! Records a zone on the calling thread, at the current nesting depth.
+  static inline void record(const char* name, int64_t begin_ns, int64_t end_ns)
+  {
+    ProfilerThreadState& state = profilerThreadState();
+    if (!state.log)
+    {
+      state.log = &registerThread();
+    }
+    state.log->record(name, begin_ns, end_ns, state.depth);
+  }
+
+  //! Events of all threads still in the ring buffers, sorted by begin.
+  static std::vector<ProfilerEvent> events();
+
+  //! Drops the recorded events of all threads.
+  static void clear();
+
+  //! Number of ring buffers allocated so far.
+  static size_t numThreadLogs();
+
+  //! Writes all events in the Chrome trace JSON format.
+  static void writeChromeTrace(std::ostream& out);
+  static void saveChromeTrace(const std::string& filename);
+
+private:
+  static ProfilerThreadLog& registerThread();
+
+  static std::atomic<bool> enabled_;
+};
+
+//! RAII zone, use the ZE_PROFILE_SCOPE macro.
+class ProfilerZone
+{
+public:
+  explicit ProfilerZone(const char* name)
+    : name_(Profiler::isEnabled() ? name : nullptr)
+  {
+    if (name_)
+    {
+      begin_ns_ = Profiler::now();
+    }
+    ++profilerThreadState().depth;
+  }
+
+  ~ProfilerZone()
+  {
+    --profilerThreadState().depth;
+    if (name_)
+    {
+      Profiler::record(name_, begin_ns_, Profiler::now());
+    }
+  }
+
+  ProfilerZone(const ProfilerZone&) = delete;
+  ProfilerZone& operator=(const ProfilerZone&) = delete;
+
+private:
+  const char* name_;
+  int64_t begin_ns_ = 0;
+};
+
+} // namespace ze
+
+#define ZE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ZE_PROFILE_CONCAT(a, b) ZE_PROFILE_CONCAT_IMPL(a, b)
+
+//! Records the enclosing scope as a zone with the given name.
+#define ZE_PROFILE_SCOPE(name) \
+  ::ze::ProfilerZone ZE_PROFILE_CONCAT(ze_profiler_zone_, __LINE__)(name)
+
+//! Records the enclosing scope as a zone with the function name.
+#define ZE_PROFILE_FUNCTION() ZE_PROFILE_SCOPE(__func__)
@@ -0,0 +1,244 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <ze/common/logging.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+
+/*! Streaming quantile estimation with a log-bucketed histogram (DDSketch,
+ * Masson et al., VLDB 2019).
+ *
+ * A sample x > 0 is counted in bucket ceil(log_gamma(x)) with
+ * gamma = (1 + a) / (1 - a), so every quantile is returned with a relative
+ * error of at most a. Negative samples are kept in a mirrored histogram.
+ * Only the range of occupied buckets is stored and it is limited to
+ * max_num_buckets per sign: If exceeded, the buckets with the smallest
+ * magnitude are merged, which keeps the upper quantiles accurate. With the
+ * default a = 1%, samples spanning six orders of magnitude need ~700
+ * buckets.
+ *
+ * Sketches with the same accuracy can be merged exactly, e.g. to combine
+ * statistics collected by several threads.
+ */
+class QuantileSketch
+{
+public:
+  explicit QuantileSketch(real_t relative_accuracy = 0.01,
+                          size_t max_num_buckets = 2048u)
+    : relative_accuracy_(relative_accuracy)
+    , gamma_((1.0 + relative_accuracy) / (1.0 - relative_accuracy))
+    , inv_log_gamma_(1.0 / std::log(gamma_))
+    , max_num_buckets_(max_num_buckets)
+  {
+    CHECK_GT(relative_accuracy, 0.0);
+    CHECK_LT(relative_accuracy, 1.0);
+    CHECK_GT(max_num_buckets, 0u);
+  }
+
+  inline void add(real_t x)
+  {
+    const double magnitude = std::abs(static_cast<double>(x));
+    if (magnitude < c_min_magnitude)
+    {
+      ++zero_count_;
+    }
+    else if (x > 0)
+    {
+      positive_.add(index(magnitude), 1u, max_num_buckets_);
+    }
+    else
+    {
+      negative_.add(index(magnitude), 1u, max_num_buckets_);
+    }
+  }
+
+  //! Adds the samples of other, which must have the same accuracy.
+  void merge(const QuantileSketch& other)
+  {
+    CHECK_EQ(relative_accuracy_, other.relative_accuracy_);
+    positive_.merge(other.positive_, max_num_buckets_);
+    negative_.merge(other.negative_, max_num_buckets_);
+    zero_count_ += other.zero_count_;
+  }
+
+  //! Returns the q-quantile, q in [0, 1], or 0 if empty.
+  real_t quantile(real_t q) const
+  {
+    const uint64_t n = count();
+    if (n == 0u)
+    {
+      return 0.0;
+    }
+    DEBUG_CHECK_GE(q, 0.0);
+    DEBUG_CHECK_LE(q, 1.0);
+    // Zero based rank of the sample, as in the lower nearest rank method.
+    const uint64_t rank =
+        static_cast<uint64_t>(std::max(0.0, std::floor(q * (n - 1u))));
+
+    // Negative samples in ascending order are the buckets in descending order.
+    uint64_t accumulated = 0u;
+    const std::vector<uint64_t>& neg = negative_.counts;
+    for (size_t i = neg.size(); i-- > 0u; )
+    {
+      accumulated += neg[i];
+      if (accumulated > rank)
+      {
+        return -value(negative_.offset + static_cast<int32_t>(i));
+      }
+    }
+    accumulated += zero_count_;
+    if (accumulated > rank)
+    {
+      return 0.0;
+    }
+    const std::vector<uint64_t>& pos = positive_.counts;
+    for (size_t i = 0u; i < pos.size(); ++i)
+    {
+      accumulated += pos[i];
+      if (accumulated > rank)
+      {
+        return value(positive_.offset + static_cast<int32_t>(i));
+      }
+    }
+    return value(positive_.offset + static_cast<int32_t>(pos.size()) - 1);
+  }
+
+  inline uint64_t count() const
+  {
+    return positive_.total + negative_.total + zero_count_;
+  }
+
+  inline size_t numBuckets() const
+  {
+    return positive_.counts.size() + negative_.counts.size();
+  }
+
+  inline real_t relativeAccuracy() const { return relative_accuracy_; }
+
+  inline void reset()
+  {
+    positive_ = Store();
+    negative_ = Store();
+    zero_count_ = 0u;
+  }
+
+private:
+  //! Magnitudes below are counted as zero.
+  static constexpr double c_min_magnitude = 1e-12;
+
+  //! Contiguous counts of the buckets [offset, offset + counts.size()).
+  struct Store
+  {
+    int32_t offset = 0;
+    uint64_t total = 0u;
+    std::vector<uint64_t> counts;
+
+    void add(int32_t index, uint64_t n, size_t max_num_buckets)
+    {
+      total += n;
+      if (counts.empty())
+      {
+        offset = index;
+        counts.assign(1u, n);
+        return;
+      }
+      const int32_t max_range = static_cast<int32_t>(max_num_buckets) - 1;
+      const int32_t last = offset + static_cast<int32_t>(counts.size()) - 1;
+      if (index < offset)
+      {
+        // Collapse into the lowest bucket if the range would get too large.
+        index = std::max(index, last - max_range);
+        counts.insert(counts.begin(), offset - index, 0u);
+        offset = index;
+      }
+      else if (index > last)
+      {
+        const int32_t new_offset = index - max_range;
+        if (new_offset > offset)
+        {
+          // Merge the buckets below new_offset into it.
+          const size_t num_collapsed =
+              std::min<size_t>(new_offset - offset, counts.size());
+          uint64_t collapsed = 0u;
+          for (size_t i = 0u; i < num_collapsed; ++i)
+          {
+            collapsed += counts[i];
+          }
+          counts.erase(counts.begin(), counts.begin() + num_collapsed);
+          if (counts.empty())
+          {
+            counts.push_back(0u);
+          }
+          counts.front() += collapsed;
+          offset = new_offset;
+        }
+        counts.resize(index - offset + 1, 0u);
+      }
+      counts[index - offset] += n;
+    }
+
+    void merge(const Store& other, size_t max_num_buckets)
+    {
+      for (size_t i = 0u; i < other.counts.size(); ++i)
+      {
+        if (other.counts[i] > 0u)
+        {
+          add(other.offset + static_cast<int32_t>(i), other.counts[i],
+              max_num_buckets);
+        }
+      }
+    }
+  };
+
+  inline int32_t index(double magnitude) const
+  {
+    return static_cast<int32_t>(std::ceil(std::log(magnitude) * inv_log_gamma_));
+  }
+
+  //! Value with the smallest maximal relative error in bucket i, i.e. in
+  //! (gamma^(i-1), gamma^i].
+  inline real_t value(int32_t i) const
+  {
+    return 2.0 * std::pow(gamma_, i) / (gamma_ + 1.0);
+  }
+
+  real_t relative_accuracy_;
+  double gamma_;
+  double inv_log_gamma_;
+  size_t max_num_buckets_;
+  Store positive_;
+  Store negative_;
+  uint64_t zero_count_ = 0u;
+};
+
+} // namespace ze
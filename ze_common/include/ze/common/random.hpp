@@ -27,10 +27,17 @@
 
 #include <random>
 #include <ze/common/logging.hpp>
+#include <ze/common/philox.hpp>
 #include <ze/common/types.hpp>
 
 //! @file random.hpp
 //! Sample integer and real-valued scalars from uniform or normal distributions.
+//!
+//! The scalar samplers use one generator per thread. In deterministic mode,
+//! every thread therefore draws the same sequence, independent of how many
+//! threads there are. For many samples, or for reproducible parallel loops
+//! with independent streams, use the bulk fill functions with a Philox4x32
+//! generator, e.g. Philox4x32(seed, item_index).
 
 namespace ze {
 
@@ -42,8 +49,8 @@ T sampleUniformIntDistribution(
     T from = std::numeric_limits<T>::lowest(),
     T to   = std::numeric_limits<T>::max())
 {
-  static std::mt19937 gen_nondeterministic(std::random_device{}());
-  static std::mt19937 gen_deterministic(0);
+  static thread_local std::mt19937 gen_nondeterministic(std::random_device{}());
+  static thread_local std::mt19937 gen_deterministic(0);
   auto dist = std::uniform_int_distribution<T>(from, to);
   return deterministic ? dist(gen_deterministic) : dist(gen_nondeterministic);
 }
@@ -56,8 +63,8 @@ T sampleUniformRealDistribution(
     T from = T{0.0},
     T to   = T{1.0})
 {
-  static std::mt19937 gen_nondeterministic(std::random_device{}());
-  static std::mt19937 gen_deterministic(0);
+  static thread_local std::mt19937 gen_nondeterministic(std::random_device{}());
+  static thread_local std::mt19937 gen_deterministic(0);
   auto dist = std::uniform_real_distribution<T>(from, to);
   return deterministic ? dist(gen_deterministic) : dist(gen_nondeterministic);
 }
@@ -70,8 +77,8 @@ T sampleNormalDistribution(
     T mean  = T{0.0},
     T sigma = T{1.0})
 {
-  static std::mt19937 gen_nondeterministic(std::random_device{}());
-  static std::mt19937 gen_deterministic(0);
+  static thread_local std::mt19937 gen_nondeterministic(std::random_device{}());
+  static thread_local std::mt19937 gen_deterministic(0);
   auto dist = std::normal_distribution<T>(mean, sigma);
   return deterministic ? dist(gen_deterministic) : dist(gen_nondeterministic);
 }
@@ -84,8 +91,8 @@ inline bool flipCoin(
 {
   DEBUG_CHECK_GE(true_probability, 0.0);
   DEBUG_CHECK_LT(true_probability, 1.0);
-  static std::mt19937 gen_nondeterministic(std::random_device{}());
-  static std::mt19937 gen_deterministic(0);
+  static thread_local std::mt19937 gen_nondeterministic(std::random_device{}());
+  static thread_local std::mt19937 gen_deterministic(0);
   auto dist = std::bernoulli_distribution(true_probability);
   return deterministic ? dist(gen_deterministic) : dist(gen_nondeterministic);
 }
@@ -94,10 +101,45 @@ inline bool flipCoin(
 // Sample manifolds:
 
 //! @return Random 3-dimensional unit vector.
-Vector3 randomDirection3D();
+Vector3 randomDirection3D(bool deterministic = false);
 
 //! @return Random 2-dimensional unit vector.
-Vector2 randomDirection2D();
+Vector2 randomDirection2D(bool deterministic = false);
+
+// -----------------------------------------------------------------------------
+// Bulk sampling with counter-based generators:
+
+//! @return Philox generator of the calling thread. The deterministic generator
+//! of every thread starts with seed 0 and stream 0.
+inline Philox4x32& threadRandomGenerator(bool deterministic = false)
+{
+  static thread_local Philox4x32 gen_nondeterministic(
+        static_cast<uint64_t>(std::random_device{}()) << 32 | std::random_device{}());
+  static thread_local Philox4x32 gen_deterministic(0u, 0u);
+  return deterministic ? gen_deterministic : gen_nondeterministic;
+}
+
+//! Fills a matrix or array with uniform samples in [from, to).
+template<typename Derived>
+void fillUniformDistributed(
+    Eigen::PlainObjectBase<Derived>& m,
+    Philox4x32& gen,
+    typename Derived::Scalar from = typename Derived::Scalar{0},
+    typename Derived::Scalar to   = typename Derived::Scalar{1})
+{
+  gen.fillUniform(m.data(), static_cast<size_t>(m.size()), from, to);
+}
+
+//! Fills a matrix or array with samples of a normal distribution.
+template<typename Derived>
+void fillNormalDistributed(
+    Eigen::PlainObjectBase<Derived>& m,
+    Philox4x32& gen,
+    typename Derived::Scalar mean  = typename Derived::Scalar{0},
+    typename Derived::Scalar sigma = typename Derived::Scalar{1})
+{
+  gen.fillNormal(m.data(), static_cast<size_t>(m.size()), mean, sigma);
+}
 
 // -----------------------------------------------------------------------------
 // Get distributions, only slightly faster than the above functions when many
@@ -46,6 +46,7 @@ public:
   typedef Eigen::Matrix<real_t, DIM, 1> covariance_vector_t;
   typedef Eigen::Matrix<real_t, DIM, 1> sigma_vector_t;
   typedef Eigen::Matrix<real_t, DIM, 1> noise_vector_t;
+  typedef Eigen::Matrix<real_t, DIM, Eigen::Dynamic> noise_matrix_t;
 
   //! Get a noise sample.
   noise_vector_t sample()
@@ -59,6 +60,24 @@ public:
     return noise;
   }
 
+  //! Get n noise samples at once, one per column. Uses the Philox generator
+  //! of the calling thread.
+  noise_matrix_t sampleN(int n) const
+  {
+    return sampleN(n, threadRandomGenerator(deterministic_));
+  }
+
+  //! Get n noise samples from the given generator. Use one generator stream
+  //! per work item for results that do not depend on the number of threads.
+  noise_matrix_t sampleN(int n, Philox4x32& gen) const
+  {
+    DEBUG_CHECK_GE(n, 0);
+    noise_matrix_t noise(DIM, n);
+    fillNormalDistributed(noise, gen);
+    noise.array().colwise() *= sigma_.array();
+    return noise;
+  }
+
   static Ptr sigmas(const sigma_vector_t& sigmas, bool deterministic = false)
   {
     Ptr noise(new RandomVectorSampler(deterministic));
@@ -135,13 +154,7 @@ inline MatrixX randomMatrixNormalDistributed(
   DEBUG_CHECK_GT(rows, 0);
   DEBUG_CHECK_GT(cols, 0);
   MatrixX m(rows, cols);
-  for (int x = 0; x < cols; ++x)
-  {
-    for (int y = 0; y < rows; ++y)
-    {
-      m(y,x) = sampleNormalDistribution(deterministic, mean, sigma);
-    }
-  }
+  fillNormalDistributed(m, threadRandomGenerator(deterministic), mean, sigma);
   return m;
 }
 
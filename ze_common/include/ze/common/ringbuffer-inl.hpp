@@ -33,11 +33,19 @@ Ringbuffer<Scalar, ValueDim, Size>::getNearestValue(time_t stamp)
 {
   CHECK_GE(stamp, 0u);
 
-  std::lock_guard<std::mutex> lock(mutex_);
+  TimeDataBoolTuple result = read([this, stamp]() {
+    return getNearestValue_impl(stamp);
+  });
+  LOG_IF(WARNING, !std::get<2>(result)) << "Buffer is empty.";
+  return result;
+}
 
+template <typename Scalar, size_t ValueDim, size_t Size>
+typename Ringbuffer<Scalar, ValueDim, Size>::TimeDataBoolTuple
+Ringbuffer<Scalar, ValueDim, Size>::getNearestValue_impl(time_t stamp)
+{
   if(times_.empty())
   {
-    LOG(WARNING) << "Buffer is empty.";
     return std::make_tuple(-1, DataType(), false);
   }
 
@@ -69,7 +77,7 @@ Ringbuffer<Scalar, ValueDim, Size>::getNearestValue(time_t stamp)
   // Select which entry is closest based on time difference.
   if(dt_after < 0 && dt_before < 0)
   {
-    CHECK(false) << "Should not occur.";
+    // Only reachable on a torn lock-free read, which is retried.
     return std::make_tuple(-1, DataType(), false);
   }
   else if(dt_after < 0)
@@ -92,36 +100,39 @@ template <typename Scalar, size_t ValueDim, size_t Size>
 typename Ringbuffer<Scalar, ValueDim, Size>::DataBoolPair
 Ringbuffer<Scalar, ValueDim, Size>::getOldestValue() const
 {
-  std::lock_guard<std::mutex> lock(mutex_);
-  if(times_.empty())
-  {
-    return std::make_pair(DataType(), false);
-  }
-  return std::make_pair(dataAtTimeIterator(times_.begin()), true);
+  return read([this]() {
+    if(times_.empty())
+    {
+      return std::make_pair(DataType(), false);
+    }
+    return std::make_pair(dataAtTimeIterator(times_.begin()), true);
+  });
 }
 
 template <typename Scalar, size_t ValueDim, size_t Size>
 typename Ringbuffer<Scalar, ValueDim, Size>::DataBoolPair
 Ringbuffer<Scalar, ValueDim, Size>::getNewestValue() const
 {
-  std::lock_guard<std::mutex> lock(mutex_);
-  if(times_.empty())
-  {
-    return std::make_pair(DataType(), false);
-  }
-  return std::make_pair(dataAtTimeIterator((times_.end()-1)), true);
+  return read([this]() {
+    if(times_.empty())
+    {
+      return std::make_pair(DataType(), false);
+    }
+    return std::make_pair(dataAtTimeIterator((times_.end()-1)), true);
+  });
 }
 
 template <typename Scalar, size_t ValueDim, size_t Size>
 std::tuple<int64_t, int64_t, bool>
 Ringbuffer<Scalar, ValueDim, Size>::getOldestAndNewestStamp() const
 {
-  std::lock_guard<std::mutex> lock(mutex_);
-  if(times_.empty())
-  {
-    return std::make_tuple(-1, -1, false);
-  }
-  return std::make_tuple(times_.front(), times_.back(), true);
+  return read([this]() {
+    if(times_.empty())
+    {
+      return std::make_tuple(time_t{-1}, time_t{-1}, false);
+    }
+    return std::make_tuple(times_.front(), times_.back(), true);
+  });
 }
 
 template <typename Scalar, size_t ValueDim, size_t Size>
@@ -133,43 +144,85 @@ Ringbuffer<Scalar, ValueDim, Size>::getBetweenValuesInterpolated(
 {
   CHECK_GE(stamp_from, 0u);
   CHECK_LT(stamp_from, stamp_to);
+
+  RangeStatus status;
+  TimeDataRangePair result = read([&]() {
+    return getBetweenValuesInterpolated_impl<Interpolator>(
+          stamp_from, stamp_to, &status);
+  });
+  switch (status)
+  {
+    case RangeStatus::TooFewEntries:
+      LOG(WARNING) << "Buffer has less than 2 entries.";
+      break;
+    case RangeStatus::TooOld:
+      LOG(WARNING) << "Requests older timestamp than in buffer.";
+      break;
+    case RangeStatus::TooNew:
+      LOG(WARNING) << "Requests newer timestamp than in buffer.";
+      break;
+    case RangeStatus::NotEnoughData:
+      LOG(WARNING) << "Not enough data for interpolation";
+      break;
+    default:
+      break;
+  }
+  return result;
+}
+
+template <typename Scalar, size_t ValueDim, size_t Size>
+template <typename Interpolator>
+typename Ringbuffer<Scalar, ValueDim, Size>::TimeDataRangePair
+Ringbuffer<Scalar, ValueDim, Size>::getBetweenValuesInterpolated_impl(
+    time_t stamp_from,
+    time_t stamp_to,
+    RangeStatus* status)
+{
   times_dynamic_t stamps;
   data_dynamic_t values;
 
-  std::lock_guard<std::mutex> lock(mutex_);
+  // Failures return empty containers, which means unsuccessful.
+  *status = RangeStatus::Invalid;
   if(times_.size() < 2)
   {
-    LOG(WARNING) << "Buffer has less than 2 entries.";
-    return std::make_pair(stamps, values); // return empty means unsuccessful.
+    *status = RangeStatus::TooFewEntries;
+    return std::make_pair(stamps, values);
   }
 
   const time_t oldest_stamp = times_.front();
   const time_t newest_stamp = times_.back();
   if(stamp_from < oldest_stamp)
   {
-    LOG(WARNING) << "Requests older timestamp than in buffer.";
-    return std::make_pair(stamps, values); // return empty means unsuccessful.
+    *status = RangeStatus::TooOld;
+    return std::make_pair(stamps, values);
   }
   if(stamp_to > newest_stamp)
   {
-    LOG(WARNING) << "Requests newer timestamp than in buffer.";
-    return std::make_pair(stamps, values); // return empty means unsuccessful.
+    *status = RangeStatus::TooNew;
+    return std::make_pair(stamps, values);
   }
 
   auto it_from_before = iterator_equal_or_before(stamp_from);
   auto it_to_after = iterator_equal_or_after(stamp_to);
-  CHECK(it_from_before != times_.end());
-  CHECK(it_to_after != times_.end());
+  // Can only fail on a torn lock-free read.
+  if(it_from_before == times_.end() || it_to_after == times_.end())
+  {
+    return std::make_pair(stamps, values);
+  }
   auto it_from_after = it_from_before + 1;
   auto it_to_before = it_to_after - 1;
   if(it_from_after == it_to_before)
   {
-    LOG(WARNING) << "Not enough data for interpolation";
-    return std::make_pair(stamps, values); // return empty means unsuccessful.
+    *status = RangeStatus::NotEnoughData;
+    return std::make_pair(stamps, values);
   }
 
   // resize containers
   size_t range = it_to_before.index() - it_from_after.index() + 3;
+  if(range > Size + 2)
+  {
+    return std::make_pair(stamps, values);
+  }
   stamps.resize(range);
   values.resize(ValueDim, range);
 
@@ -193,6 +246,10 @@ Ringbuffer<Scalar, ValueDim, Size>::getBetweenValuesInterpolated(
       values.middleCols(1, end_block_size) =
           data_.middleCols(it_from_after.container_index(), end_block_size);
       // second batch at beginning
+      if(end_block_size > range - 2)
+      {
+        return std::make_pair(times_dynamic_t(), data_dynamic_t());
+      }
       size_t begin_block_size = range - 2 - end_block_size;
       stamps.segment(end_block_size + 1, begin_block_size) =
           times_raw_.segment(0, begin_block_size);
@@ -201,7 +258,7 @@ Ringbuffer<Scalar, ValueDim, Size>::getBetweenValuesInterpolated(
           data_.middleCols(0, begin_block_size);
     }
     // copyable in a single block
-    else
+    else if(it_from_after.container_index() + range - 2 <= Size)
     {
       stamps.segment(1, range - 2) = times_raw_.segment(
                                        it_from_after.container_index(),
@@ -211,6 +268,10 @@ Ringbuffer<Scalar, ValueDim, Size>::getBetweenValuesInterpolated(
                                                   it_from_after.container_index(),
                                                   range - 2);
     }
+    else
+    {
+      return std::make_pair(times_dynamic_t(), data_dynamic_t());
+    }
   }
 
   // last element interpolated
@@ -218,6 +279,7 @@ Ringbuffer<Scalar, ValueDim, Size>::getBetweenValuesInterpolated(
 
   values.col(range - 1) = Interpolator::interpolate(this, stamp_to, it_to_before);
 
+  *status = RangeStatus::Ok;
   return std::make_pair(stamps, values);
 }
 
@@ -229,32 +291,103 @@ Ringbuffer<Scalar, ValueDim, Size>::getValuesInterpolated(
 {
   CHECK_GT(stamps.size(), 0);
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  time_t oldest_time = times_.front();
-  time_t newest_time = times_.back();
-
   data_dynamic_t values(ValueDim, stamps.size());
+  CHECK(getValuesInterpolated<Interpolator>(stamps, values))
+      << "Stamps must be ordered and within the bounds of the buffer.";
+  return values;
+}
 
-  // Starting point
-  auto it_before = iterator_equal_or_before(stamps(0));
-  values.col(0) = Interpolator::interpolate(this, stamps(0), it_before);
-
-  for (int i = 1; i < stamps.size(); ++i)
+template <typename Scalar, size_t ValueDim, size_t Size>
+template <typename Interpolator>
+bool Ringbuffer<Scalar, ValueDim, Size>::getValuesInterpolated(
+    const Eigen::Ref<const times_dynamic_t>& stamps,
+    Eigen::Ref<data_dynamic_t> values)
+{
+  CHECK_EQ(stamps.size(), values.cols());
+  if (stamps.size() == 0)
   {
-    // ensure that we stay within the bounds of the buffer
-    CHECK_LT(stamps(i), newest_time);
-    CHECK_GT(stamps(i), oldest_time);
+    return true;
+  }
 
-    // advance to next value
-    while (*(it_before + 1) < stamps(i))
+  return read([&]() {
+    if (times_.empty()
+        || stamps(0) < times_.front()
+        || stamps(stamps.size() - 1) > times_.back())
     {
-      ++it_before;
+      return false;
+    }
+    auto it_before = iterator_equal_or_before(stamps(0));
+    if (it_before == times_.end())
+    {
+      return false;
     }
+    return getValuesInterpolated_impl<Interpolator>(
+          stamps, values, it_before,
+          typename std::is_same<Interpolator, InterpolatorLinear>::type());
+  });
+}
 
+template <typename Scalar, size_t ValueDim, size_t Size>
+template <typename Interpolator>
+bool Ringbuffer<Scalar, ValueDim, Size>::getValuesInterpolated_impl(
+    const Eigen::Ref<const times_dynamic_t>& stamps,
+    Eigen::Ref<data_dynamic_t>& values,
+    typename timering_t::iterator it_before,
+    std::false_type /*is_linear*/)
+{
+  const auto it_last = times_.end() - 1;
+  for (int i = 0; i < stamps.size(); ++i)
+  {
+    if (i > 0 && stamps(i) < stamps(i - 1))
+    {
+      return false;
+    }
+    // advance the cursor to the last entry equal or before the stamp
+    while (it_before < it_last && *(it_before + 1) <= stamps(i))
+    {
+      ++it_before;
+    }
     values.col(i) = Interpolator::interpolate(this, stamps(i), it_before);
   }
+  return true;
+}
 
-  return values;
+template <typename Scalar, size_t ValueDim, size_t Size>
+template <typename Interpolator>
+bool Ringbuffer<Scalar, ValueDim, Size>::getValuesInterpolated_impl(
+    const Eigen::Ref<const times_dynamic_t>& stamps,
+    Eigen::Ref<data_dynamic_t>& values,
+    typename timering_t::iterator it_before,
+    std::true_type /*is_linear*/)
+{
+  // Merge walk: blend the samples around each stamp straight into its column.
+  const auto it_last = times_.end() - 1;
+  for (int i = 0; i < stamps.size(); ++i)
+  {
+    if (i > 0 && stamps(i) < stamps(i - 1))
+    {
+      return false;
+    }
+    while (it_before < it_last && *(it_before + 1) <= stamps(i))
+    {
+      ++it_before;
+    }
+    if (it_before < it_last)
+    {
+      const auto it_after = it_before + 1;
+      const Scalar w = static_cast<Scalar>(stamps(i) - *it_before)
+                       / static_cast<Scalar>(*it_after - *it_before);
+      values.col(i) = data_.col(it_before.container_index())
+          + w * (data_.col(it_after.container_index())
+                 - data_.col(it_before.container_index()));
+    }
+    else
+    {
+      // stamp equals the newest entry
+      values.col(i) = data_.col(it_before.container_index());
+    }
+  }
+  return true;
 }
 
 template <typename Scalar, size_t ValueDim, size_t Size>
@@ -263,30 +396,31 @@ bool Ringbuffer<Scalar, ValueDim, Size>::getValueInterpolated(
     time_t stamp,
     Eigen::Ref<typename Ringbuffer<Scalar, ValueDim, Size>::data_dynamic_t> out)
 {
-  std::lock_guard<std::mutex> lock(mutex_);
-
-  if (stamp > times_.back())
-  {
-    return false;
-  }
+  return read([&]() {
+    if (times_.empty() || stamp > times_.back())
+    {
+      return false;
+    }
 
-  // Starting point
-  auto it_before = iterator_equal_or_before(stamp);
-  if (it_before == times_.end())
-  {
-    return false;
-  }
+    // Starting point
+    auto it_before = iterator_equal_or_before(stamp);
+    if (it_before == times_.end())
+    {
+      return false;
+    }
 
-  out = Interpolator::interpolate(this, stamp, it_before);
+    out = Interpolator::interpolate(this, stamp, it_before);
 
-  return true;
+    return true;
+  });
 }
 
 template <typename Scalar, size_t ValueDim, size_t Size>
 typename Ringbuffer<Scalar, ValueDim, Size>::timering_t::iterator
 Ringbuffer<Scalar, ValueDim, Size>::iterator_equal_or_before(time_t stamp)
 {
-  DEBUG_CHECK(!mutex_.try_lock()) << "Call lock() before accessing data.";
+  DEBUG_CHECK(lock_free_reads_ || !mutex_.try_lock())
+      << "Call lock() before accessing data.";
   auto it = lower_bound(stamp);
 
   if(*it == stamp)
@@ -309,7 +443,8 @@ template <typename Scalar, size_t ValueDim, size_t Size>
 typename Ringbuffer<Scalar, ValueDim, Size>::timering_t::iterator
 Ringbuffer<Scalar, ValueDim, Size>::iterator_equal_or_after(time_t stamp)
 {
-  DEBUG_CHECK(!mutex_.try_lock()) << "Call lock() before accessing data.";
+  DEBUG_CHECK(lock_free_reads_ || !mutex_.try_lock())
+      << "Call lock() before accessing data.";
   return lower_bound(stamp);
 }
 
@@ -326,7 +461,7 @@ Ringbuffer<Scalar, ValueDim, Size>::lower_bound(time_t stamp)
     return times_.end();
   }
 
-  if (stamp < times_.front())
+  if (stamp < times_.front() || time_range <= 0)
   {
     return times_.begin();
   }
@@ -25,9 +25,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <tuple>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <mutex>
 #include <Eigen/Dense>
@@ -128,6 +130,12 @@ using DefaultInterpolator = InterpolatorLinear;
 //! A fixed size timed buffer templated on the number of entries.
 //! Opposed to the `Buffer`, values are expected to be received ORDERED in
 //! TIME!
+//!
+//! By default every accessor takes the mutex. With lock_free_reads, writers
+//! still serialize on the mutex but publish their changes through a sequence
+//! counter (seqlock), and the readers never block: They run optimistically
+//! and retry if an insertion interfered. data() and times() may then be
+//! accessed without lock() inside a readBegin() / readRetry() section.
 // Oldest entry: buffer.begin(), newest entry: buffer.rbegin()
 template <typename Scalar, size_t ValueDim, size_t Size>
 class Ringbuffer
@@ -158,11 +166,12 @@ public:
   using TimeDataBoolTuple = std::tuple<time_t, DataType, bool>;
   using TimeDataRangePair = std::pair<times_dynamic_t, data_dynamic_t>;
 
-  Ringbuffer()
+  explicit Ringbuffer(bool lock_free_reads = false)
     : times_(timering_t(times_raw_.data(),
                         times_raw_.data() + Size,
                         times_raw_.data(),
                         0))
+    , lock_free_reads_(lock_free_reads)
   {}
 
   //! no copy, no move as there is no way to track the mutex
@@ -173,8 +182,10 @@ public:
                      const DataType& data)
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    writeBegin();
     times_.push_back(stamp);
     data_.col(times_.back_idx()) = data;
+    writeEnd();
   }
 
   //! Get value with timestamp closest to stamp. Boolean returns if successful.
@@ -204,6 +215,18 @@ public:
   template <typename Interpolator = DefaultInterpolator>
   data_dynamic_t getValuesInterpolated(times_dynamic_t stamps);
 
+  /*! @brief Batch interpolation into a preallocated matrix.
+   *
+   * The stamps have to be ordered and within the time range of the buffer,
+   * values must have one column per stamp. A single cursor walks the ring
+   * alongside the stamps, the linear interpolator blends all columns at once.
+   * Returns false, leaving values undefined, if the stamps are not ordered or
+   * exceed the buffer.
+   */
+  template <typename Interpolator = DefaultInterpolator>
+  bool getValuesInterpolated(const Eigen::Ref<const times_dynamic_t>& stamps,
+                             Eigen::Ref<data_dynamic_t> values);
+
   //! Interpolate a single value
   template <typename Interpolator = DefaultInterpolator>
   bool getValueInterpolated(time_t t,  Eigen::Ref<data_dynamic_t> out);
@@ -211,26 +234,28 @@ public:
   inline void clear()
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    writeBegin();
     times_.reset();
+    writeEnd();
   }
 
   inline size_t size() const
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return times_.size();
+    return read([this]() { return times_.size(); });
   }
 
   inline bool empty() const
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return times_.empty();
+    return read([this]() { return times_.empty(); });
   }
 
   //! technically does not remove but only moves the beginning of the ring
   inline void removeDataBeforeTimestamp(time_t stamp)
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    writeBegin();
     removeDataBeforeTimestamp_impl(stamp);
+    writeEnd();
   }
 
   inline void removeDataOlderThan(real_t seconds)
@@ -241,8 +266,10 @@ public:
       return;
     }
 
+    writeBegin();
     removeDataBeforeTimestamp_impl(
           times_.back() - secToNanosec(seconds));
+    writeEnd();
   }
 
   inline void lock() const
@@ -257,16 +284,41 @@ public:
 
   const data_t& data() const
   {
-    CHECK(!mutex_.try_lock()) << "Call lock() before accessing data.";
+    CHECK(lock_free_reads_ || !mutex_.try_lock())
+        << "Call lock() before accessing data.";
     return data_;
   }
 
   const timering_t& times() const
   {
-    CHECK(!mutex_.try_lock()) << "Call lock() before accessing data.";
+    CHECK(lock_free_reads_ || !mutex_.try_lock())
+        << "Call lock() before accessing data.";
     return times_;
   }
 
+  inline bool lockFreeReads() const { return lock_free_reads_; }
+
+  //! Opens an optimistic read section and returns the sequence to validate
+  //! it with. Waits while an insertion is in progress.
+  inline uint64_t readBegin() const
+  {
+    uint64_t seq = seq_.load(std::memory_order_acquire);
+    while (seq & 1u)
+    {
+      std::this_thread::yield();
+      seq = seq_.load(std::memory_order_acquire);
+    }
+    return seq;
+  }
+
+  //! True if the buffer was modified since readBegin() returned seq, the
+  //! values read in between have to be discarded then.
+  inline bool readRetry(uint64_t seq) const
+  {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return seq_.load(std::memory_order_relaxed) != seq;
+  }
+
   typename timering_t::iterator iterator_equal_or_before(time_t stamp);
   typename timering_t::iterator iterator_equal_or_after(time_t stamp);
 
@@ -282,6 +334,47 @@ protected:
   times_t times_raw_;
   timering_t times_;
 
+  //! Seqlock counter, odd while a writer modifies the buffer.
+  std::atomic<uint64_t> seq_ { 0u };
+  const bool lock_free_reads_;
+
+  //! Writers hold the mutex, so only one of them bumps the counter at a time.
+  inline void writeBegin()
+  {
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1u,
+               std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  inline void writeEnd()
+  {
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1u,
+               std::memory_order_release);
+  }
+
+  //! Runs read_fn() on a consistent state of the buffer: Under the mutex or,
+  //! with lock-free reads, repeated until no writer interfered. read_fn() may
+  //! see a torn state in the latter case and must neither crash nor have
+  //! side effects on it.
+  template<typename ReadFn>
+  auto read(const ReadFn& read_fn) const -> decltype(read_fn())
+  {
+    if (!lock_free_reads_)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return read_fn();
+    }
+    while (true)
+    {
+      const uint64_t seq = readBegin();
+      auto result = read_fn();
+      if (!readRetry(seq))
+      {
+        return result;
+      }
+    }
+  }
+
   //! return the data at a given point in time
   inline DataType dataAtTimeIterator(typename timering_t::iterator iter) const
   {
@@ -296,6 +389,41 @@ protected:
     return data_.col(iter.container_index());
   }
 
+  //! Outcome of getBetweenValuesInterpolated_impl, logged by the caller once
+  //! the read is validated.
+  enum class RangeStatus
+  {
+    Ok,
+    Invalid,
+    TooFewEntries,
+    TooOld,
+    TooNew,
+    NotEnoughData
+  };
+
+  TimeDataBoolTuple getNearestValue_impl(time_t stamp);
+
+  //! Generic batch interpolation: One Interpolator call per stamp.
+  template <typename Interpolator>
+  bool getValuesInterpolated_impl(
+      const Eigen::Ref<const times_dynamic_t>& stamps,
+      Eigen::Ref<data_dynamic_t>& values,
+      typename timering_t::iterator it_before,
+      std::false_type /*is_linear*/);
+
+  //! Linear batch interpolation: Gathers the neighbouring samples and blends
+  //! all columns in one vectorized expression.
+  template <typename Interpolator>
+  bool getValuesInterpolated_impl(
+      const Eigen::Ref<const times_dynamic_t>& stamps,
+      Eigen::Ref<data_dynamic_t>& values,
+      typename timering_t::iterator it_before,
+      std::true_type /*is_linear*/);
+
+  template <typename Interpolator>
+  TimeDataRangePair getBetweenValuesInterpolated_impl(
+      time_t stamp_from, time_t stamp_to, RangeStatus* status);
+
   //! shifts the starting point of the ringbuffer to the given timestamp
   //! no resizing or deletion happens.
   inline void removeDataBeforeTimestamp_impl(time_t stamp)
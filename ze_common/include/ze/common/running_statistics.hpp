@@ -26,12 +26,15 @@
 #pragma once
 
 #include <algorithm>
+#include <ze/common/quantile_sketch.hpp>
 #include <ze/common/types.hpp>
 
 namespace ze {
 
 //! Collects samples and incrementally computes statistical properties.
 //! http://www.johndcook.com/blog/standard_deviation/
+//! Quantiles are estimated with a QuantileSketch, in constant memory and with
+//! 1% relative error.
 class RunningStatistics
 {
 public:
@@ -58,6 +61,32 @@ public:
       S_ += (x - M_) * (x - M_new);
       M_ = M_new;
     }
+    sketch_.add(x);
+  }
+
+  //! Adds the samples of other, e.g. to combine statistics of several
+  //! threads. [Chan et al., Updating Formulae and a Pairwise Algorithm for
+  //! Computing Sample Variances, 1979]
+  inline void merge(const RunningStatistics& other)
+  {
+    if (other.n_ == 0u)
+    {
+      return;
+    }
+    if (n_ == 0u)
+    {
+      *this = other;
+      return;
+    }
+    const uint32_t n = n_ + other.n_;
+    const real_t delta = other.M_ - M_;
+    M_ += delta * other.n_ / n;
+    S_ += other.S_ + delta * delta * n_ * other.n_ / n;
+    n_ = n;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+    sketch_.merge(other.sketch_);
   }
 
   inline real_t numSamples() const { return n_; }
@@ -72,6 +101,15 @@ public:
   inline real_t var()  const { return (n_ > 0u) ? S_ / (n_ - 1u) : 0.0; }
   inline real_t std()  const { return std::sqrt(var()); }
 
+  //! Estimated q-quantile, q in [0, 1], e.g. 0.5 for the median.
+  inline real_t quantile(real_t q) const
+  {
+    return (n_ > 0u) ? std::min(max_, std::max(min_, sketch_.quantile(q))) : 0.0;
+  }
+  inline real_t median() const { return quantile(0.5); }
+
+  inline const QuantileSketch& sketch() const { return sketch_; }
+
   inline void reset()
   {
     n_ = 0;
@@ -80,6 +118,7 @@ public:
     sum_ = 0.0;
     M_ = 0.0;
     S_ = 0.0;
+    sketch_.reset();
   }
 
 private:
@@ -89,6 +128,7 @@ private:
   real_t sum_ = 0.0;
   real_t M_ = 0.0;
   real_t S_ = 0.0;
+  QuantileSketch sketch_;
 };
 
 //! Print statistics:
@@ -100,7 +140,11 @@ inline std::ostream& operator<<(std::ostream& out, const RunningStatistics& stat
       << "  sum: " << stat.sum() << "\n"
       << "  mean: " << stat.mean() << "\n"
       << "  variance: " << stat.var() << "\n"
-      << "  standard_deviation: " << stat.std() << "\n";
+      << "  standard_deviation: " << stat.std() << "\n"
+      << "  p50: " << stat.quantile(0.5) << "\n"
+      << "  p95: " << stat.quantile(0.95) << "\n"
+      << "  p99: " << stat.quantile(0.99) << "\n"
+      << "  p99_9: " << stat.quantile(0.999) << "\n";
   return out;
 }
 
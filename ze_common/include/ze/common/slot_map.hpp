@@ -0,0 +1,232 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <ze/common/logging.hpp>
+#include <ze/common/versioned_slot_handle.hpp>
+
+namespace ze {
+
+//! Container with stable generational handles and dense storage.
+//!
+//! Values are stored contiguously, iteration visits the live elements in
+//! memory order. Handles index an indirection array of slots, each slot
+//! stores the position of its value and a version that is incremented when
+//! the value is erased. A handle is valid while its slot is occupied and its
+//! version matches the one of the slot, so stale handles are detected in
+//! O(1), also once the version of a free slot has wrapped around. Erasing
+//! moves the last value into the hole, which invalidates pointers and
+//! iterators but never handles.
+//!
+//! Versions start at 1, a default constructed handle is never valid.
+//!
+//! Usage:
+//!   using LandmarkHandle = VersionedSlotHandle<uint32_t, 20, 12>;
+//!   SlotMap<Position, LandmarkHandle> landmarks;
+//!   LandmarkHandle h = landmarks.insert(Position::Zero());
+//!   if (Position* p = landmarks.find(h)) { ... }
+//!   landmarks.erase(h);
+template<typename T, typename Handle>
+class SlotMap
+{
+public:
+  using value_type = T;
+  using handle_t = Handle;
+  using index_t = typename Handle::value_t;
+  using iterator = typename std::vector<T>::iterator;
+  using const_iterator = typename std::vector<T>::const_iterator;
+
+  SlotMap() = default;
+
+  //! Reserves storage for n values, so that inserting them does not allocate.
+  void reserve(size_t n)
+  {
+    values_.reserve(n);
+    value_slots_.reserve(n);
+    slots_.reserve(n);
+  }
+
+  inline Handle insert(const T& value)
+  {
+    return emplace(value);
+  }
+
+  inline Handle insert(T&& value)
+  {
+    return emplace(std::move(value));
+  }
+
+  template<typename... Args>
+  Handle emplace(Args&&... args)
+  {
+    index_t slot;
+    if (free_head_ != c_end_of_free_list)
+    {
+      slot = free_head_;
+      free_head_ = slots_[slot].index;
+    }
+    else
+    {
+      CHECK_LT(slots_.size(), static_cast<size_t>(Handle::maxSlot()))
+          << "SlotMap is full.";
+      slot = static_cast<index_t>(slots_.size());
+      slots_.push_back(Slot { 0u, 1u, false });
+    }
+    values_.emplace_back(std::forward<Args>(args)...);
+    value_slots_.push_back(slot);
+    slots_[slot].index = static_cast<index_t>(values_.size() - 1u);
+    slots_[slot].occupied = true;
+    return Handle(slot, slots_[slot].version);
+  }
+
+  //! @return False if the handle was stale.
+  bool erase(Handle handle)
+  {
+    if (!contains(handle))
+    {
+      return false;
+    }
+    const index_t slot = handle.slot;
+    const index_t index = slots_[slot].index;
+
+    // Move the last value into the hole.
+    const index_t last = static_cast<index_t>(values_.size() - 1u);
+    if (index != last)
+    {
+      values_[index] = std::move(values_[last]);
+      value_slots_[index] = value_slots_[last];
+      slots_[value_slots_[index]].index = index;
+    }
+    values_.pop_back();
+    value_slots_.pop_back();
+
+    releaseSlot(slot);
+    return true;
+  }
+
+  //! Erases all values and invalidates all handles. Keeps the storage.
+  void clear()
+  {
+    for (const index_t slot : value_slots_)
+    {
+      releaseSlot(slot);
+    }
+    values_.clear();
+    value_slots_.clear();
+  }
+
+  inline bool contains(Handle handle) const
+  {
+    const index_t slot = handle.slot;
+    return slot < slots_.size()
+        && slots_[slot].occupied
+        && slots_[slot].version == static_cast<index_t>(handle.version);
+  }
+
+  //! @return Pointer to the value or nullptr if the handle is stale.
+  inline T* find(Handle handle)
+  {
+    return contains(handle) ? &values_[slots_[handle.slot].index] : nullptr;
+  }
+
+  inline const T* find(Handle handle) const
+  {
+    return contains(handle) ? &values_[slots_[handle.slot].index] : nullptr;
+  }
+
+  inline T& operator[](Handle handle)
+  {
+    DEBUG_CHECK(contains(handle)) << "Stale handle " << handle;
+    return values_[slots_[handle.slot].index];
+  }
+
+  inline const T& operator[](Handle handle) const
+  {
+    DEBUG_CHECK(contains(handle)) << "Stale handle " << handle;
+    return values_[slots_[handle.slot].index];
+  }
+
+  //! @return Handle of the value at position i of the dense storage.
+  inline Handle handleAt(size_t i) const
+  {
+    DEBUG_CHECK_LT(i, values_.size());
+    const index_t slot = value_slots_[i];
+    return Handle(slot, slots_[slot].version);
+  }
+
+  inline size_t size() const { return values_.size(); }
+  inline bool empty() const { return values_.empty(); }
+
+  //! Dense storage of the live values.
+  inline T* data() { return values_.data(); }
+  inline const T* data() const { return values_.data(); }
+
+  inline iterator begin() { return values_.begin(); }
+  inline iterator end() { return values_.end(); }
+  inline const_iterator begin() const { return values_.begin(); }
+  inline const_iterator end() const { return values_.end(); }
+
+private:
+  struct Slot
+  {
+    //! Position in values_ if the slot is in use, else the next free slot.
+    index_t index;
+    index_t version;
+    //! A free slot can carry the version of an old handle again after
+    //! wrap-around, and its index is then a free list link.
+    bool occupied;
+  };
+
+  //! The largest slot is never handed out, it terminates the free list.
+  static constexpr index_t c_end_of_free_list = Handle::maxSlot();
+
+  inline void releaseSlot(index_t slot)
+  {
+    // Skip version 0 on wrap-around, it is reserved for invalid handles.
+    index_t version = slots_[slot].version + 1u;
+    if (version > Handle::maxVersion())
+    {
+      version = 1u;
+    }
+    slots_[slot].version = version;
+    slots_[slot].index = free_head_;
+    slots_[slot].occupied = false;
+    free_head_ = slot;
+  }
+
+  std::vector<T> values_;
+  std::vector<index_t> value_slots_;
+  std::vector<Slot> slots_;
+  index_t free_head_ = c_end_of_free_list;
+};
+
+template<typename T, typename Handle>
+constexpr typename SlotMap<T, Handle>::index_t SlotMap<T, Handle>::c_end_of_free_list;
+
+} // namespace ze
@@ -0,0 +1,384 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ze/common/logging.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+
+//! Sorted, contiguous storage of time-stamped vectors in structure-of-arrays
+//! layout: one array with the stamps and one array with the values, where the
+//! values of one sample are stored consecutively.
+//!
+//! Appending in time order is amortized O(1), lookups are binary searches.
+//! Out-of-order insertions are supported but cost O(n). Removing the oldest
+//! samples only advances an offset, the dead prefix is compacted once it is
+//! larger than the live data and memory is returned if the capacity is much
+//! larger than needed.
+//!
+//! The iterator interface mimics std::map<int64_t, Vector>: it->first is the
+//! stamp and it->second is an Eigen::Map to the value. Iterators are
+//! invalidated by every modification.
+template <typename Scalar, int Dim>
+class SortedTimeSeries
+{
+  static_assert(Dim > 0, "SortedTimeSeries requires a fixed dimension.");
+
+public:
+  using Vector = Eigen::Matrix<Scalar, Dim, 1>;
+  using StampVector = Eigen::Matrix<int64_t, Eigen::Dynamic, 1>;
+  using ValueMatrix = Eigen::Matrix<Scalar, Dim, Eigen::Dynamic>;
+
+  static constexpr int kDim = Dim;
+
+  template<bool IsConst>
+  class Iterator;
+
+  template<typename BaseIterator>
+  class ReverseIterator;
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+  using reverse_iterator = ReverseIterator<iterator>;
+  using const_reverse_iterator = ReverseIterator<const_iterator>;
+
+  SortedTimeSeries() = default;
+
+  //! @name Capacity
+  //@{
+  inline size_t size() const { return stamps_.size() - offset_; }
+  inline bool empty() const { return size() == 0u; }
+  inline void reserve(size_t n)
+  {
+    stamps_.reserve(offset_ + n);
+    values_.reserve((offset_ + n) * Dim);
+  }
+  //@}
+
+  //! @name Iterators
+  //@{
+  inline iterator begin() { return iterator(this, offset_); }
+  inline iterator end() { return iterator(this, stamps_.size()); }
+  inline const_iterator begin() const { return const_iterator(this, offset_); }
+  inline const_iterator end() const { return const_iterator(this, stamps_.size()); }
+  inline reverse_iterator rbegin() { return reverse_iterator(end()); }
+  inline reverse_iterator rend() { return reverse_iterator(begin()); }
+  inline const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  inline const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+  //@}
+
+  //! @name Contiguous access
+  //! Views on the stamp and value arrays, valid until the next modification.
+  //@{
+  inline Eigen::Map<const StampVector> stamps() const
+  {
+    return Eigen::Map<const StampVector>(stamps_.data() + offset_, size());
+  }
+
+  inline Eigen::Map<const ValueMatrix> values() const
+  {
+    return Eigen::Map<const ValueMatrix>(values_.data() + offset_ * Dim, Dim, size());
+  }
+
+  inline int64_t oldestStamp() const { DEBUG_CHECK(!empty()); return stamps_[offset_]; }
+  inline int64_t newestStamp() const { DEBUG_CHECK(!empty()); return stamps_.back(); }
+  //@}
+
+  //! Inserts or overwrites the value at stamp.
+  void insert(int64_t stamp, const Eigen::Ref<const Vector>& value);
+
+  //! Inserts n samples, values holds Dim scalars per sample. The leading run
+  //! of ordered samples newer than the newest entry is appended in bulk.
+  void insert(const int64_t* stamps, const Scalar* values, size_t n);
+
+  //! First entry with stamp >= the given stamp, end() if none.
+  inline iterator lower_bound(int64_t stamp)
+  {
+    return iterator(this, lowerBoundIndex(stamp));
+  }
+  inline const_iterator lower_bound(int64_t stamp) const
+  {
+    return const_iterator(this, lowerBoundIndex(stamp));
+  }
+
+  //! Removes [begin(), it).
+  void eraseBefore(const_iterator it);
+
+  inline void clear()
+  {
+    stamps_.clear();
+    values_.clear();
+    offset_ = 0u;
+  }
+
+  //! Releases unused memory, including the dead prefix.
+  void shrinkToFit();
+
+private:
+  inline size_t lowerBoundIndex(int64_t stamp) const
+  {
+    return std::lower_bound(stamps_.begin() + offset_, stamps_.end(), stamp)
+        - stamps_.begin();
+  }
+
+  void compact();
+
+  std::vector<int64_t> stamps_;
+  std::vector<Scalar> values_;
+  size_t offset_ = 0u; //!< Index of the oldest live entry.
+};
+
+// -----------------------------------------------------------------------------
+template <typename Scalar, int Dim>
+template <bool IsConst>
+class SortedTimeSeries<Scalar, Dim>::Iterator
+{
+public:
+  using Container = typename std::conditional<
+      IsConst, const SortedTimeSeries, SortedTimeSeries>::type;
+  using ValueMap = Eigen::Map<typename std::conditional<
+      IsConst, const Vector, Vector>::type>;
+
+  //! Proxy that mimics std::pair<const int64_t, Vector>&.
+  struct Entry
+  {
+    const int64_t& first;
+    ValueMap second;
+  };
+
+  //! Proxy returned by operator->.
+  struct EntryPointer
+  {
+    Entry entry;
+    inline const Entry* operator->() const { return &entry; }
+  };
+
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::pair<int64_t, Vector>;
+  using difference_type = std::ptrdiff_t;
+  using reference = Entry;
+  using pointer = EntryPointer;
+
+  Iterator() = default;
+  Iterator(Container* container, size_t index)
+    : container_(container)
+    , index_(index)
+  {}
+
+  //! Conversion from non-const to const iterator.
+  template<bool OtherConst,
+           typename = typename std::enable_if<IsConst && !OtherConst>::type>
+  Iterator(const Iterator<OtherConst>& other)
+    : container_(other.container_)
+    , index_(other.index_)
+  {}
+
+  inline reference operator*() const
+  {
+    return Entry{ container_->stamps_[index_],
+                  ValueMap(container_->values_.data() + index_ * Dim) };
+  }
+  inline pointer operator->() const { return EntryPointer{ **this }; }
+  inline reference operator[](difference_type n) const { return *(*this + n); }
+
+  inline Iterator& operator++() { ++index_; return *this; }
+  inline Iterator& operator--() { --index_; return *this; }
+  inline Iterator operator++(int) { Iterator it(*this); ++index_; return it; }
+  inline Iterator operator--(int) { Iterator it(*this); --index_; return it; }
+  inline Iterator& operator+=(difference_type n) { index_ += n; return *this; }
+  inline Iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+  inline Iterator operator+(difference_type n) const { return Iterator(container_, index_ + n); }
+  inline Iterator operator-(difference_type n) const { return Iterator(container_, index_ - n); }
+  inline difference_type operator-(const Iterator& rhs) const
+  {
+    return static_cast<difference_type>(index_) - static_cast<difference_type>(rhs.index_);
+  }
+
+  template<bool C> inline bool operator==(const Iterator<C>& rhs) const { return index_ == rhs.index_; }
+  template<bool C> inline bool operator!=(const Iterator<C>& rhs) const { return index_ != rhs.index_; }
+  template<bool C> inline bool operator<(const Iterator<C>& rhs) const { return index_ < rhs.index_; }
+  template<bool C> inline bool operator>(const Iterator<C>& rhs) const { return index_ > rhs.index_; }
+  template<bool C> inline bool operator<=(const Iterator<C>& rhs) const { return index_ <= rhs.index_; }
+  template<bool C> inline bool operator>=(const Iterator<C>& rhs) const { return index_ >= rhs.index_; }
+
+  //! Position in the underlying arrays.
+  inline size_t index() const { return index_; }
+
+private:
+  friend class SortedTimeSeries;
+  template<bool> friend class Iterator;
+
+  Container* container_ = nullptr;
+  size_t index_ = 0u;
+};
+
+// -----------------------------------------------------------------------------
+//! std::reverse_iterator needs operator-> to return a real pointer, which our
+//! proxy iterators cannot provide.
+template <typename Scalar, int Dim>
+template <typename BaseIterator>
+class SortedTimeSeries<Scalar, Dim>::ReverseIterator
+{
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename BaseIterator::value_type;
+  using difference_type = typename BaseIterator::difference_type;
+  using reference = typename BaseIterator::reference;
+  using pointer = typename BaseIterator::pointer;
+
+  ReverseIterator() = default;
+  explicit ReverseIterator(const BaseIterator& base)
+    : base_(base)
+  {}
+
+  inline BaseIterator base() const { return base_; }
+  inline reference operator*() const { BaseIterator it(base_); return *(--it); }
+  inline pointer operator->() const { BaseIterator it(base_); return (--it).operator->(); }
+
+  inline ReverseIterator& operator++() { --base_; return *this; }
+  inline ReverseIterator& operator--() { ++base_; return *this; }
+  inline ReverseIterator operator++(int) { ReverseIterator it(*this); --base_; return it; }
+  inline ReverseIterator operator--(int) { ReverseIterator it(*this); ++base_; return it; }
+
+  inline bool operator==(const ReverseIterator& rhs) const { return base_ == rhs.base_; }
+  inline bool operator!=(const ReverseIterator& rhs) const { return base_ != rhs.base_; }
+
+private:
+  BaseIterator base_;
+};
+
+// -----------------------------------------------------------------------------
+template <typename Scalar, int Dim>
+void SortedTimeSeries<Scalar, Dim>::insert(
+    int64_t stamp, const Eigen::Ref<const Vector>& value)
+{
+  if (empty() || stamp > stamps_.back())
+  {
+    // Fast path: in-order append.
+    stamps_.push_back(stamp);
+    values_.insert(values_.end(), value.data(), value.data() + Dim);
+    return;
+  }
+
+  const size_t index = lowerBoundIndex(stamp);
+  if (index < stamps_.size() && stamps_[index] == stamp)
+  {
+    Eigen::Map<Vector>(values_.data() + index * Dim) = value;
+    return;
+  }
+
+  // Out-of-order insertion. If there is a dead prefix right before the
+  // insertion point, reuse the slot instead of shifting the tail.
+  if (index == offset_ && offset_ > 0u)
+  {
+    --offset_;
+    stamps_[offset_] = stamp;
+    Eigen::Map<Vector>(values_.data() + offset_ * Dim) = value;
+    return;
+  }
+  stamps_.insert(stamps_.begin() + index, stamp);
+  values_.insert(values_.begin() + index * Dim, value.data(), value.data() + Dim);
+}
+
+// -----------------------------------------------------------------------------
+template <typename Scalar, int Dim>
+void SortedTimeSeries<Scalar, Dim>::insert(
+    const int64_t* stamps, const Scalar* values, size_t n)
+{
+  size_t n_ordered = 0u;
+  if (n > 0u && (empty() || stamps[0] > stamps_.back()))
+  {
+    n_ordered = 1u;
+    while (n_ordered < n && stamps[n_ordered] > stamps[n_ordered - 1u])
+    {
+      ++n_ordered;
+    }
+    stamps_.insert(stamps_.end(), stamps, stamps + n_ordered);
+    values_.insert(values_.end(), values, values + n_ordered * Dim);
+  }
+  for (size_t i = n_ordered; i < n; ++i)
+  {
+    insert(stamps[i], Eigen::Map<const Vector>(values + i * Dim));
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename Scalar, int Dim>
+void SortedTimeSeries<Scalar, Dim>::eraseBefore(const_iterator it)
+{
+  DEBUG_CHECK_GE(it.index(), offset_);
+  DEBUG_CHECK_LE(it.index(), stamps_.size());
+  offset_ = it.index();
+  if (offset_ == stamps_.size())
+  {
+    // Everything removed, keep the capacity for new samples.
+    clear();
+  }
+  else if (offset_ > size())
+  {
+    compact();
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename Scalar, int Dim>
+void SortedTimeSeries<Scalar, Dim>::compact()
+{
+  stamps_.erase(stamps_.begin(), stamps_.begin() + offset_);
+  values_.erase(values_.begin(), values_.begin() + offset_ * Dim);
+  offset_ = 0u;
+
+  // Shrink on trim: return memory if we use less than a quarter of it.
+  if (stamps_.capacity() > 4u * stamps_.size() && stamps_.capacity() > 1024u)
+  {
+    stamps_.shrink_to_fit();
+    values_.shrink_to_fit();
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename Scalar, int Dim>
+void SortedTimeSeries<Scalar, Dim>::shrinkToFit()
+{
+  if (offset_ > 0u)
+  {
+    stamps_.erase(stamps_.begin(), stamps_.begin() + offset_);
+    values_.erase(values_.begin(), values_.begin() + offset_ * Dim);
+    offset_ = 0u;
+  }
+  stamps_.shrink_to_fit();
+  values_.shrink_to_fit();
+}
+
+} // namespace ze
@@ -25,9 +25,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <utility>
 #include <vector>
-#include <algorithm>
 #include <Eigen/Dense>
 #include <ze/common/logging.hpp>
 
@@ -38,27 +40,164 @@
 
 namespace ze {
 
+//! Median of the n values in data, which are partially sorted in place. For
+//! even n, the upper of the two central values is returned.
+template <typename Scalar>
+std::pair<Scalar, bool> medianInPlace(Scalar* data, size_t n)
+{
+  if(n == 0)
+  {
+    LOG(WARNING) << "Median computation of empty vector.";
+    return std::make_pair(Scalar{0}, false);
+  }
+  const size_t center = n / 2;
+  std::nth_element(data, data + center, data + n);
+  return std::make_pair(data[center], true);
+}
+
 //! Does not take const-ref because vector will be sorted.
 template <typename Scalar>
 std::pair<Scalar, bool> median(std::vector<Scalar>& v)
 {
-  if(v.size() == 0)
+  return medianInPlace(v.data(), v.size());
+}
+
+//! Copies v to scratch, which is resized but keeps its capacity across calls.
+template <typename DerivedVec>
+std::pair<typename DerivedVec::Scalar, bool> median(
+    const Eigen::MatrixBase<DerivedVec>& v,
+    std::vector<typename DerivedVec::Scalar>* scratch)
+{
+  EIGEN_STATIC_ASSERT_VECTOR_ONLY(DerivedVec);
+  CHECK_NOTNULL(scratch);
+  scratch->resize(v.size());
+  Eigen::Map<Eigen::Matrix<typename DerivedVec::Scalar, Eigen::Dynamic, 1>>(
+        scratch->data(), v.size()) = v;
+  return medianInPlace(scratch->data(), scratch->size());
+}
+
+//! Uses a thread-local scratch buffer, so it does not allocate once the
+//! buffer is large enough.
+template <typename DerivedVec>
+std::pair<typename DerivedVec::Scalar, bool> median(const Eigen::MatrixBase<DerivedVec>& v)
+{
+  static thread_local std::vector<typename DerivedVec::Scalar> scratch;
+  return median(v, &scratch);
+}
+
+//! Median of |v_i|, the absolute values are computed while copying to
+//! scratch. For zero-mean residuals, this is the median absolute deviation.
+template <typename DerivedVec>
+std::pair<typename DerivedVec::Scalar, bool> medianOfAbsoluteValues(
+    const Eigen::MatrixBase<DerivedVec>& v,
+    std::vector<typename DerivedVec::Scalar>* scratch)
+{
+  EIGEN_STATIC_ASSERT_VECTOR_ONLY(DerivedVec);
+  CHECK_NOTNULL(scratch);
+  scratch->resize(v.size());
+  Eigen::Map<Eigen::Matrix<typename DerivedVec::Scalar, Eigen::Dynamic, 1>>(
+        scratch->data(), v.size()) = v.cwiseAbs();
+  return medianInPlace(scratch->data(), scratch->size());
+}
+
+namespace internal {
+
+//! Approximate median with two levels of 256-bin histograms, see
+//! approximateMedian(). transform is applied to each value.
+template <typename DerivedVec, typename Transform>
+std::pair<typename DerivedVec::Scalar, bool> approximateMedianImpl(
+    const Eigen::MatrixBase<DerivedVec>& v, const Transform& transform)
+{
+  using Scalar = typename DerivedVec::Scalar;
+  constexpr int c_num_bins = 256;
+  const int n = v.size();
+  if(n == 0)
   {
     LOG(WARNING) << "Median computation of empty vector.";
     return std::make_pair(Scalar{0}, false);
   }
-  const size_t center = v.size() / 2;
-  std::nth_element(v.begin(), v.begin() + center, v.end());
-  Scalar median = v[center];
-  return std::make_pair(median, true);
+
+  Scalar lo = transform(v(0));
+  Scalar hi = lo;
+  for(int i = 1; i < n; ++i)
+  {
+    const Scalar x = transform(v(i));
+    lo = std::min(lo, x);
+    hi = std::max(hi, x);
+  }
+
+  if(!(hi > lo))
+  {
+    return std::make_pair(lo, true);
+  }
+
+  // Find the bin of the element with the same rank as in median(), then
+  // refine within that bin.
+  int rank = n / 2;
+  std::array<int, c_num_bins> histogram;
+  auto findBin = [&]() {
+    int bin = 0;
+    while(bin < c_num_bins - 1 && rank >= histogram[bin])
+    {
+      rank -= histogram[bin];
+      ++bin;
+    }
+    return bin;
+  };
+  auto binIndex = [&](Scalar x, Scalar origin, Scalar inv_width) {
+    const int bin = static_cast<int>((x - origin) * inv_width);
+    return std::max(0, std::min(bin, c_num_bins - 1));
+  };
+
+  const Scalar width = (hi - lo) / c_num_bins;
+  const Scalar inv_width = c_num_bins / (hi - lo);
+  histogram.fill(0);
+  for(int i = 0; i < n; ++i)
+  {
+    ++histogram[binIndex(transform(v(i)), lo, inv_width)];
+  }
+  const int coarse_bin = findBin();
+
+  const Scalar fine_lo = lo + coarse_bin * width;
+  const Scalar fine_width = width / c_num_bins;
+  const Scalar fine_inv_width = inv_width * c_num_bins;
+  histogram.fill(0);
+  for(int i = 0; i < n; ++i)
+  {
+    const Scalar x = transform(v(i));
+    if(binIndex(x, lo, inv_width) == coarse_bin)
+    {
+      ++histogram[binIndex(x, fine_lo, fine_inv_width)];
+    }
+  }
+  const int fine_bin = findBin();
+  return std::make_pair(fine_lo + (fine_bin + Scalar{0.5}) * fine_width, true);
+}
+
+} // namespace internal
+
+//! Histogram-based median in O(n) without allocations, for large vectors
+//! where the partial sort in median() gets expensive. The result is off by
+//! at most about (max(v) - min(v)) / 2^17 compared to median(), so it is
+//! only usable when v has no outliers and no non-finite values; robust
+//! estimators must use median().
+template <typename DerivedVec>
+std::pair<typename DerivedVec::Scalar, bool> approximateMedian(
+    const Eigen::MatrixBase<DerivedVec>& v)
+{
+  EIGEN_STATIC_ASSERT_VECTOR_ONLY(DerivedVec);
+  using Scalar = typename DerivedVec::Scalar;
+  return internal::approximateMedianImpl(v, [](Scalar x) { return x; });
 }
 
+//! Histogram-based median of |v_i|, see approximateMedian().
 template <typename DerivedVec>
-std::pair<typename DerivedVec::Scalar, bool> median(const Eigen::MatrixBase<DerivedVec>& v)
+std::pair<typename DerivedVec::Scalar, bool> approximateMedianOfAbsoluteValues(
+    const Eigen::MatrixBase<DerivedVec>& v)
 {
   EIGEN_STATIC_ASSERT_VECTOR_ONLY(DerivedVec);
-  auto w = eigenVectorToStlVector(v);
-  return median<typename DerivedVec::Scalar>(w);
+  using Scalar = typename DerivedVec::Scalar;
+  return internal::approximateMedianImpl(v, [](Scalar x) { return std::abs(x); });
 }
 
 template<class T>
@@ -0,0 +1,121 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+//! @file test_allocation_counter.hpp
+//! Counts heap allocations in unit tests. Place ZE_ALLOCATION_COUNTING_HOOK
+//! once at global scope of a test binary. With glibc, the hook wraps malloc
+//! and friends, so that Eigen and posix_memalign allocations are counted as
+//! well. Elsewhere it only replaces the global operator new. Without the hook,
+//! all counts stay zero.
+//!
+//! Usage:
+//!   AllocationCounter counter;
+//!   processFrame();
+//!   EXPECT_EQ(counter.count(), 0u);
+
+namespace ze {
+namespace internal {
+
+inline size_t& threadAllocationCount()
+{
+  static thread_local size_t count = 0u;
+  return count;
+}
+
+} // namespace internal
+
+//! Number of heap allocations of the calling thread since construction.
+class AllocationCounter
+{
+public:
+  AllocationCounter()
+    : start_(internal::threadAllocationCount())
+  {}
+
+  inline size_t count() const
+  {
+    return internal::threadAllocationCount() - start_;
+  }
+
+  inline void restart()
+  {
+    start_ = internal::threadAllocationCount();
+  }
+
+private:
+  size_t start_;
+};
+
+} // namespace ze
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t num, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* p);
+}
+
+#define ZE_ALLOCATION_COUNTING_HOOK \
+  extern "C" { \
+  void* malloc(size_t size) \
+  { ++ze::internal::threadAllocationCount(); return __libc_malloc(size); } \
+  void* calloc(size_t num, size_t size) \
+  { ++ze::internal::threadAllocationCount(); return __libc_calloc(num, size); } \
+  void* realloc(void* p, size_t size) \
+  { ++ze::internal::threadAllocationCount(); return __libc_realloc(p, size); } \
+  void* memalign(size_t alignment, size_t size) \
+  { ++ze::internal::threadAllocationCount(); return __libc_memalign(alignment, size); } \
+  void* aligned_alloc(size_t alignment, size_t size) \
+  { ++ze::internal::threadAllocationCount(); return __libc_memalign(alignment, size); } \
+  int posix_memalign(void** p, size_t alignment, size_t size) \
+  { \
+    ++ze::internal::threadAllocationCount(); \
+    *p = __libc_memalign(alignment, size); \
+    return *p ? 0 : ENOMEM; \
+  } \
+  void free(void* p) { __libc_free(p); } \
+  }
+#else
+#define ZE_ALLOCATION_COUNTING_HOOK \
+  void* operator new(std::size_t size) \
+  { \
+    ++ze::internal::threadAllocationCount(); \
+    void* p = std::malloc(size == 0u ? 1u : size); \
+    if (!p) { throw std::bad_alloc(); } \
+    return p; \
+  } \
+  void* operator new[](std::size_t size) { return operator new(size); } \
+  void operator delete(void* p) noexcept { std::free(p); } \
+  void operator delete[](void* p) noexcept { std::free(p); }
+#endif
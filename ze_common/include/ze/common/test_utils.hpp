@@ -29,6 +29,7 @@
 #include <limits>
 #include <map>
 #include <string>
+#include <ze/common/noncopyable.hpp>
 #include <ze/common/transformation.hpp>
 #include <ze/common/types.hpp>
 
@@ -38,6 +39,24 @@ namespace ze {
 //! the environment variable ZE_TEST_DATA_PATH must be set.
 std::string getTestDataDir(const std::string& dataset_name);
 
+//! Creates an empty file with a unique name in $TMPDIR (default /tmp), so
+//! that concurrently running tests do not collide. The test removes it.
+std::string createTemporaryFile(const std::string& prefix);
+
+//! File created by createTemporaryFile() that is removed again when the
+//! object goes out of scope.
+class TemporaryFile : Noncopyable
+{
+public:
+  explicit TemporaryFile(const std::string& prefix);
+  ~TemporaryFile();
+
+  inline const std::string& path() const { return path_; }
+
+private:
+  std::string path_;
+};
+
 //! Load poses from .csv file. Returns a map { Image-Index / Stamp -> Pose }
 std::map<int64_t, Transformation> loadIndexedPosesFromCsv(const std::string& filename);
 
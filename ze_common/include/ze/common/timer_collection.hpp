@@ -57,6 +57,8 @@ namespace ze {
     ...
   }
 \endcode
+ * While the Profiler is enabled, every timing is also recorded as a zone
+ * named after the timer.
 */
 template<typename TimerEnum>
 class TimerCollection
@@ -72,12 +74,14 @@ public:
     : names_(splitString(timer_names_comma_separated, ','))
   {
     CHECK_EQ(names_.size(), timers_.size());
+    setProfilerNames();
   }
 
   TimerCollection(const std::vector<std::string>& timer_names)
     : names_(timer_names)
   {
     CHECK_EQ(names_.size(), timers_.size());
+    setProfilerNames();
   }
 
   ~TimerCollection() = default;
@@ -94,6 +98,15 @@ public:
 
   constexpr size_t size() const noexcept { return timers_.size(); }
 
+  //! Adds the timings of other, e.g. a collection of another thread.
+  inline void merge(const TimerCollection& other)
+  {
+    for (size_t i = 0u; i < timers_.size(); ++i)
+    {
+      timers_[i].merge(other.timers_[i]);
+    }
+  }
+
   //! Saves timings to file in YAML format.
   inline void saveToFile(const std::string& directory, const std::string& filename) const
   {
@@ -108,6 +121,14 @@ public:
   inline const TimerNames& names() const { return names_; }
 
 private:
+  inline void setProfilerNames()
+  {
+    for (size_t i = 0u; i < timers_.size(); ++i)
+    {
+      timers_[i].setName(Profiler::internName(names_[i]));
+    }
+  }
+
   Timers timers_;
   std::vector<std::string> names_;
 };
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <ze/common/profiler.hpp>
 #include <ze/common/running_statistics.hpp>
 #include <ze/common/timer.hpp>
 #include <ze/common/types.hpp>
@@ -50,11 +51,22 @@ public:
 
   inline real_t stop()
   {
-    real_t t = t_.stopAndGetMilliseconds();
+    const int64_t ns = t_.stopAndGetNanoseconds();
+    if (name_ && Profiler::isEnabled())
+    {
+      const int64_t end_ns = Profiler::now();
+      Profiler::record(name_, end_ns - ns, end_ns);
+    }
+    real_t t = nanosecToMillisecTrunc(ns);
     stat_.addSample(t);
     return t;
   }
 
+  //! If set, each timing is recorded as a Profiler zone with this name. The
+  //! name must outlive the profiler, see Profiler::internName().
+  inline void setName(const char* name) { name_ = name; }
+  inline const char* name() const { return name_; }
+
   inline real_t numTimings() const { return stat_.numSamples(); }
   inline real_t accumulated() const { return stat_.sum(); }
   inline real_t min() const { return stat_.min(); }
@@ -62,12 +74,15 @@ public:
   inline real_t mean() const { return stat_.mean(); }
   inline real_t variance() const { return stat_.var(); }
   inline real_t standarDeviation() const { return stat_.std(); }
+  inline real_t quantile(real_t q) const { return stat_.quantile(q); }
+  inline void merge(const TimerStatistics& other) { stat_.merge(other.stat_); }
   inline void reset() { stat_.reset(); }
   inline const RunningStatistics& statistics() const { return stat_; }
 
 private:
   Timer t_;
   RunningStatistics stat_;
+  const char* name_ = nullptr;
 };
 
 //! This object is return from TimerStatistics::timeScope()
@@ -80,10 +95,12 @@ public:
     : timer_(timer)
   {
     timer_->start();
+    ++profilerThreadState().depth;
   }
 
   ~TimedScope()
   {
+    --profilerThreadState().depth;
     timer_->stop();
   }
 private:
@@ -0,0 +1,344 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ze/common/logging.hpp>
+#include <ze/common/noncopyable.hpp>
+
+namespace ze {
+
+// fwd
+class WorkStealingThreadPool;
+
+//! Type-erased, move-only callable with inline storage. Closures up to
+//! kInlineSize bytes are stored in place, so scheduling them does not touch
+//! the heap. Larger closures fall back to a heap allocation.
+class WorkStealingTask
+{
+public:
+  static constexpr size_t kInlineSize = 64u;
+
+  WorkStealingTask() = default;
+
+  template<typename F>
+  explicit WorkStealingTask(F&& f)
+  {
+    using Fn = typename std::decay<F>::type;
+    construct<Fn>(std::forward<F>(f), std::integral_constant<bool,
+                  sizeof(Fn) <= kInlineSize && alignof(Fn) <= alignof(Storage)>());
+  }
+
+  WorkStealingTask(WorkStealingTask&& other)
+  {
+    moveFrom(other);
+  }
+
+  WorkStealingTask& operator=(WorkStealingTask&& other)
+  {
+    if (this != &other)
+    {
+      reset();
+      moveFrom(other);
+    }
+    return *this;
+  }
+
+  WorkStealingTask(const WorkStealingTask&) = delete;
+  WorkStealingTask& operator=(const WorkStealingTask&) = delete;
+
+  ~WorkStealingTask()
+  {
+    reset();
+  }
+
+  inline explicit operator bool() const { return ops_ != nullptr; }
+
+  inline void operator()() { ops_->invoke(&storage_); }
+
+  inline void reset()
+  {
+    if (ops_)
+    {
+      ops_->destroy(&storage_);
+      ops_ = nullptr;
+    }
+  }
+
+private:
+  typedef typename std::aligned_storage<kInlineSize, alignof(std::max_align_t)>::type
+  Storage;
+
+  struct Ops
+  {
+    void (*invoke)(void*);
+    void (*move)(void* dst, void* src);
+    void (*destroy)(void*);
+  };
+
+  template<typename Fn>
+  static const Ops& inlineOps()
+  {
+    static const Ops ops = {
+      [](void* s) { (*static_cast<Fn*>(s))(); },
+      [](void* dst, void* src) {
+        new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+        static_cast<Fn*>(src)->~Fn();
+      },
+      [](void* s) { static_cast<Fn*>(s)->~Fn(); }
+    };
+    return ops;
+  }
+
+  template<typename Fn>
+  static const Ops& heapOps()
+  {
+    static const Ops ops = {
+      [](void* s) { (**static_cast<Fn**>(s))(); },
+      [](void* dst, void* src) {
+        *static_cast<Fn**>(dst) = *static_cast<Fn**>(src);
+      },
+      [](void* s) { delete *static_cast<Fn**>(s); }
+    };
+    return ops;
+  }
+
+  template<typename Fn, typename F>
+  inline void construct(F&& f, std::true_type /*fits_inline*/)
+  {
+    new (&storage_) Fn(std::forward<F>(f));
+    ops_ = &inlineOps<Fn>();
+  }
+
+  template<typename Fn, typename F>
+  inline void construct(F&& f, std::false_type /*fits_inline*/)
+  {
+    new (&storage_) Fn*(new Fn(std::forward<F>(f)));
+    ops_ = &heapOps<Fn>();
+  }
+
+  inline void moveFrom(WorkStealingTask& other)
+  {
+    ops_ = other.ops_;
+    if (ops_)
+    {
+      ops_->move(&storage_, &other.storage_);
+      other.ops_ = nullptr;
+    }
+  }
+
+  Storage storage_;
+  const Ops* ops_ = nullptr;
+};
+
+//! Fork/join group of tasks. Tasks are spawned with run() and wait() blocks
+//! until all of them are finished. While waiting, the calling thread executes
+//! pending tasks of the pool instead of sleeping. No futures are allocated.
+class TaskGroup : Noncopyable
+{
+public:
+  explicit TaskGroup(WorkStealingThreadPool& pool)
+    : pool_(pool)
+  {}
+
+  //! Waits for outstanding tasks, a group must not go out of scope earlier.
+  //! Exceptions of tasks that were not collected by wait() are dropped.
+  ~TaskGroup()
+  {
+    join();
+  }
+
+  //! Spawns f() on the pool. If f() throws, the exception is caught on the
+  //! executing thread and rethrown by wait().
+  template<typename F>
+  void run(F&& f);
+
+  //! Blocks until all tasks spawned with run() have finished. Rethrows the
+  //! first exception thrown by any of them.
+  void wait();
+
+  inline size_t numPending() const
+  {
+    return pending_.load(std::memory_order_acquire);
+  }
+
+private:
+  friend class WorkStealingThreadPool;
+
+  void join();
+  void setException(std::exception_ptr exception);
+
+  WorkStealingThreadPool& pool_;
+  std::atomic<size_t> pending_ { 0u };
+  std::mutex exception_mutex_;
+  std::exception_ptr exception_;
+};
+
+//! Thread pool with one task deque per worker. Workers push and pop tasks at
+//! the back of their own deque (LIFO, cache friendly) and, when they run out
+//! of work, steal from the front of other workers' deques (FIFO, large chunks
+//! first). Tasks submitted from outside the pool go to a shared injection
+//! queue. Contention is therefore spread over n_threads + 1 locks instead of
+//! one, and idle workers park on a condition variable only when there is no
+//! work left anywhere.
+//!
+//! In contrast to ThreadPool, tasks return nothing. Use TaskGroup to join on
+//! a set of tasks and parallelFor() to split index ranges.
+class WorkStealingThreadPool : Noncopyable
+{
+public:
+  //! Starts n_threads worker threads. n_threads == 0 uses the hardware
+  //! concurrency.
+  explicit WorkStealingThreadPool(size_t n_threads = 0u);
+
+  //! The destructor finishes all queued tasks and joins the workers.
+  ~WorkStealingThreadPool();
+
+  inline size_t numThreads() const { return workers_.size(); }
+
+  //! Schedules f() for execution. If called from a worker thread, the task is
+  //! pushed to that worker's own deque.
+  template<typename F>
+  void submit(F&& f)
+  {
+    push(WorkStealingTask(std::forward<F>(f)));
+  }
+
+  //! Calls fn(chunk_begin, chunk_end) for disjoint chunks covering
+  //! [begin, end), each at most grain indices long, and returns when all
+  //! chunks are processed. The range is split recursively in halves so that
+  //! idle workers steal large pieces first. The calling thread participates.
+  template<typename Fn>
+  void parallelFor(size_t begin, size_t end, size_t grain, const Fn& fn);
+
+  //! Executes one pending task on the calling thread, if there is any.
+  //! Returns false if no task was found.
+  bool runPendingTask();
+
+  //! Index of the calling worker thread in this pool, -1 for foreign threads.
+  int currentWorkerIndex() const;
+
+private:
+  friend class TaskGroup;
+
+  struct WorkerQueue
+  {
+    std::mutex mutex;
+    std::deque<WorkStealingTask> tasks;
+  };
+
+  void push(WorkStealingTask&& task);
+  bool pop(WorkStealingTask& task);
+  void workerLoop(size_t index);
+
+  template<typename Fn>
+  void parallelForImpl(size_t begin, size_t end, size_t grain, const Fn& fn,
+                       TaskGroup& group);
+
+  std::vector<std::thread> workers_;
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  WorkerQueue injection_queue_;
+
+  //! Number of tasks in all queues, used to decide whether to park.
+  std::atomic<size_t> num_queued_ { 0u };
+  std::atomic<size_t> num_sleeping_ { 0u };
+  std::atomic<bool> stop_ { false };
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_condition_;
+};
+
+// -----------------------------------------------------------------------------
+template<typename F>
+void TaskGroup::run(F&& f)
+{
+  pending_.fetch_add(1u, std::memory_order_relaxed);
+  TaskGroup* group = this;
+  pool_.submit([group, f]() mutable {
+    try
+    {
+      f();
+    }
+    catch (...)
+    {
+      group->setException(std::current_exception());
+    }
+    group->pending_.fetch_sub(1u, std::memory_order_acq_rel);
+  });
+}
+
+// -----------------------------------------------------------------------------
+template<typename Fn>
+void WorkStealingThreadPool::parallelFor(
+    size_t begin, size_t end, size_t grain, const Fn& fn)
+{
+  if (begin >= end)
+  {
+    return;
+  }
+  grain = std::max<size_t>(grain, 1u);
+  if (end - begin <= grain || workers_.empty())
+  {
+    fn(begin, end);
+    return;
+  }
+  TaskGroup group(*this);
+  parallelForImpl(begin, end, grain, fn, group);
+  group.wait();
+}
+
+// -----------------------------------------------------------------------------
+template<typename Fn>
+void WorkStealingThreadPool::parallelForImpl(
+    size_t begin, size_t end, size_t grain, const Fn& fn, TaskGroup& group)
+{
+  // Split off the upper half as a stealable task and continue with the lower
+  // half until the range is small enough.
+  while (end - begin > grain)
+  {
+    const size_t mid = begin + (end - begin) / 2u;
+    const Fn* fn_ptr = &fn;
+    TaskGroup* group_ptr = &group;
+    group.run([this, mid, end, grain, fn_ptr, group_ptr]() {
+      parallelForImpl(mid, end, grain, *fn_ptr, *group_ptr);
+    });
+    end = mid;
+  }
+  fn(begin, end);
+}
+
+} // namespace ze
@@ -0,0 +1,352 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/benchmark.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <yaml-cpp/yaml.h>
+
+#include <ze/common/file_utils.hpp>
+
+namespace ze {
+
+namespace {
+
+std::vector<std::unique_ptr<Benchmark>>& registry()
+{
+  static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+  return benchmarks;
+}
+
+//! Linear interpolation between closest ranks, sorted must be sorted.
+double percentile(const std::vector<double>& sorted, double p)
+{
+  DEBUG_CHECK(!sorted.empty());
+  const double rank = p * (sorted.size() - 1u);
+  const size_t lower = static_cast<size_t>(rank);
+  const size_t upper = std::min(lower + 1u, sorted.size() - 1u);
+  return sorted[lower] + (rank - lower) * (sorted[upper] - sorted[lower]);
+}
+
+int64_t runEpoch(const BenchmarkFunction& fun, uint64_t num_iterations,
+                 int64_t arg, double* items_per_iteration)
+{
+  BenchmarkState state(num_iterations, arg);
+  fun(state);
+  CHECK(!state.keepRunning())
+      << "Benchmark case returned before the keepRunning() loop finished.";
+  *items_per_iteration = state.itemsPerIteration();
+  return state.elapsedNanoseconds();
+}
+
+std::string formatNanoseconds(double ns)
+{
+  char buffer[32];
+  if (ns < 1e3)
+  {
+    std::snprintf(buffer, sizeof(buffer), "%.1f ns", ns);
+  }
+  else if (ns < 1e6)
+  {
+    std::snprintf(buffer, sizeof(buffer), "%.2f us", ns * 1e-3);
+  }
+  else if (ns < 1e9)
+  {
+    std::snprintf(buffer, sizeof(buffer), "%.2f ms", ns * 1e-6);
+  }
+  else
+  {
+    std::snprintf(buffer, sizeof(buffer), "%.2f s", ns * 1e-9);
+  }
+  return buffer;
+}
+
+} // anonymous namespace
+
+// -----------------------------------------------------------------------------
+std::ostream& operator<<(std::ostream& out, const BenchmarkResult& result)
+{
+  out << result.name << ": median " << formatNanoseconds(result.median_ns)
+      << ", p90 " << formatNanoseconds(result.p90_ns)
+      << ", p99 " << formatNanoseconds(result.p99_ns)
+      << ", min " << formatNanoseconds(result.min_ns)
+      << ", mean " << formatNanoseconds(result.mean_ns)
+      << " +- " << formatNanoseconds(result.stddev_ns)
+      << " (" << result.num_epochs << " x " << result.num_iterations
+      << " iterations, " << result.num_outliers << " outliers)";
+  if (result.items_per_iteration > 0.0)
+  {
+    out << ", " << result.throughput() << " items/s";
+  }
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+Benchmark* registerBenchmark(const std::string& name, const BenchmarkFunction& fun)
+{
+  registry().emplace_back(new Benchmark(name, fun));
+  return registry().back().get();
+}
+
+std::vector<const Benchmark*> registeredBenchmarks()
+{
+  std::vector<const Benchmark*> benchmarks;
+  for (const std::unique_ptr<Benchmark>& benchmark : registry())
+  {
+    benchmarks.push_back(benchmark.get());
+  }
+  return benchmarks;
+}
+
+// -----------------------------------------------------------------------------
+BenchmarkResult runBenchmark(
+    const std::string& name, const BenchmarkFunction& fun, int64_t arg,
+    const BenchmarkOptions& options)
+{
+  CHECK_GT(options.num_epochs, 0u);
+  if (options.cpu >= 0)
+  {
+    LOG_IF(WARNING, !pinThreadToCpu(options.cpu))
+        << "Failed to pin benchmark thread to CPU " << options.cpu;
+  }
+
+  BenchmarkResult result;
+  result.name = name;
+  result.num_epochs = options.num_epochs;
+
+  // Calibrate the number of iterations per epoch.
+  uint64_t num_iterations = options.num_iterations;
+  if (num_iterations == 0u)
+  {
+    num_iterations = 1u;
+    while (runEpoch(fun, num_iterations, arg, &result.items_per_iteration)
+           < options.min_epoch_ns
+           && num_iterations < (uint64_t(1) << 40))
+    {
+      num_iterations *= 2u;
+    }
+  }
+  result.num_iterations = num_iterations;
+
+  for (uint32_t i = 0u; i < options.num_warmup_epochs; ++i)
+  {
+    runEpoch(fun, num_iterations, arg, &result.items_per_iteration);
+  }
+
+  std::vector<double> times(options.num_epochs);
+  for (double& time : times)
+  {
+    time = static_cast<double>(
+          runEpoch(fun, num_iterations, arg, &result.items_per_iteration))
+        / num_iterations;
+  }
+  std::sort(times.begin(), times.end());
+  result.min_ns = times.front();
+  result.max_ns = times.back();
+  result.median_ns = percentile(times, 0.5);
+  result.p90_ns = percentile(times, 0.9);
+  result.p99_ns = percentile(times, 0.99);
+
+  // Median absolute deviation, scaled to be consistent with the standard
+  // deviation of a normal distribution.
+  std::vector<double> deviations(times.size());
+  for (size_t i = 0u; i < times.size(); ++i)
+  {
+    deviations[i] = std::abs(times[i] - result.median_ns);
+  }
+  std::sort(deviations.begin(), deviations.end());
+  const double mad = 1.4826 * percentile(deviations, 0.5);
+  const double outlier_limit = result.median_ns + options.outlier_threshold * mad;
+
+  double sum = 0.0, sum_sq = 0.0;
+  size_t n = 0u;
+  for (double time : times)
+  {
+    if (time > outlier_limit && mad > 0.0)
+    {
+      ++result.num_outliers;
+      continue;
+    }
+    sum += time;
+    sum_sq += time * time;
+    ++n;
+  }
+  result.mean_ns = sum / n;
+  result.stddev_ns = n > 1u
+      ? std::sqrt(std::max(0.0, (sum_sq - sum * sum / n) / (n - 1u))) : 0.0;
+  return result;
+}
+
+std::vector<BenchmarkResult> runRegisteredBenchmarks(
+    const std::string& filter, const BenchmarkOptions& options,
+    bool print_results)
+{
+  std::vector<BenchmarkResult> results;
+  for (const Benchmark* benchmark : registeredBenchmarks())
+  {
+    std::vector<int64_t> args = benchmark->arguments();
+    const bool has_args = !args.empty();
+    if (!has_args)
+    {
+      args.push_back(0);
+    }
+    for (int64_t arg : args)
+    {
+      const std::string name = has_args
+          ? benchmark->name() + "/" + std::to_string(arg) : benchmark->name();
+      if (name.find(filter) == std::string::npos)
+      {
+        continue;
+      }
+      results.push_back(runBenchmark(name, benchmark->function(), arg, options));
+      if (print_results)
+      {
+        std::cout << results.back() << std::endl;
+      }
+    }
+  }
+  return results;
+}
+
+// -----------------------------------------------------------------------------
+void writeBenchmarkResults(
+    std::ostream& out, const std::vector<BenchmarkResult>& results)
+{
+  out.precision(17);
+  out << "{\n  \"benchmarks\": [";
+  for (size_t i = 0u; i < results.size(); ++i)
+  {
+    const BenchmarkResult& r = results[i];
+    // Names are "suite/case/arg" and contain no characters to escape.
+    out << (i == 0u ? "\n" : ",\n")
+        << "    {\"name\": \"" << r.name << "\""
+        << ", \"num_iterations\": " << r.num_iterations
+        << ", \"num_epochs\": " << r.num_epochs
+        << ", \"num_outliers\": " << r.num_outliers
+        << ", \"min_ns\": " << r.min_ns
+        << ", \"median_ns\": " << r.median_ns
+        << ", \"p90_ns\": " << r.p90_ns
+        << ", \"p99_ns\": " << r.p99_ns
+        << ", \"max_ns\": " << r.max_ns
+        << ", \"mean_ns\": " << r.mean_ns
+        << ", \"stddev_ns\": " << r.stddev_ns
+        << ", \"items_per_iteration\": " << r.items_per_iteration
+        << ", \"items_per_second\": " << r.throughput() << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+void saveBenchmarkResults(
+    const std::string& filename, const std::vector<BenchmarkResult>& results)
+{
+  std::ofstream fs;
+  openOutputFileStream(filename, &fs);
+  writeBenchmarkResults(fs, results);
+}
+
+std::vector<BenchmarkResult> loadBenchmarkResults(const std::string& filename)
+{
+  CHECK(fileExists(filename)) << "Benchmark results not found: " << filename;
+  // JSON is valid YAML.
+  const YAML::Node node = YAML::LoadFile(filename);
+  std::vector<BenchmarkResult> results;
+  for (const YAML::Node& entry : node["benchmarks"])
+  {
+    BenchmarkResult r;
+    r.name = entry["name"].as<std::string>();
+    r.num_iterations = entry["num_iterations"].as<uint64_t>();
+    r.num_epochs = entry["num_epochs"].as<uint32_t>();
+    r.num_outliers = entry["num_outliers"].as<uint32_t>();
+    r.min_ns = entry["min_ns"].as<double>();
+    r.median_ns = entry["median_ns"].as<double>();
+    r.p90_ns = entry["p90_ns"].as<double>();
+    r.p99_ns = entry["p99_ns"].as<double>();
+    r.max_ns = entry["max_ns"].as<double>();
+    r.mean_ns = entry["mean_ns"].as<double>();
+    r.stddev_ns = entry["stddev_ns"].as<double>();
+    r.items_per_iteration = entry["items_per_iteration"].as<double>();
+    results.push_back(r);
+  }
+  return results;
+}
+
+size_t compareBenchmarkResults(
+    const std::vector<BenchmarkResult>& results,
+    const std::vector<BenchmarkResult>& baseline,
+    double tolerance, std::ostream& out)
+{
+  std::map<std::string, const BenchmarkResult*> baseline_by_name;
+  for (const BenchmarkResult& r : baseline)
+  {
+    baseline_by_name[r.name] = &r;
+  }
+
+  size_t num_regressions = 0u;
+  for (const BenchmarkResult& r : results)
+  {
+    auto it = baseline_by_name.find(r.name);
+    if (it == baseline_by_name.end())
+    {
+      out << r.name << ": not in baseline\n";
+      continue;
+    }
+    const double ratio = r.median_ns / it->second->median_ns;
+    const bool regression = ratio > 1.0 + tolerance;
+    num_regressions += regression;
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%+.1f%%", (ratio - 1.0) * 100.0);
+    out << r.name << ": " << formatNanoseconds(it->second->median_ns)
+        << " -> " << formatNanoseconds(r.median_ns) << " (" << buffer << ")"
+        << (regression ? " REGRESSION" : "") << "\n";
+  }
+  return num_regressions;
+}
+
+// -----------------------------------------------------------------------------
+bool pinThreadToCpu(int cpu)
+{
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+  return false;
+#endif
+}
+
+} // namespace ze
@@ -0,0 +1,258 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/binary_trajectory.hpp>
+
+#include <cstring>
+#include <fstream>
+
+#include <ze/common/csv_trajectory.hpp>
+#include <ze/common/file_utils.hpp>
+#include <ze/common/logging.hpp>
+
+namespace ze {
+
+namespace {
+
+constexpr char c_magic[8] = {'Z', 'E', 'T', 'R', 'A', 'J', '\0', '\0'};
+constexpr uint64_t c_alignment = 64u;
+
+inline uint64_t alignOffset(uint64_t offset)
+{
+  return (offset + c_alignment - 1u) / c_alignment * c_alignment;
+}
+
+//! Pads the stream with zeros up to offset and writes the array there.
+void writeArray(std::ofstream& fs, uint64_t offset, const void* data,
+                size_t num_bytes)
+{
+  static const char c_zeros[c_alignment] = {};
+  const uint64_t position = static_cast<uint64_t>(fs.tellp());
+  CHECK_LE(position, offset);
+  fs.write(c_zeros, static_cast<std::streamsize>(offset - position));
+  fs.write(static_cast<const char*>(data),
+           static_cast<std::streamsize>(num_bytes));
+}
+
+} // anonymous namespace
+
+void saveBinaryTrajectory(
+    const std::string& filename,
+    const Eigen::Ref<const Eigen::Matrix<int64_t, Eigen::Dynamic, 1>>& stamps,
+    const Eigen::Ref<const Positions>& positions,
+    const Eigen::Ref<const Matrix4X>& quaternions,
+    const Matrix3X* velocities,
+    const Matrix3X* gyro_biases,
+    const Matrix3X* accel_biases)
+{
+  const uint64_t n = static_cast<uint64_t>(stamps.size());
+  CHECK_EQ(positions.cols(), stamps.size());
+  CHECK_EQ(quaternions.cols(), stamps.size());
+  const bool has_velocity_and_bias = (velocities != nullptr);
+  CHECK_EQ(has_velocity_and_bias, gyro_biases != nullptr);
+  CHECK_EQ(has_velocity_and_bias, accel_biases != nullptr);
+
+  BinaryTrajectoryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, c_magic, sizeof(c_magic));
+  header.version = BinaryTrajectoryHeader::c_version;
+  header.byte_order_mark = BinaryTrajectoryHeader::c_byte_order_mark;
+  header.scalar_size = sizeof(real_t);
+  header.num_poses = n;
+
+  const uint64_t vector3_bytes = 3u * n * sizeof(real_t);
+  header.stamps_offset = alignOffset(sizeof(header));
+  header.positions_offset = alignOffset(header.stamps_offset + n * sizeof(int64_t));
+  header.quaternions_offset = alignOffset(header.positions_offset + vector3_bytes);
+  if (has_velocity_and_bias)
+  {
+    CHECK_EQ(velocities->cols(), stamps.size());
+    CHECK_EQ(gyro_biases->cols(), stamps.size());
+    CHECK_EQ(accel_biases->cols(), stamps.size());
+    header.flags |= BinaryTrajectoryHeader::c_has_velocity_and_bias;
+    header.velocities_offset =
+        alignOffset(header.quaternions_offset + 4u * n * sizeof(real_t));
+    header.gyro_biases_offset =
+        alignOffset(header.velocities_offset + vector3_bytes);
+    header.accel_biases_offset =
+        alignOffset(header.gyro_biases_offset + vector3_bytes);
+  }
+
+  // Refs may have an outer stride, write from contiguous copies.
+  const Eigen::Matrix<int64_t, Eigen::Dynamic, 1> stamps_data = stamps;
+  const Positions positions_data = positions;
+  const Matrix4X quaternions_data = quaternions;
+
+  std::ofstream fs;
+  fs.open(filename.c_str(), std::ios::out | std::ios::binary);
+  CHECK(fs.is_open()) << "Failed to open file: " << filename;
+  fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  writeArray(fs, header.stamps_offset, stamps_data.data(), n * sizeof(int64_t));
+  writeArray(fs, header.positions_offset, positions_data.data(), vector3_bytes);
+  writeArray(fs, header.quaternions_offset, quaternions_data.data(),
+             4u * n * sizeof(real_t));
+  if (has_velocity_and_bias)
+  {
+    writeArray(fs, header.velocities_offset, velocities->data(), vector3_bytes);
+    writeArray(fs, header.gyro_biases_offset, gyro_biases->data(), vector3_bytes);
+    writeArray(fs, header.accel_biases_offset, accel_biases->data(), vector3_bytes);
+  }
+  CHECK(fs.good()) << "Failed to write file: " << filename;
+}
+
+void saveBinaryTrajectory(
+    const std::string& filename,
+    const StampedTransformationVector& stamped_poses)
+{
+  const int n = static_cast<int>(stamped_poses.size());
+  Eigen::Matrix<int64_t, Eigen::Dynamic, 1> stamps(n);
+  Positions positions(3, n);
+  Matrix4X quaternions(4, n);
+  for (int i = 0; i < n; ++i)
+  {
+    stamps(i) = stamped_poses[i].first;
+    positions.col(i) = stamped_poses[i].second.getPosition();
+    quaternions.col(i) = stamped_poses[i].second.getEigenQuaternion().coeffs();
+  }
+  saveBinaryTrajectory(filename, stamps, positions, quaternions);
+}
+
+void saveBinaryTrajectory(
+    const std::string& filename,
+    const PoseSeries& series)
+{
+  const Buffer<real_t, 7>& buffer = series.getBuffer();
+  buffer.lock();
+  const auto stamps = buffer.data().stamps();
+  const auto poses = buffer.data().values();
+  const Positions positions = poses.topRows<3>();
+  const Matrix4X quaternions = poses.bottomRows<4>();
+
+  const SWEResultSeries* swe_series =
+      dynamic_cast<const SWEResultSeries*>(&series);
+  if (swe_series)
+  {
+    const Buffer<real_t, 9>& states = swe_series->getVelocityAndBiasBuffer();
+    states.lock();
+    CHECK_EQ(states.data().size(), buffer.data().size());
+    const auto values = states.data().values();
+    const Matrix3X velocities = values.topRows<3>();
+    const Matrix3X gyro_biases = values.middleRows<3>(3);
+    const Matrix3X accel_biases = values.bottomRows<3>();
+    states.unlock();
+    saveBinaryTrajectory(filename, stamps, positions, quaternions,
+                         &velocities, &gyro_biases, &accel_biases);
+  }
+  else
+  {
+    saveBinaryTrajectory(filename, stamps, positions, quaternions);
+  }
+  buffer.unlock();
+}
+
+BinaryTrajectory::BinaryTrajectory(const std::string& filename)
+{
+  CHECK(open(filename)) << "Failed to read binary trajectory: " << filename;
+}
+
+bool BinaryTrajectory::open(const std::string& filename)
+{
+  std::memset(&header_, 0, sizeof(header_));
+  if (!file_.open(filename) || file_.size() < sizeof(header_))
+  {
+    return false;
+  }
+  BinaryTrajectoryHeader header;
+  std::memcpy(&header, file_.data(), sizeof(header));
+  if (std::memcmp(header.magic, c_magic, sizeof(c_magic)) != 0)
+  {
+    LOG(WARNING) << "Not a binary trajectory: " << filename;
+    return false;
+  }
+  if (header.version != BinaryTrajectoryHeader::c_version
+      || header.byte_order_mark != BinaryTrajectoryHeader::c_byte_order_mark
+      || header.scalar_size != sizeof(real_t))
+  {
+    LOG(WARNING) << "Unsupported binary trajectory version " << header.version
+                 << " or incompatible byte order or precision: " << filename;
+    return false;
+  }
+
+  // All arrays have to be aligned and inside the file.
+  const uint64_t n = header.num_poses;
+  const uint64_t vector3_bytes = 3u * n * sizeof(real_t);
+  auto valid = [&](uint64_t offset, uint64_t num_bytes) {
+    return offset % c_alignment == 0u && offset >= sizeof(header)
+        && offset <= file_.size() && num_bytes <= file_.size() - offset;
+  };
+  bool valid_arrays =
+      valid(header.stamps_offset, n * sizeof(int64_t))
+      && valid(header.positions_offset, vector3_bytes)
+      && valid(header.quaternions_offset, 4u * n * sizeof(real_t));
+  if (header.flags & BinaryTrajectoryHeader::c_has_velocity_and_bias)
+  {
+    valid_arrays = valid_arrays
+        && valid(header.velocities_offset, vector3_bytes)
+        && valid(header.gyro_biases_offset, vector3_bytes)
+        && valid(header.accel_biases_offset, vector3_bytes);
+  }
+  if (!valid_arrays)
+  {
+    LOG(WARNING) << "Truncated binary trajectory: " << filename;
+    return false;
+  }
+  header_ = header;
+  return true;
+}
+
+Transformation BinaryTrajectory::transformation(size_t i) const
+{
+  DEBUG_CHECK_LT(i, size());
+  const Vector4 q = quaternions().col(i);
+  return Transformation(Eigen::Quaternion<real_t>(q(3), q(0), q(1), q(2)),
+                        positions().col(i));
+}
+
+StampedTransformationVector BinaryTrajectory::getStampedTransformationVector() const
+{
+  StampedTransformationVector vec;
+  vec.reserve(size());
+  const StampMap stamps_map = stamps();
+  for (size_t i = 0u; i < size(); ++i)
+  {
+    vec.push_back(std::make_pair(stamps_map(i), transformation(i)));
+  }
+  return vec;
+}
+
+void BinaryTrajectory::insertInto(Buffer<real_t, 7>& pose_buffer) const
+{
+  Matrix7X poses(7, size());
+  poses.topRows<3>() = positions();
+  poses.bottomRows<4>() = quaternions();
+  pose_buffer.insert(stamps().data(), poses.data(), size());
+}
+
+} // namespace ze
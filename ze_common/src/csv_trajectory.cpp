@@ -25,54 +25,218 @@
 
 #include <ze/common/csv_trajectory.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <thread>
+
+#include <ze/common/csv_parser.hpp>
+#include <ze/common/mapped_file.hpp>
+
 namespace ze {
 
-int64_t CSVTrajectory::getTimeStamp(const std::string& ts_str) const
+namespace {
+
+//! Rows of one chunk of a csv file, Dim values per stamp.
+struct ParsedRows
 {
-  return std::stoll(ts_str);
-}
+  std::vector<int64_t> stamps;
+  std::vector<real_t> values;
+};
 
-void CSVTrajectory::readHeader(const std::string& in_file_path)
+//! Maps fields of a line to the output slots: Slot 0 is the stamp, slot i
+//! the (i-1)-th value. Resolved once per file instead of per field.
+class CsvColumns
 {
-  in_str_.open(in_file_path);
-  CHECK(in_str_.is_open());
-  if(!header_.empty())
+public:
+  template<size_t N>
+  CsvColumns(const std::map<std::string, int>& order,
+             const std::array<const char*, N>& keys)
+  {
+    for (size_t slot = 0u; slot < N; ++slot)
+    {
+      auto it = order.find(keys[slot]);
+      CHECK(it != order.end()) << "Column " << keys[slot] << " not defined.";
+      CHECK_GE(it->second, 0);
+      const size_t field = static_cast<size_t>(it->second);
+      if (field >= slot_of_field_.size())
+      {
+        slot_of_field_.resize(field + 1u, -1);
+      }
+      slot_of_field_[field] = static_cast<int>(slot);
+    }
+  }
+
+  inline int slot(size_t field) const
   {
-    std::string line;
-    getline(in_str_, line);
-    CHECK_EQ(line.substr(0, header_.size()), header_);
+    return field < slot_of_field_.size() ? slot_of_field_[field] : -1;
   }
+
+private:
+  std::vector<int> slot_of_field_;
+};
+
+inline const char* findChar(const char* begin, const char* end, char c)
+{
+  const void* found = std::memchr(begin, c, static_cast<size_t>(end - begin));
+  return found ? static_cast<const char*>(found) : end;
 }
 
-Vector3 CSVTrajectory::readTranslation(const std::vector<std::string>& items)
+//! Parses the lines in [begin, end) and calls fix_row(values) on each row.
+//! Stamps are parsed by trajectory.getTimeStamp().
+template<int Dim, typename RowFn>
+void parseRows(const char* begin, const char* end,
+               const CSVTrajectory& trajectory,
+               const CsvColumns& columns, char delimiter,
+               const std::string& comment_chars, size_t num_tokens_in_line,
+               const RowFn& fix_row, ParsedRows* rows)
 {
-  return Vector3(
-        std::stod(items[order_.find("tx")->second]),
-        std::stod(items[order_.find("ty")->second]),
-        std::stod(items[order_.find("tz")->second]));
+  const size_t num_lines_estimate =
+      static_cast<size_t>(std::count(begin, end, '\n')) + 1u;
+  rows->stamps.reserve(num_lines_estimate);
+  rows->values.reserve(num_lines_estimate * Dim);
+
+  std::array<real_t, Dim> values;
+  // Reused for all rows, so that it only allocates once.
+  std::string stamp_str;
+  for (const char* line = begin; line < end;)
+  {
+    const char* line_end = findChar(line, end, '\n');
+    const char* next_line = line_end + (line_end != end);
+    if (line_end != line && *(line_end - 1) == '\r')
+    {
+      --line_end;
+    }
+    if (line == line_end || comment_chars.find(*line) != std::string::npos)
+    {
+      line = next_line;
+      continue;
+    }
+
+    int64_t stamp = 0;
+    size_t field = 0u;
+    for (const char* field_begin = line;; ++field)
+    {
+      const char* field_end = findChar(field_begin, line_end, delimiter);
+      const int slot = columns.slot(field);
+      bool valid = true;
+      if (slot == 0)
+      {
+        stamp_str.assign(field_begin, field_end);
+        stamp = trajectory.getTimeStamp(stamp_str);
+      }
+      else if (slot > 0)
+      {
+        double value;
+        valid = parseDouble(field_begin, field_end, &value) != nullptr;
+        values[slot - 1] = static_cast<real_t>(value);
+      }
+      CHECK(valid) << "Invalid number in line: " << std::string(line, line_end);
+      if (field_end == line_end)
+      {
+        break;
+      }
+      field_begin = field_end + 1;
+    }
+    CHECK_GE(field + 1u, num_tokens_in_line)
+        << "Too few columns in line: " << std::string(line, line_end);
+
+    fix_row(values.data());
+    rows->stamps.push_back(stamp);
+    rows->values.insert(rows->values.end(), values.begin(), values.end());
+    line = next_line;
+  }
 }
 
-Vector4 CSVTrajectory::readOrientation(const std::vector<std::string>& items)
+//! Normalizes q = [qx, qy, qz, qw] if its norm is slightly off.
+inline void normalizeQuaternion(real_t* q_data)
 {
-  Vector4 q(
-        std::stod(items[order_.find("qx")->second]),
-        std::stod(items[order_.find("qy")->second]),
-        std::stod(items[order_.find("qz")->second]),
-        std::stod(items[order_.find("qw")->second]));
+  Eigen::Map<Vector4> q(q_data);
   if(std::abs(q.squaredNorm() - 1.0) > 1e-4)
   {
     LOG(WARNING) << "Quaternion norm is = " << q.norm();
     CHECK_NEAR(q.norm(), 1.0, 0.01);
     q.normalize(); // This is only good up to some point.
   }
-  return q;
 }
 
-Vector7 CSVTrajectory::readPose(const std::vector<std::string>& items)
+//! Loads a csv file with a stamp and Dim values per row into buffer. The
+//! file is memory mapped and, if num_threads > 1, split at line boundaries
+//! into chunks that are parsed in parallel.
+template<int Dim, typename RowFn>
+void loadRows(const std::string& in_file_path, const CSVTrajectory& trajectory,
+              const std::string& header,
+              const CsvColumns& columns, char delimiter,
+              const std::string& comment_chars, size_t num_tokens_in_line,
+              size_t num_threads, const RowFn& fix_row,
+              Buffer<real_t, Dim>* buffer)
+{
+  MappedFile file(in_file_path);
+  const char* begin = file.begin();
+  const char* end = file.end();
+  if (!header.empty())
+  {
+    const char* header_end = findChar(begin, end, '\n');
+    CHECK_EQ(std::string(begin, std::min(header_end, begin + header.size())),
+             header);
+    begin = header_end + (header_end != end);
+  }
+
+  // Don't bother spawning threads for chunks smaller than 1MB.
+  constexpr size_t c_min_chunk_size = 1u << 20;
+  const size_t size = static_cast<size_t>(end - begin);
+  const size_t num_chunks =
+      std::max<size_t>(1u, std::min(num_threads, size / c_min_chunk_size));
+
+  std::vector<const char*> chunk_begins(num_chunks + 1u, end);
+  chunk_begins[0] = begin;
+  for (size_t i = 1u; i < num_chunks; ++i)
+  {
+    const char* split = std::max(chunk_begins[i - 1],
+                                 begin + i * (size / num_chunks));
+    const char* line_end = findChar(split, end, '\n');
+    chunk_begins[i] = line_end + (line_end != end);
+  }
+
+  std::vector<ParsedRows> chunks(num_chunks);
+  std::vector<std::thread> threads;
+  for (size_t i = 1u; i < num_chunks; ++i)
+  {
+    threads.emplace_back([&, i]() {
+      parseRows<Dim>(chunk_begins[i], chunk_begins[i + 1u], trajectory, columns,
+                     delimiter, comment_chars, num_tokens_in_line, fix_row,
+                     &chunks[i]);
+    });
+  }
+  parseRows<Dim>(chunk_begins[0], chunk_begins[1], trajectory, columns,
+                 delimiter, comment_chars, num_tokens_in_line, fix_row,
+                 &chunks[0]);
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  size_t num_rows = buffer->size();
+  for (const ParsedRows& chunk : chunks)
+  {
+    num_rows += chunk.stamps.size();
+  }
+  buffer->reserve(num_rows);
+  for (const ParsedRows& chunk : chunks)
+  {
+    buffer->insert(chunk.stamps.data(), chunk.values.data(),
+                   chunk.stamps.size());
+  }
+}
+
+} // anonymous namespace
+
+int64_t CSVTrajectory::getTimeStamp(const std::string& ts_str) const
 {
-  Vector7 pose;
-  pose << readTranslation(items), readOrientation(items);
-  return pose;
+  int64_t stamp;
+  CHECK(parseInt64(ts_str.data(), ts_str.data() + ts_str.size(), &stamp) != nullptr)
+      << "Invalid timestamp: " << ts_str;
+  return stamp;
 }
 
 PositionSeries::PositionSeries()
@@ -88,19 +252,11 @@ PositionSeries::PositionSeries()
 
 void PositionSeries::load(const std::string& in_file_path)
 {
-  readHeader(in_file_path);
-  std::string line;
-  while(getline(in_str_, line))
-  {
-    if('%' != line.at(0) && '#' != line.at(0))
-    {
-      std::vector<std::string> items = ze::splitString(line, delimiter_);
-      CHECK_GE(items.size(), num_tokens_in_line_);
-      int64_t stamp = getTimeStamp(items[order_.find("ts")->second]);
-      Vector3 position = readTranslation(items);
-      position_buf_.insert(stamp, position);
-    }
-  }
+  const CsvColumns columns(
+        order_, std::array<const char*, 4>{{"ts", "tx", "ty", "tz"}});
+  loadRows<3>(in_file_path, *this, header_, columns, delimiter_,
+              comment_chars_, num_tokens_in_line_, num_load_threads_,
+              [](real_t*) {}, &position_buf_);
 }
 
 const Buffer<real_t, 3>& PositionSeries::getBuffer() const
@@ -126,23 +282,18 @@ PoseSeries::PoseSeries()
 
   header_ = "# timestamp, x, y, z, qx, qy, qz, qw";
   num_tokens_in_line_ = 8u;
+  comment_chars_ = "%#t";
 }
 
 void PoseSeries::load(const std::string& in_file_path)
 {
-  readHeader(in_file_path);
-  std::string line;
-  while(getline(in_str_, line))
-  {
-    if('%' != line.at(0) && '#' != line.at(0) && 't' != line.at(0))
-    {
-      std::vector<std::string> items = ze::splitString(line, delimiter_);
-      CHECK_GE(items.size(), num_tokens_in_line_);
-      int64_t stamp = getTimeStamp(items[order_.find("ts")->second]);
-      Vector7 pose = readPose(items);
-      pose_buf_.insert(stamp, pose);
-    }
-  }
+  const CsvColumns columns(
+        order_, std::array<const char*, 8>{{
+                  "ts", "tx", "ty", "tz", "qx", "qy", "qz", "qw"}});
+  loadRows<7>(in_file_path, *this, header_, columns, delimiter_,
+              comment_chars_, num_tokens_in_line_, num_load_threads_,
+              [](real_t* pose) { normalizeQuaternion(pose + 3); },
+              &pose_buf_);
 }
 
 const Buffer<real_t, 7>& PoseSeries::getBuffer() const
@@ -181,7 +332,51 @@ Transformation PoseSeries::getTransformationFromVec7(const Vector7& data)
 SWEResultSeries::SWEResultSeries()
   : PoseSeries()
 {
+  order_["vx"] = 8;
+  order_["vy"] = 9;
+  order_["vz"] = 10;
+  order_["bgx"] = 11;
+  order_["bgy"] = 12;
+  order_["bgz"] = 13;
+  order_["bax"] = 14;
+  order_["bay"] = 15;
+  order_["baz"] = 16;
+
   header_ = "timestamp, x, y, z, qx, qy, qz, qw, vx, vy, vz, bgx, bgy, bgz, bax, bay, baz";
+  num_tokens_in_line_ = 17u;
+}
+
+void SWEResultSeries::load(const std::string& in_file_path)
+{
+  const CsvColumns columns(
+        order_, std::array<const char*, 17>{{
+                  "ts", "tx", "ty", "tz", "qx", "qy", "qz", "qw",
+                  "vx", "vy", "vz", "bgx", "bgy", "bgz", "bax", "bay", "baz"}});
+  Buffer<real_t, 16> rows;
+  loadRows<16>(in_file_path, *this, header_, columns, delimiter_,
+               comment_chars_, num_tokens_in_line_, num_load_threads_,
+               [](real_t* row) { normalizeQuaternion(row + 3); }, &rows);
+
+  // Split the rows into the pose and the velocity and bias buffers.
+  rows.lock();
+  const auto stamps = rows.data().stamps();
+  const auto values = rows.data().values();
+  const Matrix7X poses = values.topRows<7>();
+  const Matrix9X velocities_biases = values.bottomRows<9>();
+  pose_buf_.insert(stamps.data(), poses.data(), stamps.size());
+  velocity_bias_buf_.insert(stamps.data(), velocities_biases.data(),
+                            stamps.size());
+  rows.unlock();
+}
+
+const Buffer<real_t, 9>& SWEResultSeries::getVelocityAndBiasBuffer() const
+{
+  return velocity_bias_buf_;
+}
+
+Buffer<real_t, 9>& SWEResultSeries::getVelocityAndBiasBuffer()
+{
+  return velocity_bias_buf_;
 }
 
 SWEGlobalSeries::SWEGlobalSeries()
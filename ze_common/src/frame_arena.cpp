@@ -0,0 +1,153 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/frame_arena.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace ze {
+
+constexpr size_t MonotonicArena::c_default_alignment;
+
+namespace {
+
+inline size_t alignUp(size_t offset, size_t alignment)
+{
+  return (offset + alignment - 1u) & ~(alignment - 1u);
+}
+
+inline char* allocateChunk(size_t size)
+{
+  void* data = nullptr;
+  if (posix_memalign(&data, MonotonicArena::c_default_alignment, size) != 0)
+  {
+    throw std::bad_alloc();
+  }
+  return static_cast<char*>(data);
+}
+
+} // unnamed namespace
+
+// -----------------------------------------------------------------------------
+MonotonicArena::MonotonicArena(size_t initial_capacity)
+{
+  CHECK_GT(initial_capacity, 0u);
+  chunks_.reserve(8u);
+  chunks_.push_back(Chunk { allocateChunk(initial_capacity), initial_capacity });
+  ++num_heap_allocations_;
+}
+
+// -----------------------------------------------------------------------------
+MonotonicArena::~MonotonicArena()
+{
+  freeChunks();
+}
+
+// -----------------------------------------------------------------------------
+void* MonotonicArena::allocate(size_t num_bytes, size_t alignment)
+{
+  DEBUG_CHECK_EQ(alignment & (alignment - 1u), 0u) << "Alignment must be a power of two.";
+  DEBUG_CHECK_LE(alignment, c_default_alignment);
+  const size_t begin = alignUp(offset_, alignment);
+  if (begin + num_bytes <= chunks_[current_].size)
+  {
+    offset_ = begin + num_bytes;
+    return chunks_[current_].data + begin;
+  }
+  return allocateSlow(num_bytes, alignment);
+}
+
+// -----------------------------------------------------------------------------
+void* MonotonicArena::allocateSlow(size_t num_bytes, size_t alignment)
+{
+  // Chunks are aligned to c_default_alignment, so a fresh chunk never needs
+  // padding. Reuse the next chunk if it is large enough, otherwise insert a
+  // new one that is at least twice as large as the current one.
+  ++current_;
+  if (current_ == chunks_.size() || chunks_[current_].size < num_bytes)
+  {
+    const size_t size = std::max(2u * chunks_[current_ - 1u].size, num_bytes);
+    chunks_.insert(chunks_.begin() + current_, Chunk { allocateChunk(size), size });
+    ++num_heap_allocations_;
+  }
+  offset_ = num_bytes;
+  return chunks_[current_].data;
+}
+
+// -----------------------------------------------------------------------------
+void MonotonicArena::reset()
+{
+  if (chunks_.size() > 1u)
+  {
+    const size_t total = capacity();
+    freeChunks();
+    chunks_.push_back(Chunk { allocateChunk(total), total });
+    ++num_heap_allocations_;
+  }
+  current_ = 0u;
+  offset_ = 0u;
+}
+
+// -----------------------------------------------------------------------------
+size_t MonotonicArena::bytesUsed() const
+{
+  size_t bytes = offset_;
+  for (size_t i = 0u; i < current_; ++i)
+  {
+    bytes += chunks_[i].size;
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+size_t MonotonicArena::capacity() const
+{
+  size_t bytes = 0u;
+  for (const Chunk& chunk : chunks_)
+  {
+    bytes += chunk.size;
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+void MonotonicArena::freeChunks()
+{
+  for (const Chunk& chunk : chunks_)
+  {
+    std::free(chunk.data);
+  }
+  chunks_.clear();
+}
+
+// -----------------------------------------------------------------------------
+MonotonicArena& threadFrameArena()
+{
+  static thread_local MonotonicArena arena;
+  return arena;
+}
+
+} // namespace ze
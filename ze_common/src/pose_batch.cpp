@@ -0,0 +1,354 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/pose_batch.hpp>
+
+#include <cmath>
+
+namespace ze {
+
+namespace {
+
+//! One pose, loaded from the columns of a PoseBatch. The kernels below loop
+//! over the batch with plain per-pose arithmetic on these structs. With the
+//! columns being contiguous, the compiler turns the loops into SIMD code that
+//! processes several poses per instruction.
+struct Pose
+{
+  real_t qx, qy, qz, qw;
+  real_t px, py, pz;
+};
+
+//! Element i of each column of an n x 7 column-major storage.
+inline Pose loadPose(const real_t* data, int n, int i)
+{
+  return Pose { data[i], data[i + n], data[i + 2 * n], data[i + 3 * n],
+                data[i + 4 * n], data[i + 5 * n], data[i + 6 * n] };
+}
+
+inline void storePose(const Pose& T, int n, int i, real_t* data)
+{
+  data[i] = T.qx;
+  data[i + n] = T.qy;
+  data[i + 2 * n] = T.qz;
+  data[i + 3 * n] = T.qw;
+  data[i + 4 * n] = T.px;
+  data[i + 5 * n] = T.py;
+  data[i + 6 * n] = T.pz;
+}
+
+//! v' = q * v * q^-1 for a unit quaternion, as v + w t + u x t with
+//! t = 2 u x v.
+inline void rotate(real_t qx, real_t qy, real_t qz, real_t qw,
+                   real_t vx, real_t vy, real_t vz,
+                   real_t* rx, real_t* ry, real_t* rz)
+{
+  const real_t tx = real_t{2} * (qy * vz - qz * vy);
+  const real_t ty = real_t{2} * (qz * vx - qx * vz);
+  const real_t tz = real_t{2} * (qx * vy - qy * vx);
+  *rx = vx + qw * tx + (qy * tz - qz * ty);
+  *ry = vy + qw * ty + (qz * tx - qx * tz);
+  *rz = vz + qw * tz + (qx * ty - qy * tx);
+}
+
+inline Pose compose(const Pose& a, const Pose& b)
+{
+  Pose c;
+  c.qx = a.qw * b.qx + a.qx * b.qw + a.qy * b.qz - a.qz * b.qy;
+  c.qy = a.qw * b.qy - a.qx * b.qz + a.qy * b.qw + a.qz * b.qx;
+  c.qz = a.qw * b.qz + a.qx * b.qy - a.qy * b.qx + a.qz * b.qw;
+  c.qw = a.qw * b.qw - a.qx * b.qx - a.qy * b.qy - a.qz * b.qz;
+  rotate(a.qx, a.qy, a.qz, a.qw, b.px, b.py, b.pz, &c.px, &c.py, &c.pz);
+  c.px += a.px;
+  c.py += a.py;
+  c.pz += a.pz;
+  return c;
+}
+
+inline Pose inverse(const Pose& a)
+{
+  Pose b;
+  b.qx = -a.qx;
+  b.qy = -a.qy;
+  b.qz = -a.qz;
+  b.qw = a.qw;
+  rotate(b.qx, b.qy, b.qz, b.qw, -a.px, -a.py, -a.pz, &b.px, &b.py, &b.pz);
+  return b;
+}
+
+inline Pose toPose(const Transformation& T)
+{
+  const Eigen::Quaternion<real_t>& q = T.getEigenQuaternion();
+  const Vector3& p = T.getPosition();
+  return Pose { q.x(), q.y(), q.z(), q.w(), p.x(), p.y(), p.z() };
+}
+
+} // unnamed namespace
+
+// -----------------------------------------------------------------------------
+PoseBatch::PoseBatch(int n)
+  : data_(n, 7)
+{
+  setIdentity();
+}
+
+PoseBatch::PoseBatch(const TransformationVector& T)
+  : data_(T.size(), 7)
+{
+  for (size_t i = 0; i < T.size(); ++i)
+  {
+    set(i, T[i]);
+  }
+}
+
+PoseBatch::PoseBatch(const StampedTransformationVector& stamped_T)
+  : data_(stamped_T.size(), 7)
+{
+  for (size_t i = 0; i < stamped_T.size(); ++i)
+  {
+    set(i, stamped_T[i].second);
+  }
+}
+
+void PoseBatch::setIdentity()
+{
+  data_.setZero();
+  data_.col(3).setOnes();
+}
+
+Transformation PoseBatch::at(int i) const
+{
+  DEBUG_CHECK_GE(i, 0);
+  DEBUG_CHECK_LT(i, size());
+  return Transformation(
+        Eigen::Quaternion<real_t>(data_(i, 3), data_(i, 0), data_(i, 1), data_(i, 2)),
+        Vector3(data_(i, 4), data_(i, 5), data_(i, 6)));
+}
+
+void PoseBatch::set(int i, const Transformation& T)
+{
+  DEBUG_CHECK_GE(i, 0);
+  DEBUG_CHECK_LT(i, size());
+  data_.block<1, 4>(i, 0) = T.getEigenQuaternion().coeffs().transpose();
+  data_.block<1, 3>(i, 4) = T.getPosition().transpose();
+}
+
+TransformationVector PoseBatch::toTransformationVector() const
+{
+  TransformationVector T;
+  T.reserve(size());
+  for (int i = 0; i < size(); ++i)
+  {
+    T.push_back(at(i));
+  }
+  return T;
+}
+
+StampedTransformationVector PoseBatch::toStampedTransformationVector(
+    const std::vector<int64_t>& stamps) const
+{
+  CHECK_EQ(static_cast<int>(stamps.size()), size());
+  StampedTransformationVector stamped_T;
+  stamped_T.reserve(size());
+  for (int i = 0; i < size(); ++i)
+  {
+    stamped_T.push_back(StampedTransformation(stamps[i], at(i)));
+  }
+  return stamped_T;
+}
+
+// -----------------------------------------------------------------------------
+void composePoses(const PoseBatch& T_A_B, const PoseBatch& T_B_C,
+                  PoseBatch* T_A_C)
+{
+  CHECK_NOTNULL(T_A_C);
+  CHECK_EQ(T_A_B.size(), T_B_C.size());
+  const int n = T_A_B.size();
+  T_A_C->resize(n);
+  const real_t* a = T_A_B.data().data();
+  const real_t* b = T_B_C.data().data();
+  real_t* c = T_A_C->data().data();
+  // Pose i only depends on the inputs at i, so the loop is safe to vectorize
+  // also if the output aliases an input.
+#pragma GCC ivdep
+  for (int i = 0; i < n; ++i)
+  {
+    storePose(compose(loadPose(a, n, i), loadPose(b, n, i)), n, i, c);
+  }
+}
+
+void composePoses(const Transformation& T_A_B, const PoseBatch& T_B_C,
+                  PoseBatch* T_A_C)
+{
+  CHECK_NOTNULL(T_A_C);
+  const int n = T_B_C.size();
+  T_A_C->resize(n);
+  const Pose a = toPose(T_A_B);
+  const real_t* b = T_B_C.data().data();
+  real_t* c = T_A_C->data().data();
+#pragma GCC ivdep
+  for (int i = 0; i < n; ++i)
+  {
+    storePose(compose(a, loadPose(b, n, i)), n, i, c);
+  }
+}
+
+void invertPoses(const PoseBatch& T_A_B, PoseBatch* T_B_A)
+{
+  CHECK_NOTNULL(T_B_A);
+  const int n = T_A_B.size();
+  T_B_A->resize(n);
+  const real_t* a = T_A_B.data().data();
+  real_t* b = T_B_A->data().data();
+#pragma GCC ivdep
+  for (int i = 0; i < n; ++i)
+  {
+    storePose(inverse(loadPose(a, n, i)), n, i, b);
+  }
+}
+
+void relativePoses(const PoseBatch& T_A_B, const PoseBatch& T_A_C,
+                   PoseBatch* T_B_C)
+{
+  CHECK_NOTNULL(T_B_C);
+  CHECK_EQ(T_A_B.size(), T_A_C.size());
+  const int n = T_A_B.size();
+  T_B_C->resize(n);
+  const real_t* a = T_A_B.data().data();
+  const real_t* b = T_A_C.data().data();
+  real_t* c = T_B_C->data().data();
+#pragma GCC ivdep
+  for (int i = 0; i < n; ++i)
+  {
+    const Pose A_B = loadPose(a, n, i);
+    Pose A_C = loadPose(b, n, i);
+    // T_B_C = [q_B_A * q_A_C, R_B_A * (t_A_C - t_A_B)]
+    A_C.px -= A_B.px;
+    A_C.py -= A_B.py;
+    A_C.pz -= A_B.pz;
+    Pose B_A = A_B;
+    B_A.qx = -A_B.qx;
+    B_A.qy = -A_B.qy;
+    B_A.qz = -A_B.qz;
+    B_A.px = B_A.py = B_A.pz = real_t{0};
+    storePose(compose(B_A, A_C), n, i, c);
+  }
+}
+
+void logPoses(const PoseBatch& T, Matrix6X* tangents)
+{
+  CHECK_NOTNULL(tangents);
+  const int n = T.size();
+  tangents->resize(6, n);
+  const real_t* a = T.data().data();
+  real_t* v = tangents->data();
+  for (int i = 0; i < n; ++i)
+  {
+    const Pose A = loadPose(a, n, i);
+    // q and -q are the same rotation, use the one with w >= 0 such that the
+    // rotation angle is in [0, pi].
+    const real_t sign = A.qw < real_t{0} ? real_t{-1} : real_t{1};
+    const real_t w = std::abs(A.qw);
+    const real_t vec_norm_sq = A.qx * A.qx + A.qy * A.qy + A.qz * A.qz;
+    const real_t vec_norm = std::sqrt(vec_norm_sq);
+    // Close to identity, angle / vec_norm = 2 / w * (1 - vec_norm^2 / (3 w^2)).
+    const real_t scale = sign * (vec_norm > real_t{1e-7}
+        ? real_t{2} * std::atan2(vec_norm, w) / vec_norm
+        : real_t{2} / w * (real_t{1} - vec_norm_sq / (real_t{3} * w * w)));
+    v[6 * i] = A.px;
+    v[6 * i + 1] = A.py;
+    v[6 * i + 2] = A.pz;
+    v[6 * i + 3] = A.qx * scale;
+    v[6 * i + 4] = A.qy * scale;
+    v[6 * i + 5] = A.qz * scale;
+  }
+}
+
+void expPoses(const Eigen::Ref<const Matrix6X>& tangents, PoseBatch* T)
+{
+  CHECK_NOTNULL(T);
+  const int n = tangents.cols();
+  T->resize(n);
+  real_t* a = T->data().data();
+  for (int i = 0; i < n; ++i)
+  {
+    const auto v = tangents.col(i);
+    const real_t angle_sq = v(3) * v(3) + v(4) * v(4) + v(5) * v(5);
+    const real_t angle = std::sqrt(angle_sq);
+    const real_t half_angle = real_t{0.5} * angle;
+    // Close to zero, sin(angle / 2) / angle = 1 / 2 - angle^2 / 48.
+    const real_t scale = angle > real_t{1e-7}
+        ? std::sin(half_angle) / angle
+        : real_t{0.5} - angle_sq / real_t{48};
+    storePose(Pose { v(3) * scale, v(4) * scale, v(5) * scale, std::cos(half_angle),
+                     v(0), v(1), v(2) }, n, i, a);
+  }
+}
+
+void transformPoints(const PoseBatch& T_A_B,
+                     const Eigen::Ref<const Positions>& p_B,
+                     Positions* p_A)
+{
+  CHECK_NOTNULL(p_A);
+  CHECK_EQ(T_A_B.size(), p_B.cols());
+  const int n = T_A_B.size();
+  p_A->resize(3, n);
+  const real_t* a = T_A_B.data().data();
+  const real_t* p = p_B.data();
+  const int stride = p_B.outerStride();
+  real_t* out = p_A->data();
+#pragma GCC ivdep
+  for (int i = 0; i < n; ++i)
+  {
+    const Pose A = loadPose(a, n, i);
+    real_t x, y, z;
+    rotate(A.qx, A.qy, A.qz, A.qw,
+           p[stride * i], p[stride * i + 1], p[stride * i + 2], &x, &y, &z);
+    out[3 * i] = x + A.px;
+    out[3 * i + 1] = y + A.py;
+    out[3 * i + 2] = z + A.pz;
+  }
+}
+
+void transformPointsAllPairs(const PoseBatch& T_A_B,
+                             const Eigen::Ref<const Positions>& p_B,
+                             Positions* p_A)
+{
+  CHECK_NOTNULL(p_A);
+  const int num_points = p_B.cols();
+  p_A->resize(3, T_A_B.size() * num_points);
+  for (int i = 0; i < T_A_B.size(); ++i)
+  {
+    const Matrix3 R_A_B =
+        Eigen::Quaternion<real_t>(T_A_B.qw()(i), T_A_B.qx()(i),
+                                  T_A_B.qy()(i), T_A_B.qz()(i)).toRotationMatrix();
+    const Vector3 t_A_B(T_A_B.px()(i), T_A_B.py()(i), T_A_B.pz()(i));
+    auto p_A_i = p_A->middleCols(i * num_points, num_points);
+    p_A_i.noalias() = R_A_B * p_B;
+    p_A_i.colwise() += t_A_B;
+  }
+}
+
+} // namespace ze
@@ -0,0 +1,323 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/profiler.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+
+#include <ze/common/file_utils.hpp>
+#include <ze/common/logging.hpp>
+
+namespace ze {
+
+namespace {
+
+struct ProfilerRegistry
+{
+  std::mutex mutex;
+  //! Logs are kept after their thread exits, so that they can be exported,
+  //! and handed to the next thread that registers.
+  std::vector<std::unique_ptr<ProfilerThreadLog>> logs;
+  std::vector<ProfilerThreadLog*> free_logs;
+  std::vector<std::string> thread_names;
+  std::set<std::string> names;
+  size_t capacity = 1u << 16;
+};
+
+ProfilerRegistry& registry()
+{
+  static ProfilerRegistry registry;
+  return registry;
+}
+
+size_t roundUpToPowerOfTwo(size_t n)
+{
+  size_t power = 1u;
+  while (power < n)
+  {
+    power <<= 1;
+  }
+  return power;
+}
+
+void writeJsonString(std::ostream& out, const char* str)
+{
+  out << '"';
+  for (const char* c = str; *c != '\0'; ++c)
+  {
+    switch (*c)
+    {
+      case '"': out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\n': out << "\\n"; break;
+      case '\t': out << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20)
+        {
+          char buffer[8];
+          std::snprintf(buffer, sizeof(buffer), "\\u%04x", *c);
+          out << buffer;
+        }
+        else
+        {
+          out << *c;
+        }
+    }
+  }
+  out << '"';
+}
+
+//! Returns the log of the calling thread to the registry when it exits.
+struct ProfilerThreadExit
+{
+  ProfilerThreadLog* log = nullptr;
+
+  ~ProfilerThreadExit()
+  {
+    if (log)
+    {
+      profilerThreadState().log = nullptr;
+      ProfilerRegistry& reg = registry();
+      std::lock_guard<std::mutex> lock(reg.mutex);
+      reg.free_logs.push_back(log);
+    }
+  }
+};
+
+//! Chrome trace stamps are in microseconds.
+void writeMicroseconds(std::ostream& out, int64_t ns)
+{
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%lld.%03lld",
+                static_cast<long long>(ns / 1000),
+                static_cast<long long>(ns % 1000));
+  out << buffer;
+}
+
+} // anonymous namespace
+
+// -----------------------------------------------------------------------------
+ProfilerThreadLog::ProfilerThreadLog(size_t capacity, uint32_t thread_index)
+  : slots_(capacity)
+  , mask_(capacity - 1u)
+  , thread_index_(thread_index)
+{
+  CHECK_GT(capacity, 0u);
+  CHECK_EQ(capacity & mask_, 0u) << "Capacity must be a power of two.";
+}
+
+void ProfilerThreadLog::snapshot(std::vector<ProfilerEvent>* events) const
+{
+  CHECK_NOTNULL(events);
+  const uint64_t capacity = slots_.size();
+  const uint64_t head = head_.load(std::memory_order_acquire);
+  const uint64_t first = std::max(cleared_.load(std::memory_order_acquire),
+                            head > capacity ? head - capacity : uint64_t(0u));
+  const size_t offset = events->size();
+  for (uint64_t i = first; i < head; ++i)
+  {
+    const Slot& slot = slots_[i & mask_];
+    ProfilerEvent event;
+    event.name = slot.name.load(std::memory_order_relaxed);
+    event.begin_ns = slot.begin_ns.load(std::memory_order_relaxed);
+    event.end_ns = slot.end_ns.load(std::memory_order_relaxed);
+    event.depth = slot.depth.load(std::memory_order_relaxed);
+    event.thread = thread_index_;
+    events->push_back(event);
+  }
+
+  // Events before reserved - capacity may have been overwritten while we
+  // were copying them.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const uint64_t reserved = reserved_.load(std::memory_order_relaxed);
+  if (reserved > capacity + first)
+  {
+    const uint64_t num_invalid = std::min(reserved - capacity, head) - first;
+    events->erase(events->begin() + offset,
+                  events->begin() + offset + num_invalid);
+  }
+}
+
+void ProfilerThreadLog::clear()
+{
+  cleared_.store(head_.load(std::memory_order_acquire),
+                 std::memory_order_release);
+}
+
+uint64_t ProfilerThreadLog::numDropped() const
+{
+  const uint64_t head = head_.load(std::memory_order_acquire);
+  const uint64_t cleared = cleared_.load(std::memory_order_acquire);
+  return head - cleared > slots_.size() ? head - cleared - slots_.size() : 0u;
+}
+
+// -----------------------------------------------------------------------------
+std::atomic<bool> Profiler::enabled_ { false };
+
+void Profiler::setEnabled(bool enabled)
+{
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::setEventCapacity(size_t capacity)
+{
+  CHECK_GT(capacity, 0u);
+  ProfilerRegistry& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.capacity = roundUpToPowerOfTwo(capacity);
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+  ProfilerThreadState& state = profilerThreadState();
+  if (!state.log)
+  {
+    state.log = &registerThread();
+  }
+  ProfilerRegistry& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.thread_names.at(state.log->threadIndex()) = name;
+}
+
+const char* Profiler::internName(const std::string& name)
+{
+  ProfilerRegistry& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return reg.names.insert(name).first->c_str();
+}
+
+ProfilerThreadLog& Profiler::registerThread()
+{
+  static thread_local ProfilerThreadExit thread_exit;
+  ProfilerRegistry& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  auto it = std::find_if(reg.free_logs.begin(), reg.free_logs.end(),
+                         [&reg](const ProfilerThreadLog* log) {
+    return log->capacity() == reg.capacity;
+  });
+  if (it != reg.free_logs.end())
+  {
+    thread_exit.log = *it;
+    reg.free_logs.erase(it);
+    const uint32_t index = thread_exit.log->threadIndex();
+    reg.thread_names[index] = "thread " + std::to_string(index);
+    return *thread_exit.log;
+  }
+  const uint32_t index = static_cast<uint32_t>(reg.logs.size());
+  reg.logs.emplace_back(new ProfilerThreadLog(reg.capacity, index));
+  reg.thread_names.push_back("thread " + std::to_string(index));
+  thread_exit.log = reg.logs.back().get();
+  return *thread_exit.log;
+}
+
+size_t Profiler::numThreadLogs()
+{
+  ProfilerRegistry& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return reg.logs.size();
+}
+
+std::vector<ProfilerEvent> Profiler::events()
+{
+  std::vector<ProfilerEvent> events;
+  {
+    ProfilerRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const std::unique_ptr<ProfilerThreadLog>& log : reg.logs)
+    {
+      log->snapshot(&events);
+    }
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const ProfilerEvent& lhs, const ProfilerEvent& rhs) {
+    return lhs.begin_ns < rhs.begin_ns;
+  });
+  return events;
+}
+
+void Profiler::clear()
+{
+  ProfilerRegistry& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  for (const std::unique_ptr<ProfilerThreadLog>& log : reg.logs)
+  {
+    log->clear();
+  }
+}
+
+void Profiler::writeChromeTrace(std::ostream& out)
+{
+  const std::vector<ProfilerEvent> trace_events = events();
+  std::vector<std::string> thread_names;
+  {
+    ProfilerRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    thread_names = reg.thread_names;
+    for (const std::unique_ptr<ProfilerThreadLog>& log : reg.logs)
+    {
+      LOG_IF(WARNING, log->numDropped() > 0u)
+          << "Profiler dropped " << log->numDropped() << " events of "
+          << thread_names[log->threadIndex()] << ", increase the capacity.";
+    }
+  }
+
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  for (size_t i = 0u; i < thread_names.size(); ++i)
+  {
+    out << (first ? "\n" : ",\n")
+        << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i
+        << ",\"args\":{\"name\":";
+    writeJsonString(out, thread_names[i].c_str());
+    out << "}}";
+    first = false;
+  }
+  for (const ProfilerEvent& event : trace_events)
+  {
+    out << (first ? "\n" : ",\n") << "{\"name\":";
+    writeJsonString(out, event.name);
+    out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread << ",\"ts\":";
+    writeMicroseconds(out, event.begin_ns);
+    out << ",\"dur\":";
+    writeMicroseconds(out, event.end_ns - event.begin_ns);
+    out << ",\"args\":{\"depth\":" << event.depth << "}}";
+    first = false;
+  }
+  out << "\n]}\n";
+}
+
+void Profiler::saveChromeTrace(const std::string& filename)
+{
+  std::ofstream fs;
+  openOutputFileStream(filename, &fs);
+  writeChromeTrace(fs);
+}
+
+} // namespace ze
@@ -25,7 +25,9 @@
 
 #include <ze/common/test_utils.hpp>
 
+#include <cstdio>
 #include <cstdlib>
+#include <unistd.h>
 #include <ze/common/logging.hpp>
 #include <ze/common/types.hpp>
 #include <ze/common/path_utils.hpp>
@@ -48,6 +50,25 @@ std::string getTestDataDir(const std::string& dataset_name)
   return path;
 }
 
+std::string createTemporaryFile(const std::string& prefix)
+{
+  const char* tmp_dir = std::getenv("TMPDIR");
+  std::string path = std::string(tmp_dir ? tmp_dir : "/tmp") + "/" + prefix + "_XXXXXX";
+  const int fd = mkstemp(&path[0]);
+  CHECK_NE(fd, -1) << "Could not create temporary file " << path;
+  close(fd);
+  return path;
+}
+
+TemporaryFile::TemporaryFile(const std::string& prefix)
+  : path_(createTemporaryFile(prefix))
+{}
+
+TemporaryFile::~TemporaryFile()
+{
+  std::remove(path_.c_str());
+}
+
 std::map<int64_t, Transformation> loadIndexedPosesFromCsv(const std::string& filename)
 {
   std::map<int64_t, Transformation> poses;
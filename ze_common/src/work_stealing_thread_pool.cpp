@@ -0,0 +1,247 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/work_stealing_thread_pool.hpp>
+
+namespace ze {
+
+namespace {
+
+//! Identifies the pool and deque of the calling worker thread.
+thread_local const WorkStealingThreadPool* t_worker_pool = nullptr;
+thread_local int t_worker_index = -1;
+
+//! Number of idle rounds a worker spins before parking.
+constexpr int c_spin_rounds = 64;
+
+} // anonymous namespace
+
+// -----------------------------------------------------------------------------
+void TaskGroup::wait()
+{
+  join();
+  std::exception_ptr exception;
+  {
+    std::lock_guard<std::mutex> lock(exception_mutex_);
+    std::swap(exception, exception_);
+  }
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+// -----------------------------------------------------------------------------
+void TaskGroup::join()
+{
+  while (pending_.load(std::memory_order_acquire) > 0u)
+  {
+    if (!pool_.runPendingTask())
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+void TaskGroup::setException(std::exception_ptr exception)
+{
+  std::lock_guard<std::mutex> lock(exception_mutex_);
+  if (!exception_)
+  {
+    exception_ = exception;
+  }
+}
+
+// -----------------------------------------------------------------------------
+WorkStealingThreadPool::WorkStealingThreadPool(size_t n_threads)
+{
+  if (n_threads == 0u)
+  {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  queues_.reserve(n_threads);
+  for (size_t i = 0u; i < n_threads; ++i)
+  {
+    queues_.emplace_back(new WorkerQueue());
+  }
+  workers_.reserve(n_threads);
+  for (size_t i = 0u; i < n_threads; ++i)
+  {
+    workers_.emplace_back([this, i] { workerLoop(i); });
+  }
+}
+
+// -----------------------------------------------------------------------------
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_.store(true);
+  }
+  sleep_condition_.notify_all();
+  for (std::thread& worker : workers_)
+  {
+    worker.join();
+  }
+}
+
+// -----------------------------------------------------------------------------
+int WorkStealingThreadPool::currentWorkerIndex() const
+{
+  return (t_worker_pool == this) ? t_worker_index : -1;
+}
+
+// -----------------------------------------------------------------------------
+void WorkStealingThreadPool::push(WorkStealingTask&& task)
+{
+  const int index = currentWorkerIndex();
+  WorkerQueue& queue = (index >= 0) ? *queues_[index] : injection_queue_;
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+
+  // Sequentially consistent increment and load pair up with the ones in
+  // workerLoop(), so either the sleeper sees the task or we see the sleeper.
+  num_queued_.fetch_add(1u);
+  if (num_sleeping_.load() > 0u)
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_condition_.notify_one();
+  }
+}
+
+// -----------------------------------------------------------------------------
+bool WorkStealingThreadPool::pop(WorkStealingTask& task)
+{
+  if (num_queued_.load(std::memory_order_relaxed) == 0u)
+  {
+    return false;
+  }
+
+  // Own deque first, newest task.
+  const int index = currentWorkerIndex();
+  if (index >= 0)
+  {
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty())
+    {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      num_queued_.fetch_sub(1u);
+      return true;
+    }
+  }
+
+  // Externally submitted tasks.
+  {
+    std::unique_lock<std::mutex> lock(injection_queue_.mutex, std::try_to_lock);
+    if (lock.owns_lock() && !injection_queue_.tasks.empty())
+    {
+      task = std::move(injection_queue_.tasks.front());
+      injection_queue_.tasks.pop_front();
+      num_queued_.fetch_sub(1u);
+      return true;
+    }
+  }
+
+  // Steal the oldest task of another worker, starting at the right neighbour
+  // so that thieves spread over different victims.
+  const size_t n = queues_.size();
+  const size_t start = (index >= 0) ? static_cast<size_t>(index) + 1u : 0u;
+  for (size_t i = 0u; i < n; ++i)
+  {
+    const size_t victim = (start + i) % n;
+    if (static_cast<int>(victim) == index)
+    {
+      continue;
+    }
+    WorkerQueue& queue = *queues_[victim];
+    std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+    if (lock.owns_lock() && !queue.tasks.empty())
+    {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      num_queued_.fetch_sub(1u);
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+bool WorkStealingThreadPool::runPendingTask()
+{
+  WorkStealingTask task;
+  if (!pop(task))
+  {
+    return false;
+  }
+  task();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+void WorkStealingThreadPool::workerLoop(size_t index)
+{
+  t_worker_pool = this;
+  t_worker_index = static_cast<int>(index);
+
+  WorkStealingTask task;
+  int idle_rounds = 0;
+  while (true)
+  {
+    if (pop(task))
+    {
+      task();
+      task.reset();
+      idle_rounds = 0;
+      continue;
+    }
+
+    // try_lock in pop() may miss tasks, spin a bit before parking.
+    if (++idle_rounds < c_spin_rounds)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    idle_rounds = 0;
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    num_sleeping_.fetch_add(1u);
+    sleep_condition_.wait(lock, [this] {
+      return stop_.load() || num_queued_.load() > 0u;
+    });
+    num_sleeping_.fetch_sub(1u);
+    if (stop_.load() && num_queued_.load() == 0u)
+    {
+      return;
+    }
+  }
+}
+
+} // namespace ze
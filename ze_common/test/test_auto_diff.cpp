@@ -0,0 +1,175 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cmath>
+
+#include <ze/common/auto_diff.hpp>
+#include <ze/common/dual.hpp>
+#include <ze/common/matrix.hpp>
+#include <ze/common/numerical_derivative.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/test_utils.hpp>
+#include <ze/common/transformation.hpp>
+#include <ze/common/types.hpp>
+
+namespace {
+
+using namespace ze;
+
+struct Linear
+{
+  template<typename T>
+  Eigen::Matrix<T, 2, 1> operator()(const Eigen::Matrix<T, 2, 1>& x) const
+  {
+    return x * real_t(1.2);
+  }
+};
+
+struct ScalarFunction
+{
+  template<typename T>
+  T operator()(const T& x) const
+  {
+    using std::exp;
+    using std::sin;
+    using std::sqrt;
+    return sin(x) * exp(x) / sqrt(x + 2.0);
+  }
+};
+
+struct PolarToCartesian
+{
+  template<typename T>
+  Eigen::Matrix<T, 3, 1> operator()(const Eigen::Matrix<T, 2, 1>& x) const
+  {
+    using std::atan2;
+    using std::cos;
+    using std::sin;
+    Eigen::Matrix<T, 3, 1> y;
+    y << x(0) * cos(x(1)), x(0) * sin(x(1)), atan2(x(1), x(0));
+    return y;
+  }
+};
+
+//! Rotates a point with R * Exp(delta), linearized at delta = 0.
+struct PerturbedRotation
+{
+  Matrix3 R;
+  Vector3 p;
+
+  template<typename T>
+  Eigen::Matrix<T, 3, 1> operator()(const Eigen::Matrix<T, 3, 1>& delta) const
+  {
+    Eigen::Matrix<T, 3, 1> p_perturbed = p.cast<T>() + delta.cross(p.cast<T>());
+    return R.cast<T>() * p_perturbed;
+  }
+};
+
+} // anonymous namespace
+
+TEST(AutoDiffTests, testDualArithmetic)
+{
+  using namespace ze;
+  typedef Dual<real_t, 2> Dual2;
+  const Dual2 x(1.5, 0);
+  const Dual2 y(-0.5, 1);
+
+  const Dual2 f = (x * y + 2.0 * x - y / x) / (1.0 - y);
+  // df/dx = (y + 2 + y / x^2) / (1 - y)
+  // df/dy = ((x - 1 / x)(1 - y) + (x y + 2 x - y / x)) / (1 - y)^2
+  const real_t xa = 1.5, ya = -0.5;
+  const real_t value = (xa * ya + 2.0 * xa - ya / xa) / (1.0 - ya);
+  EXPECT_NEAR(f.a, value, 1e-12);
+  EXPECT_NEAR(f.v(0), (ya + 2.0 + ya / (xa * xa)) / (1.0 - ya), 1e-12);
+  EXPECT_NEAR(f.v(1), ((xa - 1.0 / xa) * (1.0 - ya) + value * (1.0 - ya))
+              / ((1.0 - ya) * (1.0 - ya)), 1e-12);
+
+  // Comparisons look at the value only.
+  EXPECT_TRUE(x > y);
+  EXPECT_TRUE(x < 2.0);
+  EXPECT_TRUE(0.0 > y);
+  EXPECT_TRUE(Dual2(1.5, 1) == x);
+}
+
+TEST(AutoDiffTests, testLinearVector)
+{
+  using namespace ze;
+  Vector2 y;
+  Matrix2 J = autoDiff(Linear(), Vector2(1, 2), &y);
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(y, Vector2(1.2, 2.4), 1e-12));
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(J, Matrix2::Identity() * 1.2, 1e-12));
+}
+
+TEST(AutoDiffTests, testScalar)
+{
+#ifndef ZE_SINGLE_PRECISION_FLOAT
+  using namespace ze;
+  real_t y;
+  Matrix1 J = autoDiff(ScalarFunction(), real_t(0.7), &y);
+  EXPECT_NEAR(y, ScalarFunction()(real_t(0.7)), 1e-12);
+  Matrix1 J_numerical = numericalDerivative<real_t, real_t>(
+        [](const real_t& x) { return ScalarFunction()(x); }, 0.7);
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(J, J_numerical, 1e-8));
+#else
+  LOG(WARNING) << "Numerical derivative test ignored for single precision float.";
+#endif
+}
+
+TEST(AutoDiffTests, testNonlinearVector)
+{
+#ifndef ZE_SINGLE_PRECISION_FLOAT
+  using namespace ze;
+  const Vector2 x(2.0, 0.3);
+  Matrix32 J = autoDiff(PolarToCartesian(), x);
+  Matrix32 J_numerical = numericalDerivative<Vector3, Vector2>(
+        [](const Vector2& x) { return PolarToCartesian()(x); }, x);
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(J, J_numerical, 1e-8));
+#else
+  LOG(WARNING) << "Numerical derivative test ignored for single precision float.";
+#endif
+}
+
+TEST(AutoDiffTests, testManifoldPerturbation)
+{
+#ifndef ZE_SINGLE_PRECISION_FLOAT
+  using namespace ze;
+  const Quaternion q = Quaternion::exp(Vector3(0.1, -0.3, 0.25));
+  PerturbedRotation h;
+  h.R = q.getRotationMatrix();
+  h.p = Vector3(1.0, 2.0, 3.0);
+
+  // Derivative with respect to the right-hand side perturbation of q, as
+  // defined by traits<Quaternion>::retract().
+  Matrix3 J = autoDiff(h, Vector3::Zero().eval());
+  Matrix3 J_numerical = numericalDerivative<Vector3, Quaternion>(
+        [&h](const Quaternion& q) { return q.rotate(h.p); }, q);
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(J, J_numerical, 1e-8));
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(J, - h.R * skewSymmetric(h.p), 1e-12));
+#else
+  LOG(WARNING) << "Numerical derivative test ignored for single precision float.";
+#endif
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -23,11 +23,13 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-#include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
 
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/benchmark.hpp>
+#include <ze/common/test_utils.hpp>
 
 int foo(int x, int y)
 {
@@ -39,6 +41,24 @@ void printOut(const std::string& s)
   VLOG(10) << "Run dummy benchmark";
 }
 
+void benchmarkSum(ze::BenchmarkState& state)
+{
+  // Fixture code is not timed.
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  std::vector<int> data(state.arg(), 1);
+  while (state.keepRunning())
+  {
+    int sum = 0;
+    for (int x : data)
+    {
+      sum += x;
+    }
+    ze::doNotOptimizeAway(sum);
+  }
+  state.setItemsPerIteration(data.size());
+}
+ZE_BENCHMARK(benchmarkSum, "test/sum")->args({10, 1000});
+
 TEST(BenchmarkTest, testInterface)
 {
   using namespace ze;
@@ -47,6 +67,66 @@ TEST(BenchmarkTest, testInterface)
 
   auto fun2 = std::bind(foo, 1, 2);
   int64_t duration_ns = runTimingBenchmark(fun2, 1000, 100, "foo", true);
+  EXPECT_GE(duration_ns, 0);
+}
+
+TEST(BenchmarkTest, testRegisteredBenchmarks)
+{
+  using namespace ze;
+  BenchmarkOptions options;
+  options.num_epochs = 20u;
+  options.min_epoch_ns = 100000;
+  std::vector<BenchmarkResult> results =
+      runRegisteredBenchmarks("test/sum", options, false);
+  ASSERT_EQ(2u, results.size());
+  EXPECT_EQ("test/sum/10", results[0].name);
+  EXPECT_EQ("test/sum/1000", results[1].name);
+  for (const BenchmarkResult& r : results)
+  {
+    VLOG(1) << r;
+    EXPECT_EQ(20u, r.num_epochs);
+    // The sleep in the fixture is excluded.
+    EXPECT_LT(r.median_ns, 1e6);
+    EXPECT_LE(r.min_ns, r.median_ns);
+    EXPECT_LE(r.median_ns, r.p90_ns);
+    EXPECT_LE(r.p90_ns, r.p99_ns);
+    EXPECT_LE(r.p99_ns, r.max_ns);
+    EXPECT_GT(r.throughput(), 0.0);
+  }
+  EXPECT_EQ(10.0, results[0].items_per_iteration);
+  EXPECT_GT(results[1].median_ns, results[0].median_ns);
+}
+
+TEST(BenchmarkTest, testBaseline)
+{
+  using namespace ze;
+  BenchmarkResult a;
+  a.name = "test/a";
+  a.num_iterations = 100u;
+  a.num_epochs = 10u;
+  a.median_ns = 1000.0;
+  a.p99_ns = 1500.5;
+  a.items_per_iteration = 3.0;
+  BenchmarkResult b = a;
+  b.name = "test/b/100";
+  b.median_ns = 0.25;
+
+  TemporaryFile file("test_benchmark_baseline");
+  saveBenchmarkResults(file.path(), {a, b});
+  std::vector<BenchmarkResult> baseline = loadBenchmarkResults(file.path());
+  ASSERT_EQ(2u, baseline.size());
+  EXPECT_EQ("test/b/100", baseline[1].name);
+  EXPECT_EQ(100u, baseline[1].num_iterations);
+  EXPECT_EQ(0.25, baseline[1].median_ns);
+  EXPECT_EQ(1500.5, baseline[0].p99_ns);
+  EXPECT_EQ(3.0, baseline[0].items_per_iteration);
+
+  a.median_ns = 1040.0;
+  b.median_ns = 0.5;
+  std::stringstream ss;
+  EXPECT_EQ(1u, compareBenchmarkResults({a, b}, baseline, 0.05, ss));
+  VLOG(1) << ss.str();
+  EXPECT_EQ(0u, compareBenchmarkResults({a}, baseline, 0.05, ss));
 }
 
 ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,150 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <ze/common/binary_trajectory.hpp>
+#include <ze/common/csv_trajectory.hpp>
+#include <ze/common/file_utils.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/test_utils.hpp>
+#include <ze/common/transformation.hpp>
+
+using namespace ze;
+
+TEST(BinaryTrajectoryTest, roundTrip)
+{
+  const TemporaryFile file("test_binary_trajectory");
+  const std::string& filename = file.path();
+  StampedTransformationVector poses;
+  for (int i = 0; i < 101; ++i)
+  {
+    Transformation T;
+    T.setRandom();
+    poses.push_back(std::make_pair(1000 * i, T));
+  }
+  saveBinaryTrajectory(filename, poses);
+
+  BinaryTrajectory trajectory(filename);
+  ASSERT_EQ(poses.size(), trajectory.size());
+  EXPECT_FALSE(trajectory.hasVelocityAndBias());
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(trajectory.positions().data()) % 64u);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(trajectory.quaternions().data()) % 64u);
+  for (size_t i = 0; i < poses.size(); ++i)
+  {
+    EXPECT_EQ(poses[i].first, trajectory.stamps()(i));
+    EXPECT_EQ(poses[i].second.getPosition(), trajectory.positions().col(i));
+    EXPECT_EQ(poses[i].second.getTransformationMatrix(),
+              trajectory.transformation(i).getTransformationMatrix());
+  }
+
+  Buffer<real_t, 7> buffer;
+  trajectory.insertInto(buffer);
+  ASSERT_EQ(poses.size(), buffer.size());
+  buffer.lock();
+  const auto values = buffer.data().values();
+  EXPECT_EQ(poses[5].second.getPosition(), values.col(5).head<3>());
+  EXPECT_EQ(poses[5].second.getEigenQuaternion().coeffs(), values.col(5).tail<4>());
+  buffer.unlock();
+
+  // Empty trajectory.
+  saveBinaryTrajectory(filename, StampedTransformationVector());
+  ASSERT_TRUE(trajectory.open(filename));
+  EXPECT_EQ(0u, trajectory.size());
+}
+
+TEST(BinaryTrajectoryTest, convertSWEResult)
+{
+  const TemporaryFile csv_file("test_binary_trajectory_swe_csv");
+  const std::string& csv_filename = csv_file.path();
+  const TemporaryFile file("test_binary_trajectory_swe");
+  const std::string& filename = file.path();
+  const int n = 50;
+  {
+    std::ofstream fs;
+    openOutputFileStream(csv_filename, &fs);
+    fs << "timestamp, x, y, z, qx, qy, qz, qw, vx, vy, vz, bgx, bgy, bgz, bax, bay, baz\n";
+    for (int i = 0; i < n; ++i)
+    {
+      fs << 100 * (i + 1) << "," << i << ",0,0,0,0,0,1,"
+         << 0.5 * i << ",1,2," << 0.25 * i << ",3,4," << -0.125 * i << ",5,6\n";
+    }
+  }
+  SWEResultSeries series;
+  series.load(csv_filename);
+  ASSERT_EQ(static_cast<size_t>(n), series.getVelocityAndBiasBuffer().size());
+  saveBinaryTrajectory(filename, series);
+
+  BinaryTrajectory trajectory(filename);
+  ASSERT_EQ(static_cast<size_t>(n), trajectory.size());
+  ASSERT_TRUE(trajectory.hasVelocityAndBias());
+  for (int i = 0; i < n; ++i)
+  {
+    EXPECT_EQ(100 * (i + 1), trajectory.stamps()(i));
+    EXPECT_EQ(i, trajectory.positions()(0, i));
+    EXPECT_EQ(1.0, trajectory.quaternions()(3, i));
+    EXPECT_EQ(Vector3(0.5 * i, 1.0, 2.0), trajectory.velocities().col(i));
+    EXPECT_EQ(Vector3(0.25 * i, 3.0, 4.0), trajectory.gyroBiases().col(i));
+    EXPECT_EQ(Vector3(-0.125 * i, 5.0, 6.0), trajectory.accelBiases().col(i));
+  }
+}
+
+TEST(BinaryTrajectoryTest, rejectInvalidFiles)
+{
+  const TemporaryFile file("test_binary_trajectory_invalid");
+  const std::string& filename = file.path();
+  BinaryTrajectory trajectory;
+  std::string missing_filename;
+  {
+    const TemporaryFile missing_file("test_binary_trajectory_missing");
+    missing_filename = missing_file.path();
+  }
+  EXPECT_FALSE(trajectory.open(missing_filename));
+
+  {
+    std::ofstream fs(filename);
+    fs << "# timestamp, x, y, z, qx, qy, qz, qw\n";
+  }
+  EXPECT_FALSE(trajectory.open(filename));
+
+  // Truncate a valid file.
+  StampedTransformationVector poses(10, std::make_pair(0, Transformation()));
+  saveBinaryTrajectory(filename, poses);
+  std::string data;
+  {
+    std::ifstream fs(filename, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream fs(filename, std::ios::binary);
+    fs.write(data.data(), data.size() - 8);
+  }
+  EXPECT_FALSE(trajectory.open(filename));
+  EXPECT_EQ(0u, trajectory.size());
+}
+
+ZE_UNITTEST_ENTRYPOINT
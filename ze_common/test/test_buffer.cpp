@@ -95,6 +95,60 @@ TEST(BufferTest, testIterator)
   buffer.unlock();
 }
 
+TEST(BufferTest, testOutOfOrderInsert)
+{
+  ze::Buffer<double, 2> buffer;
+  for(int i : {5, 1, 3, 9, 7, 2})
+  {
+    buffer.insert(i, Eigen::Vector2d(i, -i));
+  }
+  // Overwrite existing stamp.
+  buffer.insert(3, Eigen::Vector2d(30, -30));
+
+  EXPECT_EQ(buffer.size(), 6u);
+  buffer.lock();
+  int64_t last = -1;
+  for(const auto& it : buffer.data())
+  {
+    EXPECT_GT(it.first, last);
+    last = it.first;
+    EXPECT_DOUBLE_EQ(it.second(0), (it.first == 3) ? 30.0 : it.first);
+  }
+  EXPECT_EQ(buffer.data().stamps()(0), 1);
+  EXPECT_EQ(buffer.data().stamps()(5), 9);
+  EXPECT_DOUBLE_EQ(buffer.data().values()(1, 5), -9.0);
+  buffer.unlock();
+}
+
+TEST(BufferTest, testTrimAndReuse)
+{
+  ze::SortedTimeSeries<double, 3> series;
+  for(int i = 0; i < 10000; ++i)
+  {
+    series.insert(i, Eigen::Vector3d::Constant(i));
+  }
+
+  // Repeatedly drop the oldest samples, the data stays consistent while the
+  // dead prefix is compacted.
+  for(int i = 1; i <= 99; ++i)
+  {
+    series.eraseBefore(series.lower_bound(i * 100));
+    ASSERT_EQ(series.size(), static_cast<size_t>(10000 - i * 100));
+    EXPECT_EQ(series.oldestStamp(), i * 100);
+    EXPECT_EQ(series.newestStamp(), 9999);
+    EXPECT_DOUBLE_EQ(series.begin()->second(2), i * 100.0);
+    EXPECT_DOUBLE_EQ(series.rbegin()->second(0), 9999.0);
+  }
+
+  // Inserting right before the oldest sample reuses the dead prefix.
+  series.insert(50, Eigen::Vector3d::Constant(50));
+  EXPECT_EQ(series.oldestStamp(), 50);
+  EXPECT_EQ(series.size(), 101u);
+
+  series.eraseBefore(series.end());
+  EXPECT_TRUE(series.empty());
+}
+
 TEST(BufferTest, testNearestValue)
 {
   ze::Buffer<double, 2> buffer;
@@ -23,7 +23,13 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include <ze/common/benchmark.hpp>
 #include <ze/common/buffer.hpp>
+#include <ze/common/csv_parser.hpp>
 #include <ze/common/csv_trajectory.hpp>
 #include <ze/common/file_utils.hpp>
 #include <ze/common/path_utils.hpp>
@@ -34,6 +40,206 @@
 
 using namespace ze;
 
+DEFINE_bool(run_benchmark, false, "Benchmark loading a large trajectory.");
+
+namespace {
+
+// Writes n poses with stamps 1000 * (i + 1) and a rotation about z.
+void writePoseCsv(const std::string& filename, const std::string& header,
+                  int n, bool euroc_order = false)
+{
+  std::ofstream fs;
+  openOutputFileStream(filename, &fs);
+  fs << header << "\n";
+  fs.precision(17);
+  for (int i = 0; i < n; ++i)
+  {
+    if (i % 1000 == 10)
+    {
+      fs << "# comment\n";
+    }
+    const double angle = 0.001 * i;
+    const double qz = std::sin(angle / 2.0), qw = std::cos(angle / 2.0);
+    fs << 1000 * (i + 1) << ", " << 0.5 * i << "," << -1.25e-3 * i << ","
+       << 1.0 / (i + 1) << ",";
+    if (euroc_order)
+    {
+      fs << qw << ",0,0," << qz << ",1,2,3\r\n";
+    }
+    else
+    {
+      fs << "0,0," << qz << "," << qw << "\n";
+    }
+  }
+}
+
+void expectPoses(PoseSeries& series, int n)
+{
+  auto& buffer = series.getBuffer();
+  ASSERT_EQ(static_cast<size_t>(n), buffer.size());
+  buffer.lock();
+  int i = 0;
+  for (const auto& entry : buffer.data())
+  {
+    const double angle = 0.001 * i;
+    EXPECT_EQ(1000 * (i + 1), entry.first);
+    EXPECT_DOUBLE_EQ(0.5 * i, entry.second(0));
+    EXPECT_DOUBLE_EQ(-1.25e-3 * i, entry.second(1));
+    EXPECT_DOUBLE_EQ(1.0 / (i + 1), entry.second(2));
+    EXPECT_NEAR(std::sin(angle / 2.0), entry.second(5), 1e-12);
+    EXPECT_NEAR(std::cos(angle / 2.0), entry.second(6), 1e-12);
+    ++i;
+  }
+  buffer.unlock();
+}
+
+} // anonymous namespace
+
+TEST(CsvParserTest, parseNumbers)
+{
+  const std::vector<std::string> tokens = {
+    "0", "-0", "1", "+2.5", " 3.25", "-0.001", "1e10", "1.5E-7", "123456789.123456789",
+    "0.1", "0.30000000000000004", "1.7976931348623157e308", "4.9e-324",
+    "9007199254740993", "12345678901234567890123", "1e-30", "inf", "-nan",
+    "2.5 ", "7,8" };
+  for (const std::string& token : tokens)
+  {
+    double value;
+    const char* end = parseDouble(token.data(), token.data() + token.size(), &value);
+    ASSERT_TRUE(end != nullptr) << token;
+    const double expected = std::strtod(token.c_str(), nullptr);
+    if (std::isnan(expected))
+    {
+      EXPECT_TRUE(std::isnan(value));
+    }
+    else
+    {
+      EXPECT_EQ(expected, value) << token;
+    }
+  }
+
+  // Random doubles with 17 significant digits round trip exactly.
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1e6, 1e6);
+  char buffer[64];
+  for (int i = 0; i < 10000; ++i)
+  {
+    const double x = dist(gen);
+    const int length = std::snprintf(buffer, sizeof(buffer), "%.17g", x);
+    double value;
+    ASSERT_TRUE(parseDouble(buffer, buffer + length, &value) != nullptr);
+    EXPECT_EQ(x, value);
+  }
+
+  double value;
+  const std::string no_number = " x1";
+  EXPECT_TRUE(parseDouble(no_number.data(), no_number.data() + 3, &value) == nullptr);
+
+  int64_t stamp;
+  const std::string stamp_str = " 1403636579763555584,1";
+  const char* end = parseInt64(stamp_str.data(),
+                               stamp_str.data() + stamp_str.size(), &stamp);
+  EXPECT_EQ(1403636579763555584, stamp);
+  EXPECT_EQ(',', *end);
+  EXPECT_TRUE(parseInt64(no_number.data(), no_number.data() + 3, &stamp) == nullptr);
+}
+
+TEST(CsvTrajectoryTest, loadPoseSeries)
+{
+  const TemporaryFile file("test_csv_trajectory_poses");
+  const std::string& filename = file.path();
+  const int n = 5000;
+  writePoseCsv(filename, "# timestamp, x, y, z, qx, qy, qz, qw", n);
+
+  PoseSeries poses;
+  poses.load(filename);
+  expectPoses(poses, n);
+
+  PositionSeries positions;
+  positions.load(filename);
+  EXPECT_EQ(static_cast<size_t>(n), positions.getBuffer().size());
+
+  // Quaternions are reordered according to the column definition.
+  const TemporaryFile euroc_file("test_csv_trajectory_euroc");
+  const std::string& euroc_filename = euroc_file.path();
+  EurocResultSeries euroc;
+  writePoseCsv(euroc_filename, "#timestamp, p_RS_R_x [m], p_RS_R_y [m], "
+               "p_RS_R_z [m], q_RS_w [], q_RS_x [], q_RS_y [], q_RS_z [], "
+               "v_RS_R_x [m s^-1], v_RS_R_y [m s^-1], v_RS_R_z [m s^-1], "
+               "b_w_RS_S_x [rad s^-1], b_w_RS_S_y [rad s^-1], "
+               "b_w_RS_S_z [rad s^-1], b_a_RS_S_x [m s^-2], "
+               "b_a_RS_S_y [m s^-2], b_a_RS_S_z [m s^-2]", n, true);
+  euroc.load(euroc_filename);
+  expectPoses(euroc, n);
+}
+
+TEST(CsvTrajectoryTest, loadMultiThreaded)
+{
+  // Large enough to be split in several chunks.
+  const TemporaryFile file("test_csv_trajectory_large");
+  const std::string& filename = file.path();
+  const int n = 100000;
+  writePoseCsv(filename, "# timestamp, x, y, z, qx, qy, qz, qw", n);
+
+  PoseSeries poses;
+  poses.setNumLoadThreads(4u);
+  poses.load(filename);
+  expectPoses(poses, n);
+}
+
+//! Stamps in microseconds.
+class MicrosecondPoseSeries : public PoseSeries
+{
+public:
+  virtual int64_t getTimeStamp(const std::string& ts_str) const override
+  {
+    return 1000 * PoseSeries::getTimeStamp(ts_str);
+  }
+};
+
+TEST(CsvTrajectoryTest, loadOverriddenTimeStamp)
+{
+  const TemporaryFile file("test_csv_trajectory_microseconds");
+  const int n = 2000;
+  writePoseCsv(file.path(), "# timestamp, x, y, z, qx, qy, qz, qw", n);
+
+  MicrosecondPoseSeries poses;
+  poses.setNumLoadThreads(2u);
+  poses.load(file.path());
+  auto& buffer = poses.getBuffer();
+  ASSERT_EQ(static_cast<size_t>(n), buffer.size());
+  buffer.lock();
+  const auto stamps = buffer.data().stamps();
+  EXPECT_EQ(1000 * 1000, stamps(0));
+  EXPECT_EQ(1000 * 1000 * n, stamps(n - 1));
+  buffer.unlock();
+}
+
+TEST(CsvTrajectoryTest, benchmarkLoad)
+{
+  if (!FLAGS_run_benchmark)
+  {
+    return;
+  }
+
+  const TemporaryFile file("test_csv_trajectory_benchmark");
+  const std::string& filename = file.path();
+  const int n = 1000000;
+  writePoseCsv(filename, "# timestamp, x, y, z, qx, qy, qz, qw", n);
+
+  for (size_t num_threads : {1u, 4u})
+  {
+    auto load = [&]()
+    {
+      PoseSeries poses;
+      poses.setNumLoadThreads(num_threads);
+      poses.load(filename);
+    };
+    runTimingBenchmark(load, 1, 5, "Load 1M poses, threads: "
+                       + std::to_string(num_threads), true);
+  }
+}
+
 TEST(TimeStampMatcher, matchTest)
 {
   std::string test_data_dir = getTestDataDir("ze_ts_matching");
@@ -0,0 +1,202 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/frame_arena.hpp>
+#include <ze/common/test_allocation_counter.hpp>
+#include <ze/common/test_entrypoint.hpp>
+
+ZE_ALLOCATION_COUNTING_HOOK
+
+TEST(FrameArenaTests, testAllocate)
+{
+  using namespace ze;
+
+  MonotonicArena arena(256u);
+  char* a = static_cast<char*>(arena.allocate(3u, 1u));
+  double* b = arena.allocate<double>(4u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % MonotonicArena::c_default_alignment, 0u);
+  EXPECT_GT(reinterpret_cast<char*>(b), a);
+  EXPECT_EQ(arena.numChunks(), 1u);
+
+  // Allocations larger than the chunk add new chunks, reset merges them.
+  arena.allocate(400u);
+  arena.allocate(10u);
+  EXPECT_EQ(arena.numChunks(), 2u);
+  const size_t capacity = arena.capacity();
+  arena.reset();
+  EXPECT_EQ(arena.numChunks(), 1u);
+  EXPECT_EQ(arena.capacity(), capacity);
+  EXPECT_EQ(arena.bytesUsed(), 0u);
+
+  // Same frame again fits into the merged chunk.
+  const size_t num_heap_allocations = arena.numHeapAllocations();
+  arena.allocate(3u, 1u);
+  arena.allocate<double>(4u);
+  arena.allocate(400u);
+  arena.allocate(10u);
+  EXPECT_EQ(arena.numChunks(), 1u);
+  EXPECT_EQ(arena.numHeapAllocations(), num_heap_allocations);
+}
+
+TEST(FrameArenaTests, testNestedScopes)
+{
+  using namespace ze;
+
+  MonotonicArena arena(1024u);
+  {
+    FrameScope outer(arena);
+    arena.allocate(100u);
+    const size_t used = arena.bytesUsed();
+    void* p = nullptr;
+    {
+      FrameScope inner(arena);
+      p = arena.allocate(200u);
+      EXPECT_GT(arena.bytesUsed(), used);
+    }
+    EXPECT_EQ(arena.bytesUsed(), used);
+    EXPECT_EQ(arena.allocate(200u), p);
+  }
+  EXPECT_EQ(arena.bytesUsed(), 0u);
+}
+
+TEST(FrameArenaTests, testContainersAndEigen)
+{
+  using namespace ze;
+
+  MonotonicArena arena(1024u);
+  for (int frame = 0; frame < 3; ++frame)
+  {
+    FrameScope scope(arena);
+    FrameVector<int> v(scope.allocator<int>());
+    for (int i = 0; i < 1000; ++i)
+    {
+      v.push_back(i);
+    }
+    EXPECT_EQ(v.back(), 999);
+
+    std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+        ArenaAllocator<std::pair<const int, int>>> map(
+          16u, std::hash<int>(), std::equal_to<int>(),
+          scope.allocator<std::pair<const int, int>>());
+    map[3] = 4;
+    EXPECT_EQ(map.at(3), 4);
+
+    auto m = arenaMatrix<Matrix3X>(scope.arena(), 3, 10);
+    m.setConstant(2.0);
+    auto v2 = arenaVector<VectorX>(scope.arena(), 10);
+    v2 = m.colwise().squaredNorm().transpose();
+    EXPECT_DOUBLE_EQ(v2(9), 12.0);
+    auto c = arenaCopy(scope.arena(), m * real_t{2});
+    EXPECT_DOUBLE_EQ(c(2, 9), 4.0);
+  }
+  EXPECT_EQ(arena.numChunks(), 1u);
+}
+
+TEST(FrameArenaTests, testSteadyStateIsAllocationFree)
+{
+  using namespace ze;
+
+  auto frame = []()
+  {
+    FrameScope scope;
+    FrameVector<uint32_t> indices(scope.allocator<uint32_t>());
+    for (uint32_t i = 0u; i < 10000u; ++i)
+    {
+      indices.push_back(i);
+    }
+    auto p = arenaMatrix<Matrix3X>(scope.arena(), 3, 5000);
+    p.setZero();
+    return indices.size();
+  };
+
+  // Warm up until the arena covers the peak of a frame.
+  frame();
+  frame();
+  AllocationCounter counter;
+  for (int i = 0; i < 10; ++i)
+  {
+    frame();
+  }
+  EXPECT_EQ(counter.count(), 0u);
+
+  // The hook counts regular heap allocations.
+  counter.restart();
+  std::vector<int> v(10);
+  VectorX x(100);
+  EXPECT_EQ(counter.count(), 2u);
+
+  // Every thread has its own arena.
+  MonotonicArena* main_arena = &threadFrameArena();
+  MonotonicArena* other_arena = nullptr;
+  std::thread([&]() { other_arena = &threadFrameArena(); }).join();
+  EXPECT_NE(main_arena, other_arena);
+}
+
+TEST(FrameArenaTests, benchmark)
+{
+  using namespace ze;
+
+  auto heap = []()
+  {
+    std::vector<uint32_t> indices;
+    indices.reserve(1000u);
+    for (uint32_t i = 0u; i < 1000u; ++i)
+    {
+      indices.push_back(i);
+    }
+    Matrix3X p(3, 1000);
+    p.setZero();
+    VectorX n = p.colwise().norm();
+    doNotOptimizeAway(n.data());
+    doNotOptimizeAway(indices.data());
+    doNotOptimizeAway(p.data());
+  };
+  runTimingBenchmark(heap, 100, 10, "Heap", true);
+
+  auto arena = []()
+  {
+    FrameScope scope;
+    FrameVector<uint32_t> indices(scope.allocator<uint32_t>());
+    indices.reserve(1000u);
+    for (uint32_t i = 0u; i < 1000u; ++i)
+    {
+      indices.push_back(i);
+    }
+    auto p = arenaMatrix<Matrix3X>(scope.arena(), 3, 1000);
+    p.setZero();
+    auto n = arenaCopy(scope.arena(), p.colwise().norm().transpose());
+    doNotOptimizeAway(n.data());
+    doNotOptimizeAway(indices.data());
+    doNotOptimizeAway(p.data());
+  };
+  runTimingBenchmark(arena, 100, 10, "FrameArena", true);
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,308 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/lock_free_fifo.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/thread_safe_fifo.hpp>
+
+using namespace ::ze;
+
+namespace {
+
+constexpr unsigned c_num_objects_per_thread = 20000;
+
+template<typename Fifo>
+class LockFreeFifoTest : public ::testing::Test
+{
+};
+
+typedef ::testing::Types<
+LockFreeSpscFifo<std::shared_ptr<int>, 8>,
+LockFreeMpmcFifo<std::shared_ptr<int>, 8>
+> FifoTypes;
+
+} // unnamed namespace
+
+TYPED_TEST_CASE(LockFreeFifoTest, FifoTypes);
+
+TYPED_TEST(LockFreeFifoTest, Default)
+{
+  typedef std::shared_ptr<int> Ptr;
+  TypeParam queue;
+
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.full());
+  for (int i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(static_cast<unsigned>(i), queue.size());
+    queue.write(std::make_shared<int>(i));
+  }
+  EXPECT_TRUE(queue.full());
+  EXPECT_FALSE(queue.nonBlockingWrite(std::make_shared<int>(8)));
+  EXPECT_FALSE(queue.timedWrite(std::make_shared<int>(8), 1));
+
+  for (int i = 0; i < 5; ++i)
+  {
+    Ptr p = queue.read();
+    ASSERT_TRUE(p.get() != nullptr);
+    EXPECT_EQ(i, *p);
+  }
+  for (int i = 8; i < 10; ++i)
+  {
+    EXPECT_TRUE(queue.nonBlockingWrite(std::make_shared<int>(i)));
+  }
+  EXPECT_EQ(5u, queue.size());
+  for (int i = 5; i < 10; ++i)
+  {
+    Ptr p;
+    EXPECT_TRUE(queue.timedRead(p, 1));
+    ASSERT_TRUE(p.get() != nullptr);
+    EXPECT_EQ(i, *p);
+  }
+  Ptr p;
+  EXPECT_FALSE(queue.nonBlockingRead(p));
+  EXPECT_FALSE(queue.timedRead(p, 1));
+
+  // clear() releases the stored objects.
+  Ptr tracked = std::make_shared<int>(42);
+  queue.write(tracked);
+  EXPECT_EQ(2, tracked.use_count());
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(1, tracked.use_count());
+}
+
+TYPED_TEST(LockFreeFifoTest, Batch)
+{
+  typedef std::shared_ptr<int> Ptr;
+  TypeParam queue;
+
+  std::vector<Ptr> in;
+  for (int i = 0; i < 12; ++i)
+  {
+    in.push_back(std::make_shared<int>(i));
+  }
+
+  // Only 8 elements fit.
+  EXPECT_EQ(8u, queue.nonBlockingWriteBatch(in.data(), in.size()));
+  EXPECT_TRUE(queue.full());
+  EXPECT_EQ(0u, queue.nonBlockingWriteBatch(in.data() + 8, 4));
+
+  std::vector<Ptr> out(16);
+  EXPECT_EQ(3u, queue.nonBlockingReadBatch(out.data(), 3));
+  EXPECT_EQ(3u, queue.nonBlockingWriteBatch(in.data() + 8, 3));
+  EXPECT_EQ(8u, queue.readBatch(out.data() + 3, 16));
+  EXPECT_EQ(1u, queue.nonBlockingWriteBatch(in.data() + 11, 1));
+  EXPECT_EQ(1u, queue.timedReadBatch(out.data() + 11, 16, 1));
+  EXPECT_EQ(0u, queue.timedReadBatch(out.data() + 12, 16, 1));
+
+  for (int i = 0; i < 12; ++i)
+  {
+    ASSERT_TRUE(out[i].get() != nullptr);
+    EXPECT_EQ(i, *out[i]);
+  }
+}
+
+TEST(LockFreeSpscFifo, ThreadTest)
+{
+  LockFreeSpscFifo<unsigned, 64> queue;
+  constexpr unsigned num = 10 * c_num_objects_per_thread;
+
+  std::thread writer([&queue]() {
+    unsigned i = 0;
+    std::array<unsigned, 7> batch;
+    while (i < num)
+    {
+      if (i % 3 == 0 && i + batch.size() <= num)
+      {
+        std::iota(batch.begin(), batch.end(), i);
+        queue.writeBatch(batch.data(), batch.size());
+        i += batch.size();
+      }
+      else
+      {
+        queue.write(i++);
+      }
+    }
+  });
+
+  // Elements must arrive in order.
+  unsigned expected = 0;
+  std::array<unsigned, 5> batch;
+  while (expected < num)
+  {
+    if (expected % 2 == 0)
+    {
+      EXPECT_EQ(expected, queue.read());
+      ++expected;
+    }
+    else
+    {
+      size_t n = queue.readBatch(batch.data(), batch.size());
+      for (size_t i = 0; i < n; ++i)
+      {
+        EXPECT_EQ(expected++, batch[i]);
+      }
+    }
+  }
+  writer.join();
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(LockFreeMpmcFifo, ThreadTest)
+{
+  LockFreeMpmcFifo<unsigned, 128> queue;
+  constexpr unsigned num_writers = 4;
+  constexpr unsigned num_readers = 3;
+
+  std::vector<std::thread> writers;
+  for (unsigned w = 0; w < num_writers; ++w)
+  {
+    writers.emplace_back([&queue, w]() {
+      std::array<unsigned, 4> batch;
+      for (unsigned i = 0; i < c_num_objects_per_thread; i += batch.size())
+      {
+        if (w % 2 == 0)
+        {
+          batch.fill(1u);
+          queue.writeBatch(batch.data(), batch.size());
+        }
+        else
+        {
+          for (size_t j = 0; j < batch.size(); ++j)
+          {
+            queue.write(1u);
+          }
+        }
+      }
+    });
+  }
+
+  std::atomic<bool> run(true);
+  std::vector<unsigned> counters(num_readers, 0u);
+  std::vector<std::thread> readers;
+  for (unsigned r = 0; r < num_readers; ++r)
+  {
+    readers.emplace_back([&queue, &run, &counters, r]() {
+      std::array<unsigned, 6> batch;
+      while (true)
+      {
+        size_t n = 0;
+        if (r == 0)
+        {
+          unsigned value;
+          n = queue.timedRead(value, 10) ? value : 0u;
+        }
+        else
+        {
+          n = queue.timedReadBatch(batch.data(), batch.size(), 10);
+        }
+        counters[r] += n;
+        if (n == 0 && !run)
+        {
+          break;
+        }
+      }
+    });
+  }
+
+  for (std::thread& t : writers)
+  {
+    t.join();
+  }
+  run = false;
+  for (std::thread& t : readers)
+  {
+    t.join();
+  }
+
+  EXPECT_EQ(num_writers * c_num_objects_per_thread,
+            std::accumulate(counters.begin(), counters.end(), 0u));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(LockFreeFifo, Benchmark)
+{
+  constexpr unsigned num = 100000;
+
+  auto runThreadSafe = []() {
+    ThreadSafeFifo<unsigned, 257> queue;
+    std::thread writer([&queue]() {
+      for (unsigned i = 0; i < num; ++i) { queue.write(i); }
+    });
+    for (unsigned i = 0; i < num; ++i) { queue.read(); }
+    writer.join();
+  };
+
+  auto runSpsc = []() {
+    LockFreeSpscFifo<unsigned, 256> queue;
+    std::thread writer([&queue]() {
+      for (unsigned i = 0; i < num; ++i) { queue.write(i); }
+    });
+    for (unsigned i = 0; i < num; ++i) { queue.read(); }
+    writer.join();
+  };
+
+  auto runMpmc = []() {
+    LockFreeMpmcFifo<unsigned, 256> queue;
+    std::thread writer([&queue]() {
+      for (unsigned i = 0; i < num; ++i) { queue.write(i); }
+    });
+    for (unsigned i = 0; i < num; ++i) { queue.read(); }
+    writer.join();
+  };
+
+  auto runSpscBatch = []() {
+    LockFreeSpscFifo<unsigned, 256> queue;
+    std::thread writer([&queue]() {
+      std::array<unsigned, 16> batch;
+      for (unsigned i = 0; i < num; i += batch.size())
+      {
+        queue.writeBatch(batch.data(), batch.size());
+      }
+    });
+    std::array<unsigned, 16> batch;
+    for (unsigned i = 0; i < num; )
+    {
+      i += queue.readBatch(batch.data(), batch.size());
+    }
+    writer.join();
+  };
+
+  runTimingBenchmark(runThreadSafe, 1, 5, "ThreadSafeFifo", true);
+  runTimingBenchmark(runSpsc, 1, 5, "LockFreeSpscFifo", true);
+  runTimingBenchmark(runMpmc, 1, 5, "LockFreeMpmcFifo", true);
+  runTimingBenchmark(runSpscBatch, 1, 5, "LockFreeSpscFifo batch", true);
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,181 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/pose_batch.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/test_utils.hpp>
+#include <ze/common/transformation.hpp>
+
+namespace {
+
+using namespace ze;
+
+#ifndef ZE_SINGLE_PRECISION_FLOAT
+constexpr real_t c_tol = 1e-10;
+#else
+constexpr real_t c_tol = 1e-4;
+#endif
+
+// Not a multiple of the internal block size.
+constexpr int c_num_poses = 150;
+
+TransformationVector randomPoses(int n)
+{
+  TransformationVector T(n);
+  for (Transformation& T_i : T)
+  {
+    T_i.setRandom(5.0);
+  }
+  return T;
+}
+
+void expectNear(const Transformation& T_expected, const Transformation& T)
+{
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(T_expected.getTransformationMatrix(),
+                                T.getTransformationMatrix(), c_tol));
+}
+
+} // unnamed namespace
+
+TEST(PoseBatchTest, conversions)
+{
+  using namespace ze;
+  const TransformationVector T = randomPoses(c_num_poses);
+  const PoseBatch batch(T);
+  ASSERT_EQ(c_num_poses, batch.size());
+  const TransformationVector T_converted = batch.toTransformationVector();
+  for (int i = 0; i < c_num_poses; ++i)
+  {
+    EXPECT_EQ(T[i].getTransformationMatrix(), T_converted[i].getTransformationMatrix());
+    EXPECT_EQ(T[i].getPosition()(1), batch.py()(i));
+    EXPECT_EQ(T[i].getEigenQuaternion().w(), batch.qw()(i));
+  }
+
+  std::vector<int64_t> stamps;
+  StampedTransformationVector stamped_T;
+  for (int i = 0; i < c_num_poses; ++i)
+  {
+    stamps.push_back(1000 * i);
+    stamped_T.push_back(StampedTransformation(stamps.back(), T[i]));
+  }
+  const StampedTransformationVector stamped_T_converted =
+      PoseBatch(stamped_T).toStampedTransformationVector(stamps);
+  for (int i = 0; i < c_num_poses; ++i)
+  {
+    EXPECT_EQ(stamps[i], stamped_T_converted[i].first);
+    EXPECT_EQ(T[i].getTransformationMatrix(),
+              stamped_T_converted[i].second.getTransformationMatrix());
+  }
+
+  PoseBatch identity(3);
+  EXPECT_EQ(Matrix4::Identity(), identity.at(2).getTransformationMatrix());
+}
+
+TEST(PoseBatchTest, composeInvertRelative)
+{
+  using namespace ze;
+  const TransformationVector T_A_B = randomPoses(c_num_poses);
+  const TransformationVector T_B_C = randomPoses(c_num_poses);
+  const PoseBatch batch_A_B(T_A_B);
+  const PoseBatch batch_B_C(T_B_C);
+
+  PoseBatch batch_A_C, batch_B_A, batch_B_C_relative, batch_aligned;
+  composePoses(batch_A_B, batch_B_C, &batch_A_C);
+  invertPoses(batch_A_B, &batch_B_A);
+  relativePoses(batch_A_B, batch_A_C, &batch_B_C_relative);
+  composePoses(T_A_B[0], batch_B_C, &batch_aligned);
+  for (int i = 0; i < c_num_poses; ++i)
+  {
+    expectNear(T_A_B[i] * T_B_C[i], batch_A_C.at(i));
+    expectNear(T_A_B[i].inverse(), batch_B_A.at(i));
+    expectNear(T_B_C[i], batch_B_C_relative.at(i));
+    expectNear(T_A_B[0] * T_B_C[i], batch_aligned.at(i));
+  }
+
+  // In-place.
+  PoseBatch batch(T_A_B);
+  composePoses(batch, batch_B_C, &batch);
+  invertPoses(batch, &batch);
+  for (int i = 0; i < c_num_poses; ++i)
+  {
+    expectNear((T_A_B[i] * T_B_C[i]).inverse(), batch.at(i));
+  }
+}
+
+TEST(PoseBatchTest, logExp)
+{
+  using namespace ze;
+  TransformationVector T = randomPoses(c_num_poses);
+  // Identity, small and half-turn rotations.
+  T[0].setIdentity();
+  T[1] = Transformation(Quaternion::exp(Vector3(1e-9, -2e-9, 0.0)), Vector3(1, 2, 3));
+  T[2] = Transformation(Quaternion::exp(Vector3(0.0, M_PI - 1e-6, 0.0)), Vector3(1, 2, 3));
+  const PoseBatch batch(T);
+
+  Matrix6X tangents;
+  logPoses(batch, &tangents);
+  ASSERT_EQ(c_num_poses, tangents.cols());
+  for (int i = 0; i < c_num_poses; ++i)
+  {
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(T[i].log(), tangents.col(i), 1e-8));
+  }
+
+  PoseBatch batch_exp;
+  expPoses(tangents, &batch_exp);
+  for (int i = 0; i < c_num_poses; ++i)
+  {
+    expectNear(Transformation::exp(tangents.col(i)), batch_exp.at(i));
+    expectNear(T[i], batch_exp.at(i));
+  }
+}
+
+TEST(PoseBatchTest, transformPoints)
+{
+  using namespace ze;
+  const TransformationVector T_A_B = randomPoses(c_num_poses);
+  const PoseBatch batch(T_A_B);
+  const Positions p_B = Positions::Random(3, c_num_poses);
+
+  Positions p_A;
+  transformPoints(batch, p_B, &p_A);
+  for (int i = 0; i < c_num_poses; ++i)
+  {
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(T_A_B[i] * Vector3(p_B.col(i)), p_A.col(i), c_tol));
+  }
+
+  const Positions p_B_few = p_B.leftCols(7);
+  transformPointsAllPairs(batch, p_B_few, &p_A);
+  ASSERT_EQ(c_num_poses * 7, p_A.cols());
+  for (int i = 0; i < c_num_poses; ++i)
+  {
+    for (int j = 0; j < 7; ++j)
+    {
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(T_A_B[i] * Vector3(p_B_few.col(j)),
+                                    p_A.col(i * 7 + j), c_tol));
+    }
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,237 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <atomic>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/profiler.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/timer_collection.hpp>
+
+using namespace ze;
+
+DEFINE_bool(run_benchmark, false, "Benchmark the zone overhead.");
+
+namespace {
+
+std::vector<ProfilerEvent> eventsOfThread(uint32_t thread)
+{
+  std::vector<ProfilerEvent> events;
+  for (const ProfilerEvent& event : Profiler::events())
+  {
+    if (event.thread == thread)
+    {
+      events.push_back(event);
+    }
+  }
+  return events;
+}
+
+void recordNested(int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    ZE_PROFILE_SCOPE("outer");
+    {
+      ZE_PROFILE_SCOPE("inner");
+    }
+  }
+}
+
+} // anonymous namespace
+
+TEST(ProfilerTest, disabled)
+{
+  Profiler::clear();
+  Profiler::setEnabled(false);
+  recordNested(10);
+  EXPECT_TRUE(Profiler::events().empty());
+}
+
+TEST(ProfilerTest, nestedZones)
+{
+  Profiler::clear();
+  Profiler::setEnabled(true);
+  recordNested(3);
+  Profiler::setEnabled(false);
+
+  std::vector<ProfilerEvent> events = Profiler::events();
+  ASSERT_EQ(6u, events.size());
+  for (size_t i = 0u; i < events.size(); i += 2u)
+  {
+    EXPECT_STREQ("outer", events[i].name);
+    EXPECT_EQ(0u, events[i].depth);
+    EXPECT_STREQ("inner", events[i + 1].name);
+    EXPECT_EQ(1u, events[i + 1].depth);
+    EXPECT_LE(events[i].begin_ns, events[i + 1].begin_ns);
+    EXPECT_GE(events[i].end_ns, events[i + 1].end_ns);
+  }
+}
+
+TEST(ProfilerTest, threads)
+{
+  Profiler::clear();
+  Profiler::setEventCapacity(16u);
+  Profiler::setEnabled(true);
+  std::vector<std::thread> threads;
+  std::atomic<int> num_done { 0 };
+  for (int i = 0; i < 3; ++i)
+  {
+    threads.emplace_back([i, &num_done]() {
+      Profiler::setThreadName("worker " + std::to_string(i));
+      recordNested(100);
+      // Stay alive until all workers recorded, exited threads share logs.
+      ++num_done;
+      while (num_done < 3)
+      {
+        std::this_thread::yield();
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  Profiler::setEnabled(false);
+  Profiler::setEventCapacity(1u << 16);
+
+  // Each thread keeps its last 16 events.
+  std::vector<ProfilerEvent> events = Profiler::events();
+  EXPECT_EQ(48u, events.size());
+  for (const ProfilerEvent& event : events)
+  {
+    const std::vector<ProfilerEvent> thread_events = eventsOfThread(event.thread);
+    ASSERT_EQ(16u, thread_events.size());
+    // Events are sorted by begin, the last inner zone starts after its outer.
+    EXPECT_STREQ("inner", thread_events.back().name);
+  }
+
+  std::stringstream ss;
+  Profiler::writeChromeTrace(ss);
+  const std::string trace = ss.str();
+  EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, trace.find("\"args\":{\"name\":\"worker 2\"}"));
+  EXPECT_NE(std::string::npos, trace.find("{\"name\":\"inner\",\"ph\":\"X\""));
+}
+
+TEST(ProfilerTest, concurrentSnapshot)
+{
+  Profiler::clear();
+  Profiler::setEventCapacity(64u);
+  Profiler::setEnabled(true);
+  std::atomic<bool> stop { false };
+  std::atomic<uint32_t> thread { 0u };
+  std::thread writer([&]() {
+    Profiler::setThreadName("writer");
+    thread = profilerThreadState().log->threadIndex();
+    int n = 0;
+    while (!stop || n < 64)
+    {
+      const int64_t t = Profiler::now();
+      Profiler::record("event", t, t);
+      ++n;
+    }
+  });
+  for (int i = 0; i < 1000; ++i)
+  {
+    for (const ProfilerEvent& event : Profiler::events())
+    {
+      ASSERT_TRUE(event.name != nullptr);
+      ASSERT_EQ(event.begin_ns, event.end_ns);
+    }
+  }
+  stop = true;
+  writer.join();
+  Profiler::setEnabled(false);
+  Profiler::setEventCapacity(1u << 16);
+  EXPECT_EQ(64u, eventsOfThread(thread).size());
+}
+
+TEST(ProfilerTest, reuseLogsOfExitedThreads)
+{
+  Profiler::clear();
+  Profiler::setEnabled(true);
+  std::set<uint32_t> thread_indices;
+  size_t num_logs = 0u;
+  for (int i = 0; i < 10; ++i)
+  {
+    std::thread thread([&thread_indices]() {
+      recordNested(1);
+      thread_indices.insert(profilerThreadState().log->threadIndex());
+    });
+    thread.join();
+    if (i == 0)
+    {
+      num_logs = Profiler::numThreadLogs();
+    }
+  }
+  Profiler::setEnabled(false);
+
+  // Threads that run one after the other share one ring buffer.
+  EXPECT_EQ(1u, thread_indices.size());
+  EXPECT_EQ(num_logs, Profiler::numThreadLogs());
+  EXPECT_EQ(20u, eventsOfThread(*thread_indices.begin()).size());
+}
+
+TEST(ProfilerTest, timerCollection)
+{
+  DECLARE_TIMER(TestTimer, timers, foo, bar);
+  Profiler::clear();
+  Profiler::setEnabled(true);
+  {
+    auto t = timers[TestTimer::foo].timeScope();
+    timers[TestTimer::bar].start();
+    timers[TestTimer::bar].stop();
+  }
+  Profiler::setEnabled(false);
+
+  std::vector<ProfilerEvent> events = Profiler::events();
+  ASSERT_EQ(2u, events.size());
+  EXPECT_STREQ("foo", events[0].name);
+  EXPECT_EQ(0u, events[0].depth);
+  EXPECT_STREQ("bar", events[1].name);
+  EXPECT_EQ(1u, events[1].depth);
+  EXPECT_EQ(1u, timers[TestTimer::foo].numTimings());
+}
+
+TEST(ProfilerTest, benchmarkOverhead)
+{
+  if (!FLAGS_run_benchmark)
+  {
+    return;
+  }
+
+  auto zones = []() { recordNested(1000); };
+  Profiler::setEnabled(false);
+  runTimingBenchmark(zones, 10, 20, "2000 zones, disabled", true);
+  Profiler::setEnabled(true);
+  runTimingBenchmark(zones, 10, 20, "2000 zones, enabled", true);
+  Profiler::setEnabled(false);
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -23,6 +23,9 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <thread>
+#include <vector>
+
 #include <ze/common/benchmark.hpp>
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/random.hpp>
@@ -112,6 +115,136 @@ TEST(RandomTests, testDistribution)
   }
 }
 
+TEST(RandomTests, testPhiloxKnownAnswers)
+{
+  using namespace ze;
+
+  // Known-answer tests of Random123 (kat_vectors, philox4x32 10 rounds).
+  auto expectBlock = [](const Philox4x32::Counter& ctr, const Philox4x32::Key& key,
+                        const Philox4x32::Counter& expected)
+  {
+    const Philox4x32::Counter r = Philox4x32::block(ctr, key);
+    for (int i = 0; i < 4; ++i)
+    {
+      EXPECT_EQ(r[i], expected[i]);
+    }
+  };
+  expectBlock({{ 0u, 0u, 0u, 0u }}, {{ 0u, 0u }},
+              {{ 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u }});
+  expectBlock({{ 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu }},
+              {{ 0xffffffffu, 0xffffffffu }},
+              {{ 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu }});
+  expectBlock({{ 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u }},
+              {{ 0xa4093822u, 0x299f31d0u }},
+              {{ 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u }});
+
+  // The generator starts at counter 0 of its stream.
+  Philox4x32 gen;
+  EXPECT_EQ(gen(), 0x6627e8d5u);
+  EXPECT_EQ(gen(), 0xe169c58du);
+}
+
+TEST(RandomTests, testPhiloxStreams)
+{
+  using namespace ze;
+
+  // Bulk fill and discard are equivalent to sequential calls.
+  Philox4x32 a(42u, 7u);
+  Philox4x32 b(42u, 7u);
+  std::vector<uint32_t> words(103);
+  a();
+  a.fillBits(words.data(), words.size());
+  b.discard(1u);
+  for (size_t i = 0; i < words.size(); ++i)
+  {
+    EXPECT_EQ(words[i], b());
+  }
+  EXPECT_EQ(a.position(), b.position());
+  b.discard(5u);
+  Philox4x32 c(42u, 7u);
+  c.discard(a.position() + 5u);
+  EXPECT_EQ(b(), c());
+
+  Philox4x32 d(1u, 2u);
+  Philox4x32 e(1u, 2u);
+  std::vector<double> uniform(37);
+  d.fillUniform(uniform.data(), uniform.size(), 2.0, 3.0);
+  for (double u : uniform)
+  {
+    EXPECT_DOUBLE_EQ(u, 2.0 + e.uniform<double>());
+    EXPECT_GE(u, 2.0);
+    EXPECT_LT(u, 3.0);
+  }
+
+  // Different streams and seeds give different sequences.
+  EXPECT_NE(Philox4x32(1u, 0u)(), Philox4x32(1u, 1u)());
+  EXPECT_NE(Philox4x32(1u, 0u)(), Philox4x32(2u, 0u)());
+}
+
+TEST(RandomTests, testBulkNormal)
+{
+  using namespace ze;
+
+  for (bool deterministic : { true, false })
+  {
+    Eigen::VectorXd samples(100001);
+    fillNormalDistributed(samples, threadRandomGenerator(deterministic), 2.0, 5.0);
+    RunningStatistics statistics;
+    for (int i = 0; i < samples.size(); ++i)
+    {
+      statistics.addSample(samples(i));
+    }
+    EXPECT_NEAR(statistics.mean(), 2.0, 0.1);
+    EXPECT_NEAR(statistics.std(),  5.0, 0.1);
+  }
+
+  Eigen::ArrayXf samples(10000);
+  Philox4x32 gen(3u);
+  fillNormalDistributed(samples, gen);
+  EXPECT_TRUE(samples.allFinite());
+  EXPECT_NEAR(samples.mean(), 0.0f, 0.05f);
+}
+
+TEST(RandomTests, testReproducibleAcrossThreadCounts)
+{
+  using namespace ze;
+
+  // One stream per work item, the result must not depend on the partitioning.
+  const size_t num_items = 64u;
+  const size_t samples_per_item = 100u;
+  auto run = [&](size_t num_threads)
+  {
+    std::vector<double> result(num_items * samples_per_item);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+      threads.emplace_back([&, t]() {
+        for (size_t item = t; item < num_items; item += num_threads)
+        {
+          Philox4x32 gen(123u, item);
+          gen.fillNormal(&result[item * samples_per_item], samples_per_item);
+        }
+      });
+    }
+    for (std::thread& thread : threads)
+    {
+      thread.join();
+    }
+    return result;
+  };
+  const std::vector<double> reference = run(1u);
+  EXPECT_EQ(reference, run(3u));
+  EXPECT_EQ(reference, run(8u));
+
+  // Deterministic thread-local generators start the same on every thread.
+  double main_thread = 0.0, other_thread = 1.0;
+  std::thread([&]() {
+    main_thread = Philox4x32(0u, 0u).uniform<double>();
+    other_thread = threadRandomGenerator(true).uniform<double>();
+  }).join();
+  EXPECT_EQ(main_thread, other_thread);
+}
+
 TEST(RandomTests, benchmark)
 {
   using namespace ze;
@@ -144,6 +277,26 @@ TEST(RandomTests, benchmark)
     }
   };
   runTimingBenchmark(lambda3, 10, 10, "Using std interface", true);
+
+  std::vector<real_t> samples(100000);
+  auto lambda4 = [&]()
+  {
+    for (real_t& s : samples)
+      s = sampleNormalDistribution<real_t>(false);
+  };
+  runTimingBenchmark(lambda4, 10, 10, "sampleNormalDistribution", true);
+
+  auto lambda5 = [&]()
+  {
+    threadRandomGenerator().fillNormal(samples.data(), samples.size());
+  };
+  runTimingBenchmark(lambda5, 10, 10, "Philox4x32::fillNormal", true);
+
+  auto lambda6 = [&]()
+  {
+    threadRandomGenerator().fillUniform(samples.data(), samples.size());
+  };
+  runTimingBenchmark(lambda6, 10, 10, "Philox4x32::fillUniform", true);
 }
 
 ZE_UNITTEST_ENTRYPOINT
@@ -39,6 +39,24 @@ TEST(RandomMatrixTests, testRandomVectorSampler)
 
   Vector2 sample = sampler->sample();
   Vector3 sample2 = sampler2->sample();
+
+  // Bulk sampling: one sample per column with the given standard deviations.
+  Eigen::Matrix<real_t, 3, Eigen::Dynamic> samples = sampler2->sampleN(20000);
+  ASSERT_EQ(samples.cols(), 20000);
+  for (int i = 0; i < 3; ++i)
+  {
+    RunningStatistics statistics;
+    for (int j = 0; j < samples.cols(); ++j)
+    {
+      statistics.addSample(samples(i, j));
+    }
+    EXPECT_NEAR(statistics.mean(), 0.0, 0.1);
+    EXPECT_NEAR(statistics.std(), static_cast<real_t>(i + 1), 0.1);
+  }
+
+  // Same generator state gives the same samples.
+  Philox4x32 gen1(5u, 1u), gen2(5u, 1u);
+  EXPECT_EQ(sampler->sampleN(7, gen1), sampler->sampleN(7, gen2));
 }
 
 TEST(RandomMatrixTests, testRandomVector)
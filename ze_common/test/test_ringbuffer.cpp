@@ -23,7 +23,9 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
 #include <iostream>
 
@@ -278,6 +280,52 @@ TEST(RingBufferTest, testInterpolationTimestamps)
   EXPECT_DOUBLE_EQ(values(1, 2), 3.5);  
 }
 
+TEST(RingBufferTest, testBatchInterpolation)
+{
+  using namespace ze;
+  ze::Ringbuffer<real_t, 2, 10> buffer;
+  // wrap around the ring, entries 6 to 15 remain
+  for(int i = 1; i < 16; ++i)
+  {
+    buffer.insert(secToNanosec(i), Vector2(i, -2 * i));
+  }
+
+  Eigen::Matrix<int64_t, Eigen::Dynamic, 1> stamps(6);
+  stamps << secToNanosec(6), secToNanosec(6.25), secToNanosec(6.25),
+      secToNanosec(9), secToNanosec(12.5), secToNanosec(15);
+  Eigen::Matrix<real_t, 2, Eigen::Dynamic> values(2, 6);
+
+  EXPECT_TRUE(buffer.getValuesInterpolated(stamps, values));
+  Vector2 out;
+  for (int i = 0; i < stamps.size(); ++i)
+  {
+    EXPECT_TRUE(buffer.getValueInterpolated(stamps(i), out));
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(out, values.col(i), 1e-10));
+  }
+  EXPECT_DOUBLE_EQ(12.5, values(0, 4));
+  EXPECT_DOUBLE_EQ(-25.0, values(1, 4));
+
+  // writes into blocks, generic interpolator path
+  Eigen::Matrix<real_t, 2, Eigen::Dynamic> nearest(2, 8);
+  nearest.setZero();
+  EXPECT_TRUE(buffer.getValuesInterpolated<InterpolatorNearest>(
+                stamps, nearest.middleCols(1, 6)));
+  EXPECT_DOUBLE_EQ(0.0, nearest(0, 0));
+  EXPECT_DOUBLE_EQ(6.0, nearest(0, 2));
+  EXPECT_DOUBLE_EQ(9.0, nearest(0, 4));
+  EXPECT_DOUBLE_EQ(15.0, nearest(0, 6));
+  EXPECT_DOUBLE_EQ(0.0, nearest(0, 7));
+
+  // out of bounds or unordered
+  stamps(0) = secToNanosec(5);
+  EXPECT_FALSE(buffer.getValuesInterpolated(stamps, values));
+  stamps(0) = secToNanosec(7);
+  EXPECT_FALSE(buffer.getValuesInterpolated(stamps, values));
+  stamps(0) = secToNanosec(6);
+  stamps(5) = secToNanosec(16);
+  EXPECT_FALSE(buffer.getValuesInterpolated(stamps, values));
+}
+
 TEST(RingBufferTest, testGetValueInterpolated)
 {
   using namespace ze;
@@ -334,6 +382,104 @@ TEST(RingBufferTest, testInterpolationBounds)
   EXPECT_EQ(0, values.cols());
 }
 
+TEST(RingBufferTest, testLockFreeReads)
+{
+  using namespace ze;
+
+  // The writer stores value == stamp, so every consistent read satisfies
+  // value == stamp no matter how far the ring advanced in the meantime.
+  Ringbuffer<real_t, 2, 64> buffer(true);
+  EXPECT_TRUE(buffer.lockFreeReads());
+  EXPECT_FALSE(std::get<2>(buffer.getOldestAndNewestStamp()));
+
+  std::atomic<bool> done { false };
+  std::thread writer([&]() {
+    for (int64_t i = 1; i <= 200000; ++i)
+    {
+      buffer.insert(i, Vector2(i, -i));
+    }
+    done = true;
+  });
+
+  size_t num_reads = 0u;
+  Vector2 out;
+  while (!done)
+  {
+    int64_t oldest, newest;
+    bool success;
+    std::tie(oldest, newest, success) = buffer.getOldestAndNewestStamp();
+    if (!success || newest - oldest < 10)
+    {
+      continue;
+    }
+    EXPECT_LE(newest - oldest, 63);
+
+    const int64_t stamp = newest - 3;
+    if (buffer.getValueInterpolated(stamp, out))
+    {
+      EXPECT_DOUBLE_EQ(static_cast<real_t>(stamp), out(0));
+      EXPECT_DOUBLE_EQ(static_cast<real_t>(-stamp), out(1));
+      ++num_reads;
+    }
+
+    Eigen::Matrix<int64_t, Eigen::Dynamic, 1> stamps;
+    Eigen::Matrix<real_t, 2, Eigen::Dynamic> values;
+    std::tie(stamps, values) =
+        buffer.getBetweenValuesInterpolated(newest - 8, newest - 1);
+    for (int i = 0; i < stamps.size(); ++i)
+    {
+      EXPECT_DOUBLE_EQ(static_cast<real_t>(stamps(i)), values(0, i));
+    }
+  }
+  writer.join();
+
+  VLOG(1) << "Lock-free reads during insertion: " << num_reads;
+  EXPECT_EQ(64u, buffer.size());
+  EXPECT_TRUE(buffer.getValueInterpolated(199999, out));
+  EXPECT_DOUBLE_EQ(199999.0, out(0));
+}
+
+TEST(RingBufferTest, benchmarkBatchInterpolation)
+{
+  if (!FLAGS_run_benchmark) {
+    return;
+  }
+
+  using namespace ze;
+
+  Ringbuffer<real_t, 3, 2048> buffer;
+  for (int i = 0; i < 2048; ++i)
+  {
+    buffer.insert(secToNanosec(i * 0.005), Vector3::Random());
+  }
+
+  // resample at 3x the buffer rate
+  Eigen::Matrix<int64_t, Eigen::Dynamic, 1> stamps(6000);
+  for (int i = 0; i < stamps.size(); ++i)
+  {
+    stamps(i) = secToNanosec(0.001 + i * 0.0017);
+  }
+  Eigen::Matrix<real_t, 3, Eigen::Dynamic> values(3, stamps.size());
+
+  auto perStamp = [&]()
+  {
+    for (int i = 0; i < stamps.size(); ++i)
+    {
+      buffer.getValueInterpolated(stamps(i), values.col(i));
+    }
+  };
+  auto batch = [&]()
+  {
+    buffer.getValuesInterpolated(stamps, values);
+  };
+
+  real_t per_stamp_time = runTimingBenchmark(perStamp, 10, 20,
+                                             "Ringbuffer: Per-stamp", true);
+  real_t batch_time = runTimingBenchmark(batch, 10, 20,
+                                         "Ringbuffer: Batch", true);
+  VLOG(1) << "[Interpolation] Per-stamp/Batch: " << per_stamp_time / batch_time;
+}
+
 TEST(RingBufferTest, benchmarkBufferVsRingBuffer)
 {
   if (!FLAGS_run_benchmark) {
@@ -23,9 +23,15 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <algorithm>
+#include <random>
+
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/running_statistics.hpp>
 #include <ze/common/running_statistics_collection.hpp>
+#include <ze/common/test_utils.hpp>
+#include <ze/common/timer_collection.hpp>
+#include <ze/common/yaml_serialization.hpp>
 
 TEST(RunningStatisticsTest, testRunningStatistics)
 {
@@ -61,5 +67,114 @@ TEST(RunningStatisticsTest, testCollection)
   VLOG(1) << stats;
 }
 
+TEST(RunningStatisticsTest, testQuantiles)
+{
+  using namespace ze;
+
+  // Latencies in milliseconds with a long tail.
+  std::mt19937 gen(10);
+  std::lognormal_distribution<real_t> dist(1.0, 1.0);
+  std::vector<real_t> samples(100000);
+  RunningStatistics stat;
+  for (real_t& x : samples)
+  {
+    x = dist(gen);
+    stat.addSample(x);
+  }
+  std::sort(samples.begin(), samples.end());
+  for (real_t q : {0.0, 0.01, 0.5, 0.95, 0.99, 0.999, 1.0})
+  {
+    const real_t expected = samples[static_cast<size_t>(q * (samples.size() - 1u))];
+    EXPECT_NEAR(expected, stat.quantile(q), 0.01 * expected) << q;
+  }
+  EXPECT_LT(stat.sketch().numBuckets(), 2048u);
+
+  stat.reset();
+  EXPECT_EQ(0.0, stat.quantile(0.5));
+  for (real_t x : {-4.0, -2.0, 0.0, 1.0, 3.0})
+  {
+    stat.addSample(x);
+  }
+  EXPECT_NEAR(-4.0, stat.quantile(0.0), 0.04);
+  EXPECT_NEAR(-2.0, stat.quantile(0.25), 0.02);
+  EXPECT_EQ(0.0, stat.median());
+  EXPECT_NEAR(1.0, stat.quantile(0.75), 0.01);
+  EXPECT_NEAR(3.0, stat.quantile(1.0), 0.03);
+}
+
+TEST(RunningStatisticsTest, testMerge)
+{
+  using namespace ze;
+
+  std::mt19937 gen(10);
+  std::uniform_real_distribution<real_t> dist(1.0, 100.0);
+  RunningStatistics all, a, b;
+  for (int i = 0; i < 1000; ++i)
+  {
+    const real_t x = dist(gen);
+    all.addSample(x);
+    (i % 3 == 0 ? a : b).addSample(x);
+  }
+  a.merge(b);
+  EXPECT_EQ(all.numSamples(), a.numSamples());
+  EXPECT_FLOATTYPE_EQ(all.min(), a.min());
+  EXPECT_FLOATTYPE_EQ(all.max(), a.max());
+  EXPECT_NEAR(all.sum(), a.sum(), 1e-8);
+  EXPECT_NEAR(all.mean(), a.mean(), 1e-10);
+  EXPECT_NEAR(all.var(), a.var(), 1e-8);
+  // The merged sketch is identical.
+  for (real_t q : {0.1, 0.5, 0.9, 0.99})
+  {
+    EXPECT_EQ(all.quantile(q), a.quantile(q));
+  }
+
+  RunningStatistics empty;
+  empty.merge(all);
+  EXPECT_EQ(all.numSamples(), empty.numSamples());
+  EXPECT_EQ(all.quantile(0.9), empty.quantile(0.9));
+}
+
+TEST(RunningStatisticsTest, testSketchBucketLimit)
+{
+  using namespace ze;
+
+  // Samples over 40 orders of magnitude, the smallest buckets are merged.
+  QuantileSketch sketch(0.01, 128u);
+  for (int i = -20; i <= 20; ++i)
+  {
+    sketch.add(std::pow(10.0, i));
+  }
+  EXPECT_EQ(128u, sketch.numBuckets());
+  EXPECT_EQ(41u, sketch.count());
+  EXPECT_NEAR(1e20, sketch.quantile(1.0), 1e18);
+  EXPECT_NEAR(1e19, sketch.quantile(0.975), 1e17);
+}
+
+TEST(RunningStatisticsTest, testTimerCollectionYaml)
+{
+  using namespace ze;
+
+  DECLARE_TIMER(TestTimer, timers, foo, bar);
+  for (int i = 1; i <= 100; ++i)
+  {
+    timers[TestTimer::foo].start();
+    timers[TestTimer::foo].stop();
+  }
+  // E.g. the timers of another thread.
+  TimerCollection<TestTimer> other_timers("foo, bar");
+  other_timers[TestTimer::foo].start();
+  other_timers[TestTimer::foo].stop();
+  timers.merge(other_timers);
+  TemporaryFile file("test_running_statistics_timers");
+  const size_t slash = file.path().rfind('/');
+  timers.saveToFile(file.path().substr(0, slash), file.path().substr(slash + 1));
+
+  YAML::Node node = YAML::LoadFile(file.path());
+  EXPECT_EQ(101, node["foo"]["num_samples"].as<int>());
+  EXPECT_LE(node["foo"]["p50"].as<real_t>(), node["foo"]["p99"].as<real_t>());
+  EXPECT_LE(node["foo"]["p99_9"].as<real_t>(), node["foo"]["max"].as<real_t>());
+  EXPECT_TRUE(node["bar"]["p95"].IsDefined());
+}
+
 ZE_UNITTEST_ENTRYPOINT
 
@@ -0,0 +1,178 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <string>
+#include <unordered_map>
+
+#include <ze/common/random.hpp>
+#include <ze/common/slot_map.hpp>
+#include <ze/common/test_entrypoint.hpp>
+
+namespace {
+
+using Handle = ze::VersionedSlotHandle<uint32_t, 8, 24>;
+
+} // unnamed namespace
+
+TEST(SlotMapTests, testInsertEraseFind)
+{
+  using namespace ze;
+
+  SlotMap<std::string, Handle> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_FALSE(map.contains(Handle()));
+
+  Handle a = map.insert("a");
+  Handle b = map.insert("b");
+  Handle c = map.emplace(3, 'c');
+  EXPECT_EQ(map.size(), 3u);
+  EXPECT_EQ(map[a], "a");
+  EXPECT_EQ(map[c], "ccc");
+  EXPECT_NE(a, b);
+
+  // Erase moves the last element into the hole, handles stay valid.
+  EXPECT_TRUE(map.erase(a));
+  EXPECT_FALSE(map.erase(a));
+  EXPECT_FALSE(map.contains(a));
+  EXPECT_EQ(map.find(a), nullptr);
+  EXPECT_EQ(map.size(), 2u);
+  EXPECT_EQ(*map.find(b), "b");
+  EXPECT_EQ(*map.find(c), "ccc");
+  EXPECT_EQ(map.data()[0], "ccc");
+  EXPECT_EQ(map.handleAt(0), c);
+
+  // The freed slot is reused with a new version.
+  Handle d = map.insert("d");
+  EXPECT_EQ(d.slot, a.slot);
+  EXPECT_NE(d.version, a.version);
+  EXPECT_FALSE(map.contains(a));
+  EXPECT_EQ(map[d], "d");
+
+  std::string concatenated;
+  for (const std::string& s : map)
+  {
+    concatenated += s;
+  }
+  EXPECT_EQ(concatenated, "cccbd");
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_FALSE(map.contains(b));
+  EXPECT_FALSE(map.contains(c));
+  EXPECT_FALSE(map.contains(d));
+}
+
+TEST(SlotMapTests, testVersionWrapAround)
+{
+  using namespace ze;
+
+  // 2 version bits: versions 1, 2, 3, then back to 1.
+  using SmallHandle = VersionedSlotHandle<uint32_t, 8, 2>;
+  SlotMap<int, SmallHandle> map;
+  SmallHandle h;
+  for (int i = 0; i < 5; ++i)
+  {
+    h = map.insert(i);
+    EXPECT_EQ(h.slot, 0u);
+    EXPECT_NE(h.version, 0u);
+    map.erase(h);
+  }
+  EXPECT_EQ(h.version, 2u);
+}
+
+TEST(SlotMapTests, testStaleHandleOfFreeSlotAfterWrapAround)
+{
+  using namespace ze;
+
+  // After 3 erase/insert cycles, the free slot has the version of h again.
+  using SmallHandle = VersionedSlotHandle<uint32_t, 8, 2>;
+  SlotMap<int, SmallHandle> map;
+  const SmallHandle h = map.insert(0);
+  map.erase(h);
+  for (int i = 0; i < 2; ++i)
+  {
+    map.erase(map.insert(i));
+  }
+  EXPECT_FALSE(map.contains(h));
+  EXPECT_EQ(map.find(h), nullptr);
+  EXPECT_FALSE(map.erase(h));
+
+  // The same holds for a slot further down the free list.
+  const SmallHandle a = map.insert(1);
+  const SmallHandle b = map.insert(2);
+  map.erase(b);
+  map.erase(a);
+  for (int i = 0; i < 2; ++i)
+  {
+    const SmallHandle first = map.insert(i);
+    const SmallHandle second = map.insert(i);
+    map.erase(second);
+    map.erase(first);
+  }
+  EXPECT_FALSE(map.contains(a));
+  EXPECT_FALSE(map.contains(b));
+  EXPECT_EQ(map.find(b), nullptr);
+  EXPECT_TRUE(map.empty());
+
+  // Occupying the slot again validates the handle with that version.
+  SmallHandle reused = map.insert(7);
+  EXPECT_TRUE(map.contains(reused));
+  EXPECT_EQ(map[reused], 7);
+}
+
+TEST(SlotMapTests, testRandomOperations)
+{
+  using namespace ze;
+
+  // Compare against unordered_map as reference.
+  SlotMap<int, Handle> map;
+  std::unordered_map<uint32_t, int> reference;
+  std::vector<Handle> handles;
+  for (int i = 0; i < 10000; ++i)
+  {
+    if (handles.empty() || (map.size() < 200u && flipCoin(true, 0.6)))
+    {
+      Handle h = map.insert(i);
+      handles.push_back(h);
+      reference[h.handle] = i;
+    }
+    else
+    {
+      const size_t k = sampleUniformIntDistribution<size_t>(true, 0u, handles.size() - 1u);
+      const bool live = reference.count(handles[k].handle) > 0u;
+      EXPECT_EQ(map.erase(handles[k]), live);
+      reference.erase(handles[k].handle);
+      handles[k] = handles.back();
+      handles.pop_back();
+    }
+    ASSERT_EQ(map.size(), reference.size());
+  }
+  for (size_t i = 0u; i < map.size(); ++i)
+  {
+    EXPECT_EQ(reference.at(map.handleAt(i).handle), map.data()[i]);
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -24,12 +24,16 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cmath>
+#include <random>
 #include <utility>
+#include <ze/common/benchmark.hpp>
 #include <ze/common/types.hpp>
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/statistics.hpp>
 #include <ze/common/random_matrix.hpp>
 
+DEFINE_bool(run_benchmark, false, "Benchmark the median computation.");
+
 TEST(StatisticsTest, testMedian)
 {
   Eigen::VectorXd x(5);
@@ -38,6 +42,74 @@ TEST(StatisticsTest, testMedian)
   EXPECT_DOUBLE_EQ(m.first, 3);
 }
 
+TEST(StatisticsTest, testMedianVariants)
+{
+  using namespace ze;
+
+  std::mt19937 gen(10);
+  std::normal_distribution<real_t> dist(1.0, 3.0);
+  std::vector<real_t> scratch;
+  for (int n : {1, 2, 7, 100, 1001})
+  {
+    VectorX x(n);
+    for (int i = 0; i < n; ++i)
+    {
+      x(i) = dist(gen);
+    }
+    std::vector<real_t> sorted(x.data(), x.data() + n);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<real_t> sorted_abs(n);
+    for (int i = 0; i < n; ++i)
+    {
+      sorted_abs[i] = std::abs(x(i));
+    }
+    std::sort(sorted_abs.begin(), sorted_abs.end());
+
+    EXPECT_EQ(sorted[n / 2], median(x).first);
+    EXPECT_EQ(sorted[n / 2], median(x, &scratch).first);
+    EXPECT_EQ(sorted_abs[n / 2], medianOfAbsoluteValues(x, &scratch).first);
+
+    const real_t range = sorted.back() - sorted.front();
+    EXPECT_NEAR(sorted[n / 2], approximateMedian(x).first, range * 1e-5);
+    EXPECT_NEAR(sorted_abs[n / 2], approximateMedianOfAbsoluteValues(x).first,
+                sorted_abs.back() * 1e-5);
+  }
+
+  VectorX constant = VectorX::Constant(10, 2.5);
+  EXPECT_EQ(2.5, approximateMedian(constant).first);
+  EXPECT_FALSE(approximateMedian(VectorX()).second);
+  EXPECT_FALSE(median(VectorX(), &scratch).second);
+}
+
+TEST(StatisticsTest, benchmarkMedian)
+{
+  if (!FLAGS_run_benchmark)
+  {
+    return;
+  }
+
+  using namespace ze;
+  for (int n : {100, 1000, 10000, 1000000})
+  {
+    VectorX x = VectorX::Random(n);
+    std::vector<real_t> scratch;
+    real_t m = 0.0;
+    auto copy = [&]() {
+      VectorX abs_x = x.array().abs();
+      std::vector<real_t> v = eigenVectorToStlVector(abs_x);
+      m += median(v).first;
+    };
+    auto fused = [&]() { m += medianOfAbsoluteValues(x, &scratch).first; };
+    auto histogram = [&]() { m += approximateMedianOfAbsoluteValues(x).first; };
+    const std::string size = std::to_string(n);
+    real_t t_copy = runTimingBenchmark(copy, 10, 10, "Copy and median " + size, true);
+    real_t t_fused = runTimingBenchmark(fused, 10, 10, "Fused median " + size, true);
+    real_t t_histogram = runTimingBenchmark(histogram, 10, 10, "Histogram median " + size, true);
+    VLOG(1) << "n = " << n << ": fused " << t_copy / t_fused << "x, histogram "
+            << t_copy / t_histogram << "x faster";
+  }
+}
+
 TEST(StatisticsTest, testMeasurementCovariance)
 {
   using namespace ze;
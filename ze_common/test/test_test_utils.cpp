@@ -24,6 +24,7 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cmath>
+#include <fstream>
 
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/test_utils.hpp>
@@ -44,4 +45,19 @@ TEST(TestUtilsTest, testLoadCsvPoses)
   EXPECT_FLOATTYPE_EQ(poses[1].getPosition().x(), real_t{1.499260});
 }
 
+TEST(TestUtilsTest, testTemporaryFile)
+{
+  using namespace ze;
+
+  std::string path;
+  {
+    TemporaryFile a("test_test_utils");
+    TemporaryFile b("test_test_utils");
+    EXPECT_NE(a.path(), b.path());
+    EXPECT_TRUE(std::ifstream(a.path()).good());
+    path = a.path();
+  }
+  EXPECT_FALSE(std::ifstream(path).good());
+}
+
 ZE_UNITTEST_ENTRYPOINT
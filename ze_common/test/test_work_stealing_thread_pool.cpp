@@ -0,0 +1,211 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/logging.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/thread_pool.hpp>
+#include <ze/common/work_stealing_thread_pool.hpp>
+
+TEST(WorkStealingThreadPoolTests, testSubmitAndTaskGroup)
+{
+  ze::WorkStealingThreadPool pool(4);
+  EXPECT_EQ(pool.numThreads(), 4u);
+
+  std::vector<size_t> results(100, 0u);
+  {
+    ze::TaskGroup group(pool);
+    for (size_t i = 0u; i < results.size(); ++i)
+    {
+      group.run([i, &results] { results[i] = i * i; });
+    }
+    group.wait();
+    EXPECT_EQ(group.numPending(), 0u);
+  }
+
+  for (size_t i = 0u; i < results.size(); ++i)
+  {
+    EXPECT_EQ(results[i], i * i);
+  }
+}
+
+TEST(WorkStealingThreadPoolTests, testNestedTaskGroups)
+{
+  ze::WorkStealingThreadPool pool(3);
+  std::atomic<int> counter(0);
+  ze::TaskGroup outer(pool);
+  for (int i = 0; i < 10; ++i)
+  {
+    outer.run([&pool, &counter] {
+      // Waiting inside a worker must not deadlock, it executes tasks instead.
+      ze::TaskGroup inner(pool);
+      for (int j = 0; j < 10; ++j)
+      {
+        inner.run([&counter] { ++counter; });
+      }
+      inner.wait();
+    });
+  }
+  outer.wait();
+  EXPECT_EQ(counter.load(), 100);
+}
+
+TEST(WorkStealingThreadPoolTests, testParallelFor)
+{
+  ze::WorkStealingThreadPool pool(4);
+  std::vector<int> values(10007, 0);
+  std::atomic<size_t> num_chunks(0u);
+  pool.parallelFor(0u, values.size(), 64u, [&](size_t begin, size_t end) {
+    EXPECT_LE(end - begin, 64u);
+    for (size_t i = begin; i < end; ++i)
+    {
+      values[i] += 1;
+    }
+    ++num_chunks;
+  });
+
+  for (int v : values)
+  {
+    EXPECT_EQ(v, 1);
+  }
+  EXPECT_GE(num_chunks.load(), values.size() / 64u);
+
+  // Empty and single-chunk ranges run inline.
+  pool.parallelFor(5u, 5u, 1u, [](size_t, size_t) { FAIL(); });
+  size_t calls = 0u;
+  pool.parallelFor(0u, 10u, 100u, [&](size_t begin, size_t end) {
+    EXPECT_EQ(begin, 0u);
+    EXPECT_EQ(end, 10u);
+    ++calls;
+  });
+  EXPECT_EQ(calls, 1u);
+}
+
+TEST(WorkStealingThreadPoolTests, testLargeClosure)
+{
+  ze::WorkStealingThreadPool pool(2);
+  std::array<double, 32> payload;
+  payload.fill(1.0);
+  std::atomic<int> sum(0);
+  ze::TaskGroup group(pool);
+  for (int i = 0; i < 8; ++i)
+  {
+    // Exceeds the inline storage of WorkStealingTask.
+    group.run([payload, &sum] {
+      sum += static_cast<int>(std::accumulate(payload.begin(), payload.end(), 0.0));
+    });
+  }
+  group.wait();
+  EXPECT_EQ(sum.load(), 8 * 32);
+}
+
+TEST(WorkStealingThreadPoolTests, testTaskException)
+{
+  ze::WorkStealingThreadPool pool(2);
+  std::atomic<int> counter(0);
+  ze::TaskGroup group(pool);
+  for (int i = 0; i < 10; ++i)
+  {
+    group.run([i, &counter] {
+      if (i == 3)
+      {
+        throw std::runtime_error("task failed");
+      }
+      ++counter;
+    });
+  }
+  // wait() must return once the other tasks are done and rethrow the error.
+  EXPECT_THROW(group.wait(), std::runtime_error);
+  EXPECT_EQ(group.numPending(), 0u);
+  EXPECT_EQ(counter.load(), 9);
+
+  // The exception is only reported once.
+  group.run([&counter] { ++counter; });
+  EXPECT_NO_THROW(group.wait());
+  EXPECT_EQ(counter.load(), 10);
+}
+
+TEST(WorkStealingThreadPoolTests, benchmarkSmallTasks)
+{
+  using namespace ze;
+
+  constexpr size_t num_threads = 4u;
+  constexpr size_t num_tasks = 10000u;
+  std::vector<double> data(num_tasks, 1.0);
+  auto work = [&data](size_t i) { data[i] = std::sqrt(data[i] + i); };
+
+  ThreadPool queue_pool(num_threads);
+  auto runThreadPool = [&]() {
+    std::vector<std::future<void>> futures;
+    futures.reserve(num_tasks);
+    for (size_t i = 0u; i < num_tasks; ++i)
+    {
+      futures.emplace_back(queue_pool.enqueue(work, i));
+    }
+    for (std::future<void>& f : futures)
+    {
+      f.get();
+    }
+  };
+
+  WorkStealingThreadPool stealing_pool(num_threads);
+  auto runTaskGroup = [&]() {
+    TaskGroup group(stealing_pool);
+    for (size_t i = 0u; i < num_tasks; ++i)
+    {
+      group.run([&work, i] { work(i); });
+    }
+    group.wait();
+  };
+
+  auto runParallelFor = [&]() {
+    stealing_pool.parallelFor(0u, num_tasks, 64u, [&work](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+      {
+        work(i);
+      }
+    });
+  };
+
+  uint64_t t_thread_pool = runTimingBenchmark(
+        runThreadPool, 10, 5, "ThreadPool::enqueue", true);
+  uint64_t t_task_group = runTimingBenchmark(
+        runTaskGroup, 10, 5, "TaskGroup::run", true);
+  uint64_t t_parallel_for = runTimingBenchmark(
+        runParallelFor, 10, 5, "WorkStealingThreadPool::parallelFor", true);
+  VLOG(1) << "Speedup TaskGroup vs ThreadPool: "
+          << static_cast<double>(t_thread_pool) / t_task_group
+          << ", parallelFor vs ThreadPool: "
+          << static_cast<double>(t_thread_pool) / t_parallel_for;
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -26,7 +26,9 @@
 #pragma once
 
 #include <memory>
+#include <tuple>
 #include <imp/core/image_base.hpp>
+#include <ze/common/frame_arena.hpp>
 #include <ze/common/types.hpp>
 #include <ze/common/time_conversions.hpp>
 #include <ze/imu/imu_buffer.hpp>
@@ -38,6 +40,9 @@ class DataProviderBase;
 // convenience typedefs
 using ImuStampsVector = std::vector<ImuStamps>;
 using ImuAccGyrVector = std::vector<ImuAccGyrContainer>;
+//! Oldest and newest stamp per IMU and whether the buffer has data. Allocated
+//! in the frame arena, it only lives during one synchronization step.
+using ImuStampRangeVector = FrameVector<std::tuple<int64_t, int64_t, bool>>;
 
 // callback typedefs
 using SynchronizedCameraImuCallback =
@@ -106,7 +111,7 @@ protected:
   bool validateImuBuffers(
       const int64_t& min_stamp,
       const int64_t& max_stamp,
-      const std::vector<std::tuple<int64_t, int64_t, bool>>& oldest_newest_stamp_vector);
+      const ImuStampRangeVector& oldest_newest_stamp_vector);
 
   //! Max time difference of images in a bundle
   int64_t img_bundle_max_dt_nsec_ = millisecToNanosec(2.0);
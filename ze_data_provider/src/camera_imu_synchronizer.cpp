@@ -87,7 +87,10 @@ void CameraImuSynchronizer::checkImuDataAndCallback()
   if (num_imus_ != 0)
   {
     // get oldest / newest stamp for all imu buffers
-    std::vector<std::tuple<int64_t, int64_t, bool>> oldest_newest_stamp_vector(num_imus_);
+    FrameScope scope;
+    ImuStampRangeVector oldest_newest_stamp_vector(
+          num_imus_, std::make_tuple(int64_t{-1}, int64_t{-1}, false),
+          scope.allocator<std::tuple<int64_t, int64_t, bool>>());
     std::transform(
           imu_buffers_.begin(),
           imu_buffers_.end(),
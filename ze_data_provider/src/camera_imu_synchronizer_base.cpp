@@ -140,8 +140,7 @@ void CameraImuSynchronizerBase::addImgData(
 bool CameraImuSynchronizerBase::validateImuBuffers(
     const int64_t& min_stamp,
     const int64_t& max_stamp,
-    const std::vector<std::tuple<int64_t, int64_t, bool> >&
-      oldest_newest_stamp_vector)
+    const ImuStampRangeVector& oldest_newest_stamp_vector)
 {
   // Check if we have received some IMU measurements for at least one of the imu's.
   if (std::none_of(oldest_newest_stamp_vector.begin(),
@@ -42,22 +42,26 @@ namespace ze {
 template <typename Scalar>
 struct UnitScaleEstimator
 {
-  static constexpr Scalar compute(const VectorX& /*errors*/)
+  static constexpr Scalar compute(const Eigen::Ref<const VectorX>& /*errors*/)
   {
     return Scalar{1.0};
   }
 };
 
 //! Estimates scale by computing the median absolute deviation (MAD).
+//! Called in every iteration of the solvers, so the absolute values go to a
+//! thread-local scratch buffer that is reused. Always uses the exact median:
+//! the histogram-based one is spread over the full range and breaks down on
+//! the gross outliers this estimator is meant to reject.
 template <typename Scalar>
 struct MADScaleEstimator
 {
   using VectorX = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
-  static Scalar compute(const VectorX& errors)
+
+  static Scalar compute(const Eigen::Ref<const VectorX>& errors)
   {
-    VectorX absolute_error(errors.size());
-    absolute_error = errors.array().abs();
-    std::pair<Scalar, bool> res = median(absolute_error);
+    static thread_local std::vector<Scalar> scratch;
+    const std::pair<Scalar, bool> res = medianOfAbsoluteValues(errors, &scratch);
     CHECK(res.second);
     return Scalar{1.48} * res.first; // 1.48f / 0.6745
   }
@@ -68,7 +72,7 @@ template <typename Scalar>
 struct NormalDistributionScaleEstimator
 {
   using VectorX = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
-  static Scalar compute(const VectorX& errors)
+  static Scalar compute(const Eigen::Ref<const VectorX>& errors)
   {
     // normed_errors should not have absolute values.
     const int n = errors.size();
@@ -93,14 +97,22 @@ template <typename Scalar, typename Implementation>
 struct WeightFunction
 {
   using VectorX = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
-  static VectorX weightVectorized(const VectorX& error_vec)
+  static VectorX weightVectorized(const Eigen::Ref<const VectorX>& error_vec)
   {
     VectorX weights(error_vec.size());
+    weightVectorized(error_vec, weights);
+    return weights;
+  }
+
+  //! Writes the weights into preallocated storage, e.g. a frame arena.
+  static void weightVectorized(
+      const Eigen::Ref<const VectorX>& error_vec, Eigen::Ref<VectorX> weights)
+  {
+    DEBUG_CHECK_EQ(weights.size(), error_vec.size());
     for(int i = 0; i < error_vec.size(); ++i)
     {
       weights(i) = Implementation::weight(error_vec(i));
     }
-    return weights;
   }
 
   static real_t weight(const real_t error)
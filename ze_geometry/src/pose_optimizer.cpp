@@ -30,6 +30,7 @@
 #include <algorithm>
 
 #include <ze/cameras/camera.hpp>
+#include <ze/common/frame_arena.hpp>
 #include <ze/common/logging.hpp>
 #include <ze/common/matrix.hpp>
 #include <ze/common/stl_utils.hpp>
@@ -93,68 +94,39 @@ void PoseOptimizer::setPrior(
   prior_weight_rot_ = prior_weight_rot;
 }
 
-//------------------------------------------------------------------------------
-real_t PoseOptimizer::evaluateError(
-    const Transformation& T_B_W, HessianMatrix* H, GradientVector* g)
-{
-  real_t chi2 = real_t{0.0};
-
-  // Loop over all cameras in rig.
-  VLOG(400) << "Num residual blocks = " << data_.size();
-  for (auto& residual_block : data_)
-  {
-    VLOG(400) << "Process residual block " << residual_block.camera_idx;
-    if (residual_block.kp_idx.size() == 0 && residual_block.lines_W.empty())
-    {
-      VLOG(40) << "Residual block has no measurements.";
-      continue;
-    }
-
-    switch (residual_block.type)
-    {
-      case PoseOptimizerResidualType::Bearing:
-        chi2 += evaluateBearingErrors(T_B_W, iter_ == 0, residual_block, H, g).first;
-        break;
-      case PoseOptimizerResidualType::UnitPlane:
-        chi2 += evaluateUnitPlaneErrors(T_B_W, iter_ == 0, residual_block, H, g).first;
-        break;
-      case PoseOptimizerResidualType::Line:
-        chi2 += evaluateLineErrors(T_B_W, iter_ == 0, residual_block, H, g).first;
-        break;
-      default:
-        LOG(FATAL) << "Residual type not implemented.";
-        break;
-    }
-  }
-
-  // Apply prior.
-  if (prior_weight_rot_ > real_t{0.0} || prior_weight_pos_ > real_t{0.0})
-  {
-    applyPosePrior(T_B_W, T_B_W_prior_, prior_weight_rot_, prior_weight_pos_, *H, *g);
-  }
+namespace {
 
-  return chi2;
-}
+// The error terms are evaluated in every solver iteration. All temporaries live
+// in the frame arena and the error norms are written to err_norm, such that
+// evaluateError() does not touch the heap once the arena is warm.
 
 //------------------------------------------------------------------------------
-std::pair<real_t, VectorX> evaluateBearingErrors(
+real_t bearingErrors(
     const Transformation& T_B_W,
     const bool first_iteration,
     PoseOptimizerFrameData& data,
     PoseOptimizer::HessianMatrix* H,
-    PoseOptimizer::GradientVector* g)
+    PoseOptimizer::GradientVector* g,
+    MonotonicArena& arena,
+    Eigen::Ref<VectorX> f_err_norm)
 {
+  const int n = data.f.cols();
+
   // Transform points from world coordinates to camera coordinates.
   const Transformation T_C_W = data.T_C_B * T_B_W;
-  Positions p_C = T_C_W.transformVectorized(data.p_W);
-
-  // Normalize points to obtain estimated bearing vectors.
-  Bearings f_est = p_C;
-  normalizeBearings(f_est);
-
-  // Compute difference between bearing vectors.
-  Bearings f_err = f_est - data.f;
-  VectorX f_err_norm = f_err.colwise().norm();
+  const Matrix3 R_C_W = T_C_W.getRotationMatrix();
+  auto p_C = arenaMatrix<Positions>(arena, 3, n);
+  p_C.noalias() = R_C_W * data.p_W;
+  p_C.colwise() += T_C_W.getPosition();
+
+  // Normalize points to obtain estimated bearing vectors and compute
+  // difference between bearing vectors.
+  auto f_err = arenaMatrix<Bearings>(arena, 3, n);
+  for (int i = 0; i < n; ++i)
+  {
+    f_err.col(i) = p_C.col(i).normalized() - data.f.col(i);
+  }
+  f_err_norm = f_err.colwise().norm().transpose();
 
   // Account that features at higher levels have higher uncertainty.
   f_err_norm.array() /= data.scale.array();
@@ -166,16 +138,15 @@ std::pair<real_t, VectorX> evaluateBearingErrors(
   }
 
   // Robust cost function.
-  VectorX weights = PoseOptimizer::WeightFunction::weightVectorized(
-                      f_err_norm.array() / data.measurement_sigma);
+  auto weights = arenaVector<VectorX>(arena, n);
+  weights = f_err_norm / data.measurement_sigma;
+  PoseOptimizer::WeightFunction::weightVectorized(weights, weights);
 
   // Instead of whitening the error and the Jacobian, we apply sigma to the weights:
   weights.array() /= (data.scale.array() * data.measurement_sigma * data.measurement_sigma);
 
   if (H && g)
   {
-    const Matrix3 R_C_W = T_C_W.getRotationMatrix();
-    const int n = data.f.cols();
     Matrix36 G;
     G.block<3,3>(0,0) = I_3x3;
     for (int i = 0; i < n; ++i)
@@ -192,30 +163,44 @@ std::pair<real_t, VectorX> evaluateBearingErrors(
   }
 
   // Compute log-likelihood : 1/(2*sigma^2)*(z-h(x))^2 = 1/2*e'R'*R*e
-  return std::make_pair(real_t{0.5} * weights.dot(f_err.colwise().squaredNorm()),
-                        f_err_norm);
+  return real_t{0.5} * weights.dot(f_err.colwise().squaredNorm().transpose());
 }
 
 //------------------------------------------------------------------------------
-std::pair<real_t, VectorX> evaluateUnitPlaneErrors(
+real_t unitPlaneErrors(
     const Transformation& T_B_W,
     const bool first_iteration,
     PoseOptimizerFrameData& data,
     PoseOptimizer::HessianMatrix* H,
-    PoseOptimizer::GradientVector* g)
+    PoseOptimizer::GradientVector* g,
+    MonotonicArena& arena,
+    Eigen::Ref<VectorX> uv_err_norm)
 {
+  const int n = data.f.cols();
   if (first_iteration)
   {
-    data.uv = project2Vectorized(data.f);
+    // Resizing keeps the storage of the previous frame if the size matches.
+    data.uv.resize(Eigen::NoChange, n);
+    for (int i = 0; i < n; ++i)
+    {
+      data.uv.col(i) = project2(data.f.col(i));
+    }
   }
 
   // Transform points from world coordinates to camera coordinates.
   const Transformation T_C_W = data.T_C_B * T_B_W;
-  Positions p_C = T_C_W.transformVectorized(data.p_W);
+  const Matrix3 R_C_W = T_C_W.getRotationMatrix();
+  auto p_C = arenaMatrix<Positions>(arena, 3, n);
+  p_C.noalias() = R_C_W * data.p_W;
+  p_C.colwise() += T_C_W.getPosition();
 
   // Compute difference on unit plane.
-  Keypoints uv_err = project2Vectorized(p_C) - data.uv;
-  VectorX uv_err_norm = uv_err.colwise().norm();
+  auto uv_err = arenaMatrix<Keypoints>(arena, 2, n);
+  for (int i = 0; i < n; ++i)
+  {
+    uv_err.col(i) = project2(p_C.col(i)) - data.uv.col(i);
+  }
+  uv_err_norm = uv_err.colwise().norm().transpose();
 
   // Account that features at higher levels have higher uncertainty.
   uv_err_norm.array() /= data.scale.array();
@@ -228,16 +213,15 @@ std::pair<real_t, VectorX> evaluateUnitPlaneErrors(
   }
 
   // Robust cost function.
-  VectorX weights = PoseOptimizer::WeightFunction::weightVectorized(
-                      uv_err_norm.array() / data.measurement_sigma);
+  auto weights = arenaVector<VectorX>(arena, n);
+  weights = uv_err_norm / data.measurement_sigma;
+  PoseOptimizer::WeightFunction::weightVectorized(weights, weights);
 
   // Instead of whitening the error and the Jacobian, we apply sigma to the weights:
   weights.array() /= (data.scale.array() * data.measurement_sigma * data.measurement_sigma);
 
   if (H && g)
   {
-    const Matrix3 R_C_W = T_C_W.getRotationMatrix();
-    const int n = data.f.cols();
     Matrix36 G;
     G.block<3,3>(0,0) = I_3x3;
     for (int i = 0; i < n; ++i)
@@ -254,31 +238,33 @@ std::pair<real_t, VectorX> evaluateUnitPlaneErrors(
   }
 
   // Compute log-likelihood : 1/(2*sigma^2)*(z-h(x))^2 = 1/2*e'R'*R*e
-  return std::make_pair(real_t{0.5} * weights.dot(uv_err.colwise().squaredNorm()),
-                        uv_err_norm);
+  return real_t{0.5} * weights.dot(uv_err.colwise().squaredNorm().transpose());
 }
 
 //------------------------------------------------------------------------------
-std::pair<real_t, VectorX> evaluateLineErrors(
+real_t lineErrors(
     const Transformation& T_B_W,
     const bool first_iteration,
     PoseOptimizerFrameData& data,
     PoseOptimizer::HessianMatrix* H,
-    PoseOptimizer::GradientVector* g)
+    PoseOptimizer::GradientVector* g,
+    MonotonicArena& arena,
+    Eigen::Ref<VectorX> error_norm)
 {
   const Transformation T_C_W = data.T_C_B * T_B_W;
   const Matrix3 R_C_W = T_C_W.getRotationMatrix();
   const Vector3 camera_pos_W = T_C_W.inverse().getPosition();
   // Compute error.
-  const Matrix3X line_measurements_W = R_C_W.transpose() * data.line_measurements_C;
   const size_t n = data.line_measurements_C.cols();
-  Matrix2X error(2, n);
+  auto line_measurements_W = arenaMatrix<Matrix3X>(arena, 3, n);
+  line_measurements_W.noalias() = R_C_W.transpose() * data.line_measurements_C;
+  auto error = arenaMatrix<Matrix2X>(arena, 2, n);
   for (size_t i = 0; i < n; ++i)
   {
     error.col(i) = data.lines_W[i].calculateMeasurementError(line_measurements_W.col(i),
                                                              camera_pos_W);
   }
-  VectorX error_norm = error.colwise().norm();
+  error_norm = error.colwise().norm().transpose();
 
   // At the first iteration, compute the scale of the error.
   if (first_iteration)
@@ -286,12 +272,9 @@ std::pair<real_t, VectorX> evaluateLineErrors(
     data.measurement_sigma = PoseOptimizer::ScaleEstimator::compute(error_norm);
   }
 
-  // Robust cost function.
-  VectorX weights(n);
-  weights.setOnes();
-
-  // Instead of whitening the error and the Jacobian, we apply sigma to the weights:
-  // weights.array() /= (data.measurement_sigma * data.measurement_sigma);
+  // Robust cost function: unit weights.
+  // Instead of whitening the error and the Jacobian, we would apply sigma to
+  // the weights: weights.array() /= (data.measurement_sigma * data.measurement_sigma);
 
   if (H && g)
   {
@@ -304,13 +287,114 @@ std::pair<real_t, VectorX> evaluateLineErrors(
                                           data.lines_W[i].direction());
 
       // Compute Hessian and Gradient Vector.
-      H->noalias() += J.transpose() * J * weights(i);
-      g->noalias() -= J.transpose() * error.col(i) * weights(i);
+      H->noalias() += J.transpose() * J;
+      g->noalias() -= J.transpose() * error.col(i);
     }
   }
 
-  return std::make_pair(real_t{0.5} * weights.dot(error.colwise().squaredNorm()),
-                        error_norm);
+  return real_t{0.5} * error.squaredNorm();
+}
+
+//------------------------------------------------------------------------------
+inline int numErrorTerms(const PoseOptimizerFrameData& data)
+{
+  return data.type == PoseOptimizerResidualType::Line
+      ? data.line_measurements_C.cols() : data.f.cols();
+}
+
+} // unnamed namespace
+
+//------------------------------------------------------------------------------
+real_t PoseOptimizer::evaluateError(
+    const Transformation& T_B_W, HessianMatrix* H, GradientVector* g)
+{
+  real_t chi2 = real_t{0.0};
+
+  // Loop over all cameras in rig.
+  VLOG(400) << "Num residual blocks = " << data_.size();
+  for (auto& residual_block : data_)
+  {
+    VLOG(400) << "Process residual block " << residual_block.camera_idx;
+    if (residual_block.kp_idx.size() == 0 && residual_block.lines_W.empty())
+    {
+      VLOG(40) << "Residual block has no measurements.";
+      continue;
+    }
+
+    FrameScope scope;
+    auto err_norm = arenaVector<VectorX>(scope.arena(), numErrorTerms(residual_block));
+    switch (residual_block.type)
+    {
+      case PoseOptimizerResidualType::Bearing:
+        chi2 += bearingErrors(T_B_W, iter_ == 0, residual_block, H, g,
+                              scope.arena(), err_norm);
+        break;
+      case PoseOptimizerResidualType::UnitPlane:
+        chi2 += unitPlaneErrors(T_B_W, iter_ == 0, residual_block, H, g,
+                                scope.arena(), err_norm);
+        break;
+      case PoseOptimizerResidualType::Line:
+        chi2 += lineErrors(T_B_W, iter_ == 0, residual_block, H, g,
+                           scope.arena(), err_norm);
+        break;
+      default:
+        LOG(FATAL) << "Residual type not implemented.";
+        break;
+    }
+  }
+
+  // Apply prior.
+  if (prior_weight_rot_ > real_t{0.0} || prior_weight_pos_ > real_t{0.0})
+  {
+    applyPosePrior(T_B_W, T_B_W_prior_, prior_weight_rot_, prior_weight_pos_, *H, *g);
+  }
+
+  return chi2;
+}
+
+//------------------------------------------------------------------------------
+std::pair<real_t, VectorX> evaluateBearingErrors(
+    const Transformation& T_B_W,
+    const bool first_iteration,
+    PoseOptimizerFrameData& data,
+    PoseOptimizer::HessianMatrix* H,
+    PoseOptimizer::GradientVector* g)
+{
+  FrameScope scope;
+  VectorX f_err_norm(data.f.cols());
+  const real_t chi2 =
+      bearingErrors(T_B_W, first_iteration, data, H, g, scope.arena(), f_err_norm);
+  return std::make_pair(chi2, f_err_norm);
+}
+
+//------------------------------------------------------------------------------
+std::pair<real_t, VectorX> evaluateUnitPlaneErrors(
+    const Transformation& T_B_W,
+    const bool first_iteration,
+    PoseOptimizerFrameData& data,
+    PoseOptimizer::HessianMatrix* H,
+    PoseOptimizer::GradientVector* g)
+{
+  FrameScope scope;
+  VectorX uv_err_norm(data.f.cols());
+  const real_t chi2 =
+      unitPlaneErrors(T_B_W, first_iteration, data, H, g, scope.arena(), uv_err_norm);
+  return std::make_pair(chi2, uv_err_norm);
+}
+
+//------------------------------------------------------------------------------
+std::pair<real_t, VectorX> evaluateLineErrors(
+    const Transformation& T_B_W,
+    const bool first_iteration,
+    PoseOptimizerFrameData& data,
+    PoseOptimizer::HessianMatrix* H,
+    PoseOptimizer::GradientVector* g)
+{
+  FrameScope scope;
+  VectorX error_norm(data.line_measurements_C.cols());
+  const real_t chi2 =
+      lineErrors(T_B_W, first_iteration, data, H, g, scope.arena(), error_norm);
+  return std::make_pair(chi2, error_norm);
 }
 
 //------------------------------------------------------------------------------
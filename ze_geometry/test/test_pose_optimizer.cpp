@@ -25,6 +25,7 @@
 
 #include <random>
 #include <ze/common/benchmark.hpp>
+#include <ze/common/test_allocation_counter.hpp>
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/matrix.hpp>
 #include <ze/common/timer.hpp>
@@ -36,6 +37,8 @@
 #include <ze/geometry/pose_optimizer.hpp>
 #include <ze/geometry/robust_cost.hpp>
 
+ZE_ALLOCATION_COUNTING_HOOK
+
 namespace ze {
 
 void testPoseOptimizer(
@@ -139,6 +142,25 @@ TEST(PoseOptimizerTests, testSolver)
         10.0, 0.0, T_B_W, T_B_W_perturbed, data, "Bearing, Rotation Prior");
   testPoseOptimizer(
         10.0, 10.0, T_B_W, T_B_W_perturbed, data, "Bearing, Rotation and Position Prior");
+
+  // Once the frame arena is warm, evaluating the error does not allocate.
+  PoseOptimizerFrameDataVec data_vec = { data };
+  PoseOptimizer optimizer(
+        PoseOptimizer::getDefaultSolverOptions(), data_vec, T_B_W, 10.0, 10.0);
+  for (PoseOptimizerResidualType type : { PoseOptimizerResidualType::UnitPlane,
+                                          PoseOptimizerResidualType::Bearing })
+  {
+    data_vec[0].type = type;
+    PoseOptimizer::HessianMatrix H = PoseOptimizer::HessianMatrix::Zero();
+    PoseOptimizer::GradientVector g = PoseOptimizer::GradientVector::Zero();
+    optimizer.evaluateError(T_B_W_perturbed, &H, &g);
+    AllocationCounter counter;
+    for (int i = 0; i < 10; ++i)
+    {
+      optimizer.evaluateError(T_B_W_perturbed, &H, &g);
+    }
+    EXPECT_EQ(counter.count(), 0u);
+  }
 }
 
 TEST(PoseOptimizerTests, testSolver_withLines)
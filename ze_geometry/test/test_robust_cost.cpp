@@ -24,6 +24,7 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cmath>
+#include <limits>
 #include <random>
 #include <utility>
 #include <ze/common/test_entrypoint.hpp>
@@ -51,6 +52,38 @@ TEST(RobustCostTest, testScaleEstimators)
 
   double s3 = MADScaleEstimator<real_t>::compute(errors);
   EXPECT_TRUE(std::abs(s3 - 3.0) < 0.2);
+
+  VectorX many_errors(100000);
+  for(int i = 0; i < many_errors.size(); ++i)
+    many_errors(i) = noise(gen);
+  double s4 = MADScaleEstimator<real_t>::compute(many_errors);
+  EXPECT_TRUE(std::abs(s4 - 3.0) < 0.05);
+}
+
+TEST(RobustCostTest, testMADScaleEstimatorOutliers)
+{
+  using namespace ze;
+
+  std::ranlux24 gen;
+  std::normal_distribution<real_t> noise(0.0, 1.0);
+  VectorX errors(20000);
+  for(int i = 0; i < errors.size(); ++i)
+    errors(i) = noise(gen);
+  const real_t s = MADScaleEstimator<real_t>::compute(errors);
+  EXPECT_TRUE(std::abs(s - 1.0) < 0.05);
+
+  // A single gross outlier must not change the scale noticeably.
+  VectorX with_outlier = errors;
+  with_outlier(0) = 1e7;
+  const real_t s_outlier = MADScaleEstimator<real_t>::compute(with_outlier);
+  EXPECT_TRUE(std::abs(s_outlier - s) < 1e-3);
+
+  // Neither must a non-finite residual.
+  VectorX with_inf = errors;
+  with_inf(0) = std::numeric_limits<real_t>::infinity();
+  const real_t s_inf = MADScaleEstimator<real_t>::compute(with_inf);
+  EXPECT_TRUE(std::isfinite(s_inf));
+  EXPECT_TRUE(std::abs(s_inf - s) < 1e-3);
 }
 
 TEST(RobustCostTest, testWeightFunctions)
@@ -26,6 +26,7 @@
 #pragma once
 
 #include <mutex>
+#include <utility>
 
 #include <ze/imu/imu_model.hpp>
 #include <ze/common/ringbuffer.hpp>
@@ -79,6 +80,8 @@ using DefaultInterpolator = InterpolatorLinear;
 //! An IMU Buffer with an underlying Gyro and Accel model that also corrects
 //! measurement timestamps. The timestamps are corrected when inserted into the
 //! buffers.
+//! With lock_free_reads, the readers do not block the (IMU driver) thread
+//! inserting measurements but retry if it interfered, see Ringbuffer.
 template<int BufferSize, typename GyroInterp,
 typename AccelInterp = GyroInterp>
 class ImuBuffer
@@ -86,7 +89,7 @@ class ImuBuffer
 public:
   ZE_POINTER_TYPEDEFS(ImuBuffer);
 
-  ImuBuffer(ImuModel::Ptr imu_model);
+  ImuBuffer(ImuModel::Ptr imu_model, bool lock_free_reads = false);
 
   void insertGyroscopeMeasurement(time_t stamp, const Vector3);
   void insertAccelerometerMeasurement(time_t stamp, const Vector3);
@@ -125,10 +128,43 @@ protected:
   bool getGyroscopeDistorted(int64_t time, Eigen::Ref<Vector3> out);
 
 private:
+  enum class RangeStatus
+  {
+    Ok,
+    Invalid,
+    TooFewEntries,
+    TooOld,
+    TooNew,
+    NotEnoughData,
+    NoAccelerometerData
+  };
+
+  //! Runs read_fn() on a consistent state of both buffers, either under
+  //! their mutexes or by retrying until no insertion interfered.
+  template<typename ReadFn>
+  auto read(const ReadFn& read_fn) -> decltype(read_fn());
+
+  typedef Ringbuffer<real_t, 3, BufferSize> ImuRingbuffer;
+
+  //! Fixed-size results of the interpolators, no heap allocation per sample.
+  typedef decltype(GyroInterp::interpolate(
+      std::declval<ImuRingbuffer*>(), int64_t{0},
+      std::declval<typename ImuRingbuffer::timering_t::iterator>())) GyroValue;
+  typedef decltype(AccelInterp::interpolate(
+      std::declval<ImuRingbuffer*>(), int64_t{0},
+      std::declval<typename ImuRingbuffer::timering_t::iterator>())) AccelValue;
+
+  //! Interpolates the accelerometer, false if the buffer does not cover time.
+  bool interpolateAccelerometer(int64_t time, AccelValue* a);
+
+  std::pair<ImuStamps, ImuAccGyrContainer>
+  getBetweenValuesInterpolated_impl(int64_t stamp_from, int64_t stamp_to,
+                                    RangeStatus* status);
+
   //! The underlying storage structures for accelerometer and gyroscope
   //! measurements.
-  Ringbuffer<real_t, 3, BufferSize> acc_buffer_;
-  Ringbuffer<real_t, 3, BufferSize> gyr_buffer_;
+  ImuRingbuffer acc_buffer_;
+  ImuRingbuffer gyr_buffer_;
 
   ImuModel::Ptr imu_model_;
 
@@ -28,13 +28,39 @@
 namespace ze {
 
 template<int BufferSize, typename GyroInterp, typename AccelInterp>
-ImuBuffer<BufferSize, GyroInterp, AccelInterp>::ImuBuffer(ImuModel::Ptr imu_model)
-  : imu_model_(imu_model)
+ImuBuffer<BufferSize, GyroInterp, AccelInterp>::ImuBuffer(
+    ImuModel::Ptr imu_model, bool lock_free_reads)
+  : acc_buffer_(lock_free_reads)
+  , gyr_buffer_(lock_free_reads)
+  , imu_model_(imu_model)
   , gyro_delay_(secToNanosec(imu_model->gyroscopeModel()->intrinsicModel()->delay()))
   , accel_delay_(secToNanosec(imu_model->accelerometerModel()->intrinsicModel()->delay()))
 {
 }
 
+template<int BufferSize, typename GyroInterp, typename AccelInterp>
+template<typename ReadFn>
+auto ImuBuffer<BufferSize, GyroInterp, AccelInterp>::read(
+    const ReadFn& read_fn) -> decltype(read_fn())
+{
+  if (!gyr_buffer_.lockFreeReads())
+  {
+    std::lock_guard<std::mutex> gyr_lock(gyr_buffer_.mutex());
+    std::lock_guard<std::mutex> acc_lock(acc_buffer_.mutex());
+    return read_fn();
+  }
+  while (true)
+  {
+    const uint64_t gyr_seq = gyr_buffer_.readBegin();
+    const uint64_t acc_seq = acc_buffer_.readBegin();
+    auto result = read_fn();
+    if (!gyr_buffer_.readRetry(gyr_seq) && !acc_buffer_.readRetry(acc_seq))
+    {
+      return result;
+    }
+  }
+}
+
 template<int BufferSize, typename GyroInterp, typename AccelInterp>
 void ImuBuffer<BufferSize, GyroInterp, AccelInterp>::insertImuMeasurement(
     int64_t time, const ImuAccGyr value)
@@ -62,27 +88,40 @@ template<int BufferSize, typename GyroInterp, typename AccelInterp>
 bool ImuBuffer<BufferSize, GyroInterp, AccelInterp>::get(int64_t time,
                                               Eigen::Ref<ImuAccGyr> out)
 {
-  std::lock_guard<std::mutex> gyr_lock(gyr_buffer_.mutex());
-  std::lock_guard<std::mutex> acc_lock(acc_buffer_.mutex());
+  return read([&]() {
+    if (gyr_buffer_.times().empty() || acc_buffer_.times().empty()
+        || time > gyr_buffer_.times().back()
+        || time > acc_buffer_.times().back())
+    {
+      return false;
+    }
 
-  if (time > gyr_buffer_.times().back()
-      || time > acc_buffer_.times().back())
-  {
-    return false;
-  }
+    const auto gyro_before = gyr_buffer_.iterator_equal_or_before(time);
+    const auto acc_before = acc_buffer_.iterator_equal_or_before(time);
 
-  const auto gyro_before = gyr_buffer_.iterator_equal_or_before(time);
-  const auto acc_before = acc_buffer_.iterator_equal_or_before(time);
+    if (gyro_before == gyr_buffer_.times().end()
+        || acc_before == acc_buffer_.times().end()) {
+      return false;
+    }
 
-  if (gyro_before == gyr_buffer_.times().end()
-      || acc_before == acc_buffer_.times().end()) {
-    return false;
-  }
+    const GyroValue w = GyroInterp::interpolate(&gyr_buffer_, time, gyro_before);
+    const AccelValue a = AccelInterp::interpolate(&acc_buffer_, time, acc_before);
 
-  VectorX w = GyroInterp::interpolate(&gyr_buffer_, time, gyro_before);
-  VectorX a = AccelInterp::interpolate(&acc_buffer_, time, acc_before);
+    out = imu_model_->undistort(a, w);
+    return true;
+  });
+}
 
-  out = imu_model_->undistort(a, w);
+template<int BufferSize, typename GyroInterp, typename AccelInterp>
+bool ImuBuffer<BufferSize, GyroInterp, AccelInterp>::interpolateAccelerometer(
+    int64_t time, AccelValue* a)
+{
+  const auto acc_before = acc_buffer_.iterator_equal_or_before(time);
+  if (acc_before == acc_buffer_.times().end())
+  {
+    return false;
+  }
+  *a = AccelInterp::interpolate(&acc_buffer_, time, acc_before);
   return true;
 }
 
@@ -111,16 +150,48 @@ ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getBetweenValuesInterpolated(
   // same times. Rectifies all measurements.
   CHECK_GE(stamp_from, 0u);
   CHECK_LT(stamp_from, stamp_to);
+
+  RangeStatus status;
+  std::pair<ImuStamps, ImuAccGyrContainer> result = read([&]() {
+    return getBetweenValuesInterpolated_impl(stamp_from, stamp_to, &status);
+  });
+  switch (status)
+  {
+    case RangeStatus::TooFewEntries:
+      LOG(WARNING) << "Buffer has less than 2 entries.";
+      break;
+    case RangeStatus::TooOld:
+      LOG(WARNING) << "Requests older timestamp than in buffer.";
+      break;
+    case RangeStatus::TooNew:
+      LOG(WARNING) << "Requests newer timestamp than in buffer.";
+      break;
+    case RangeStatus::NotEnoughData:
+      LOG(WARNING) << "Not enough data for interpolation";
+      break;
+    case RangeStatus::NoAccelerometerData:
+      // caller should check the bounds:
+      LOG(FATAL) << "Accelerometer measurements do not cover the requested range.";
+      break;
+    default:
+      break;
+  }
+  return result;
+}
+
+template<int BufferSize, typename GyroInterp, typename AccelInterp>
+std::pair<ImuStamps, ImuAccGyrContainer>
+ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getBetweenValuesInterpolated_impl(
+    int64_t stamp_from, int64_t stamp_to, RangeStatus* status)
+{
   ImuAccGyrContainer rectified_measurements;
   ImuStamps stamps;
 
-  std::lock_guard<std::mutex> gyr_lock(gyr_buffer_.mutex());
-  std::lock_guard<std::mutex> acc_lock(acc_buffer_.mutex());
-
+  // Failures return empty containers, which means unsuccessful.
+  *status = RangeStatus::Invalid;
   if(gyr_buffer_.times().size() < 2)
   {
-    LOG(WARNING) << "Buffer has less than 2 entries.";
-    // return empty means unsuccessful.
+    *status = RangeStatus::TooFewEntries;
     return std::make_pair(stamps, rectified_measurements);
   }
 
@@ -128,38 +199,48 @@ ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getBetweenValuesInterpolated(
   const time_t newest_stamp = gyr_buffer_.times().back();
   if (stamp_from < oldest_stamp)
   {
-    LOG(WARNING) << "Requests older timestamp than in buffer.";
-    // return empty means unsuccessful.
+    *status = RangeStatus::TooOld;
     return std::make_pair(stamps, rectified_measurements);
   }
   if (stamp_to > newest_stamp)
   {
-    LOG(WARNING) << "Requests newer timestamp than in buffer.";
-    // return empty means unsuccessful.
+    *status = RangeStatus::TooNew;
     return std::make_pair(stamps, rectified_measurements);
   }
 
   const auto it_from_before = gyr_buffer_.iterator_equal_or_before(stamp_from);
   const auto it_to_after = gyr_buffer_.iterator_equal_or_after(stamp_to);
-  CHECK(it_from_before != gyr_buffer_.times().end());
-  CHECK(it_to_after != gyr_buffer_.times().end());
+  // Can only fail on a torn lock-free read.
+  if (it_from_before == gyr_buffer_.times().end()
+      || it_to_after == gyr_buffer_.times().end())
+  {
+    return std::make_pair(stamps, rectified_measurements);
+  }
   const auto it_from_after = it_from_before + 1;
   const auto it_to_before = it_to_after - 1;
   if (it_from_after == it_to_before)
   {
-    LOG(WARNING) << "Not enough data for interpolation";
-    // return empty means unsuccessful.
+    *status = RangeStatus::NotEnoughData;
     return std::make_pair(stamps, rectified_measurements);
   }
 
   // resize containers
   const size_t range = it_to_before.index() - it_from_after.index() + 3;
+  if (range > BufferSize + 2)
+  {
+    return std::make_pair(stamps, rectified_measurements);
+  }
   rectified_measurements.resize(Eigen::NoChange, range);
   stamps.resize(range);
 
   // first element
-  VectorX w = GyroInterp::interpolate(&gyr_buffer_, stamp_from, it_from_before);
-  VectorX a = AccelInterp::interpolate(&acc_buffer_, stamp_from);
+  GyroValue w = GyroInterp::interpolate(&gyr_buffer_, stamp_from, it_from_before);
+  AccelValue a;
+  if (!interpolateAccelerometer(stamp_from, &a))
+  {
+    *status = RangeStatus::NoAccelerometerData;
+    return std::make_pair(ImuStamps(), ImuAccGyrContainer());
+  }
   stamps(0) = stamp_from;
   rectified_measurements.col(0) = imu_model_->undistort(a, w);
 
@@ -170,7 +251,11 @@ ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getBetweenValuesInterpolated(
   {
     for (auto it=it_from_before+1; it!=it_to_after; ++it) {
       w = GyroInterp::interpolate(&gyr_buffer_, (*it), it);
-      a = AccelInterp::interpolate(&acc_buffer_, (*it));
+      if (!interpolateAccelerometer(*it, &a))
+      {
+        *status = RangeStatus::NoAccelerometerData;
+        return std::make_pair(ImuStamps(), ImuAccGyrContainer());
+      }
       stamps(col) = (*it);
       rectified_measurements.col(col) = imu_model_->undistort(a, w);
       ++col;
@@ -179,10 +264,15 @@ ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getBetweenValuesInterpolated(
 
   // last element
   w = GyroInterp::interpolate(&gyr_buffer_, stamp_to, it_to_before);
-  a = AccelInterp::interpolate(&acc_buffer_, stamp_to);
+  if (!interpolateAccelerometer(stamp_to, &a))
+  {
+    *status = RangeStatus::NoAccelerometerData;
+    return std::make_pair(ImuStamps(), ImuAccGyrContainer());
+  }
   stamps(range - 1) = stamp_to;
   rectified_measurements.col(range - 1) = imu_model_->undistort(a, w);
 
+  *status = RangeStatus::Ok;
   return std::make_pair(stamps, rectified_measurements);
 }
 
@@ -25,6 +25,7 @@
 
 #include <ze/trajectory_analysis/kitti_evaluation.hpp>
 
+#include <ze/common/pose_batch.hpp>
 #include <ze/geometry/align_poses.hpp>
 #include <ze/geometry/align_points.hpp>
 
@@ -80,8 +81,8 @@ std::vector<RelativeError> calcSequenceErrors(
   std::vector<real_t> dist_gt = trajectoryDistances(T_W_A);
   std::vector<real_t> dist_es = trajectoryDistances(T_W_B);
 
-  // Compute relative errors for all start positions.
-  std::vector<RelativeError> errors;
+  // Find the segments to evaluate.
+  std::vector<std::pair<size_t, int32_t>> segments;
   for (size_t first_frame = 0; first_frame < T_W_A.size();
        first_frame += skip_num_frames_between_segment_evaluation)
   {
@@ -91,12 +92,33 @@ std::vector<RelativeError> calcSequenceErrors(
     {
       continue; // continue, if segment is longer than trajectory.
     }
+    segments.push_back(std::make_pair(first_frame, last_frame));
+  }
+
+  // Gather the poses at the start and end of all segments, such that the
+  // relative poses are computed with the batch kernels.
+  const int num_segments = segments.size();
+  PoseBatch T_W_A0(num_segments), T_W_Ai(num_segments);
+  PoseBatch T_W_B0(num_segments), T_W_Bi(num_segments);
+  for (int k = 0; k < num_segments; ++k)
+  {
+    T_W_A0.set(k, T_W_A[segments[k].first]);
+    T_W_Ai.set(k, T_W_A[segments[k].second]);
+    T_W_B0.set(k, T_W_B[segments[k].first]);
+    T_W_Bi.set(k, T_W_B[segments[k].second]);
+  }
+  PoseBatch T_A0_B0;
+  relativePoses(T_W_A0, T_W_B0, &T_A0_B0);
 
-    // Perform a least-squares alignment of the first part of the trajectories.
+  // Perform a least-squares alignment of the first part of the trajectories.
+  for (int k = 0; k < num_segments; ++k)
+  {
+    const size_t first_frame = segments[k].first;
+    const int32_t last_frame = segments[k].second;
     int n_align_poses = least_squares_align_range * (last_frame - first_frame);
-    Transformation T_A0_B0 = T_W_A[first_frame].inverse() * T_W_B[first_frame];
     if(use_least_squares_alignment && n_align_poses > 1)
     {
+      Transformation T_A0_B0_k = T_A0_B0.at(k);
       if (least_squares_align_translation_only)
       {
         /*
@@ -108,7 +130,7 @@ std::vector<RelativeError> calcSequenceErrors(
           p_W_gt_align.col(i) = T_W_A.at(first_frame + i).getPosition();
 
           PointAligner problem(p_W_gt_align, p_W_es_align);
-          problem.optimize(T_A0_B0);
+          problem.optimize(T_A0_B0_k);
         }
         */
         //! @todo: Run closed-form solution of the alignment first. As it is now
@@ -126,23 +148,41 @@ std::vector<RelativeError> calcSequenceErrors(
         const real_t sigma_pos = 0.05;
         const real_t sigma_rot = 5.0 / 180 * M_PI;
         PoseAligner problem(T_W_gt_align, T_W_es_align, sigma_pos, sigma_rot);
-        problem.optimize(T_A0_B0);
+        problem.optimize(T_A0_B0_k);
       }
+      T_A0_B0.set(k, T_A0_B0_k);
     }
+  }
 
-    // Compute relative rotational and translational errors.
-    Transformation T_W_Ai = T_W_A[last_frame];
-    Transformation T_A0_Ai = T_W_A[first_frame].inverse() * T_W_Ai;
-    Transformation T_Bi_A0 = T_W_B[last_frame].inverse() * T_W_A[first_frame];
-    Transformation T_Bi_Ai = T_Bi_A0 * T_A0_B0 * T_A0_Ai;
-    Transformation T_Ai_Bi = T_Bi_Ai.inverse();
+  // Compute relative rotational and translational errors:
+  // T_Bi_Ai = T_Bi_A0 * T_A0_B0 * T_A0_Ai.
+  PoseBatch T_A0_Ai, T_Bi_A0, T_Bi_Ai, T_Ai_Bi;
+  relativePoses(T_W_A0, T_W_Ai, &T_A0_Ai);
+  relativePoses(T_W_Bi, T_W_A0, &T_Bi_A0);
+  composePoses(T_Bi_A0, T_A0_B0, &T_Bi_Ai);
+  composePoses(T_Bi_Ai, T_A0_Ai, &T_Bi_Ai);
+  invertPoses(T_Bi_Ai, &T_Ai_Bi);
+
+  // The relative error is represented in the frame of reference of the last
+  // frame in the ground-truth trajectory. We want to express it in the world
+  // frame to make statements about the yaw drift (not observable in Visual-
+  // inertial setting) vs. roll and pitch (observable).
+  Matrix6X Ai_log_Ai_Bi;
+  logPoses(T_Ai_Bi, &Ai_log_Ai_Bi);
+  PoseBatch R_W_Ai = T_W_Ai;
+  R_W_Ai.px().setZero();
+  R_W_Ai.py().setZero();
+  R_W_Ai.pz().setZero();
+  Positions W_t_gtlast_eslast, W_R_gtlast_eslast;
+  transformPoints(R_W_Ai, Ai_log_Ai_Bi.topRows<3>(), &W_t_gtlast_eslast);
+  transformPoints(R_W_Ai, Ai_log_Ai_Bi.bottomRows<3>(), &W_R_gtlast_eslast);
 
-    // The relative error is represented in the frame of reference of the last
-    // frame in the ground-truth trajectory. We want to express it in the world
-    // frame to make statements about the yaw drift (not observable in Visual-
-    // inertial setting) vs. roll and pitch (observable).
-    Vector3 W_t_gtlast_eslast = T_W_Ai.getRotation().rotate(T_Ai_Bi.getPosition());
-    Vector3 W_R_gtlast_eslast = T_W_Ai.getRotation().rotate(T_Ai_Bi.getRotation().log());
+  std::vector<RelativeError> errors;
+  errors.reserve(num_segments);
+  for (int k = 0; k < num_segments; ++k)
+  {
+    const size_t first_frame = segments[k].first;
+    const int32_t last_frame = segments[k].second;
 
     // Scale error is the ratio of the respective segment length
     real_t scale_error =
@@ -150,8 +190,8 @@ std::vector<RelativeError> calcSequenceErrors(
         / (dist_gt.at(last_frame) - dist_gt.at(first_frame));
 
     errors.push_back(RelativeError(first_frame,
-                                   W_t_gtlast_eslast,
-                                   W_R_gtlast_eslast,
+                                   W_t_gtlast_eslast.col(k),
+                                   W_R_gtlast_eslast.col(k),
                                    segment_length,
                                    scale_error,
                                    last_frame - first_frame + 1));
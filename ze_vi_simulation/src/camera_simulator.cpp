@@ -27,6 +27,7 @@
 
 #include <ze/cameras/camera_rig.hpp>
 #include <ze/cameras/camera_utils.hpp>
+#include <ze/common/frame_arena.hpp>
 #include <ze/common/random_matrix.hpp>
 #include <ze/vi_simulation/trajectory_simulator.hpp>
 #include <ze/visualization/viz_interface.hpp>
@@ -98,35 +99,40 @@ CameraMeasurements CameraSimulator::visibleLandmarks(
     return CameraMeasurements();
   }
 
-  const Size2u image_size = rig_->at(cam_idx).size();
-  const auto lm_W = landmarks_W_.middleCols(lm_min_idx, num_landmarks);
-  const auto lm_C = (T_W_B * rig_->T_B_C(cam_idx)).inverse().transformVectorized(lm_W);
-  Keypoints px = rig_->at(cam_idx).projectVectorized(lm_C);
-  std::vector<uint32_t> visible_indices;
+  // Landmarks are transformed and projected one by one, temporaries live in
+  // the frame arena.
+  FrameScope scope;
+  const Camera& cam = rig_->at(cam_idx);
+  const Size2u image_size = cam.size();
+  const Transformation T_C_W = (T_W_B * rig_->T_B_C(cam_idx)).inverse();
+  const Matrix3 R_C_W = T_C_W.getRotationMatrix();
+  const Position t_C_W = T_C_W.getPosition();
+  auto px = arenaMatrix<Keypoints>(scope.arena(), 2, num_landmarks);
+  FrameVector<uint32_t> visible_indices(scope.allocator<uint32_t>());
+  visible_indices.reserve(num_landmarks);
   for (uint32_t i = 0u; i < num_landmarks; ++i)
   {
-    if (lm_C(2,i) < options_.min_depth_m ||
-        lm_C(2,i) > options_.max_depth_m)
+    const Position p_C = R_C_W * landmarks_W_.col(lm_min_idx + i) + t_C_W;
+    if (p_C(2) < options_.min_depth_m ||
+        p_C(2) > options_.max_depth_m)
     {
       // Landmark is either behind or too far from the camera.
       continue;
     }
 
-    if (isVisible(image_size, px.col(i)))
+    const Keypoint px_i = cam.project(p_C);
+    if (isVisible(image_size, px_i))
     {
+      px.col(visible_indices.size()) = px_i;
       visible_indices.push_back(i);
     }
   }
 
   // Copy visible indices into Camera Measurements struct:
+  const int num_visible = visible_indices.size();
   CameraMeasurements m;
-  m.keypoints_.resize(Eigen::NoChange, visible_indices.size());
-  m.global_landmark_ids_.resize(visible_indices.size());
-  for (size_t i = 0; i < visible_indices.size(); ++i)
-  {
-    m.keypoints_.col(i) = px.col(visible_indices[i]);
-    m.global_landmark_ids_[i] = visible_indices[i];
-  }
+  m.keypoints_ = px.leftCols(num_visible);
+  m.global_landmark_ids_.assign(visible_indices.begin(), visible_indices.end());
 
   return m;
 }
@@ -169,11 +175,11 @@ CameraMeasurementsVector CameraSimulator::getMeasurements(real_t time)
       // Update our list of tracks:
       new_global_lm_id_to_track_id_map[lm_id] = track_id;
     }
-    measurements.push_back(m);
+    measurements.push_back(std::move(m));
   }
 
   // Update our list of active tracks:
-  global_lm_id_to_track_id_map_ = new_global_lm_id_to_track_id_map;
+  global_lm_id_to_track_id_map_.swap(new_global_lm_id_to_track_id_map);
 
   return measurements;
 }